@@ -19,7 +19,9 @@ scons -f SConstruct_linux
 if [[ $? -eq 0 ]]; then
 	# Copy executable
 	cp build/linux/release/xmem ./xmem
+	cp build/linux/release/libxmem.a build/linux/release/libxmem.so .
 	echo Done! The executable is at the top of the project tree: xmem
+	echo The libxmem libraries are next to it: libxmem.a, libxmem.so
 	exit 0
 else
 	echo X-Mem for GNU/Linux build FAILED.	
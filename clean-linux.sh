@@ -8,5 +8,6 @@ echo Cleaning build of X-Mem for GNU/Linux...
 scons -c -f SConstruct_linux
 rm -rf build/linux
 rm xmem-linux
+rm -f libxmem.a libxmem.so
 
 echo Done!
@@ -0,0 +1,430 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the AggregateThroughputBenchmark class.
+ */
+
+//Headers
+#include <AggregateThroughputBenchmark.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+#include <LoadWorker.h>
+#include <Thread.h>
+#include <Timer.h>
+#include <PermutationCache.h>
+
+//Libraries
+#include <iostream>
+#include <assert.h>
+#include <time.h>
+
+using namespace xmem;
+
+AggregateThroughputBenchmark::AggregateThroughputBenchmark(
+		std::vector<void*> mem_arrays,
+		std::vector<size_t> lens,
+		uint32_t iterations,
+		uint64_t passes_per_iteration,
+		uint32_t threads_per_group,
+		std::vector<uint32_t> mem_nodes,
+		std::vector<uint32_t> cpu_nodes,
+		std::vector<int32_t> cpu_ids,
+		pattern_mode_t pattern_mode,
+		rw_mode_t rw_mode,
+		chunk_size_t chunk_size,
+		int64_t stride_size,
+		std::vector<PowerReader*> dram_power_readers,
+		std::string name
+	) :
+	Benchmark(
+		mem_arrays.empty() ? NULL : mem_arrays[0], //The base class tracks the first group's region only
+		lens.empty() ? 0 : lens[0],
+		iterations,
+		passes_per_iteration,
+		threads_per_group * static_cast<uint32_t>(cpu_nodes.size()),
+		mem_nodes.empty() ? 0 : mem_nodes[0],
+		cpu_nodes.empty() ? 0 : cpu_nodes[0],
+		cpu_ids,
+		pattern_mode,
+		rw_mode,
+		chunk_size,
+		stride_size,
+		dram_power_readers,
+		"MB/s",
+		name
+	),
+	__mem_arrays(mem_arrays),
+	__lens(lens),
+	__threads_per_group(threads_per_group),
+	__mem_nodes(mem_nodes),
+	__cpu_nodes(cpu_nodes),
+	__groupMetricOnIter(),
+	__averageGroupMetric()
+	{
+
+	for (uint32_t g = 0; g < __cpu_nodes.size(); g++) {
+		__groupMetricOnIter.push_back(std::vector<double>(_iterations, -1));
+		__averageGroupMetric.push_back(0);
+	}
+}
+
+void AggregateThroughputBenchmark::report_benchmark_info() const {
+	std::cout << "Worker groups (CPU NUMA Node -> Memory NUMA Node): ";
+	for (uint32_t g = 0; g < __cpu_nodes.size(); g++)
+		std::cout << __cpu_nodes[g] << "->" << __mem_nodes[g] << " ";
+	std::cout << std::endl;
+
+	std::cout << "Chunk Size: ";
+	switch (_chunk_size) {
+		case CHUNK_32b:
+			std::cout << "32-bit";
+			break;
+		case CHUNK_64b:
+			std::cout << "64-bit";
+			break;
+		case CHUNK_128b:
+			std::cout << "128-bit";
+			break;
+		case CHUNK_256b:
+			std::cout << "256-bit";
+			break;
+		default:
+			std::cout << "UNKNOWN";
+			break;
+	}
+	std::cout << std::endl;
+
+	std::cout << "Access Pattern: ";
+	switch (_pattern_mode) {
+		case SEQUENTIAL:
+			if (_stride_size > 0)
+				std::cout << "forward ";
+			else if (_stride_size < 0)
+				std::cout << "reverse ";
+			else 
+				std::cout << "UNKNOWN ";
+
+			if (_stride_size == 1 || _stride_size == -1)
+				std::cout << "sequential";
+			else 
+				std::cout << "strides of " << _stride_size << " chunks";
+			break;
+		case RANDOM:
+			std::cout << "random";
+			break;
+		default:
+			std::cout << "UNKNOWN";
+			break;
+	}
+	std::cout << std::endl;
+
+	std::cout << "Read/Write Mode: ";
+	switch (_rw_mode) {
+		case READ:
+			std::cout << "read";
+			break;
+		case WRITE:
+			std::cout << "write";
+			break;
+		default:
+			std::cout << "UNKNOWN";
+			break;
+	}
+	std::cout << std::endl;
+
+	std::cout << "Number of worker threads: " << _num_worker_threads << " (" << __threads_per_group << " per group)";
+	std::cout << std::endl;
+
+	std::cout << "Worker CPUs: ";
+	for (uint32_t w = 0; w < _cpu_ids.size(); w++)
+		std::cout << _cpu_ids[w] << " ";
+	std::cout << std::endl;
+
+	std::cout << std::endl;
+}
+
+void AggregateThroughputBenchmark::report_results() const {
+	Benchmark::report_results();
+
+	if (_hasRun) {
+		for (uint32_t g = 0; g < __cpu_nodes.size(); g++)
+			std::cout << "...CPU node " << __cpu_nodes[g] << " -> memory node " << __mem_nodes[g] << " average: " << __averageGroupMetric[g] << " " << _metricUnits << std::endl;
+	}
+}
+
+uint32_t AggregateThroughputBenchmark::getNumGroups() const {
+	return static_cast<uint32_t>(__cpu_nodes.size());
+}
+
+uint32_t AggregateThroughputBenchmark::getThreadsPerGroup() const {
+	return __threads_per_group;
+}
+
+uint32_t AggregateThroughputBenchmark::getGroupCPUNode(uint32_t group) const {
+	return __cpu_nodes[group];
+}
+
+uint32_t AggregateThroughputBenchmark::getGroupMemNode(uint32_t group) const {
+	return __mem_nodes[group];
+}
+
+double AggregateThroughputBenchmark::getAverageGroupMetric(uint32_t group) const {
+	if (_hasRun && group < __averageGroupMetric.size())
+		return __averageGroupMetric[group];
+	else //bad call
+		return -1;
+}
+
+void AggregateThroughputBenchmark::getResult(BenchmarkResult& result) const {
+	Benchmark::getResult(result);
+	result.kind = "aggregate";
+	if (!__lens.empty() && __threads_per_group > 0)
+		result.working_set_size_per_thread = __lens[0] / __threads_per_group;
+	result.group_cpu_nodes = __cpu_nodes;
+	result.group_mem_nodes = __mem_nodes;
+	for (uint32_t g = 0; g < getNumGroups(); g++)
+		result.group_metrics.push_back(getAverageGroupMetric(g));
+}
+
+bool AggregateThroughputBenchmark::_prepare_core() {
+	uint32_t num_groups = static_cast<uint32_t>(__mem_arrays.size());
+	if (__lens.size() != num_groups || __threads_per_group == 0)
+		return false;
+
+	//Benchmark::prepare() only touches the first group's region, so make the rest resident too. Their NUMA placement was fixed at allocation.
+	for (uint32_t g = 1; g < num_groups; g++)
+		g_permutation_cache.touch(__mem_arrays[g], reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__mem_arrays[g]) + __lens[g]));
+
+	//Build pointer indices. Note that the pointers for each thread must stay within its respective region, otherwise sharing may occur. 
+	if (_pattern_mode == RANDOM) {
+		for (uint32_t g = 0; g < num_groups; g++) {
+			size_t len_per_thread = __lens[g] / __threads_per_group;
+			for (uint32_t t = 0; t < __threads_per_group; t++) {
+				if (!g_permutation_cache.preparePermutation(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__mem_arrays[g]) + t*len_per_thread), //casts to silence compiler warnings
+															reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__mem_arrays[g]) + (t+1)*len_per_thread), //casts to silence compiler warnings
+															_chunk_size,
+															g_permutation_seed,
+															_info_log,
+															_warning_log)) {
+					_reportError("Failed to build a random pointer permutation for a worker thread!");
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+bool AggregateThroughputBenchmark::_run_core() {
+	uint32_t num_groups = static_cast<uint32_t>(__cpu_nodes.size());
+	if (num_groups == 0 || __mem_arrays.size() != num_groups || __lens.size() != num_groups || __mem_nodes.size() != num_groups || __threads_per_group == 0) {
+		_reportError("Aggregate throughput benchmark was given an inconsistent set of worker groups.");
+		return false;
+	}
+
+	//Set up kernel function pointers
+	SequentialFunction kernel_fptr_seq = NULL;
+	SequentialFunction kernel_dummy_fptr_seq = NULL; 
+	RandomFunction kernel_fptr_ran = NULL;
+	RandomFunction kernel_dummy_fptr_ran = NULL; 
+
+	if (_pattern_mode == SEQUENTIAL) {
+		if (!determineSequentialKernel(_rw_mode, _chunk_size, _stride_size, &kernel_fptr_seq, &kernel_dummy_fptr_seq)) {
+			_reportError("Failed to find appropriate benchmark kernel.");
+			return false;
+		}
+	} else if (_pattern_mode == RANDOM) {
+		if (!determineRandomKernel(_rw_mode, _chunk_size, &kernel_fptr_ran, &kernel_dummy_fptr_ran)) {
+			_reportError("Failed to find appropriate benchmark kernel.");
+			return false;
+		}
+	} else {
+		_reportError("Got an invalid pattern mode.");
+		return false;
+	}
+
+	//Sequential writes clobber any pointer permutation left in the working sets
+	if (_pattern_mode == SEQUENTIAL && _rw_mode == WRITE)
+		for (uint32_t g = 0; g < num_groups; g++)
+			g_permutation_cache.invalidate(__mem_arrays[g], reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__mem_arrays[g]) + __lens[g]));
+
+	//For getting timer frequency info, etc.
+	Timer helper_timer;
+	
+	//Set up some stuff for worker threads
+	std::vector<LoadWorker*> workers;
+	std::vector<Thread*> worker_threads;
+
+	//Start power measurement
+	if (_info_log != NULL) 
+		*_info_log << "Starting power measurement threads...";
+	if (!_start_power_threads()) {
+		if (_info_log != NULL)
+			*_info_log << "FAIL" << std::endl;
+		_reportWarning("Failed to start power measurement threads.");
+	} else if (_info_log != NULL)
+		*_info_log << "done" << std::endl;
+
+	//Run benchmark
+	if (_info_log != NULL)
+		*_info_log << "Running benchmark." << std::endl << std::endl;
+
+	//Do a bunch of iterations of the core benchmark routines
+	for (uint32_t i = 0; _beginIteration(i); i++) {
+		for (uint32_t g = 0; g < num_groups; g++)
+			if (i >= __groupMetricOnIter[g].size())
+				__groupMetricOnIter[g].push_back(-1);
+		WorkerGroupSync group_sync(_num_worker_threads); //One gate for every worker across all groups
+
+		//Create workers and worker threads. Worker w belongs to group w / __threads_per_group.
+		for (uint32_t g = 0; g < num_groups; g++) {
+			size_t len_per_thread = __lens[g] / __threads_per_group; //Carve up each group's memory space so each worker has its own area to play in
+			for (uint32_t t = 0; t < __threads_per_group; t++) {
+				void* thread_mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__mem_arrays[g]) + t * len_per_thread);
+				uint32_t w = g * __threads_per_group + t;
+				int32_t cpu_id = w < _cpu_ids.size() ? _cpu_ids[w] : -1;
+				if (cpu_id < 0)
+					_reportWarning("No logical CPU was found for worker thread " + std::to_string(t) + " of the group on NUMA node " + std::to_string(__cpu_nodes[g]));
+				if (_pattern_mode == SEQUENTIAL)
+					workers.push_back(new LoadWorker(thread_mem_array,
+													 len_per_thread,
+													 _passes_per_iteration,
+													 kernel_fptr_seq,
+													 kernel_dummy_fptr_seq,
+													 cpu_id));
+				else
+					workers.push_back(new LoadWorker(thread_mem_array,
+													 len_per_thread,
+													 _passes_per_iteration,
+													 kernel_fptr_ran,
+													 kernel_dummy_fptr_ran,
+													 cpu_id));
+				workers.back()->setGroupSync(&group_sync);
+				_traceWorker(workers.back(), helper_timer.get_ticks_per_sec());
+				worker_threads.push_back(new Thread(workers.back()));
+			}
+		}
+
+		//Start worker threads! gogogo
+		_beginInterferenceCheck();
+		bool started = true;
+		for (uint32_t w = 0; w < worker_threads.size(); w++) {
+			if (!worker_threads[w]->create_and_start()) {
+				_reportError("Failed to start a worker thread!");
+				started = false;
+			}
+		}
+
+		//The gate waits for every worker, so release the ones that did start
+		if (!started)
+			group_sync.requestStop();
+
+		//Wait for all threads to complete
+		for (uint32_t w = 0; w < worker_threads.size(); w++)
+			if (worker_threads[w]->created() && !worker_threads[w]->join())
+				_reportWarning("A worker thread failed to complete correctly!");
+
+		if (!started) {
+			for (uint32_t w = 0; w < worker_threads.size(); w++) {
+				delete worker_threads[w];
+				delete workers[w];
+			}
+			if (!_stop_power_threads())
+				_reportWarning("Failed to stop power measurement threads.");
+			return false;
+		}
+
+		//Compute throughput achieved by each group. Because all workers share one measurement window, the system total is the sum over groups.
+		bool iter_warning = false;
+		double iter_total = 0;
+		for (uint32_t g = 0; g < num_groups; g++) {
+			uint64_t total_passes = 0;
+			uint64_t total_adjusted_ticks = 0;
+			uint64_t avg_adjusted_ticks = 0;
+			uint64_t bytes_per_pass = workers[g * __threads_per_group]->getBytesPerPass(); //all should be the same.
+			for (uint32_t t = 0; t < __threads_per_group; t++) {
+				LoadWorker* worker = workers[g * __threads_per_group + t];
+				total_passes += worker->getPasses();
+				total_adjusted_ticks += worker->getAdjustedTicks();
+				iter_warning |= worker->hadWarning();
+				_recordWorker(i, worker, false, helper_timer.get_ns_per_tick());
+			}
+			avg_adjusted_ticks = total_adjusted_ticks / __threads_per_group;
+
+			__groupMetricOnIter[g][i] = ((static_cast<double>(total_passes) * static_cast<double>(bytes_per_pass)) / static_cast<double>(MB))   /   ((static_cast<double>(avg_adjusted_ticks) * helper_timer.get_ns_per_tick()) / 1e9);
+			iter_total += __groupMetricOnIter[g][i];
+
+			if (_info_log != NULL)
+				*_info_log << "Iter " << i+1 << " group " << g << " (CPU node " << __cpu_nodes[g] << " -> memory node " << __mem_nodes[g] << ") had " << total_passes << " passes across " << __threads_per_group << " threads, with " << bytes_per_pass << " bytes touched per pass: " << __groupMetricOnIter[g][i] << " " << _metricUnits << std::endl;
+		}
+
+		if (iter_warning)
+			_warning = true;
+		_endInterferenceCheck(i);
+
+		//Compute metric for this iteration
+		_metricOnIter[i] = iter_total;
+		_recordTrace(i, workers, helper_timer.get_ticks_per_sec(), helper_timer.get_ns_per_tick());
+
+		//Clean up workers and threads for this iteration
+		for (uint32_t w = 0; w < worker_threads.size(); w++) {
+			delete worker_threads[w];
+			delete workers[w];
+		}
+		worker_threads.clear();
+		workers.clear();
+	}
+
+	//Stopping power measurement
+	if (_info_log != NULL) 
+		*_info_log << "Stopping power measurement threads...";
+	if (!_stop_power_threads()) {
+		if (_info_log != NULL)
+			*_info_log << "FAIL" << std::endl;
+		_reportWarning("Failed to stop power measurement threads.");
+	} else if (_info_log != NULL)
+		*_info_log << "done" << std::endl;
+	
+	//Run metadata
+	_finishIterations();
+
+	//Group averages cover the same iterations as the total, so that they add up to it
+	for (uint32_t g = 0; g < num_groups; g++) {
+		double sum = 0;
+		uint32_t kept = 0;
+		for (uint32_t i = 0; i < _iterations && i < __groupMetricOnIter[g].size(); i++) {
+			if (_outlierOnIter[i])
+				continue;
+			sum += __groupMetricOnIter[g][i];
+			kept++;
+		}
+		__averageGroupMetric[g] = (kept > 0) ? sum / static_cast<double>(kept) : 0;
+	}
+	_hasRun = true;
+
+	return true;
+}
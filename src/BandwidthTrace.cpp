@@ -0,0 +1,128 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the BandwidthTrace class.
+ */
+
+//Headers
+#include <BandwidthTrace.h>
+#include <common.h>
+
+//Libraries
+#include <algorithm>
+
+using namespace xmem;
+
+/**
+ * @brief Finds how many passes a worker had completed at a given tick, interpolating between its samples.
+ * @param trace The worker's trace. It must hold at least one sample.
+ * @param tick The tick. It must not be before the first sample.
+ * @param cursor Index of a sample at or before the tick. Advanced as far as possible, so that a series of increasing ticks walks the trace once.
+ * @returns The interpolated number of passes.
+ */
+static double passes_at(const BandwidthTrace& trace, uint64_t tick, size_t& cursor) {
+	while (cursor + 1 < trace.size() && trace.at(cursor + 1).tick <= tick)
+		cursor++;
+	const TraceSample& before = trace.at(cursor);
+	if (cursor + 1 >= trace.size() || tick <= before.tick)
+		return static_cast<double>(before.passes);
+	const TraceSample& after = trace.at(cursor + 1);
+	double fraction = static_cast<double>(tick - before.tick) / static_cast<double>(after.tick - before.tick);
+	return static_cast<double>(before.passes) + fraction * static_cast<double>(after.passes - before.passes);
+}
+
+BandwidthTrace::BandwidthTrace(size_t capacity, uint64_t period_ticks) :
+	__samples(),
+	__mask(0),
+	__count(0),
+	__period_ticks(period_ticks),
+	__next_sample_tick(0),
+	__bytes_per_pass(0)
+	{
+	size_t size = 1;
+	while (size < capacity && size < BANDWIDTH_TRACE_MAX_SAMPLES)
+		size *= 2;
+	__samples.resize(size);
+	__mask = size - 1;
+}
+
+void BandwidthTrace::begin(uint64_t tick, uint64_t bytes_per_pass) {
+	__count = 0;
+	__bytes_per_pass = bytes_per_pass;
+	__next_sample_tick = 0;
+	sample(tick, 0);
+}
+
+size_t BandwidthTrace::size() const {
+	return static_cast<size_t>(std::min(__count, static_cast<uint64_t>(__samples.size())));
+}
+
+const TraceSample& BandwidthTrace::at(size_t index) const {
+	uint64_t oldest = __count - size();
+	return __samples[(oldest + index) & __mask];
+}
+
+bool BandwidthTrace::wrapped() const {
+	return __count > __samples.size();
+}
+
+uint64_t BandwidthTrace::getBytesPerPass() const {
+	return __bytes_per_pass;
+}
+
+void xmem::merge_bandwidth_traces(const std::vector<const BandwidthTrace*>& traces, uint64_t period_ticks, double ns_per_tick, std::vector<double>& mb_per_sec) {
+	mb_per_sec.clear();
+	if (traces.empty() || period_ticks == 0)
+		return;
+
+	//Find the span covered by every trace
+	uint64_t start_tick = 0;
+	uint64_t end_tick = UINT64_MAX;
+	for (uint32_t t = 0; t < traces.size(); t++) {
+		if (traces[t] == NULL || traces[t]->size() == 0)
+			return;
+		start_tick = std::max(start_tick, traces[t]->at(0).tick);
+		end_tick = std::min(end_tick, traces[t]->at(traces[t]->size() - 1).tick);
+	}
+	if (end_tick <= start_tick)
+		return;
+
+	std::vector<size_t> cursors(traces.size(), 0);
+	std::vector<double> previous_passes(traces.size(), 0);
+	for (uint32_t t = 0; t < traces.size(); t++)
+		previous_passes[t] = passes_at(*traces[t], start_tick, cursors[t]);
+
+	double interval_sec = static_cast<double>(period_ticks) * ns_per_tick / 1e9;
+	for (uint64_t tick = start_tick + period_ticks; tick <= end_tick; tick += period_ticks) {
+		double bytes = 0;
+		for (uint32_t t = 0; t < traces.size(); t++) {
+			double passes = passes_at(*traces[t], tick, cursors[t]);
+			bytes += (passes - previous_passes[t]) * static_cast<double>(traces[t]->getBytesPerPass());
+			previous_passes[t] = passes;
+		}
+		mb_per_sec.push_back(bytes / static_cast<double>(MB) / interval_sec);
+	}
+}
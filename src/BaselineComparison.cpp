@@ -0,0 +1,399 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the BaselineComparison class.
+ */
+
+//Headers
+#include <BaselineComparison.h>
+#include <JsonValue.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+using namespace xmem;
+
+/**
+ * @brief Builds the key segment of one load worker's own workload.
+ */
+static std::string format_worker_spec(const std::string& pattern, const std::string& rw, uint32_t chunk_bits, int64_t stride, uint32_t mem_node, uint64_t throttle_bytes_per_sec) {
+	std::ostringstream segment;
+	segment << " worker=" << pattern << "," << rw << "," << chunk_bits << "," << stride << "," << mem_node << "," << throttle_bytes_per_sec;
+	return segment.str();
+}
+
+/**
+ * @brief Builds a parameter key from its parts. Load parameters are left out when there are no load threads, and run settings are left out of the benchmarks they do not affect.
+ */
+static std::string format_key(const std::string& mode, uint64_t bytes_per_pass, uint32_t latency_unroll, const std::string& kind, uint64_t working_set_size_per_thread, uint32_t threads, uint32_t load_threads, uint32_t cpu_node, uint32_t mem_node, uint32_t load_cpu_node, uint32_t load_mem_node, const std::string& pattern, const std::string& rw, uint32_t chunk_bits, int64_t stride, const std::string& sharing, const std::vector< std::pair<uint32_t, uint32_t> >& groups, const std::vector<int32_t>& cpus, const std::vector<std::string>& worker_specs) {
+	std::ostringstream key;
+	key << mode << " " << kind << " ws=" << working_set_size_per_thread << " threads=" << threads << " load_threads=" << load_threads;
+	if (mode == "time" && (kind != "latency" || load_threads > 0)) //Only time-based throughput kernels run in passes
+		key << " bytes_per_pass=" << bytes_per_pass;
+	if (kind == "latency")
+		key << " unroll=" << latency_unroll;
+	if (groups.empty())
+		key << " cpu_node=" << cpu_node << " mem_node=" << mem_node;
+	else {
+		key << " groups=";
+		for (size_t g = 0; g < groups.size(); g++)
+			key << (g > 0 ? "," : "") << groups[g].first << "->" << groups[g].second;
+	}
+	if (!cpus.empty()) { //Results from before placement was recorded have no CPUs
+		key << " cpus=";
+		for (size_t c = 0; c < cpus.size(); c++)
+			key << (c > 0 ? "," : "") << cpus[c];
+	}
+	if (load_threads > 0)
+		key << " pattern=" << pattern << " rw=" << rw << " chunk=" << chunk_bits << " stride=" << stride;
+	if (load_threads > 0 && !sharing.empty() && sharing != "PRIVATE") //Results from before sharing modes existed are private
+		key << " sharing=" << sharing;
+	if (load_threads > 0 && (load_cpu_node != cpu_node || load_mem_node != mem_node))
+		key << " load_nodes=" << load_cpu_node << "->" << load_mem_node;
+	for (size_t w = 0; w < worker_specs.size(); w++) //Benchmarks where all load threads run the same kernel have no worker segments
+		key << worker_specs[w];
+	return key.str();
+}
+
+/**
+ * @brief Indicates whether smaller values of a metric are better, judging by its units. Rates such as MB/s are better when larger, and times such as ns/access are better when smaller.
+ */
+static bool lower_is_better(const std::string& units) {
+	return !(units.size() >= 2 && units.compare(units.size()-2, 2, "/s") == 0);
+}
+
+/**
+ * @brief Computes the mean and sample variance of a set of samples.
+ */
+static void mean_and_variance(const std::vector<double>& samples, double& mean, double& variance) {
+	mean = 0;
+	variance = 0;
+	if (samples.empty())
+		return;
+	for (size_t i = 0; i < samples.size(); i++)
+		mean += samples[i];
+	mean /= samples.size();
+	if (samples.size() < 2)
+		return;
+	for (size_t i = 0; i < samples.size(); i++)
+		variance += (samples[i] - mean) * (samples[i] - mean);
+	variance /= (samples.size() - 1);
+}
+
+BaselineComparison::BaselineComparison() :
+	__filename(),
+	__loaded(false),
+	__min_relative_change(0),
+	__baseline(),
+	__entries()
+	{
+}
+
+bool BaselineComparison::load(const std::string& filename) {
+	std::ifstream in(filename.c_str());
+	if (!in.is_open()) {
+		std::cerr << "ERROR: Failed to open baseline file " << filename << "." << std::endl;
+		return false;
+	}
+
+	__filename = filename;
+	__baseline.clear();
+	std::string mode = "";
+	uint64_t bytes_per_pass = DEFAULT_THROUGHPUT_BENCHMARK_BYTES_PER_PASS; //Results from before these were recorded used the defaults
+	uint32_t latency_unroll = DEFAULT_LATENCY_BENCHMARK_UNROLL_LENGTH;
+	std::string line;
+	uint32_t line_number = 0;
+	while (std::getline(in, line)) {
+		line_number++;
+		if (line.find_first_not_of(" \t\r") == std::string::npos)
+			continue;
+
+		JsonValue record;
+		std::string error;
+		if (!JsonValue::parse(line, record, error)) {
+			std::cerr << "ERROR: " << filename << ":" << line_number << ": " << error << "." << std::endl;
+			return false;
+		}
+
+		const JsonValue* type = record.get("record");
+		if (type == NULL)
+			continue;
+		if (type->asString() == "run") {
+			const JsonValue* config = record.get("config");
+			if (config != NULL && config->get("benchmark_mode") != NULL)
+				mode = config->get("benchmark_mode")->asString();
+			if (config != NULL && config->get("bytes_per_pass") != NULL)
+				bytes_per_pass = static_cast<uint64_t>(config->get("bytes_per_pass")->asNumber());
+			if (config != NULL && config->get("latency_unroll") != NULL)
+				latency_unroll = static_cast<uint32_t>(config->get("latency_unroll")->asNumber());
+			continue;
+		}
+		if (type->asString() != "benchmark")
+			continue;
+
+		const JsonValue* completed = record.get("completed");
+		if (completed != NULL && !completed->asBool())
+			continue;
+
+		const JsonValue* config = record.get("config");
+		const JsonValue* metric = record.get("metric");
+		const JsonValue* iterations = record.get("iterations");
+		if (config == NULL || metric == NULL || iterations == NULL) {
+			std::cerr << "WARNING: " << filename << ":" << line_number << ": Ignoring a benchmark record without config, metric, or iterations." << std::endl;
+			continue;
+		}
+
+		std::vector< std::pair<uint32_t, uint32_t> > groups;
+		const JsonValue* group_array = record.get("groups");
+		if (group_array != NULL) {
+			for (size_t g = 0; g < group_array->size(); g++) {
+				const JsonValue& group = group_array->at(g);
+				groups.push_back(std::make_pair(static_cast<uint32_t>(group.get("cpu_node") ? group.get("cpu_node")->asNumber() : 0),
+												static_cast<uint32_t>(group.get("mem_node") ? group.get("mem_node")->asNumber() : 0)));
+			}
+		}
+
+		std::vector<int32_t> cpus;
+		const JsonValue* cpu_array = config->get("cpus");
+		if (cpu_array != NULL) {
+			for (size_t c = 0; c < cpu_array->size(); c++)
+				cpus.push_back(static_cast<int32_t>(cpu_array->at(c).asNumber()));
+		}
+
+		std::vector<std::string> worker_specs;
+		const JsonValue* spec_array = config->get("worker_specs");
+		if (spec_array != NULL) {
+			for (size_t w = 0; w < spec_array->size(); w++) {
+				const JsonValue& spec = spec_array->at(w);
+				worker_specs.push_back(format_worker_spec(spec.get("pattern") ? spec.get("pattern")->asString() : "",
+														  spec.get("rw") ? spec.get("rw")->asString() : "",
+														  static_cast<uint32_t>(spec.get("chunk_bits") ? spec.get("chunk_bits")->asNumber() : 0),
+														  static_cast<int64_t>(spec.get("stride") ? spec.get("stride")->asNumber() : 0),
+														  static_cast<uint32_t>(spec.get("mem_node") ? spec.get("mem_node")->asNumber() : 0),
+														  static_cast<uint64_t>(spec.get("throttle_bytes_per_sec") ? spec.get("throttle_bytes_per_sec")->asNumber() : 0)));
+			}
+		}
+
+		BaselineEntry entry;
+		entry.name = record.get("name") ? record.get("name")->asString() : "";
+		entry.units = metric->get("units") ? metric->get("units")->asString() : "";
+		entry.key = format_key(mode,
+							   bytes_per_pass,
+							   latency_unroll,
+							   record.get("kind") ? record.get("kind")->asString() : "",
+							   static_cast<uint64_t>(config->get("working_set_size_per_thread") ? config->get("working_set_size_per_thread")->asNumber() : 0),
+							   static_cast<uint32_t>(config->get("threads") ? config->get("threads")->asNumber() : 0),
+							   static_cast<uint32_t>(config->get("load_threads") ? config->get("load_threads")->asNumber() : 0),
+							   static_cast<uint32_t>(config->get("cpu_node") ? config->get("cpu_node")->asNumber() : 0),
+							   static_cast<uint32_t>(config->get("mem_node") ? config->get("mem_node")->asNumber() : 0),
+							   static_cast<uint32_t>(config->get("load_cpu_node") ? config->get("load_cpu_node")->asNumber() : (config->get("cpu_node") ? config->get("cpu_node")->asNumber() : 0)), //Results from before load nodes existed kept the load threads with the latency thread
+							   static_cast<uint32_t>(config->get("load_mem_node") ? config->get("load_mem_node")->asNumber() : (config->get("mem_node") ? config->get("mem_node")->asNumber() : 0)),
+							   config->get("pattern") ? config->get("pattern")->asString() : "",
+							   config->get("rw") ? config->get("rw")->asString() : "",
+							   static_cast<uint32_t>(config->get("chunk_bits") ? config->get("chunk_bits")->asNumber() : 0),
+							   static_cast<int64_t>(config->get("stride") ? config->get("stride")->asNumber() : 0),
+							   config->get("sharing") ? config->get("sharing")->asString() : "",
+							   groups,
+							   cpus,
+							   worker_specs);
+		for (size_t i = 0; i < iterations->size(); i++) {
+			const JsonValue& iteration = iterations->at(i);
+			const JsonValue* value = iteration.get("metric");
+			const JsonValue* outlier = iteration.get("outlier");
+			if (value == NULL || value->getType() != JsonValue::JSON_NUMBER)
+				continue;
+			if (outlier != NULL && outlier->asBool())
+				continue;
+			entry.samples.push_back(value->asNumber());
+		}
+		entry.matched = false;
+		__baseline.push_back(entry);
+	}
+
+	__loaded = true;
+	return true;
+}
+
+void BaselineComparison::compare(const BenchmarkResult& result) {
+	if (!__loaded || !result.completed)
+		return;
+
+	ComparisonEntry entry;
+	entry.name = result.name;
+	entry.key = makeKey(result);
+	entry.units = result.metric_units;
+	entry.baseline_mean = 0;
+	entry.current_mean = 0;
+	entry.baseline_samples = 0;
+	entry.current_samples = 0;
+	entry.relative_change = 0;
+	entry.t = 0;
+	entry.t_critical = 0;
+	entry.verdict = COMPARISON_NO_BASELINE;
+
+	std::vector<double> current;
+	for (size_t i = 0; i < result.metric_on_iter.size(); i++)
+		if (i >= result.outlier_on_iter.size() || !result.outlier_on_iter[i])
+			current.push_back(result.metric_on_iter[i]);
+	double current_var = 0;
+	mean_and_variance(current, entry.current_mean, current_var);
+	entry.current_samples = static_cast<uint32_t>(current.size());
+
+	BaselineEntry* baseline = NULL;
+	for (size_t b = 0; b < __baseline.size() && baseline == NULL; b++)
+		if (!__baseline[b].matched && __baseline[b].key == entry.key)
+			baseline = &__baseline[b];
+	if (baseline == NULL) {
+		__entries.push_back(entry);
+		return;
+	}
+	baseline->matched = true;
+
+	double baseline_var = 0;
+	mean_and_variance(baseline->samples, entry.baseline_mean, baseline_var);
+	entry.baseline_samples = static_cast<uint32_t>(baseline->samples.size());
+	if (entry.baseline_mean != 0)
+		entry.relative_change = (entry.current_mean - entry.baseline_mean) / std::fabs(entry.baseline_mean);
+
+	//Welch's t-test does not assume equal variances, which matters when comparing across firmware or kernel changes
+	if (entry.baseline_samples < 2 || entry.current_samples < 2) {
+		entry.verdict = COMPARISON_UNTESTED;
+		__entries.push_back(entry);
+		return;
+	}
+	double vb = baseline_var / entry.baseline_samples;
+	double vc = current_var / entry.current_samples;
+	double se = std::sqrt(vb + vc);
+	bool significant = false;
+	if (se > 0) {
+		entry.t = (entry.current_mean - entry.baseline_mean) / se;
+		double df = (vb + vc) * (vb + vc) / (vb * vb / (entry.baseline_samples - 1) + vc * vc / (entry.current_samples - 1)); //Welch-Satterthwaite
+		uint32_t dof = (df < 1) ? 1 : static_cast<uint32_t>(df); //Rounding down is conservative
+		entry.t_critical = student_t_critical_95(dof);
+		significant = std::fabs(entry.t) > entry.t_critical;
+	} else //Both sides are exactly repeatable
+		significant = (entry.current_mean != entry.baseline_mean);
+
+	if (!significant || std::fabs(entry.relative_change) < __min_relative_change)
+		entry.verdict = COMPARISON_UNCHANGED;
+	else if ((entry.current_mean < entry.baseline_mean) == lower_is_better(entry.units))
+		entry.verdict = COMPARISON_IMPROVED;
+	else
+		entry.verdict = COMPARISON_REGRESSED;
+	__entries.push_back(entry);
+}
+
+void BaselineComparison::report() const {
+	if (!__loaded)
+		return;
+
+	uint32_t counts[5] = { 0, 0, 0, 0, 0 };
+	std::streamsize old_precision = std::cout.precision();
+	std::cout << std::endl << "Comparison with baseline " << __filename << ":" << std::endl;
+	for (size_t i = 0; i < __entries.size(); i++) {
+		const ComparisonEntry& e = __entries[i];
+		counts[e.verdict]++;
+		std::cout << e.name << ": ";
+		switch (e.verdict) {
+			case COMPARISON_NO_BASELINE:
+				std::cout << "no baseline with the same parameters" << std::endl;
+				continue;
+			case COMPARISON_UNCHANGED:
+				std::cout << "unchanged";
+				break;
+			case COMPARISON_IMPROVED:
+				std::cout << "IMPROVED";
+				break;
+			case COMPARISON_REGRESSED:
+				std::cout << "REGRESSED";
+				break;
+			case COMPARISON_UNTESTED:
+				std::cout << "untested (fewer than 2 iterations)";
+				break;
+		}
+		std::cout << std::fixed << std::setprecision(2);
+		std::cout << ", " << e.baseline_mean << " -> " << e.current_mean << " " << e.units;
+		std::cout << " (" << std::showpos << e.relative_change * 100 << std::noshowpos << "%";
+		if (e.verdict != COMPARISON_UNTESTED)
+			std::cout << ", |t| = " << std::fabs(e.t) << " vs. " << e.t_critical;
+		std::cout << ")" << std::endl;
+		std::cout.unsetf(std::ios_base::floatfield);
+		std::cout.precision(old_precision);
+	}
+
+	uint32_t unmatched = 0;
+	for (size_t b = 0; b < __baseline.size(); b++)
+		if (!__baseline[b].matched)
+			unmatched++;
+
+	std::cout << counts[COMPARISON_REGRESSED] << " regressed, " << counts[COMPARISON_IMPROVED] << " improved, " << counts[COMPARISON_UNCHANGED] << " unchanged, " << counts[COMPARISON_UNTESTED] << " untested, " << counts[COMPARISON_NO_BASELINE] << " without a baseline";
+	if (unmatched > 0)
+		std::cout << ", and " << unmatched << " baseline benchmarks were not run";
+	std::cout << "." << std::endl;
+}
+
+uint32_t BaselineComparison::getNumRegressions() const {
+	uint32_t regressions = 0;
+	for (size_t i = 0; i < __entries.size(); i++)
+		if (__entries[i].verdict == COMPARISON_REGRESSED)
+			regressions++;
+	return regressions;
+}
+
+std::string BaselineComparison::makeKey(const BenchmarkResult& result) {
+	std::vector< std::pair<uint32_t, uint32_t> > groups;
+	for (size_t g = 0; g < result.group_cpu_nodes.size() && g < result.group_mem_nodes.size(); g++)
+		groups.push_back(std::make_pair(result.group_cpu_nodes[g], result.group_mem_nodes[g]));
+	std::vector<std::string> worker_specs;
+	for (size_t w = 0; w < result.worker_specs.size(); w++) {
+		const WorkerSpec& spec = result.worker_specs[w];
+		worker_specs.push_back(format_worker_spec(pattern_mode_name(spec.pattern_mode), rw_mode_name(spec.rw_mode), chunk_size_bits(spec.chunk_size), spec.stride_size, spec.mem_node, spec.throttle_bytes_per_sec));
+	}
+	return format_key(g_benchmark_mode == TIME_BASED ? "time" : "size",
+					  g_throughput_bytes_per_pass,
+					  g_latency_unroll_length,
+					  result.kind,
+					  result.working_set_size_per_thread,
+					  result.num_threads,
+					  result.num_load_threads,
+					  result.cpu_node,
+					  result.mem_node,
+					  result.load_cpu_node,
+					  result.load_mem_node,
+					  pattern_mode_name(result.pattern_mode),
+					  rw_mode_name(result.rw_mode),
+					  chunk_size_bits(result.chunk_size),
+					  result.stride_size,
+					  sharing_mode_name(result.sharing_mode),
+					  groups,
+					  result.cpus,
+					  worker_specs);
+}
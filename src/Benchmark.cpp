@@ -32,11 +32,19 @@
 #include <common.h>
 #include <benchmark_kernels.h>
 #include <PowerReader.h>
+#include <PermutationCache.h>
+#include <MemoryWorker.h>
+#include <LoadWorker.h>
+#include <BandwidthTrace.h>
+#include <FrequencyCounter.h>
 
 //Libraries
 #include <cstdint>
 #include <iostream>
+#include <sstream>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 #include <time.h>
 
 using namespace xmem;
@@ -45,12 +53,11 @@ Benchmark::Benchmark(
 		void* mem_array,
 		size_t len,
 		uint32_t iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-#endif
 		uint32_t num_worker_threads,
 		uint32_t mem_node,
 		uint32_t cpu_node,
+		std::vector<int32_t> cpu_ids,
 		pattern_mode_t pattern_mode,
 		rw_mode_t rw_mode,
 		chunk_size_t chunk_size,
@@ -62,27 +69,60 @@ Benchmark::Benchmark(
 		_mem_array(mem_array),
 		_len(len),
 		_iterations(iterations),
-#ifdef USE_SIZE_BASED_BENCHMARKS
+		_max_iterations(iterations),
+		_target_relative_ci(0),
+		_time_budget_sec(0),
+		_reject_noisy(false),
+		_run_start_time(0),
+		_completed_iterations(0),
 		_passes_per_iteration(passes_per_iteration),
-#endif
 		_num_worker_threads(num_worker_threads),
 		_mem_node(mem_node),
 		_cpu_node(cpu_node),
+		_cpu_ids(cpu_ids),
 		_pattern_mode(pattern_mode),
 		_rw_mode(rw_mode),
 		_chunk_size(chunk_size),
 		_stride_size(stride_size),
+		_sharing_mode(SHARING_PRIVATE),
+		_worker_specs(),
 		_dram_power_readers(dram_power_readers),
 		_dram_power_threads(),
 		_metricOnIter(),
 		_averageMetric(0),
+		_medianMetric(0),
+		_minMetric(0),
+		_maxMetric(0),
+		_stddevMetric(0),
+		_ciMetric(0),
+		_outlierOnIter(),
+		_warningOnIter(),
+		_workersOnIter(),
+		_workerMetrics(),
+		_fairnessOnIter(),
+		_minWorkerMetric(0),
+		_maxWorkerMetric(0),
+		_workerFairness(0),
+		_interferenceOnIter(),
+		_interferenceBefore(),
+		_frequencyOnIter(),
+		_averageFrequency(0),
+		_minFrequency(0),
+		_maxFrequency(0),
+		_frequencyVaried(false),
+		_traceOnIter(),
 		_metricUnits(metricUnits),
 		_average_dram_power_socket(),
 		_peak_dram_power_socket(),
+		_dram_power_results(),
 		_name(name),
 		_obj_valid(false),
 		_hasRun(false),
-		_warning(false)
+		_prepared(false),
+		_warning(false),
+		_info_log(NULL),
+		_warning_log(&std::cerr),
+		_error()
 	{
 	
 	for (uint32_t i = 0; i < _iterations; i++) 
@@ -92,27 +132,180 @@ Benchmark::Benchmark(
 Benchmark::~Benchmark() {
 }
 
-bool Benchmark::run() {
-	if (_hasRun) //A benchmark should only be run once per object
+bool Benchmark::run(bool print_info) {
+	if (_hasRun) { //A benchmark should only be run once per object
+		_reportError("Benchmark " + _name + " has already run.");
 		return false;
+	}
+
+	if (print_info) {
+		print_benchmark_header();
+		report_benchmark_info(); 
+	}
 
-	print_benchmark_header();
-	report_benchmark_info(); 
+	_run_start_time = time(NULL);
 
-	//Write to all of the memory region of interest to make sure
-	//pages are resident in physical memory and are not shared
-	forwSequentialWrite_Word64(_mem_array,
-							   reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + _len));
+	//Setup may already have been done in the background, e.g. while a previous benchmark was measuring
+	if (!prepare()) {
+		_reportWarning("Benchmark " + _name + " failed to prepare its working set!");
+		if (_error.empty())
+			_error = "Benchmark " + _name + " failed to prepare its working set.";
+		return false;
+	}
 
 	bool success = _run_core();
 	if (success) {
 		return true;
 	} else {
-		std::cerr << "WARNING: Benchmark " << _name << " failed!" << std::endl;
+		_reportWarning("Benchmark " + _name + " failed!");
+		if (_error.empty())
+			_error = "Benchmark " + _name + " failed.";
 		return false;
 	}
 }
 
+void Benchmark::setReporting(std::ostream* info_log, std::ostream* warning_log) {
+	_info_log = info_log;
+	_warning_log = warning_log;
+}
+
+std::string Benchmark::getError() const {
+	return _error;
+}
+
+void Benchmark::_reportWarning(const std::string& message) const {
+	if (_warning_log != NULL)
+		*_warning_log << "WARNING: " << message << std::endl;
+}
+
+void Benchmark::_reportError(const std::string& message) {
+	if (_error.empty())
+		_error = message;
+	if (_warning_log != NULL)
+		*_warning_log << "ERROR: " << message << std::endl;
+}
+
+bool Benchmark::prepare() {
+	if (_prepared)
+		return true;
+
+	//Make sure pages are resident in physical memory and are not shared. This is skipped if an earlier benchmark already touched the region.
+	g_permutation_cache.touch(_mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + _len));
+
+	//Load workers with regions of their own, on other memory nodes, need theirs made resident too
+	size_t len_per_thread = (_num_worker_threads > 0) ? _len / _num_worker_threads : 0;
+	for (uint32_t w = 0; w < _worker_specs.size(); w++)
+		if (_worker_specs[w].mem_array != NULL)
+			g_permutation_cache.touch(_worker_specs[w].mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_worker_specs[w].mem_array) + len_per_thread));
+
+	_prepared = _prepare_core();
+	return _prepared;
+}
+
+bool Benchmark::_prepare_core() {
+	return true;
+}
+
+void Benchmark::getResult(BenchmarkResult& result) const {
+	result.name = _name;
+	result.kind = "unknown";
+	result.completed = _hasRun;
+	result.warning = _warning;
+
+	result.working_set_size_per_thread = (_num_worker_threads > 0) ? _len / _num_worker_threads : 0;
+	result.num_threads = _num_worker_threads;
+	result.num_load_threads = _num_worker_threads;
+	result.cpu_node = _cpu_node;
+	result.mem_node = _mem_node;
+	result.load_cpu_node = _cpu_node;
+	result.load_mem_node = _mem_node;
+	result.cpus = _cpu_ids;
+	result.pattern_mode = _pattern_mode;
+	result.rw_mode = _rw_mode;
+	result.chunk_size = _chunk_size;
+	result.stride_size = _stride_size;
+	result.sharing_mode = _sharing_mode;
+	result.worker_specs = _worker_specs;
+	result.passes_per_iteration = _passes_per_iteration;
+
+	result.metric_units = _metricUnits;
+	result.metric_on_iter = _metricOnIter;
+	result.outlier_on_iter = _outlierOnIter;
+	result.warning_on_iter = _warningOnIter;
+	result.average_metric = _averageMetric;
+	result.median_metric = _medianMetric;
+	result.min_metric = _minMetric;
+	result.max_metric = _maxMetric;
+	result.stddev_metric = _stddevMetric;
+	result.ci_metric = _ciMetric;
+	result.num_outliers = getNumOutliers();
+
+	result.load_metric_units = "";
+	result.load_metric_on_iter.clear();
+	result.average_load_metric = 0;
+
+	result.group_cpu_nodes.clear();
+	result.group_mem_nodes.clear();
+	result.group_metrics.clear();
+
+	result.interference_on_iter = _interferenceOnIter;
+	result.num_noisy = 0;
+	for (uint32_t i = 0; i < _interferenceOnIter.size(); i++)
+		if (_interferenceOnIter[i].noisy)
+			result.num_noisy++;
+	result.reject_noisy = _reject_noisy;
+
+	result.frequency_on_iter = _frequencyOnIter;
+	result.average_frequency = _averageFrequency;
+	result.min_frequency = _minFrequency;
+	result.max_frequency = _maxFrequency;
+	result.frequency_varied = _frequencyVaried;
+	result.cycles_on_iter.clear();
+	result.average_cycles = 0;
+
+	result.worker_metrics = _workerMetrics;
+	result.fairness_on_iter = _fairnessOnIter;
+	result.min_worker_metric = _minWorkerMetric;
+	result.max_worker_metric = _maxWorkerMetric;
+	result.worker_fairness = _workerFairness;
+
+	result.workers_on_iter = _workersOnIter;
+	result.trace_on_iter = _traceOnIter;
+	result.trace_period_sec = 0;
+	for (uint32_t i = 0; i < _traceOnIter.size(); i++)
+		if (!_traceOnIter[i].empty())
+			result.trace_period_sec = static_cast<double>(g_bandwidth_trace_period_us) / 1e6;
+	result.power = _dram_power_results;
+}
+
+void Benchmark::_recordWorker(uint32_t iter, MemoryWorker* worker, bool latency, double ns_per_tick) {
+	if (iter >= _workersOnIter.size()) {
+		_workersOnIter.resize(iter+1);
+		_warningOnIter.resize(iter+1, false);
+	}
+
+	WorkerResult w;
+	w.cpu = worker->getCPUAffinity();
+	w.latency = latency;
+	w.passes = worker->getPasses();
+	w.bytes_per_pass = worker->getBytesPerPass();
+	w.elapsed_ticks = worker->getElapsedTicks();
+	w.elapsed_dummy_ticks = worker->getElapsedDummyTicks();
+	w.adjusted_ticks = worker->getAdjustedTicks();
+	w.throughput = 0;
+	if (w.adjusted_ticks > 0)
+		w.throughput = ((static_cast<double>(w.passes) * static_cast<double>(w.bytes_per_pass)) / static_cast<double>(MB))   /   ((static_cast<double>(w.adjusted_ticks) * ns_per_tick) / 1e9);
+	w.frequency_ghz = effective_frequency_ghz(worker->getFrequencyRatio(), ns_per_tick);
+	w.involuntary_switches = worker->getInvoluntarySwitches();
+	w.warning = worker->hadWarning();
+	_workersOnIter[iter].push_back(w);
+	std::vector<std::string> messages = worker->getWarningMessages();
+	for (uint32_t i = 0; i < messages.size(); i++)
+		_reportWarning(messages[i]);
+	if (w.warning)
+		_warningOnIter[iter] = true;
+}
+
 void Benchmark::print_benchmark_header() const {
 	//Spit out useful info
 	std::cout << std::endl;
@@ -185,6 +378,13 @@ void Benchmark::report_benchmark_info() const {
 	std::cout << "Number of worker threads: " << _num_worker_threads;
 	std::cout << std::endl;
 
+	std::cout << "Worker CPUs: ";
+	for (uint32_t t = 0; t < _cpu_ids.size(); t++)
+		std::cout << _cpu_ids[t] << " ";
+	std::cout << std::endl;
+	_report_sharing();
+	_report_worker_specs(0);
+
 	std::cout << std::endl;
 }
 
@@ -198,6 +398,10 @@ void Benchmark::report_results() const {
 	if (_hasRun) {
 		for (uint32_t i = 0; i < _iterations; i++) {
 			std::cout << "Iter #" << i + 1 << ": " << _metricOnIter[i] << " " << _metricUnits;
+			if (_outlierOnIter[i])
+				std::cout << " (outlier)";
+			if (i < _interferenceOnIter.size() && _interferenceOnIter[i].noisy)
+				std::cout << " (noisy)";
 			if (_warning)
 				std::cout << " (WARNING)";
 			std::cout << std::endl;
@@ -206,6 +410,11 @@ void Benchmark::report_results() const {
 		if (_warning)
 			std::cout << " (WARNING)";
 		std::cout << std::endl;
+		_report_statistics();
+		_report_interference();
+		_report_frequency();
+		_report_workers();
+		_report_trace();
 		
 		for (uint32_t i = 0; i < _dram_power_readers.size(); i++) {
 			if (_dram_power_readers[i] != NULL) {
@@ -223,6 +432,8 @@ bool Benchmark::isValid() const { return _obj_valid; }
 
 bool Benchmark::hasRun() const { return _hasRun; }
 
+bool Benchmark::isPrepared() const { return _prepared; }
+
 double Benchmark::getMetricOnIter(uint32_t iter) const {
 	if (_hasRun && iter - 1 <= _iterations)
 		return _metricOnIter[iter - 1];
@@ -237,6 +448,75 @@ double Benchmark::getAverageMetric() const {
 		return -1;
 }
 
+double Benchmark::getMedianMetric() const {
+	if (_hasRun)
+		return _medianMetric;
+	else //bad call
+		return -1;
+}
+
+double Benchmark::getMinMetric() const {
+	if (_hasRun)
+		return _minMetric;
+	else //bad call
+		return -1;
+}
+
+double Benchmark::getMaxMetric() const {
+	if (_hasRun)
+		return _maxMetric;
+	else //bad call
+		return -1;
+}
+
+double Benchmark::getStdDevMetric() const {
+	if (_hasRun)
+		return _stddevMetric;
+	else //bad call
+		return -1;
+}
+
+double Benchmark::getConfidenceInterval() const {
+	if (_hasRun)
+		return _ciMetric;
+	else //bad call
+		return -1;
+}
+
+uint32_t Benchmark::getNumOutliers() const {
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < _outlierOnIter.size(); i++)
+		if (_outlierOnIter[i])
+			count++;
+	return count;
+}
+
+void Benchmark::setRejectNoisy(bool reject) {
+	_reject_noisy = reject;
+}
+
+void Benchmark::setSharingMode(sharing_mode_t sharing_mode) {
+	_sharing_mode = sharing_mode;
+}
+
+sharing_mode_t Benchmark::getSharingMode() const {
+	return _sharing_mode;
+}
+
+void Benchmark::setWorkerSpecs(const std::vector<WorkerSpec>& worker_specs) {
+	_worker_specs = worker_specs;
+}
+
+const std::vector<WorkerSpec>& Benchmark::getWorkerSpecs() const {
+	return _worker_specs;
+}
+
+void Benchmark::setAdaptiveIterations(double target_relative_ci, uint32_t max_iterations, uint32_t time_budget_sec) {
+	_target_relative_ci = target_relative_ci;
+	_max_iterations = max_iterations < _iterations ? _iterations : max_iterations;
+	_time_budget_sec = time_budget_sec;
+}
+
 std::string Benchmark::getMetricUnits() const {
 	return _metricUnits;
 }
@@ -263,11 +543,9 @@ uint32_t Benchmark::getIterations() const {
 	return _iterations;
 }
 
-#ifdef USE_SIZE_BASED_BENCHMARKS
 uint64_t Benchmark::getPassesPerIteration() const {
 	return _passes_per_iteration;
 }
-#endif
 
 chunk_size_t Benchmark::getChunkSize() const {
 	return _chunk_size;
@@ -301,6 +579,417 @@ rw_mode_t Benchmark::getRWMode() const {
 	return _rw_mode;
 }
 
+bool Benchmark::_beginIteration(uint32_t iter) {
+	_completed_iterations = iter;
+	if (iter >= _max_iterations)
+		return false;
+
+	if (_target_relative_ci > 0 && iter >= _iterations) { //adaptive mode, minimum iterations done
+		if (_time_budget_sec > 0 && difftime(time(NULL), _run_start_time) >= static_cast<double>(_time_budget_sec)) {
+			if (_info_log != NULL)
+				*_info_log << "Time budget of " << _time_budget_sec << " s reached after " << iter << " iterations." << std::endl;
+			return false;
+		}
+		_computeStatistics(iter);
+		if (_averageMetric != 0 && _ciMetric / std::fabs(_averageMetric) <= _target_relative_ci) {
+			if (_info_log != NULL)
+				*_info_log << "Confidence interval target reached after " << iter << " iterations." << std::endl;
+			return false;
+		}
+	}
+
+	if (iter >= _metricOnIter.size())
+		_metricOnIter.push_back(-1);
+	_warningOnIter.resize(iter+1, false);
+	_workersOnIter.resize(iter+1);
+	_traceOnIter.resize(iter+1);
+	_interferenceOnIter.resize(iter+1, InterferenceResult());
+	return true;
+}
+
+void Benchmark::_finishIterations() {
+	_iterations = _completed_iterations;
+	_metricOnIter.resize(_iterations);
+	_warningOnIter.resize(_iterations, false);
+	_workersOnIter.resize(_iterations);
+	_traceOnIter.resize(_iterations);
+	_interferenceOnIter.resize(_iterations, InterferenceResult());
+	_computeStatistics(_iterations);
+	_computeWorkerFairness();
+	_computeFrequency();
+	if (_target_relative_ci > 0 && (_averageMetric == 0 || _ciMetric / std::fabs(_averageMetric) > _target_relative_ci)) {
+		std::ostringstream message;
+		message << "Benchmark " << _name << " did not reach its confidence interval target after " << _iterations << " iterations.";
+		_reportWarning(message.str());
+	}
+}
+
+void Benchmark::_computeStatistics(uint32_t num_samples) {
+	_outlierOnIter.assign(num_samples, false);
+	if (num_samples == 0) {
+		_averageMetric = _medianMetric = _minMetric = _maxMetric = _stddevMetric = _ciMetric = 0;
+		return;
+	}
+
+	//Iterations with significant interference are rejected up front if so configured, unless that would leave nothing
+	std::vector<uint32_t> candidates;
+	for (uint32_t i = 0; i < num_samples; i++) {
+		if (_reject_noisy && i < _interferenceOnIter.size() && _interferenceOnIter[i].noisy)
+			_outlierOnIter[i] = true;
+		else
+			candidates.push_back(i);
+	}
+	if (candidates.empty()) {
+		_outlierOnIter.assign(num_samples, false);
+		for (uint32_t i = 0; i < num_samples; i++)
+			candidates.push_back(i);
+	}
+	uint32_t num_candidates = static_cast<uint32_t>(candidates.size());
+
+	//Median and median absolute deviation of all samples
+	std::vector<double> sorted;
+	for (uint32_t c = 0; c < num_candidates; c++)
+		sorted.push_back(_metricOnIter[candidates[c]]);
+	std::sort(sorted.begin(), sorted.end());
+	double median = median_of_sorted(sorted);
+	std::vector<double> deviations;
+	for (uint32_t c = 0; c < num_candidates; c++)
+		deviations.push_back(std::fabs(_metricOnIter[candidates[c]] - median));
+	std::sort(deviations.begin(), deviations.end());
+	double mad = median_of_sorted(deviations);
+
+	//Samples more than 3 scaled MADs from the median are outliers. 1.4826 scales the MAD to a standard deviation for normal data.
+	std::vector<double> kept;
+	for (uint32_t c = 0; c < num_candidates; c++) {
+		uint32_t i = candidates[c];
+		if (num_candidates >= 3 && mad > 0 && std::fabs(_metricOnIter[i] - median) > 3 * 1.4826 * mad)
+			_outlierOnIter[i] = true;
+		else
+			kept.push_back(_metricOnIter[i]);
+	}
+	std::sort(kept.begin(), kept.end());
+
+	double sum = 0;
+	for (uint32_t i = 0; i < kept.size(); i++)
+		sum += kept[i];
+	_averageMetric = sum / static_cast<double>(kept.size());
+	_medianMetric = median_of_sorted(kept);
+	_minMetric = kept.front();
+	_maxMetric = kept.back();
+
+	_stddevMetric = 0;
+	_ciMetric = 0;
+	if (kept.size() > 1) {
+		double sum_squares = 0;
+		for (uint32_t i = 0; i < kept.size(); i++)
+			sum_squares += (kept[i] - _averageMetric) * (kept[i] - _averageMetric);
+		_stddevMetric = std::sqrt(sum_squares / static_cast<double>(kept.size() - 1));
+		_ciMetric = student_t_critical_95(static_cast<uint32_t>(kept.size() - 1)) * _stddevMetric / std::sqrt(static_cast<double>(kept.size()));
+	}
+}
+
+void Benchmark::_report_statistics() const {
+	std::cout << "Median: " << _medianMetric << " " << _metricUnits << std::endl;
+	std::cout << "Min: " << _minMetric << " " << _metricUnits << std::endl;
+	std::cout << "Max: " << _maxMetric << " " << _metricUnits << std::endl;
+	std::cout << "Standard deviation: " << _stddevMetric << " " << _metricUnits << std::endl;
+	std::cout << "95% confidence interval: +/-" << _ciMetric << " " << _metricUnits;
+	if (_averageMetric != 0)
+		std::cout << " (+/-" << 100 * _ciMetric / std::fabs(_averageMetric) << "%)";
+	std::cout << std::endl;
+	if (getNumOutliers() > 0)
+		std::cout << "Outlier iterations excluded: " << getNumOutliers() << std::endl;
+}
+
+void Benchmark::_beginInterferenceCheck() {
+	capture_interference(_cpu_ids, _interferenceBefore);
+}
+
+void Benchmark::_endInterferenceCheck(uint32_t iter) {
+	InterferenceSnapshot after;
+	if (!_interferenceBefore.valid || !capture_interference(_cpu_ids, after))
+		return;
+
+	uint64_t involuntary_switches = 0;
+	uint32_t num_workers = 0;
+	if (iter < _workersOnIter.size()) {
+		for (uint32_t w = 0; w < _workersOnIter[iter].size(); w++)
+			involuntary_switches += _workersOnIter[iter][w].involuntary_switches;
+		num_workers = static_cast<uint32_t>(_workersOnIter[iter].size());
+	}
+
+	if (iter >= _interferenceOnIter.size())
+		_interferenceOnIter.resize(iter+1, InterferenceResult());
+	InterferenceResult& result = _interferenceOnIter[iter];
+	if (!interference_between(_interferenceBefore, after, involuntary_switches, num_workers, result) || !result.noisy)
+		return;
+
+	if (_info_log != NULL)
+		*_info_log << "Iter " << iter+1 << " was noisy: " << result.interrupts << " interrupts, " << result.irq_sec + result.softirq_sec << " s in irq/softirq, " << result.steal_sec << " s stolen, " << result.run_delay_sec << " s of run queue delay, " << result.involuntary_switches << " preemptions of workers" << std::endl;
+	if (!_reject_noisy) { //Rejected iterations are excluded from the statistics instead
+		_warningOnIter[iter] = true;
+		_warning = true;
+	}
+}
+
+void Benchmark::_report_interference() const {
+	uint32_t num_noisy = 0;
+	for (uint32_t i = 0; i < _interferenceOnIter.size(); i++)
+		if (_interferenceOnIter[i].noisy)
+			num_noisy++;
+	if (num_noisy == 0)
+		return;
+	std::cout << "Iterations with interference on the measurement CPUs: " << num_noisy;
+	if (_reject_noisy && num_noisy < _metricOnIter.size())
+		std::cout << " (excluded)";
+	else if (_reject_noisy)
+		std::cout << " (WARNING: none excluded, as every iteration was noisy)";
+	else
+		std::cout << " (WARNING)";
+	std::cout << std::endl;
+}
+
+void Benchmark::_computeFrequency() {
+	_frequencyOnIter.assign(_workersOnIter.size(), 0);
+	_averageFrequency = _minFrequency = _maxFrequency = 0;
+	_frequencyVaried = false;
+
+	uint32_t num_known = 0;
+	for (uint32_t i = 0; i < _workersOnIter.size(); i++) {
+		double sum = 0;
+		uint32_t num_workers = 0;
+		for (uint32_t w = 0; w < _workersOnIter[i].size(); w++) {
+			if (_workersOnIter[i][w].frequency_ghz > 0) {
+				sum += _workersOnIter[i][w].frequency_ghz;
+				num_workers++;
+			}
+		}
+		if (num_workers == 0)
+			continue;
+
+		_frequencyOnIter[i] = sum / static_cast<double>(num_workers);
+		if (num_known == 0 || _frequencyOnIter[i] < _minFrequency)
+			_minFrequency = _frequencyOnIter[i];
+		if (num_known == 0 || _frequencyOnIter[i] > _maxFrequency)
+			_maxFrequency = _frequencyOnIter[i];
+		_averageFrequency += _frequencyOnIter[i];
+		num_known++;
+	}
+	if (num_known == 0)
+		return;
+	_averageFrequency /= static_cast<double>(num_known);
+
+	//Results taken at different clocks are not comparable, so flag them like any other questionable measurement
+	if (_maxFrequency - _minFrequency > FREQUENCY_VARIATION_THRESHOLD * _maxFrequency) {
+		_frequencyVaried = true;
+		_warning = true;
+		std::ostringstream message;
+		message << "The effective core frequency of benchmark " << _name << " varied from " << _minFrequency << " to " << _maxFrequency << " GHz across iterations.";
+		_reportWarning(message.str());
+	}
+}
+
+void Benchmark::_report_frequency() const {
+	if (_averageFrequency <= 0)
+		return;
+	std::cout << "Effective core frequency: " << _averageFrequency << " GHz (min " << _minFrequency << ", max " << _maxFrequency << ")";
+	if (_frequencyVaried)
+		std::cout << " (WARNING: varied by more than " << FREQUENCY_VARIATION_THRESHOLD * 100 << "%)";
+	std::cout << std::endl;
+}
+
+void Benchmark::_traceWorker(LoadWorker* worker, uint64_t ticks_per_sec) const {
+	if (worker == NULL || g_bandwidth_trace_period_us == 0 || g_benchmark_mode != TIME_BASED)
+		return;
+	uint64_t period_ticks = ticks_per_sec * g_bandwidth_trace_period_us / 1000000;
+	if (period_ticks == 0)
+		period_ticks = 1;
+	size_t capacity = static_cast<size_t>(static_cast<uint64_t>(g_benchmark_duration_sec) * 1000000 / g_bandwidth_trace_period_us) + 2; //One sample per period, plus the start and the last sample
+	worker->enableTrace(period_ticks, capacity);
+}
+
+void Benchmark::_recordTrace(uint32_t iter, const std::vector<LoadWorker*>& workers, uint64_t ticks_per_sec, double ns_per_tick) {
+	std::vector<const BandwidthTrace*> traces;
+	for (uint32_t w = 0; w < workers.size(); w++) {
+		const BandwidthTrace* trace = workers[w]->getTrace();
+		if (trace == NULL)
+			return;
+		if (trace->wrapped())
+			_reportWarning("A worker's bandwidth trace was full, so its oldest samples were discarded.");
+		traces.push_back(trace);
+	}
+
+	if (iter >= _traceOnIter.size())
+		_traceOnIter.resize(iter+1);
+	uint64_t period_ticks = ticks_per_sec * g_bandwidth_trace_period_us / 1000000;
+	merge_bandwidth_traces(traces, period_ticks > 0 ? period_ticks : 1, ns_per_tick, _traceOnIter[iter]);
+}
+
+void Benchmark::_report_trace() const {
+	double min_metric = 0;
+	double max_metric = 0;
+	size_t num_samples = 0;
+	for (uint32_t i = 0; i < _traceOnIter.size(); i++) {
+		for (uint32_t s = 0; s < _traceOnIter[i].size(); s++) {
+			if (num_samples == 0 || _traceOnIter[i][s] < min_metric)
+				min_metric = _traceOnIter[i][s];
+			if (num_samples == 0 || _traceOnIter[i][s] > max_metric)
+				max_metric = _traceOnIter[i][s];
+			num_samples++;
+		}
+	}
+	if (num_samples == 0)
+		return;
+
+	std::cout << "Bandwidth trace: " << num_samples << " intervals of " << g_bandwidth_trace_period_us << " us, ranging from " << min_metric << " to " << max_metric << " MB/s" << std::endl;
+}
+
+const WorkerSpec* Benchmark::_workerSpec(uint32_t t, uint32_t first_load_worker) const {
+	if (t < first_load_worker || t - first_load_worker >= _worker_specs.size())
+		return NULL;
+	return &_worker_specs[t - first_load_worker];
+}
+
+void* Benchmark::_loadRegion(uint32_t t, uint32_t first_load_worker, void* mem_array, void* shared_slice, size_t len_per_thread, pattern_mode_t& pattern_mode, rw_mode_t& rw_mode, chunk_size_t& chunk_size, int64_t& stride_size) const {
+	const WorkerSpec* spec = _workerSpec(t, first_load_worker);
+	if (spec != NULL) {
+		pattern_mode = spec->pattern_mode;
+		rw_mode = spec->rw_mode;
+		chunk_size = spec->chunk_size;
+		stride_size = spec->stride_size;
+		if (spec->mem_array != NULL)
+			return spec->mem_array;
+		return reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + t * len_per_thread);
+	}
+
+	pattern_mode = _pattern_mode;
+	rw_mode = _rw_mode;
+	chunk_size = _chunk_size;
+	stride_size = _stride_size;
+	switch (_sharing_mode) {
+		case SHARING_READ_SHARED:
+			rw_mode = READ;
+			return shared_slice;
+		case SHARING_ONE_WRITER:
+			rw_mode = (t == first_load_worker) ? WRITE : READ;
+			return shared_slice;
+		case SHARING_FALSE_SHARING: {
+			//Every writer strides over whole lines, starting at its own chunk. Workers beyond the chunks in a line double up.
+			uint32_t chunk_bytes = chunk_size_bits(_chunk_size) / 8;
+			uint32_t lanes = FALSE_SHARING_LINE_SIZE / chunk_bytes;
+			rw_mode = WRITE;
+			stride_size = lanes;
+			return reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(shared_slice) + ((t - first_load_worker) % lanes) * chunk_bytes);
+		}
+		case SHARING_PRIVATE:
+		default:
+			return reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + t * len_per_thread);
+	}
+}
+
+void Benchmark::_report_sharing() const {
+	switch (_sharing_mode) {
+		case SHARING_READ_SHARED:
+			std::cout << "Sharing Mode: all load workers read one shared slice" << std::endl;
+			break;
+		case SHARING_ONE_WRITER:
+			std::cout << "Sharing Mode: one load worker writes a slice that the others read" << std::endl;
+			break;
+		case SHARING_FALSE_SHARING:
+			std::cout << "Sharing Mode: false sharing, load workers write their own chunks of the same " << FALSE_SHARING_LINE_SIZE << "-byte lines" << std::endl;
+			break;
+		case SHARING_PRIVATE:
+		default:
+			break;
+	}
+}
+
+void Benchmark::_report_worker_specs(uint32_t first_load_worker) const {
+	if (_worker_specs.empty())
+		return;
+
+	std::cout << "Load Worker Workloads:" << std::endl;
+	for (uint32_t w = 0; w < _worker_specs.size(); w++) {
+		const WorkerSpec& spec = _worker_specs[w];
+		std::cout << "...thread " << first_load_worker + w << ": " << (spec.rw_mode == WRITE ? "write" : "read") << ", ";
+		if (spec.pattern_mode == SEQUENTIAL) {
+			if (spec.stride_size == 1 || spec.stride_size == -1)
+				std::cout << (spec.stride_size > 0 ? "forward" : "reverse") << " sequential";
+			else
+				std::cout << "strides of " << spec.stride_size << " chunks";
+		} else
+			std::cout << "random";
+		std::cout << ", " << chunk_size_bits(spec.chunk_size) << "-bit chunks, memory node " << spec.mem_node;
+		if (spec.throttle_bytes_per_sec > 0)
+			std::cout << ", limited to " << static_cast<double>(spec.throttle_bytes_per_sec) / static_cast<double>(MB) << " MB/s";
+		std::cout << std::endl;
+	}
+}
+
+void Benchmark::_computeWorkerFairness() {
+	_workerMetrics.clear();
+	_fairnessOnIter.assign(_workersOnIter.size(), 0);
+	uint32_t num_kept = 0;
+	for (uint32_t i = 0; i < _workersOnIter.size(); i++) {
+		std::vector<double> iter_metrics;
+		for (uint32_t w = 0; w < _workersOnIter[i].size(); w++)
+			if (!_workersOnIter[i][w].latency)
+				iter_metrics.push_back(_workersOnIter[i][w].throughput);
+		_fairnessOnIter[i] = jain_fairness_index(iter_metrics);
+
+		//Workers are recorded in the same order every iteration, so position identifies the thread
+		if (i < _outlierOnIter.size() && _outlierOnIter[i])
+			continue;
+		if (_workerMetrics.size() < iter_metrics.size())
+			_workerMetrics.resize(iter_metrics.size(), 0);
+		for (uint32_t t = 0; t < iter_metrics.size(); t++)
+			_workerMetrics[t] += iter_metrics[t];
+		num_kept++;
+	}
+
+	_minWorkerMetric = _maxWorkerMetric = _workerFairness = 0;
+	if (_workerMetrics.empty())
+		return;
+	for (uint32_t t = 0; t < _workerMetrics.size(); t++)
+		_workerMetrics[t] /= static_cast<double>(num_kept);
+	_minWorkerMetric = *std::min_element(_workerMetrics.begin(), _workerMetrics.end());
+	_maxWorkerMetric = *std::max_element(_workerMetrics.begin(), _workerMetrics.end());
+	_workerFairness = jain_fairness_index(_workerMetrics);
+}
+
+void Benchmark::_report_workers() const {
+	if (_workerMetrics.size() < 2)
+		return;
+
+	std::cout << "Per-thread load throughput, excluding outliers:" << std::endl;
+	for (uint32_t t = 0; t < _workerMetrics.size(); t++) {
+		//Find this thread's CPU and count the iterations in which it warned
+		int32_t cpu = -1;
+		uint32_t warnings = 0;
+		for (uint32_t i = 0; i < _workersOnIter.size(); i++) {
+			uint32_t load_index = 0;
+			for (uint32_t w = 0; w < _workersOnIter[i].size(); w++) {
+				if (_workersOnIter[i][w].latency)
+					continue;
+				if (load_index == t) {
+					cpu = _workersOnIter[i][w].cpu;
+					if (_workersOnIter[i][w].warning)
+						warnings++;
+					break;
+				}
+				load_index++;
+			}
+		}
+		std::cout << "...Thread " << t << " on CPU " << cpu << ": " << _workerMetrics[t] << " MB/s";
+		if (_maxWorkerMetric > 0)
+			std::cout << " (" << 100 * _workerMetrics[t] / _maxWorkerMetric << "% of the fastest)";
+		if (warnings > 0)
+			std::cout << " (WARNING in " << warnings << " iterations)";
+		std::cout << std::endl;
+	}
+	std::cout << "Thread fairness: min " << _minWorkerMetric << " MB/s, max " << _maxWorkerMetric << " MB/s, Jain index " << _workerFairness << std::endl;
+}
+
 bool Benchmark::_start_power_threads() {
 	bool success = true;
 
@@ -311,13 +1000,13 @@ bool Benchmark::_start_power_threads() {
 			_dram_power_readers[i]->clear_and_reset(); //clear the state of the reader
 			mythread = new Thread(_dram_power_readers[i]);
 			if (mythread == NULL) {
-				std::cerr << "WARNING: Failed to allocate a DRAM power measurement thread." << std::endl;
+				_reportWarning("Failed to allocate a DRAM power measurement thread.");
 				success = false;
 			}
 			else {
 				_dram_power_threads.push_back(mythread);
 				if (!_dram_power_threads[i]->create_and_start()) { //Create and start the power threads
-					std::cerr << "WARNING: Failed to create and start a DRAM power measurement thread." << std::endl;
+					_reportWarning("Failed to create and start a DRAM power measurement thread.");
 					success = false;
 				}
 			}
@@ -334,7 +1023,7 @@ bool Benchmark::_stop_power_threads() {
 	for (uint32_t i = 0; i < _dram_power_threads.size(); i++) {
 		if (_dram_power_threads[i] != NULL) {
 			if (_dram_power_threads[i]->started() && !_dram_power_readers[i]->stop()) {
-				std::cerr << "WARNING: Failed to indicate end of power measurement to a power measurement object. The corresponding worker thread might not terminate." << std::endl;
+				_reportWarning("Failed to indicate end of power measurement to a power measurement object. The corresponding worker thread might not terminate.");
 				success = false;
 			}
 		}
@@ -344,18 +1033,30 @@ bool Benchmark::_stop_power_threads() {
 	for (uint32_t i = 0; i < _dram_power_threads.size(); i++) {
 		if (_dram_power_threads[i] != NULL) {
 			if (!_dram_power_threads[i]->join()) { 
-				std::cerr << "WARNING: A power measurement thread failed to join! Forcing the thread to stop." << std::endl;
+				_reportWarning("A power measurement thread failed to join! Forcing the thread to stop.");
 				if (!_dram_power_threads[i]->cancel())
-					std::cerr << "WARNING: Failed to force stop a power measurement thread. Its behavior may be unpredictable." << std::endl;
+					_reportWarning("Failed to force stop a power measurement thread. Its behavior may be unpredictable.");
 			}
 		}
 
-		//Collect power data
-		for (uint32_t i = 0; i < _dram_power_readers.size(); i++) {
-			if (_dram_power_readers[i] != NULL) {
-				_average_dram_power_socket.push_back(_dram_power_readers[i]->getAveragePower() * _dram_power_readers[i]->getPowerUnits());
-				_peak_dram_power_socket.push_back(_dram_power_readers[i]->getPeakPower() * _dram_power_readers[i]->getPowerUnits());
-			}
+	}
+
+	//Collect power data
+	for (uint32_t i = 0; i < _dram_power_readers.size(); i++) {
+		if (_dram_power_readers[i] != NULL) {
+			double units = _dram_power_readers[i]->getPowerUnits();
+			_average_dram_power_socket.push_back(_dram_power_readers[i]->getAveragePower() * units);
+			_peak_dram_power_socket.push_back(_dram_power_readers[i]->getPeakPower() * units);
+
+			PowerResult power;
+			power.name = _dram_power_readers[i]->name();
+			power.average_watts = _average_dram_power_socket.back();
+			power.peak_watts = _peak_dram_power_socket.back();
+			power.sampling_period_sec = _dram_power_readers[i]->getSamplingPeriod();
+			std::vector<double> trace = _dram_power_readers[i]->getPowerTrace();
+			for (uint32_t s = 0; s < trace.size(); s++)
+				power.trace_watts.push_back(trace[s] * units);
+			_dram_power_results.push_back(power);
 		}
 	}
 
@@ -31,6 +31,12 @@
 #include <BenchmarkManager.h>
 #include <common.h>
 #include <Configurator.h>
+#include <BenchmarkRunner.h>
+#include <BenchmarkPreparer.h>
+#include <PermutationCache.h>
+#include <LoadWorker.h>
+#include <Thread.h>
+#include <Topology.h>
 
 #ifdef _WIN32
 #include <win/win_common_third_party.h>
@@ -42,7 +48,11 @@
 #include <stdlib.h>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -57,6 +67,21 @@ extern "C" {
 
 using namespace xmem;
 
+/**
+ * @brief Checks whether a plan benchmark touches memory on a NUMA node, either with its working set, the load threads' working set, or a load thread's own region.
+ * @param spec The benchmark specification.
+ * @param node The memory NUMA node.
+ * @returns True if the benchmark uses memory on the node.
+ */
+static bool spec_uses_mem_node(const BenchmarkSpec& spec, uint32_t node) {
+	if (spec.mem_node == node || spec_load_mem_node(spec) == node)
+		return true;
+	for (uint32_t w = 0; w < spec.workers.size(); w++)
+		if (spec.workers[w].mem_node == node)
+			return true;
+	return false;
+}
+
 BenchmarkManager::BenchmarkManager(
 		Configurator &config
 	) :
@@ -68,7 +93,12 @@ BenchmarkManager::BenchmarkManager(
 		__tp_benchmarks(),
 		__lat_benchmarks(),
 		__dram_power_readers(),
+		__benchmark_cpu_nodes(),
+		__tp_cpus(),
+		__lat_cpus(),
 		__results_file(),
+		__json_stream(),
+		__baseline(),
 		__built_benchmarks(false)
 	{
 	//Set up DRAM power measurement
@@ -76,8 +106,8 @@ BenchmarkManager::BenchmarkManager(
 		std::string power_obj_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Socket " << i << " DRAM"))->str();
 		
 #ifdef _WIN32
-		//Put the thread on the last logical CPU in each NUMA node.
-		__dram_power_readers.push_back(new WindowsDRAMPowerReader(cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_nodes - 1), POWER_SAMPLING_PERIOD_SEC, 1, power_obj_name, cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_nodes - 1))); 
+		//Put the thread on the last housekeeping logical CPU in each NUMA node.
+		__dram_power_readers.push_back(new WindowsDRAMPowerReader(cpu_id_in_numa_node(i,g_num_logical_cpus / g_num_nodes - 1), g_power_sampling_period_sec, 1, power_obj_name, housekeeping_cpu_in_numa_node(i))); 
 #endif
 #ifdef __gnu_linux__
 		//TODO: Implement derived PowerReaders for Linux systems.
@@ -85,8 +115,15 @@ BenchmarkManager::BenchmarkManager(
 #endif
 	}
 
-	//Build working memory regions
-	__setupWorkingSets(__config.getWorkingSetSizePerThread());
+	//Pointer permutations are reused within this run, and across runs if index files are enabled
+	g_permutation_cache.setIndexDirectory(__config.getPermutationIndexDir());
+
+	//Build working memory regions. Plan files and antagonist mode allocate their own working sets instead.
+	if (!__config.usePlanFile() && !__config.antagonistMode())
+		__setupWorkingSets(__config.getWorkingSetSizePerThread());
+
+	//Choose the logical CPUs for worker threads
+	__placeWorkers();
 
 	//Open results file
 	if (__config.useOutputFile()) {
@@ -95,9 +132,26 @@ BenchmarkManager::BenchmarkManager(
 			__config.setUseOutputFile(false);
 			std::cerr << "WARNING: Failed to open " << __config.getOutputFilename() << " for writing! No results file will be generated." << std::endl;
 		}
+	}
 
-		//Generate file headers
-		__results_file << "Test Name,Iterations,Working Set Size Per Thread (KB),Total Number of Threads,Number of Load Generating Threads,NUMA Memory Node,NUMA CPU Node,Load Access Pattern,Load Read/Write Mix,Load Chunk Size (bits),Load Stride Size (chunks),Average Load Throughput,Throughput Units,Average Latency,Latency Units,";
+	//Open JSON results stream and describe the run before any benchmark completes
+	if (__config.useJSONFile()) {
+		if (__json_stream.open(__config.getJSONFilename()))
+			__json_stream.writeRunHeader(__config);
+		else
+			std::cerr << "WARNING: Failed to open " << __config.getJSONFilename() << " for writing! No JSON results file will be generated." << std::endl;
+	}
+
+	//Load baseline results to compare against
+	if (__config.useCompareFile()) {
+		__baseline.setThreshold(__config.getCompareThreshold());
+		if (!__baseline.load(__config.getCompareFilename()))
+			std::cerr << "WARNING: Failed to load the baseline. Results will not be compared." << std::endl;
+	}
+
+	//Generate file headers. NUMA matrix mode and aggregate mode write their own, and antagonist mode has no results.
+	if (__config.useOutputFile() && !__config.numaMatrixMode() && !__config.aggregateMode() && !__config.antagonistMode()) {
+		__results_file << "Test Name,Iterations,Working Set Size Per Thread (KB),Total Number of Threads,Number of Load Generating Threads,NUMA Memory Node,NUMA CPU Node,Load Access Pattern,Load Read/Write Mix,Load Chunk Size (bits),Load Stride Size (chunks),Average Load Throughput,Throughput Units,Average Latency,Latency Units," << STATISTICS_CSV_HEADER;
 		for (uint32_t i = 0; i < __dram_power_readers.size(); i++)  {
 			if (__dram_power_readers[i] != NULL) {
 				__results_file << __dram_power_readers[i]->name() << " Average Power (W),";
@@ -122,20 +176,14 @@ BenchmarkManager::~BenchmarkManager() {
 			delete __lat_benchmarks[i];
 	//Free memory arrays
 	for (uint32_t i = 0; i < __mem_arrays.size(); i++)
-		if (__mem_arrays[i] != nullptr) {
-#ifdef _WIN32
-			VirtualFreeEx(GetCurrentProcess(), __mem_arrays[i], 0, MEM_RELEASE);
-#endif
-#ifdef __gnu_linux__
-			if (__config.useLargePages())
-				free_huge_pages(__mem_arrays[i]);
-			else
-				numa_free(__mem_arrays[i], __mem_array_lens[i]); 
-#endif
-		}
+		if (__mem_arrays[i] != nullptr)
+			__freeWorkingSet(__mem_arrays[i], __mem_array_lens[i]);
 	//Close results file
 	if (__results_file.is_open())
 		__results_file.close();
+
+	if (g_verbose)
+		std::cout << "Pointer permutations: " << g_permutation_cache.getNumBuilt() << " built, " << g_permutation_cache.getNumReused() << " reused, " << g_permutation_cache.getNumLoaded() << " loaded from index files." << std::endl;
 }
 
 bool BenchmarkManager::runAll() {
@@ -161,71 +209,7 @@ bool BenchmarkManager::runThroughputBenchmarks() {
 		__tp_benchmarks[i]->run(); 
 		__tp_benchmarks[i]->report_results(); //to console
 		
-		//Write to results file if necessary
-		if (__config.useOutputFile()) {
-			__results_file << __tp_benchmarks[i]->getName() << ",";
-			__results_file << __tp_benchmarks[i]->getIterations() << ",";
-			__results_file << static_cast<uint64_t>(__tp_benchmarks[i]->getLen() / __tp_benchmarks[i]->getNumThreads() / KB) << ",";
-			__results_file << __tp_benchmarks[i]->getNumThreads() << ",";
-			__results_file << __tp_benchmarks[i]->getNumThreads() << ",";
-			__results_file << __tp_benchmarks[i]->getMemNode() << ",";
-			__results_file << __tp_benchmarks[i]->getCPUNode() << ",";
-			pattern_mode_t pattern = __tp_benchmarks[i]->getPatternMode();
-			switch (pattern) {
-				case SEQUENTIAL:
-					__results_file << "SEQUENTIAL" << ",";
-					break;
-				case RANDOM:
-					__results_file << "RANDOM" << ",";
-					break;
-				default:
-					__results_file << "UNKNOWN" << ",";
-					break;
-			}
-
-			rw_mode_t rw_mode = __tp_benchmarks[i]->getRWMode();
-			switch (rw_mode) {
-				case READ:
-					__results_file << "READ" << ",";
-					break;
-				case WRITE:
-					__results_file << "WRITE" << ",";
-					break;
-				default:
-					__results_file << "UNKNOWN" << ",";
-					break;
-			}
-
-			chunk_size_t chunk_size = __tp_benchmarks[i]->getChunkSize();
-			switch (chunk_size) {
-				case CHUNK_32b:
-					__results_file << "32" << ",";
-					break;
-				case CHUNK_64b:
-					__results_file << "64" << ",";
-					break;
-				case CHUNK_128b:
-					__results_file << "128" << ",";
-					break;
-				case CHUNK_256b:
-					__results_file << "256" << ",";
-					break;
-				default:
-					__results_file << "UNKNOWN" << ",";
-					break;
-			}
-
-			__results_file << __tp_benchmarks[i]->getStrideSize() << ",";
-			__results_file << __tp_benchmarks[i]->getAverageMetric() << ",";
-			__results_file << __tp_benchmarks[i]->getMetricUnits() << ",";
-			__results_file << "N/A" << ",";
-			__results_file << "N/A" << ",";
-			for (uint32_t j = 0; j < g_num_physical_packages; j++) {
-				__results_file << __tp_benchmarks[i]->getAverageDRAMPower(j) << ",";
-				__results_file << __tp_benchmarks[i]->getPeakDRAMPower(j) << ",";
-			}
-			__results_file << std::endl;
-		}
+		__writeResults(__tp_benchmarks[i]); //to results files
 	}
 
 	if (g_verbose)
@@ -246,85 +230,734 @@ bool BenchmarkManager::runLatencyBenchmarks() {
 		__lat_benchmarks[i]->run(); 
 		__lat_benchmarks[i]->report_results(); //to console
 		
-		//Write to results file if necessary
-		if (__config.useOutputFile()) {
-			__results_file << __lat_benchmarks[i]->getName() << ",";
-			__results_file << __lat_benchmarks[i]->getIterations() << ",";
-			__results_file << static_cast<uint64_t>(__lat_benchmarks[i]->getLen() / __lat_benchmarks[i]->getNumThreads() / KB) << ",";
-			__results_file << __lat_benchmarks[i]->getNumThreads() << ",";
-			__results_file << __lat_benchmarks[i]->getNumThreads()-1 << ",";
-			__results_file << __lat_benchmarks[i]->getMemNode() << ",";
-			__results_file << __lat_benchmarks[i]->getCPUNode() << ",";
-			if (__lat_benchmarks[i]->getNumThreads() < 2) {
-				__results_file << "N/A" << ",";
-				__results_file << "N/A" << ",";
-				__results_file << "N/A" << ",";
-				__results_file << "N/A" << ",";
-			} else {
-				pattern_mode_t pattern = __lat_benchmarks[i]->getPatternMode();
-				switch (pattern) {
-					case SEQUENTIAL:
-						__results_file << "SEQUENTIAL" << ",";
-						break;
-					case RANDOM:
-						__results_file << "RANDOM" << ",";
-						break;
-					default:
-						__results_file << "UNKNOWN" << ",";
-						break;
-				}
+		__writeResults(__lat_benchmarks[i]); //to results files
+	}
 
-				rw_mode_t rw_mode = __lat_benchmarks[i]->getRWMode();
-				switch (rw_mode) {
-					case READ:
-						__results_file << "READ" << ",";
-						break;
-					case WRITE:
-						__results_file << "WRITE" << ",";
-						break;
-					default:
-						__results_file << "UNKNOWN" << ",";
-						break;
+	if (g_verbose)
+		std::cout << std::endl << "Done running latency benchmarks." << std::endl;
+
+	return true;
+}
+
+bool BenchmarkManager::runPlanBenchmarks() {
+	const BenchmarkPlan& plan = __config.getPlan();
+	bool success = true;
+
+	//Benchmarks are generated one at a time. At most two working sets are resident: the one being measured, and the next one if it is being prepared in the background.
+	Benchmark* benchmark = NULL;
+	void* mem_array = nullptr;
+	size_t len = 0;
+	std::vector<void*> worker_arrays;
+	std::vector<size_t> worker_lens;
+	std::vector<int32_t> worker_cpus;
+	Benchmark* next_benchmark = NULL;
+	void* next_mem_array = nullptr;
+	size_t next_len = 0;
+	std::vector<void*> next_worker_arrays;
+	std::vector<size_t> next_worker_lens;
+	std::vector<int32_t> next_worker_cpus;
+
+	for (size_t i = 0; i < plan.getNumSpecs(); i++) {
+		const BenchmarkSpec& spec = plan.getSpec(i);
+
+		if (next_benchmark != NULL) { //Built and prepared while the previous benchmark was measuring
+			benchmark = next_benchmark;
+			mem_array = next_mem_array;
+			len = next_len;
+			worker_arrays = next_worker_arrays;
+			worker_lens = next_worker_lens;
+			worker_cpus = next_worker_cpus;
+			next_benchmark = NULL;
+		} else {
+			benchmark = __buildPlanBenchmark(spec, mem_array, len, worker_arrays, worker_lens, worker_cpus);
+			if (benchmark == NULL) {
+				std::cerr << "ERROR: Failed to allocate the working set for the benchmark at " << plan.getFilename() << ":" << spec.line << ". Skipping it." << std::endl;
+				success = false;
+				continue;
+			}
+		}
+
+		//Prepare the next benchmark in the background, if the overlap policy allows it
+		BenchmarkPreparer* preparer = NULL;
+		Thread* prep_thread = NULL;
+		if (i+1 < plan.getNumSpecs()) {
+			const BenchmarkSpec& next_spec = plan.getSpec(i+1);
+			int32_t prep_cpu = __choosePrepCPU(spec, worker_cpus, next_spec);
+			if (prep_cpu >= 0)
+				next_benchmark = __buildPlanBenchmark(next_spec, next_mem_array, next_len, next_worker_arrays, next_worker_lens, next_worker_cpus);
+			if (next_benchmark != NULL) {
+				if (g_verbose)
+					std::cout << "Preparing the next benchmark on logical CPU " << prep_cpu << " while this one runs." << std::endl;
+				preparer = new BenchmarkPreparer(next_benchmark, prep_cpu);
+				prep_thread = new Thread(preparer);
+				if (!prep_thread->create_and_start()) { //Fall back to preparing it when it runs
+					delete prep_thread;
+					prep_thread = NULL;
 				}
+			}
+		}
+
+		success = benchmark->run() && success;
+		benchmark->report_results(); //to console
+		__writeResults(benchmark); //to results files
+		delete benchmark;
+		__freeWorkingSet(mem_array, len);
+		for (uint32_t w = 0; w < worker_arrays.size(); w++)
+			__freeWorkingSet(worker_arrays[w], worker_lens[w]);
 
-				chunk_size_t chunk_size = __lat_benchmarks[i]->getChunkSize();
-				switch (chunk_size) {
-					case CHUNK_32b:
-						__results_file << "32" << ",";
-						break;
-					case CHUNK_64b:
-						__results_file << "64" << ",";
-						break;
-					case CHUNK_128b:
-						__results_file << "128" << ",";
-						break;
-					case CHUNK_256b:
-						__results_file << "256" << ",";
-						break;
-					default:
-						__results_file << "UNKNOWN" << ",";
-						break;
+		if (prep_thread != NULL) {
+			prep_thread->join();
+			if (!preparer->succeeded())
+				std::cerr << "WARNING: Background preparation of the next benchmark failed. It will be prepared again before it runs." << std::endl;
+			delete prep_thread;
+		}
+		if (preparer != NULL)
+			delete preparer;
+	}
+
+	if (g_verbose)
+		std::cout << std::endl << "Done running the benchmark plan." << std::endl;
+
+	return success;
+}
+
+Benchmark* BenchmarkManager::__buildPlanBenchmark(const BenchmarkSpec& spec, void*& mem_array, size_t& len, std::vector<void*>& worker_arrays, std::vector<size_t>& worker_lens, std::vector<int32_t>& worker_cpus) {
+	worker_arrays.clear();
+	worker_lens.clear();
+	len = spec.num_worker_threads * spec.working_set_size_per_thread;
+	mem_array = __allocateWorkingSet(spec.mem_node, len);
+	if (mem_array == nullptr)
+		return NULL;
+
+	//Load threads of a latency benchmark on another memory node get a working set of their own there
+	uint32_t load_mem_node = spec_load_mem_node(spec);
+	void* load_mem_array = mem_array;
+	if (load_mem_node != spec.mem_node) {
+		load_mem_array = __allocateWorkingSet(load_mem_node, len);
+		if (load_mem_array == nullptr) {
+			__freeWorkingSet(mem_array, len);
+			return NULL;
+		}
+		worker_arrays.push_back(load_mem_array);
+		worker_lens.push_back(len);
+	}
+
+	//Load threads on other memory nodes get one region each from a working set allocated on their node
+	std::vector<WorkerSpec> workers = spec.workers;
+	for (uint32_t node = 0; node < g_num_nodes; node++) {
+		if (node == load_mem_node)
+			continue;
+		uint32_t num_on_node = 0;
+		for (uint32_t w = 0; w < workers.size(); w++)
+			if (workers[w].mem_node == node)
+				num_on_node++;
+		if (num_on_node == 0)
+			continue;
+
+		size_t node_len = num_on_node * spec.working_set_size_per_thread;
+		void* node_array = __allocateWorkingSet(node, node_len);
+		if (node_array == nullptr) {
+			__freeWorkingSet(mem_array, len);
+			for (uint32_t i = 0; i < worker_arrays.size(); i++)
+				__freeWorkingSet(worker_arrays[i], worker_lens[i]);
+			worker_arrays.clear();
+			worker_lens.clear();
+			return NULL;
+		}
+		worker_arrays.push_back(node_array);
+		worker_lens.push_back(node_len);
+
+		uint32_t region = 0;
+		for (uint32_t w = 0; w < workers.size(); w++)
+			if (workers[w].mem_node == node)
+				workers[w].mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(node_array) + (region++) * spec.working_set_size_per_thread);
+	}
+
+	std::vector<int32_t> tp_cpus;
+	std::vector<int32_t> lat_cpus;
+	choose_worker_cpus(spec.cpu_node, spec.num_worker_threads, spec.cpus, spec.placement, spec.latency_cpu, tp_cpus, lat_cpus);
+	if (spec_load_cpu_node(spec) != spec.cpu_node)
+		choose_split_latency_cpus(spec.cpu_node, spec_load_cpu_node(spec), spec.num_worker_threads, spec.placement, spec.latency_cpu, lat_cpus);
+
+	int64_t stride = (spec.pattern_mode == SEQUENTIAL) ? spec.stride_size : 0;
+	std::ostringstream benchmark_name;
+	Benchmark* benchmark = NULL;
+	if (!spec.latency) {
+		benchmark_name << "Test #" << g_test_index++ << "T (" << (spec.label.empty() ? "Throughput" : spec.label) << ")";
+		//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
+		size_t passes_per_iteration = compute_number_of_passes(spec.working_set_size_per_thread / KB);
+		benchmark = new ThroughputBenchmark(mem_array,
+											len,
+											spec.iterations,
+											passes_per_iteration,
+											spec.num_worker_threads,
+											spec.mem_node,
+											spec.cpu_node,
+											tp_cpus,
+											spec.pattern_mode,
+											spec.rw_mode,
+											spec.chunk_size,
+											stride,
+											__dram_power_readers,
+											benchmark_name.str());
+		worker_cpus = tp_cpus;
+	} else {
+		benchmark_name << "Test #" << g_test_index++ << "L (" << (spec.label.empty() ? "Latency" : spec.label) << ")";
+		//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
+		size_t passes_per_iteration = compute_number_of_passes(spec.working_set_size_per_thread / KB) / 4;
+		LatencyBenchmark* latency_benchmark = new LatencyBenchmark(mem_array,
+																   len,
+																   spec.iterations,
+																   passes_per_iteration,
+																   spec.num_worker_threads,
+																   spec.mem_node,
+																   spec.cpu_node,
+																   lat_cpus,
+																   spec.pattern_mode,
+																   spec.rw_mode,
+																   spec.chunk_size,
+																   stride,
+																   __dram_power_readers,
+																   benchmark_name.str());
+		latency_benchmark->setLoadNodes(spec_load_cpu_node(spec), load_mem_node, load_mem_array);
+		benchmark = latency_benchmark;
+		worker_cpus = lat_cpus;
+	}
+
+	benchmark->setSharingMode(spec.sharing_mode);
+	benchmark->setWorkerSpecs(workers);
+	__applyRunSettings(benchmark);
+	return benchmark;
+}
+
+int32_t BenchmarkManager::__choosePrepCPU(const BenchmarkSpec& measured, const std::vector<int32_t>& measured_cpus, const BenchmarkSpec& next) const {
+	prep_overlap_t overlap = __config.getPrepOverlap();
+	if (overlap == PREP_OVERLAP_OFF)
+		return -1;
+
+	//First-touching memory on a node being measured would steal its bandwidth
+	if (overlap == PREP_OVERLAP_ISOLATED) {
+		for (uint32_t node = 0; node < g_num_nodes; node++)
+			if (spec_uses_mem_node(next, node) && spec_uses_mem_node(measured, node))
+				return -1;
+	}
+
+	//Physical cores running measured threads. In the second pass, their SMT siblings are allowed too.
+	std::vector<int64_t> measured_cores;
+	for (uint32_t i = 0; i < measured_cpus.size(); i++)
+		if (measured_cpus[i] >= 0)
+			measured_cores.push_back(g_topology.getCoreOfCPU(static_cast<uint32_t>(measured_cpus[i])));
+
+	uint32_t num_passes = (overlap == PREP_OVERLAP_ANY) ? 2 : 1;
+	for (uint32_t pass = 0; pass < num_passes; pass++) {
+		for (uint32_t node = 0; node < g_num_nodes; node++) {
+			if (overlap == PREP_OVERLAP_ISOLATED && (node == measured.cpu_node || node == spec_load_cpu_node(measured) || spec_uses_mem_node(measured, node)))
+				continue;
+			if (__config.useLargePages() && node != next.mem_node) //Large pages land on the node that first touches them
+				continue;
+
+			const std::vector<uint32_t>& cpus = g_topology.getCPUsInNode(node);
+			for (uint32_t c = 0; c < cpus.size(); c++) {
+				int32_t cpu = static_cast<int32_t>(cpus[c]);
+				if (std::find(measured_cpus.begin(), measured_cpus.end(), cpu) != measured_cpus.end())
+					continue;
+				if (g_topology.isCPUIsolated(cpus[c])) //Reserved for measurement
+					continue;
+				if (pass == 0 && std::find(measured_cores.begin(), measured_cores.end(), g_topology.getCoreOfCPU(cpus[c])) != measured_cores.end())
+					continue;
+				return cpu;
+			}
+		}
+	}
+
+	return -1;
+}
+
+bool BenchmarkManager::runMatrixBenchmarks() {
+	//The matrix characterizes a single kernel, so use the first selected option of each kind.
+	std::vector<chunk_size_t> chunks;
+	std::vector<rw_mode_t> rws;
+	std::vector<int64_t> strides;
+	__getKernelOptions(chunks, rws, strides);
+
+	pattern_mode_t pattern = __config.useSequentialAccessPattern() ? SEQUENTIAL : RANDOM;
+	rw_mode_t rw = rws.empty() ? READ : rws[0];
+	chunk_size_t chunk = chunks.empty() ? CHUNK_64b : chunks[0];
+	int64_t stride = (pattern == SEQUENTIAL && !strides.empty()) ? strides[0] : 0;
+
+	uint32_t num_nodes = __benchmark_num_numa_nodes;
+	std::vector< std::vector<ThroughputBenchmark*> > tp_cells(num_nodes, std::vector<ThroughputBenchmark*>(num_nodes, NULL));
+	std::vector< std::vector<LatencyBenchmark*> > lat_cells(num_nodes, std::vector<LatencyBenchmark*>(num_nodes, NULL));
+	std::vector<PowerReader*> no_power_readers; //Cells run concurrently, so no single cell can own the DRAM power readers.
+	std::string benchmark_name;
+
+	if (g_verbose)  {
+		std::cout << std::endl;
+		std::cout << "Generating NUMA matrix benchmarks." << std::endl;
+	}
+
+	//Build one cell per (CPU node, memory node) pair
+	for (uint32_t mem_node = 0; mem_node < num_nodes; mem_node++) {
+		void* mem_array = __mem_arrays[mem_node];
+		size_t mem_array_len = __mem_array_lens[mem_node];
+		if (mem_array == nullptr) //node has no memory
+			continue;
+
+		for (uint32_t cpu_node = 0; cpu_node < num_nodes; cpu_node++) {
+			if (!g_topology.nodeHasCPUs(cpu_node)) //memory-only node
+				continue;
+
+			if (__config.throughputTestSelected()) {
+				std::ostringstream tp_name;
+				tp_name << "Test #" << g_test_index << "T (Throughput)";
+				//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
+				size_t passes_per_iteration = compute_number_of_passes((mem_array_len / __config.getNumWorkerThreads()) / KB);
+				tp_cells[cpu_node][mem_node] = new ThroughputBenchmark(mem_array,
+																	   mem_array_len,
+																	   __config.getIterationsPerTest(),
+																	   passes_per_iteration,
+																	   __config.getNumWorkerThreads(),
+																	   mem_node,
+																	   cpu_node,
+																	   __tp_cpus[cpu_node],
+																	   pattern,
+																	   rw,
+																	   chunk,
+																	   stride,
+																	   no_power_readers,
+																	   tp_name.str());
+				__applyRunSettings(tp_cells[cpu_node][mem_node]);
+			}
+
+			if (__config.latencyTestSelected()) {
+				//Latency cells are unloaded: a single thread chasing pointers through one thread's worth of memory.
+				std::ostringstream lat_name;
+				lat_name << "Test #" << g_test_index << "L (Latency)";
+				size_t lat_passes_per_iteration = compute_number_of_passes(__config.getWorkingSetSizePerThread() / KB) / 4;
+				lat_cells[cpu_node][mem_node] = new LatencyBenchmark(mem_array,
+																	 __config.getWorkingSetSizePerThread(),
+																	 __config.getIterationsPerTest(),
+																	 lat_passes_per_iteration,
+																	 1,
+																	 mem_node,
+																	 cpu_node,
+																	 std::vector<int32_t>(1, __lat_cpus[cpu_node][0]),
+																	 pattern,
+																	 rw,
+																	 chunk,
+																	 stride,
+																	 no_power_readers,
+																	 lat_name.str());
+				__applyRunSettings(lat_cells[cpu_node][mem_node]);
+			}
+			g_test_index++;
+		}
+	}
+
+	//The local cells on the diagonal run at the same time, since each keeps its traffic within its own node's cores and memory controller.
+	//A remote cell loads the interconnect and another node's memory controller, which any other remote cell running with it could share, so remote cells run one at a time.
+	bool success = true;
+	std::vector<Benchmark*> tp_local;
+	std::vector<Benchmark*> lat_local;
+	for (uint32_t node = 0; node < num_nodes; node++) {
+		if (tp_cells[node][node] != NULL)
+			tp_local.push_back(tp_cells[node][node]);
+		if (lat_cells[node][node] != NULL)
+			lat_local.push_back(lat_cells[node][node]);
+	}
+	if (!__runConcurrently(tp_local))
+		success = false;
+	if (!__runConcurrently(lat_local))
+		success = false;
+
+	for (uint32_t cpu_node = 0; cpu_node < num_nodes; cpu_node++) {
+		for (uint32_t mem_node = 0; mem_node < num_nodes; mem_node++) {
+			if (cpu_node == mem_node)
+				continue;
+			if (tp_cells[cpu_node][mem_node] != NULL && !__runConcurrently(std::vector<Benchmark*>(1, tp_cells[cpu_node][mem_node])))
+				success = false;
+			if (lat_cells[cpu_node][mem_node] != NULL && !__runConcurrently(std::vector<Benchmark*>(1, lat_cells[cpu_node][mem_node])))
+				success = false;
+		}
+	}
+
+	//Collect the results
+	std::vector< std::vector<double> > tp_matrix(num_nodes, std::vector<double>(num_nodes, -1));
+	std::vector< std::vector<double> > lat_matrix(num_nodes, std::vector<double>(num_nodes, -1));
+	std::vector< std::vector<double> > distance_matrix(num_nodes, std::vector<double>(num_nodes, -1));
+	for (uint32_t cpu_node = 0; cpu_node < num_nodes; cpu_node++) {
+		for (uint32_t mem_node = 0; mem_node < num_nodes; mem_node++) {
+			if (tp_cells[cpu_node][mem_node] != NULL)
+				tp_matrix[cpu_node][mem_node] = tp_cells[cpu_node][mem_node]->getAverageMetric();
+			if (lat_cells[cpu_node][mem_node] != NULL)
+				lat_matrix[cpu_node][mem_node] = lat_cells[cpu_node][mem_node]->getAverageMetric();
+			distance_matrix[cpu_node][mem_node] = numa_node_distance(cpu_node, mem_node);
+		}
+	}
+
+	if (__config.latencyTestSelected())
+		__reportMatrix("Unloaded Latency Matrix (ns/access, -1 if the CPU node has no CPUs or the memory node has no memory)", lat_matrix);
+	if (__config.throughputTestSelected())
+		__reportMatrix("Bandwidth Matrix (MB/s, -1 if the CPU node has no CPUs or the memory node has no memory)", tp_matrix);
+	__reportMatrix("NUMA Node Distance Matrix (reported by OS, -1 if unknown)", distance_matrix);
+
+	//Free the cells
+	for (uint32_t cpu_node = 0; cpu_node < num_nodes; cpu_node++) {
+		for (uint32_t mem_node = 0; mem_node < num_nodes; mem_node++) {
+			if (tp_cells[cpu_node][mem_node] != NULL)
+				delete tp_cells[cpu_node][mem_node];
+			if (lat_cells[cpu_node][mem_node] != NULL)
+				delete lat_cells[cpu_node][mem_node];
+		}
+	}
+
+	if (g_verbose)
+		std::cout << std::endl << "Done running NUMA matrix benchmarks." << std::endl;
+
+	return success;
+}
+
+bool BenchmarkManager::runAggregateBenchmarks() {
+	std::vector<chunk_size_t> chunks;
+	std::vector<rw_mode_t> rws;
+	std::vector<int64_t> strides;
+	__getKernelOptions(chunks, rws, strides);
+
+	//The worker group on CPU node c loads memory node (c + offset) mod N
+	uint32_t num_nodes = __benchmark_num_numa_nodes;
+	std::vector<void*> group_mem_arrays;
+	std::vector<size_t> group_lens;
+	std::vector<uint32_t> group_mem_nodes;
+	std::vector<uint32_t> group_cpu_nodes;
+	std::vector<int32_t> group_cpu_ids;
+	for (uint32_t cpu_node = 0; cpu_node < num_nodes; cpu_node++) {
+		uint32_t mem_node = (cpu_node + __config.getRemoteOffset()) % num_nodes;
+		if (!g_topology.nodeHasCPUs(cpu_node)) //memory-only nodes get no worker group
+			continue;
+		if (__mem_arrays[mem_node] == nullptr) {
+			std::cerr << "WARNING: Skipping the worker group on CPU node " << cpu_node << " because its target memory node " << mem_node << " has no memory." << std::endl;
+			continue;
+		}
+		group_mem_arrays.push_back(__mem_arrays[mem_node]);
+		group_lens.push_back(__mem_array_lens[mem_node]);
+		group_mem_nodes.push_back(mem_node);
+		group_cpu_nodes.push_back(cpu_node);
+		group_cpu_ids.insert(group_cpu_ids.end(), __tp_cpus[cpu_node].begin(), __tp_cpus[cpu_node].end());
+	}
+	if (group_cpu_nodes.empty()) {
+		std::cerr << "ERROR: No NUMA node has both CPUs and a target memory node with memory. Nothing to run in aggregate mode." << std::endl;
+		return false;
+	}
+
+	//Enumerate the kernels to run
+	std::vector<pattern_mode_t> kernel_patterns;
+	std::vector<rw_mode_t> kernel_rws;
+	std::vector<chunk_size_t> kernel_chunks;
+	std::vector<int64_t> kernel_strides;
+	for (uint32_t rw_index = 0; rw_index < rws.size(); rw_index++) {
+		for (uint32_t chunk_index = 0; chunk_index < chunks.size(); chunk_index++) {
+			if (__config.useSequentialAccessPattern()) {
+				for (uint32_t stride_index = 0; stride_index < strides.size(); stride_index++) {
+					kernel_patterns.push_back(SEQUENTIAL);
+					kernel_rws.push_back(rws[rw_index]);
+					kernel_chunks.push_back(chunks[chunk_index]);
+					kernel_strides.push_back(strides[stride_index]);
 				}
-			
-				__results_file << __lat_benchmarks[i]->getStrideSize() << ",";
 			}
+			if (__config.useRandomAccessPattern()) {
+				kernel_patterns.push_back(RANDOM);
+				kernel_rws.push_back(rws[rw_index]);
+				kernel_chunks.push_back(chunks[chunk_index]);
+				kernel_strides.push_back(0);
+			}
+		}
+	}
 
-			__results_file << __lat_benchmarks[i]->getAvgLoadMetric() << ",";
-			__results_file << "MB/s" << ",";
-			__results_file << __lat_benchmarks[i]->getAverageMetric() << ",";
-			__results_file << __lat_benchmarks[i]->getMetricUnits() << ",";
-			for (uint32_t j = 0; j < g_num_physical_packages; j++) {
-				__results_file << __tp_benchmarks[i]->getAverageDRAMPower(j) << ",";
-				__results_file << __tp_benchmarks[i]->getPeakDRAMPower(j) << ",";
+	//Generate file headers
+	if (__config.useOutputFile()) {
+		__results_file << "Test Name,Iterations,Working Set Size Per Thread (KB),Number of Load Generating Threads Per Node,Memory Node Offset,Load Access Pattern,Load Read/Write Mix,Load Chunk Size (bits),Load Stride Size (chunks),Total Throughput,Throughput Units," << STATISTICS_CSV_HEADER;
+		for (uint32_t g = 0; g < group_cpu_nodes.size(); g++)
+			__results_file << "CPU Node " << group_cpu_nodes[g] << " -> Memory Node " << group_mem_nodes[g] << " Throughput,";
+		for (uint32_t i = 0; i < __dram_power_readers.size(); i++)  {
+			if (__dram_power_readers[i] != NULL) {
+				__results_file << __dram_power_readers[i]->name() << " Average Power (W),";
+				__results_file << __dram_power_readers[i]->name() << " Peak Power (W),";
+			} else {
+				__results_file << "NAME? Average Power (W),";
+				__results_file << "NAME? Peak Power (W),";
 			}
-			__results_file << std::endl;
 		}
+		__results_file << std::endl;
+	}
+
+	bool success = true;
+	for (uint32_t k = 0; k < kernel_patterns.size(); k++) {
+		std::ostringstream benchmark_name;
+		benchmark_name << "Test #" << g_test_index++ << "A (Aggregate Throughput)";
+		//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
+		size_t passes_per_iteration = compute_number_of_passes(__config.getWorkingSetSizePerThread() / KB);
+		AggregateThroughputBenchmark* benchmark = new AggregateThroughputBenchmark(group_mem_arrays,
+																				   group_lens,
+																				   __config.getIterationsPerTest(),
+																				   passes_per_iteration,
+																				   __config.getNumWorkerThreads(),
+																				   group_mem_nodes,
+																				   group_cpu_nodes,
+																				   group_cpu_ids,
+																				   kernel_patterns[k],
+																				   kernel_rws[k],
+																				   kernel_chunks[k],
+																				   kernel_strides[k],
+																				   __dram_power_readers,
+																				   benchmark_name.str());
+		__applyRunSettings(benchmark);
+		if (!benchmark->run())
+			success = false;
+		benchmark->report_results(); //to console
+
+		__writeResults(benchmark); //to results files
+
+		delete benchmark;
 	}
 
 	if (g_verbose)
-		std::cout << std::endl << "Done running latency benchmarks." << std::endl;
+		std::cout << std::endl << "Done running aggregate throughput benchmarks." << std::endl;
 
-	return true;
+	return success;
+}
+
+bool BenchmarkManager::runAntagonist() {
+	uint32_t num_threads = __config.getNumWorkerThreads();
+	uint32_t cpu_node = __config.getAntagonistCPUNode();
+	uint32_t mem_node = __config.getAntagonistMemNode();
+	size_t len_per_thread = __config.getWorkingSetSizePerThread();
+	size_t len = num_threads * len_per_thread;
+
+	//The load runs a single kernel, so take the first configured one
+	std::vector<chunk_size_t> chunks;
+	std::vector<rw_mode_t> rws;
+	std::vector<int64_t> strides;
+	__getKernelOptions(chunks, rws, strides);
+	pattern_mode_t pattern_mode = __config.useSequentialAccessPattern() ? SEQUENTIAL : RANDOM;
+	if (chunks.size() > 1 || rws.size() > 1 || strides.size() > 1 || (__config.useSequentialAccessPattern() && __config.useRandomAccessPattern()))
+		std::cerr << "WARNING: Antagonist mode runs a single kernel. Using the first of the selected ones." << std::endl;
+
+	SequentialFunction kernel_fptr_seq = NULL;
+	SequentialFunction kernel_dummy_fptr_seq = NULL;
+	RandomFunction kernel_fptr_ran = NULL;
+	RandomFunction kernel_dummy_fptr_ran = NULL;
+	if ((pattern_mode == SEQUENTIAL && !determineSequentialKernel(rws[0], chunks[0], strides[0], &kernel_fptr_seq, &kernel_dummy_fptr_seq))
+		|| (pattern_mode == RANDOM && !determineRandomKernel(rws[0], chunks[0], &kernel_fptr_ran, &kernel_dummy_fptr_ran))) {
+		std::cerr << "ERROR: Failed to find appropriate benchmark kernel." << std::endl;
+		return false;
+	}
+
+	void* mem_array = __allocateWorkingSet(mem_node, len);
+	if (mem_array == nullptr) {
+		std::cerr << "ERROR: Failed to allocate the antagonist working set on NUMA node " << mem_node << std::endl;
+		return false;
+	}
+
+	//Make sure pages are resident, and build pointer indices that keep each thread within its own region
+	g_permutation_cache.touch(mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + len));
+	if (pattern_mode == RANDOM) {
+		for (uint32_t t = 0; t < num_threads; t++) {
+			if (!g_permutation_cache.preparePermutation(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + t*len_per_thread), //casts to silence compiler warnings
+														reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + (t+1)*len_per_thread), //casts to silence compiler warnings
+														chunks[0],
+														g_permutation_seed,
+														g_verbose ? &std::cout : NULL,
+														&std::cerr)) {
+				std::cerr << "ERROR: Failed to build a random pointer permutation for a worker thread!" << std::endl;
+				__freeWorkingSet(mem_array, len);
+				return false;
+			}
+		}
+	}
+
+	//The workers run until told to stop, and the throttle is shared evenly among them
+	double target_rate = __config.getAntagonistRate() * MB;
+	WorkerGroupSync group_sync(num_threads);
+	std::vector<LoadWorker*> workers;
+	std::vector<Thread*> worker_threads;
+	for (uint32_t t = 0; t < num_threads; t++) {
+		void* thread_mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + t * len_per_thread);
+		int32_t cpu_id = t < __tp_cpus[cpu_node].size() ? __tp_cpus[cpu_node][t] : -1;
+		if (cpu_id < 0)
+			std::cerr << "WARNING: No logical CPU was found for worker thread " << t << std::endl;
+		if (pattern_mode == SEQUENTIAL)
+			workers.push_back(new LoadWorker(thread_mem_array, len_per_thread, 0, kernel_fptr_seq, kernel_dummy_fptr_seq, cpu_id));
+		else
+			workers.push_back(new LoadWorker(thread_mem_array, len_per_thread, 0, kernel_fptr_ran, kernel_dummy_fptr_ran, cpu_id));
+		workers[t]->setGroupSync(&group_sync);
+		workers[t]->setFreeRunning();
+		workers[t]->setThrottle(static_cast<uint64_t>(target_rate / num_threads));
+		worker_threads.push_back(new Thread(workers[t]));
+	}
+
+	catch_stop_signals(true);
+
+	bool success = true;
+	for (uint32_t t = 0; t < num_threads; t++) {
+		if (!worker_threads[t]->create_and_start()) {
+			std::cerr << "ERROR: Failed to start an antagonist worker thread!" << std::endl;
+			success = false;
+		}
+	}
+
+	std::cout << std::endl << "Generating antagonist load with " << num_threads << " threads on CPU node " << cpu_node << " against memory node " << mem_node << ". Send SIGINT or SIGTERM to stop." << std::endl;
+
+	uint64_t bytes_per_pass = g_throughput_bytes_per_pass;
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point last_time = start_time;
+	uint64_t last_passes = 0;
+	uint64_t peak_passes = 0;
+	bool calibrating = success && __config.getAntagonistPeakFraction() > 0;
+	uint32_t duration = __config.getAntagonistDuration();
+	uint32_t seconds = 0;
+	while (success && !stop_signal_received()) {
+		//Sleep in short slices so that a stop request is honored quickly
+		std::chrono::steady_clock::time_point next_time = start_time + std::chrono::seconds(seconds + 1);
+		while (std::chrono::steady_clock::now() < next_time && !stop_signal_received())
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		if (stop_signal_received())
+			break;
+		seconds++;
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		uint64_t total_passes = 0;
+		for (uint32_t t = 0; t < num_threads; t++)
+			total_passes += workers[t]->getLivePasses();
+		double interval_sec = std::chrono::duration<double>(now - last_time).count();
+		double achieved_rate = static_cast<double>((total_passes - last_passes) * bytes_per_pass) / interval_sec;
+
+		std::cout << "[" << seconds << " s] achieved " << std::fixed << std::setprecision(1) << achieved_rate / MB << " MB/s";
+		if (target_rate > 0 && !calibrating)
+			std::cout << " (target " << target_rate / MB << " MB/s)";
+		else if (calibrating)
+			std::cout << " (measuring peak)";
+		std::cout << std::defaultfloat << std::endl;
+
+		//A relative rate is set from the peak measured after the first second, which lets the workers warm up
+		if (calibrating && seconds == 1) {
+			peak_passes = total_passes;
+		} else if (calibrating && seconds == 1 + ANTAGONIST_CALIBRATION_SEC) {
+			double peak_rate = static_cast<double>((total_passes - peak_passes) * bytes_per_pass) / ANTAGONIST_CALIBRATION_SEC;
+			target_rate = peak_rate * __config.getAntagonistPeakFraction();
+			for (uint32_t t = 0; t < num_threads; t++)
+				workers[t]->setThrottle(static_cast<uint64_t>(target_rate / num_threads));
+			calibrating = false;
+			std::cout << "Measured peak of " << std::fixed << std::setprecision(1) << peak_rate / MB << " MB/s. Throttling to " << target_rate / MB << " MB/s." << std::defaultfloat << std::endl;
+		}
+
+		last_time = now;
+		last_passes = total_passes;
+		if (duration > 0 && seconds >= duration)
+			break;
+	}
+
+	//Stop the load
+	group_sync.requestStop();
+	uint64_t total_passes = 0;
+	for (uint32_t t = 0; t < num_threads; t++) {
+		if (worker_threads[t]->created() && !worker_threads[t]->join()) {
+			std::cerr << "ERROR: Failed to join an antagonist worker thread!" << std::endl;
+			success = false;
+		}
+		total_passes += workers[t]->getLivePasses();
+	}
+	double total_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	catch_stop_signals(false);
+
+	uint64_t total_bytes = total_passes * bytes_per_pass;
+	std::cout << std::endl << "Antagonist load stopped after " << std::fixed << std::setprecision(1) << total_sec << " s: " << static_cast<double>(total_bytes) / MB << " MB accessed, averaging " << static_cast<double>(total_bytes) / total_sec / MB << " MB/s";
+	if (target_rate > 0)
+		std::cout << " against a target of " << target_rate / MB << " MB/s";
+	std::cout << "." << std::defaultfloat << std::endl;
+
+	for (uint32_t t = 0; t < num_threads; t++) {
+		delete worker_threads[t];
+		delete workers[t];
+	}
+	__freeWorkingSet(mem_array, len);
+
+	return success;
+}
+
+bool BenchmarkManager::__runConcurrently(std::vector<Benchmark*> benchmarks) {
+	//Print each benchmark's configuration up front so console output of concurrent runs is not interleaved
+	for (uint32_t i = 0; i < benchmarks.size(); i++) {
+		benchmarks[i]->print_benchmark_header();
+		benchmarks[i]->report_benchmark_info();
+	}
+
+	std::vector<BenchmarkRunner*> runners;
+	std::vector<Thread*> threads;
+	for (uint32_t i = 0; i < benchmarks.size(); i++) {
+		runners.push_back(new BenchmarkRunner(benchmarks[i]));
+		threads.push_back(new Thread(runners[i]));
+	}
+
+	bool success = true;
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		if (!threads[i]->create_and_start()) {
+			std::cerr << "ERROR: Failed to start a benchmark thread!" << std::endl;
+			success = false;
+		}
+	}
+
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		if (threads[i]->created() && !threads[i]->join()) {
+			std::cerr << "ERROR: Failed to join a benchmark thread!" << std::endl;
+			success = false;
+		}
+		if (!runners[i]->succeeded())
+			success = false;
+		benchmarks[i]->report_results(); //to console
+		__writeResults(benchmarks[i]); //to results files
+	}
+
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		delete threads[i];
+		delete runners[i];
+	}
+
+	return success;
+}
+
+void BenchmarkManager::__reportMatrix(std::string title, const std::vector< std::vector<double> >& cells) {
+	//To console
+	std::streamsize old_precision = std::cout.precision();
+	std::cout << std::endl;
+	std::cout << title << std::endl;
+	std::cout << std::setw(12) << "CPU \\ Mem";
+	for (uint32_t mem_node = 0; mem_node < cells.size(); mem_node++)
+		std::cout << std::setw(12) << mem_node;
+	std::cout << std::endl;
+	for (uint32_t cpu_node = 0; cpu_node < cells.size(); cpu_node++) {
+		std::cout << std::setw(12) << cpu_node;
+		for (uint32_t mem_node = 0; mem_node < cells[cpu_node].size(); mem_node++)
+			std::cout << std::setw(12) << std::fixed << std::setprecision(2) << cells[cpu_node][mem_node];
+		std::cout << std::endl;
+	}
+	std::cout.unsetf(std::ios_base::floatfield);
+	std::cout.precision(old_precision);
+
+	//Write to results file if necessary
+	if (__config.useOutputFile()) {
+		__results_file << title << std::endl;
+		__results_file << "CPU Node \\ Memory Node,";
+		for (uint32_t mem_node = 0; mem_node < cells.size(); mem_node++)
+			__results_file << mem_node << ",";
+		__results_file << std::endl;
+		for (uint32_t cpu_node = 0; cpu_node < cells.size(); cpu_node++) {
+			__results_file << cpu_node << ",";
+			for (uint32_t mem_node = 0; mem_node < cells[cpu_node].size(); mem_node++)
+				__results_file << cells[cpu_node][mem_node] << ",";
+			__results_file << std::endl;
+		}
+		__results_file << std::endl;
+	}
 }
 
 void BenchmarkManager::__setupWorkingSets(size_t working_set_size) {
@@ -336,87 +969,147 @@ void BenchmarkManager::__setupWorkingSets(size_t working_set_size) {
 	__mem_array_lens.resize(__benchmark_num_numa_nodes);
 
 	for (uint32_t numa_node = 0; numa_node < __benchmark_num_numa_nodes; numa_node++) {
-		size_t allocation_size = 0;
-
-		if (__config.useLargePages()) {
-			size_t remainder = 0;
-			//For large pages, working set size could be less than a single large page. So let's allocate the right amount of memory, which is the working set size rounded up to nearest large page, which could be more than we actually use.
-			if (__config.getNumWorkerThreads() * working_set_size < g_large_page_size)
-				allocation_size = g_large_page_size;
-			else { 
-				remainder = (__config.getNumWorkerThreads() * working_set_size) % g_large_page_size;
-				allocation_size = (__config.getNumWorkerThreads() * working_set_size) + remainder;
-			}
-			
+		//Nodes without memory, e.g. CPU-only nodes or offline node IDs, cannot be benchmarked as memory nodes
+		if (__config.isNUMAEnabled() && !g_topology.nodeHasMemory(numa_node)) {
+			__mem_arrays[numa_node] = nullptr;
+			__mem_array_lens[numa_node] = 0;
+			if (g_verbose)
+				std::cout << std::endl << "NUMA node " << numa_node << " has no memory. It will not be benchmarked as a memory node." << std::endl;
+			continue;
+		}
+
+		__mem_arrays[numa_node] = __allocateWorkingSet(numa_node, __config.getNumWorkerThreads() * working_set_size);
+		if (__mem_arrays[numa_node] == nullptr) {
+			std::cerr << "ERROR: Could not allocate working sets for " << __config.getNumWorkerThreads() << " worker threads." << std::endl;
+			exit(-1);
+		}
+		__mem_array_lens[numa_node] = __config.getNumWorkerThreads() * working_set_size;
+	}
+}
+
+void* BenchmarkManager::__allocateWorkingSet(uint32_t numa_node, size_t len) {
+	void* mem_array = nullptr;
+	size_t allocation_size = 0;
+
+	if (__config.useLargePages()) {
+		size_t remainder = 0;
+		//For large pages, working set size could be less than a single large page. So let's allocate the right amount of memory, which is the working set size rounded up to nearest large page, which could be more than we actually use.
+		if (len < g_large_page_size)
+			allocation_size = g_large_page_size;
+		else { 
+			remainder = len % g_large_page_size;
+			allocation_size = len + remainder;
+		}
+		
 #ifdef _WIN32
-			//Make sure we have necessary privileges
-			HANDLE hToken;
-			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &hToken)) {
-				std::cerr << "ERROR: Failed to open process token to adjust privileges! Did you remember to run in Administrator mode?" << std::endl;
-				exit(-1);
-			}
-			if (!SetPrivilege(hToken,"SeLockMemoryPrivilege", true)) {
-				std::cerr << "ERROR: Failed to adjust privileges to allow locking memory pages! Did you remember to run in Administrator mode?" << std::endl;
-				exit(-1);
-			}
-			CloseHandle(hToken);
-			
-			__mem_arrays[numa_node] = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE, numa_node); //Windows NUMA allocation. Make the allocation one page bigger than necessary so that we can do alignment.
+		//Make sure we have necessary privileges
+		HANDLE hToken;
+		if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &hToken)) {
+			std::cerr << "ERROR: Failed to open process token to adjust privileges! Did you remember to run in Administrator mode?" << std::endl;
+			exit(-1);
+		}
+		if (!SetPrivilege(hToken,"SeLockMemoryPrivilege", true)) {
+			std::cerr << "ERROR: Failed to adjust privileges to allow locking memory pages! Did you remember to run in Administrator mode?" << std::endl;
+			exit(-1);
+		}
+		CloseHandle(hToken);
+		
+		mem_array = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE, numa_node); //Windows NUMA allocation. Make the allocation one page bigger than necessary so that we can do alignment.
 #endif
 #ifdef __gnu_linux__
-			__mem_arrays[numa_node] = get_huge_pages(allocation_size, GHP_DEFAULT); //TODO: hugetlbfs does not seem to be NUMA-aware. We may require NUMA awareness and huge pages to be mutually exclusive on Linux builds =( FIXME: I get segfaults in ThroughputBenchmark if allocation_size ends up requiring more than 1 huge page.
+		mem_array = get_huge_pages(allocation_size, GHP_DEFAULT); //TODO: hugetlbfs does not seem to be NUMA-aware. We may require NUMA awareness and huge pages to be mutually exclusive on Linux builds =( FIXME: I get segfaults in ThroughputBenchmark if allocation_size ends up requiring more than 1 huge page.
 #endif
-		} else { //Non-large pages (nominal case)
-			//Under normal (not large-page) operation, working set size is a multiple of regular pages.
-			allocation_size = __config.getNumWorkerThreads() * working_set_size + g_page_size; 
+	} else { //Non-large pages (nominal case)
+		//Under normal (not large-page) operation, working set size is a multiple of regular pages.
+		allocation_size = len + g_page_size; 
 #ifdef _WIN32
-			__mem_arrays[numa_node] = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, numa_node); //Windows NUMA allocation. Make the allocation one page bigger than necessary so that we can do alignment.
+		mem_array = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, numa_node); //Windows NUMA allocation. Make the allocation one page bigger than necessary so that we can do alignment.
 #endif
 #ifdef __gnu_linux__
-			numa_set_strict(1); //Enforce NUMA memory allocation to land on specified node or fail otherwise. Alternative node fallback is forbidden.
-			__mem_arrays[numa_node] = numa_alloc_onnode(allocation_size, numa_node);
+		numa_set_strict(1); //Enforce NUMA memory allocation to land on specified node or fail otherwise. Alternative node fallback is forbidden.
+		mem_array = numa_alloc_onnode(allocation_size, numa_node);
 #endif
-		}
-		
-		if (__mem_arrays[numa_node] != nullptr)
-			__mem_array_lens[numa_node] = __config.getNumWorkerThreads() * working_set_size;
-		else {
-			std::cerr << "ERROR: Failed to allocate " << allocation_size << " B on NUMA node " << numa_node << " for " << __config.getNumWorkerThreads() << " worker threads." << std::endl;
-			exit(-1);
-		}
+	}
+	
+	if (mem_array == nullptr) {
+		std::cerr << "ERROR: Failed to allocate " << allocation_size << " B on NUMA node " << numa_node << "." << std::endl;
+		return nullptr;
+	}
 
-	 	if (g_verbose) {
-			std::cout << std::endl;
-			std::cout << "Virtual address for memory on NUMA node " << numa_node << ":" << std::endl;
-			std::printf("0x%.16llX", reinterpret_cast<long long unsigned int>(__mem_arrays[numa_node]));
-		}
+ 	if (g_verbose) {
+		std::cout << std::endl;
+		std::cout << "Virtual address for memory on NUMA node " << numa_node << ":" << std::endl;
+		std::printf("0x%.16llX", reinterpret_cast<long long unsigned int>(mem_array));
+	}
 
-		//upwards alignment to page boundary
-		uintptr_t mask;
-		if (__config.useLargePages())
-			mask = static_cast<uintptr_t>(g_large_page_size)-1;
-		else
-			mask = static_cast<uintptr_t>(g_page_size)-1; //e.g. 4095 bytes
-		uintptr_t tmp_ptr = reinterpret_cast<uintptr_t>(__mem_arrays[numa_node]);
-		uintptr_t aligned_addr = (tmp_ptr + mask) & ~mask; //add one page to the address, then truncate least significant bits of address to be page aligned.
-		__mem_arrays[numa_node] = reinterpret_cast<void*>(aligned_addr); 
+	//upwards alignment to page boundary
+	uintptr_t mask;
+	if (__config.useLargePages())
+		mask = static_cast<uintptr_t>(g_large_page_size)-1;
+	else
+		mask = static_cast<uintptr_t>(g_page_size)-1; //e.g. 4095 bytes
+	uintptr_t tmp_ptr = reinterpret_cast<uintptr_t>(mem_array);
+	uintptr_t aligned_addr = (tmp_ptr + mask) & ~mask; //add one page to the address, then truncate least significant bits of address to be page aligned.
+	mem_array = reinterpret_cast<void*>(aligned_addr); 
 
-		if (g_verbose) {
-			std::cout << " --- ALIGNED --> ";
-			std::printf("0x%.16llX", reinterpret_cast<long long unsigned int>(__mem_arrays[numa_node]));
-			std::cout << std::endl;
-		}
+	if (g_verbose) {
+		std::cout << " --- ALIGNED --> ";
+		std::printf("0x%.16llX", reinterpret_cast<long long unsigned int>(mem_array));
+		std::cout << std::endl;
 	}
+
+	return mem_array;
 }
 
-bool BenchmarkManager::__buildBenchmarks() {
-	if (g_verbose)  {
-		std::cout << std::endl;
-		std::cout << "Generating benchmarks." << std::endl;
+void BenchmarkManager::__freeWorkingSet(void* mem_array, size_t len) {
+	g_permutation_cache.release(mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + len));
+#ifdef _WIN32
+	VirtualFreeEx(GetCurrentProcess(), mem_array, 0, MEM_RELEASE);
+#endif
+#ifdef __gnu_linux__
+	if (__config.useLargePages())
+		free_huge_pages(mem_array);
+	else
+		numa_free(mem_array, len); 
+#endif
+}
+
+void BenchmarkManager::__placeWorkers() {
+	uint32_t num_threads = __config.getNumWorkerThreads();
+	std::vector<uint32_t> cpu_list = __config.getCPUList();
+
+	for (uint32_t cpu_node = 0; cpu_node < __num_numa_nodes; cpu_node++) {
+		std::vector<int32_t> tp_cpus;
+		std::vector<int32_t> lat_cpus;
+		choose_worker_cpus(cpu_node, num_threads, cpu_list, __config.getPlacementPolicy(), __config.getLatencyCPU(), tp_cpus, lat_cpus);
+		if (__config.getLoadCPUNode() >= 0 && static_cast<uint32_t>(__config.getLoadCPUNode()) != cpu_node)
+			choose_split_latency_cpus(cpu_node, static_cast<uint32_t>(__config.getLoadCPUNode()), num_threads, __config.getPlacementPolicy(), __config.getLatencyCPU(), lat_cpus);
+		__tp_cpus.push_back(tp_cpus);
+		__lat_cpus.push_back(lat_cpus);
 	}
 
-	//Put the enumerations into vectors to make constructing benchmarks more loopable
-	std::vector<chunk_size_t> chunks;
+	//An explicit CPU list pins every benchmark to the same CPUs, so only its NUMA node needs to be benchmarked
+	if (!cpu_list.empty()) {
+		int32_t node = numa_node_of_cpu_id(cpu_list[0]);
+		__benchmark_cpu_nodes.push_back(node < 0 ? 0 : static_cast<uint32_t>(node));
+	} else {
+		for (uint32_t cpu_node = 0; cpu_node < __benchmark_num_numa_nodes; cpu_node++)
+			if (!__config.isNUMAEnabled() || g_topology.nodeHasCPUs(cpu_node)) //memory-only nodes have no CPUs to run workers on
+				__benchmark_cpu_nodes.push_back(cpu_node);
+	}
+
+	if (g_verbose) {
+		for (uint32_t i = 0; i < __benchmark_cpu_nodes.size(); i++) {
+			uint32_t cpu_node = __benchmark_cpu_nodes[i];
+			std::cout << "Worker CPUs for NUMA node " << cpu_node << ": ";
+			for (uint32_t t = 0; t < __tp_cpus[cpu_node].size(); t++)
+				std::cout << __tp_cpus[cpu_node][t] << " ";
+			std::cout << "(latency thread on " << __lat_cpus[cpu_node][0] << ")" << std::endl;
+		}
+	}
+}
+
+void BenchmarkManager::__getKernelOptions(std::vector<chunk_size_t>& chunks, std::vector<rw_mode_t>& rws, std::vector<int64_t>& strides) const {
 	if (__config.useChunk32b())
 		chunks.push_back(CHUNK_32b); 
 	if (__config.useChunk64b())
@@ -426,13 +1119,11 @@ bool BenchmarkManager::__buildBenchmarks() {
 	if (__config.useChunk256b())
 		chunks.push_back(CHUNK_256b); 
 
-	std::vector<rw_mode_t> rws;
 	if (__config.useReads())
 		rws.push_back(READ);
 	if (__config.useWrites())
 		rws.push_back(WRITE);
 	
-	std::vector<int64_t> strides;
 	if (__config.useStrideP1())
 		strides.push_back(1);
 	if (__config.useStrideN1())
@@ -453,6 +1144,19 @@ bool BenchmarkManager::__buildBenchmarks() {
 		strides.push_back(16);
 	if (__config.useStrideN16())
 		strides.push_back(-16);
+}
+
+bool BenchmarkManager::__buildBenchmarks() {
+	if (g_verbose)  {
+		std::cout << std::endl;
+		std::cout << "Generating benchmarks." << std::endl;
+	}
+
+	//Put the enumerations into vectors to make constructing benchmarks more loopable
+	std::vector<chunk_size_t> chunks;
+	std::vector<rw_mode_t> rws;
+	std::vector<int64_t> strides;
+	__getKernelOptions(chunks, rws, strides);
 
 	if (g_verbose)
 		std::cout << std::endl;
@@ -463,8 +1167,11 @@ bool BenchmarkManager::__buildBenchmarks() {
 	for (uint32_t mem_node = 0; mem_node < __benchmark_num_numa_nodes; mem_node++) { //iterate each memory NUMA node
 		void* mem_array = __mem_arrays[mem_node];			
 		size_t mem_array_len = __mem_array_lens[mem_node];
+		if (mem_array == nullptr) //node has no memory
+			continue;
 
-		for (uint32_t cpu_node = 0; cpu_node < __benchmark_num_numa_nodes; cpu_node++) { //iterate each CPU node
+		for (uint32_t cpu_index = 0; cpu_index < __benchmark_cpu_nodes.size(); cpu_index++) { //iterate each CPU node
+			uint32_t cpu_node = __benchmark_cpu_nodes[cpu_index];
 
 			//DO SEQUENTIAL/STRIDED TESTS
 			if (__config.useSequentialAccessPattern()) {
@@ -479,19 +1186,16 @@ bool BenchmarkManager::__buildBenchmarks() {
 							
 							//Add the throughput benchmark
 							benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index << "T (Throughput)"))->str();
-#ifdef USE_SIZE_BASED_BENCHMARKS
 							//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
 							size_t passes_per_iteration = compute_number_of_passes((mem_array_len / __config.getNumWorkerThreads()) / KB);
-#endif
 							__tp_benchmarks.push_back(new ThroughputBenchmark(mem_array,
 																		 mem_array_len,
 																		 __config.getIterationsPerTest(),
-#ifdef USE_SIZE_BASED_BENCHMARKS
 																		 passes_per_iteration,
-#endif
 																		 __config.getNumWorkerThreads(),
 																		 mem_node,
 																		 cpu_node,
+																		 __tp_cpus[cpu_node],
 																		 SEQUENTIAL,
 																		 rw,
 																		 chunk,
@@ -508,19 +1212,16 @@ bool BenchmarkManager::__buildBenchmarks() {
 							//Special case: number of worker threads is 1, only need 1 latency thread in general to do unloaded latency tests.
 							if (__config.getNumWorkerThreads() > 1 || __lat_benchmarks.size() < 1) {
 								benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "L (Latency)"))->str();
-#ifdef USE_SIZE_BASED_BENCHMARKS
 								//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
 								passes_per_iteration = compute_number_of_passes((mem_array_len / __config.getNumWorkerThreads()) / KB) / 4;
-#endif
 								__lat_benchmarks.push_back(new LatencyBenchmark(mem_array,
 																				mem_array_len,
 																				__config.getIterationsPerTest(),
-#ifdef USE_SIZE_BASED_BENCHMARKS
 																				passes_per_iteration,
-#endif
 																				__config.getNumWorkerThreads(),
 																				mem_node,
 																				cpu_node,
+																				__lat_cpus[cpu_node],
 																				SEQUENTIAL,
 																				rw,
 																				chunk,
@@ -547,19 +1248,16 @@ bool BenchmarkManager::__buildBenchmarks() {
 						
 						//Add the throughput benchmark
 						benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index << "T (Throughput)"))->str();
-#ifdef USE_SIZE_BASED_BENCHMARKS
 						//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
 						size_t passes_per_iteration = compute_number_of_passes((mem_array_len / __config.getNumWorkerThreads()) / KB);
-#endif
 						__tp_benchmarks.push_back(new ThroughputBenchmark(mem_array,
 																		  mem_array_len,
 																		  __config.getIterationsPerTest(),
-#ifdef USE_SIZE_BASED_BENCHMARKS
 																		  passes_per_iteration,
-#endif
 																		  __config.getNumWorkerThreads(),
 																		  mem_node,
 																		  cpu_node,
+																		  __tp_cpus[cpu_node],
 																		  RANDOM,
 																		  rw,
 																		  chunk,
@@ -575,19 +1273,16 @@ bool BenchmarkManager::__buildBenchmarks() {
 						//Special case: number of worker threads is 1, only need 1 latency thread in general to do unloaded latency tests.
 						if (__config.getNumWorkerThreads() > 1 || __lat_benchmarks.size() < 1) {
 							benchmark_name = static_cast<std::ostringstream*>(&(std::ostringstream() << "Test #" << g_test_index++ << "L (Latency)"))->str();
-#ifdef USE_SIZE_BASED_BENCHMARKS
 							//Determine number of passes for each benchmark. This is working set size-dependent, to ensure the timed duration of each run is sufficiently long, but not too long.
 							passes_per_iteration = compute_number_of_passes((mem_array_len / __config.getNumWorkerThreads()) / KB) / 4;
-#endif
 							__lat_benchmarks.push_back(new LatencyBenchmark(mem_array,
 																			mem_array_len,
 																			__config.getIterationsPerTest(),
-#ifdef USE_SIZE_BASED_BENCHMARKS
 																			passes_per_iteration,
-#endif
 																			__config.getNumWorkerThreads(),
 																			mem_node,
 																			cpu_node,
+																			__lat_cpus[cpu_node],
 																			RANDOM,
 																			rw,
 																			chunk,
@@ -605,6 +1300,162 @@ bool BenchmarkManager::__buildBenchmarks() {
 		}
 	}
 	
+	for (uint32_t i = 0; i < __tp_benchmarks.size(); i++) {
+		if (__tp_benchmarks[i]->getPatternMode() == SEQUENTIAL)
+			__tp_benchmarks[i]->setSharingMode(__config.getSharingMode());
+		__applyRunSettings(__tp_benchmarks[i]);
+	}
+	for (uint32_t i = 0; i < __lat_benchmarks.size(); i++) {
+		if (__lat_benchmarks[i]->getPatternMode() == SEQUENTIAL)
+			__lat_benchmarks[i]->setSharingMode(__config.getSharingMode());
+		__applyRunSettings(__lat_benchmarks[i]);
+
+		//Load threads may run on and use the memory of other NUMA nodes than the latency thread. Their CPUs were already chosen by __placeWorkers().
+		if (__lat_benchmarks[i]->getNumThreads() > 1 && (__config.getLoadCPUNode() >= 0 || __config.getLoadMemNode() >= 0)) {
+			uint32_t load_cpu_node = (__config.getLoadCPUNode() >= 0) ? static_cast<uint32_t>(__config.getLoadCPUNode()) : __lat_benchmarks[i]->getCPUNode();
+			uint32_t load_mem_node = (__config.getLoadMemNode() >= 0) ? static_cast<uint32_t>(__config.getLoadMemNode()) : __lat_benchmarks[i]->getMemNode();
+			if (load_mem_node >= __mem_arrays.size() || __mem_arrays[load_mem_node] == nullptr) {
+				std::cerr << "ERROR: No working set was allocated on load memory NUMA node " << load_mem_node << "." << std::endl;
+				return false;
+			}
+			__lat_benchmarks[i]->setLoadNodes(load_cpu_node, load_mem_node, __mem_arrays[load_mem_node]);
+		}
+	}
+
 	__built_benchmarks = true;
 	return true;
 }
+
+void BenchmarkManager::__applyRunSettings(Benchmark* benchmark) const {
+	if (benchmark != NULL)
+		benchmark->setReporting(g_verbose ? &std::cout : NULL, &std::cerr);
+	if (benchmark != NULL && __config.getTargetRelativeCI() > 0)
+		benchmark->setAdaptiveIterations(__config.getTargetRelativeCI(), __config.getMaxIterations(), __config.getTimeBudget());
+	if (benchmark != NULL && __config.rejectNoisyIterations())
+		benchmark->setRejectNoisy(true);
+}
+
+void BenchmarkManager::__writeResults(const Benchmark* benchmark) {
+	BenchmarkResult result;
+	benchmark->getResult(result);
+
+	if (__config.useOutputFile()) {
+		if (result.kind == "aggregate")
+			__writeAggregateCSVResult(result);
+		else if (!__config.numaMatrixMode()) //NUMA matrix mode writes its tables once all cells have run
+			__writeCSVResult(result);
+	}
+
+	if (__json_stream.isOpen())
+		__json_stream.writeResult(result);
+
+	if (__baseline.isLoaded())
+		__baseline.compare(result);
+}
+
+uint32_t BenchmarkManager::reportComparison() const {
+	if (!__baseline.isLoaded())
+		return 0;
+
+	__baseline.report();
+	return __baseline.getNumRegressions();
+}
+
+void BenchmarkManager::__writeStatistics(const BenchmarkResult& result) {
+	__results_file << result.median_metric << ",";
+	__results_file << result.min_metric << ",";
+	__results_file << result.max_metric << ",";
+	__results_file << result.stddev_metric << ",";
+	__results_file << result.ci_metric << ",";
+	__results_file << result.num_outliers << ",";
+	if (result.worker_metrics.empty()) {
+		__results_file << "N/A" << ",";
+		__results_file << "N/A" << ",";
+		__results_file << "N/A" << ",";
+	} else {
+		__results_file << result.min_worker_metric << ",";
+		__results_file << result.max_worker_metric << ",";
+		__results_file << result.worker_fairness << ",";
+	}
+}
+
+void BenchmarkManager::__writeCSVResult(const BenchmarkResult& result) {
+	bool latency = (result.kind == "latency");
+
+	__results_file << result.name << ",";
+	__results_file << result.metric_on_iter.size() << ",";
+	__results_file << static_cast<uint64_t>(result.working_set_size_per_thread / KB) << ",";
+	__results_file << result.num_threads << ",";
+	__results_file << result.num_load_threads << ",";
+	__results_file << result.mem_node << ",";
+	__results_file << result.cpu_node << ",";
+	if (result.num_load_threads == 0) {
+		__results_file << "N/A" << ",";
+		__results_file << "N/A" << ",";
+		__results_file << "N/A" << ",";
+		__results_file << "N/A" << ",";
+	} else {
+		__results_file << pattern_mode_name(result.pattern_mode) << ",";
+		__results_file << rw_mode_name(result.rw_mode) << ",";
+		if (chunk_size_bits(result.chunk_size) > 0)
+			__results_file << chunk_size_bits(result.chunk_size) << ",";
+		else
+			__results_file << "UNKNOWN" << ",";
+		__results_file << result.stride_size << ",";
+	}
+
+	if (latency) {
+		__results_file << result.average_load_metric << ",";
+		__results_file << "MB/s" << ",";
+		__results_file << result.average_metric << ",";
+		__results_file << result.metric_units << ",";
+	} else {
+		__results_file << result.average_metric << ",";
+		__results_file << result.metric_units << ",";
+		__results_file << "N/A" << ",";
+		__results_file << "N/A" << ",";
+	}
+	__writeStatistics(result);
+	for (uint32_t j = 0; j < g_num_physical_packages; j++) {
+		if (j < result.power.size()) {
+			__results_file << result.power[j].average_watts << ",";
+			__results_file << result.power[j].peak_watts << ",";
+		} else {
+			__results_file << 0 << ",";
+			__results_file << 0 << ",";
+		}
+	}
+	__results_file << std::endl;
+}
+
+void BenchmarkManager::__writeAggregateCSVResult(const BenchmarkResult& result) {
+	uint32_t num_groups = static_cast<uint32_t>(result.group_metrics.size());
+
+	__results_file << result.name << ",";
+	__results_file << result.metric_on_iter.size() << ",";
+	__results_file << static_cast<uint64_t>(result.working_set_size_per_thread / KB) << ",";
+	__results_file << (num_groups > 0 ? result.num_threads / num_groups : 0) << ",";
+	__results_file << __config.getRemoteOffset() << ",";
+	__results_file << pattern_mode_name(result.pattern_mode) << ",";
+	__results_file << rw_mode_name(result.rw_mode) << ",";
+	if (chunk_size_bits(result.chunk_size) > 0)
+		__results_file << chunk_size_bits(result.chunk_size) << ",";
+	else
+		__results_file << "UNKNOWN" << ",";
+	__results_file << result.stride_size << ",";
+	__results_file << result.average_metric << ",";
+	__results_file << result.metric_units << ",";
+	__writeStatistics(result);
+	for (uint32_t g = 0; g < num_groups; g++)
+		__results_file << result.group_metrics[g] << ",";
+	for (uint32_t j = 0; j < g_num_physical_packages; j++) {
+		if (j < result.power.size()) {
+			__results_file << result.power[j].average_watts << ",";
+			__results_file << result.power[j].peak_watts << ",";
+		} else {
+			__results_file << 0 << ",";
+			__results_file << 0 << ",";
+		}
+	}
+	__results_file << std::endl;
+}
@@ -0,0 +1,491 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the BenchmarkPlan class.
+ */
+
+//Headers
+#include <BenchmarkPlan.h>
+#include <common.h>
+#include <Topology.h>
+
+//Libraries
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace xmem;
+
+/**
+ * @brief Removes leading and trailing whitespace.
+ * @param str The string to trim.
+ * @returns The trimmed string.
+ */
+static std::string trim(const std::string& str) {
+	size_t first = str.find_first_not_of(" \t\r\n");
+	if (first == std::string::npos)
+		return "";
+	size_t last = str.find_last_not_of(" \t\r\n");
+	return str.substr(first, last - first + 1);
+}
+
+/**
+ * @brief Parses a whole string as a signed decimal integer.
+ * @param str The text to parse.
+ * @param value Set to the parsed value on success.
+ * @returns True if the entire string is a valid integer.
+ */
+static bool parse_integer(const std::string& str, int64_t& value) {
+	if (str.empty())
+		return false;
+	char* endptr = NULL;
+	value = strtoll(str.c_str(), &endptr, 10);
+	return *endptr == '\0';
+}
+
+BenchmarkPlan::BenchmarkPlan() :
+	__filename(),
+	__specs()
+{
+}
+
+bool BenchmarkPlan::load(const std::string& filename, const BenchmarkSpec& defaults) {
+	__filename = filename;
+	__specs.clear();
+
+	std::ifstream in(filename.c_str());
+	if (!in.is_open()) {
+		std::cerr << "ERROR: Failed to open the plan file " << filename << std::endl;
+		return false;
+	}
+
+	BenchmarkSpec section_defaults = defaults;
+	BenchmarkSpec spec = defaults;
+	bool in_defaults = false;
+	bool in_benchmark = false;
+	std::vector<std::string> worker_groups;
+	std::vector<uint32_t> worker_group_lines;
+	std::string raw;
+	uint32_t line = 0;
+	while (std::getline(in, raw)) {
+		line++;
+		std::string text = trim(raw);
+		if (text.empty() || text[0] == '#' || text[0] == ';')
+			continue;
+
+		if (text[0] == '[') { //New section
+			if (text[text.size()-1] != ']') {
+				std::cerr << "ERROR: " << filename << ":" << line << ": Malformed section header " << text << std::endl;
+				goto error;
+			}
+			if (in_benchmark) {
+				if (!__setWorkers(spec, worker_groups, worker_group_lines) || !__validate(spec))
+					goto error;
+				__specs.push_back(spec);
+			}
+
+			std::string section = trim(text.substr(1, text.size()-2));
+			in_defaults = false;
+			in_benchmark = false;
+			if (section == "defaults") {
+				in_defaults = true;
+			} else if (section == "throughput" || section == "latency") {
+				in_benchmark = true;
+				spec = section_defaults;
+				spec.latency = (section == "latency");
+				spec.line = line;
+				worker_groups.clear();
+				worker_group_lines.clear();
+			} else {
+				std::cerr << "ERROR: " << filename << ":" << line << ": Unknown section [" << section << "]. Allowed sections: defaults, throughput, latency." << std::endl;
+				goto error;
+			}
+			continue;
+		}
+
+		size_t eq = text.find('=');
+		if (eq == std::string::npos) {
+			std::cerr << "ERROR: " << filename << ":" << line << ": Expected key = value, got " << text << std::endl;
+			goto error;
+		}
+		if (!in_defaults && !in_benchmark) {
+			std::cerr << "ERROR: " << filename << ":" << line << ": Settings must come after a [defaults], [throughput], or [latency] section header." << std::endl;
+			goto error;
+		}
+
+		std::string key = trim(text.substr(0, eq));
+		std::string value = trim(text.substr(eq+1));
+		if (key == "workers") { //Groups are resolved at the end of the section, so that they inherit all of its settings
+			if (in_defaults) {
+				std::cerr << "ERROR: " << filename << ":" << line << ": Worker groups can only be given in [throughput] or [latency] sections." << std::endl;
+				goto error;
+			}
+			worker_groups.push_back(value);
+			worker_group_lines.push_back(line);
+			continue;
+		}
+		if (!__setKey(in_defaults ? section_defaults : spec, key, value)) {
+			std::cerr << "ERROR: " << filename << ":" << line << ": Invalid setting " << key << " = " << value << std::endl;
+			goto error;
+		}
+	}
+
+	if (in_benchmark) {
+		if (!__setWorkers(spec, worker_groups, worker_group_lines) || !__validate(spec))
+			goto error;
+		__specs.push_back(spec);
+	}
+
+	if (__specs.empty()) {
+		std::cerr << "ERROR: The plan file " << filename << " does not contain any [throughput] or [latency] sections." << std::endl;
+		goto error;
+	}
+
+	return true;
+
+	error:
+		__specs.clear();
+		return false;
+}
+
+const std::string& BenchmarkPlan::getFilename() const {
+	return __filename;
+}
+
+size_t BenchmarkPlan::getNumSpecs() const {
+	return __specs.size();
+}
+
+const BenchmarkSpec& BenchmarkPlan::getSpec(size_t index) const {
+	return __specs[index];
+}
+
+bool BenchmarkPlan::__setKey(BenchmarkSpec& spec, const std::string& key, const std::string& value) const {
+	int64_t number = 0;
+
+	if (key == "name") {
+		spec.label = value;
+	} else if (key == "threads") {
+		if (!parse_integer(value, number) || number < 1)
+			return false;
+		spec.num_worker_threads = static_cast<uint32_t>(number);
+	} else if (key == "working_set_kb") {
+		if (!parse_integer(value, number) || number < 4 || number % 4 != 0) {
+			std::cerr << "ERROR: Working set size must be specified in KB and be a multiple of 4 KB." << std::endl;
+			return false;
+		}
+		spec.working_set_size_per_thread = static_cast<size_t>(number) * KB;
+	} else if (key == "pattern") {
+		if (value == "sequential")
+			spec.pattern_mode = SEQUENTIAL;
+		else if (value == "random")
+			spec.pattern_mode = RANDOM;
+		else
+			return false;
+	} else if (key == "rw") {
+		if (value == "read")
+			spec.rw_mode = READ;
+		else if (value == "write")
+			spec.rw_mode = WRITE;
+		else
+			return false;
+	} else if (key == "chunk") {
+		if (value == "32")
+			spec.chunk_size = CHUNK_32b;
+		else if (value == "64")
+			spec.chunk_size = CHUNK_64b;
+		else if (value == "128")
+			spec.chunk_size = CHUNK_128b;
+		else if (value == "256")
+			spec.chunk_size = CHUNK_256b;
+		else
+			return false;
+	} else if (key == "stride") {
+		if (!parse_integer(value, number))
+			return false;
+		if (number != 1 && number != -1 && number != 2 && number != -2 && number != 4 && number != -4 && number != 8 && number != -8 && number != 16 && number != -16) {
+			std::cerr << "ERROR: Stride size must be one of 1, -1, 2, -2, 4, -4, 8, -8, 16, -16." << std::endl;
+			return false;
+		}
+		spec.stride_size = number;
+	} else if (key == "cpu_node") {
+		if (!parse_integer(value, number) || number < 0)
+			return false;
+		spec.cpu_node = static_cast<uint32_t>(number);
+	} else if (key == "mem_node") {
+		if (!parse_integer(value, number) || number < 0)
+			return false;
+		spec.mem_node = static_cast<uint32_t>(number);
+	} else if (key == "placement") {
+		if (value == "compact")
+			spec.placement = PLACEMENT_COMPACT;
+		else if (value == "scatter")
+			spec.placement = PLACEMENT_SCATTER;
+		else if (value == "smt_pairs")
+			spec.placement = PLACEMENT_SMT_PAIRS;
+		else
+			return false;
+	} else if (key == "cpus") {
+		spec.cpus.clear();
+		if (!parse_cpu_list(value, spec.cpus) || spec.cpus.empty())
+			return false;
+	} else if (key == "latency_cpu") {
+		if (!parse_integer(value, number) || number < -1)
+			return false;
+		spec.latency_cpu = static_cast<int32_t>(number);
+	} else if (key == "load_cpu_node") {
+		if (!parse_integer(value, number) || number < -1)
+			return false;
+		spec.load_cpu_node = static_cast<int32_t>(number);
+	} else if (key == "load_mem_node") {
+		if (!parse_integer(value, number) || number < -1)
+			return false;
+		spec.load_mem_node = static_cast<int32_t>(number);
+	} else if (key == "sharing") {
+		if (value == "private")
+			spec.sharing_mode = SHARING_PRIVATE;
+		else if (value == "read_shared")
+			spec.sharing_mode = SHARING_READ_SHARED;
+		else if (value == "one_writer")
+			spec.sharing_mode = SHARING_ONE_WRITER;
+		else if (value == "false_sharing")
+			spec.sharing_mode = SHARING_FALSE_SHARING;
+		else
+			return false;
+	} else if (key == "iterations") {
+		if (!parse_integer(value, number) || number < 1)
+			return false;
+		spec.iterations = static_cast<uint32_t>(number);
+	} else {
+		std::cerr << "ERROR: Unknown plan setting " << key << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool BenchmarkPlan::__setWorkers(BenchmarkSpec& spec, const std::vector<std::string>& groups, const std::vector<uint32_t>& lines) const {
+	if (groups.empty())
+		return true;
+
+	spec.workers.clear();
+	for (uint32_t g = 0; g < groups.size(); g++) {
+		std::istringstream tokens(groups[g]);
+		std::string token;
+		int64_t count = 0;
+		if (!(tokens >> token) || !parse_integer(token, count) || count < 1) {
+			std::cerr << "ERROR: " << __filename << ":" << lines[g] << ": A worker group must start with its number of threads." << std::endl;
+			return false;
+		}
+
+		//The group's kernel settings start from the section's, and are parsed like the section's own
+		BenchmarkSpec group = spec;
+		group.mem_node = spec_load_mem_node(spec);
+		uint64_t throttle_bytes_per_sec = 0;
+		while (tokens >> token) {
+			size_t eq = token.find('=');
+			std::string key = (eq == std::string::npos) ? token : token.substr(0, eq);
+			std::string value = (eq == std::string::npos) ? "" : token.substr(eq+1);
+			int64_t rate = 0;
+			bool valid = false;
+			if (key == "rate")
+				valid = parse_integer(value, rate) && rate >= 0;
+			else if (key == "pattern" || key == "rw" || key == "chunk" || key == "stride" || key == "mem_node")
+				valid = __setKey(group, key, value);
+			else
+				std::cerr << "ERROR: Unknown worker group setting " << key << ". Allowed settings: pattern, rw, chunk, stride, mem_node, rate." << std::endl;
+			if (!valid) {
+				std::cerr << "ERROR: " << __filename << ":" << lines[g] << ": Invalid worker group setting " << token << std::endl;
+				return false;
+			}
+			if (key == "rate")
+				throttle_bytes_per_sec = static_cast<uint64_t>(rate) * MB;
+		}
+
+		WorkerSpec worker;
+		worker.pattern_mode = group.pattern_mode;
+		worker.rw_mode = group.rw_mode;
+		worker.chunk_size = group.chunk_size;
+		worker.stride_size = (group.pattern_mode == SEQUENTIAL) ? group.stride_size : 0;
+		worker.mem_node = group.mem_node;
+		worker.throttle_bytes_per_sec = throttle_bytes_per_sec;
+		worker.mem_array = NULL;
+		spec.workers.insert(spec.workers.end(), static_cast<size_t>(count), worker);
+	}
+
+	spec.num_worker_threads = static_cast<uint32_t>(spec.workers.size()) + (spec.latency ? 1 : 0);
+	return true;
+}
+
+bool BenchmarkPlan::__validate(const BenchmarkSpec& spec) const {
+	std::string error;
+	if (!validate_benchmark_spec(spec, error)) {
+		std::cerr << "ERROR: " << __filename << ":" << spec.line << ": " << error << std::endl;
+		return false;
+	}
+	return true;
+}
+
+uint32_t xmem::spec_load_cpu_node(const BenchmarkSpec& spec) {
+	return (spec.latency && spec.load_cpu_node >= 0) ? static_cast<uint32_t>(spec.load_cpu_node) : spec.cpu_node;
+}
+
+uint32_t xmem::spec_load_mem_node(const BenchmarkSpec& spec) {
+	return (spec.latency && spec.load_mem_node >= 0) ? static_cast<uint32_t>(spec.load_mem_node) : spec.mem_node;
+}
+
+bool xmem::validate_benchmark_spec(const BenchmarkSpec& spec, std::string& error) {
+	std::ostringstream msg;
+
+	if (spec.num_worker_threads < 1 || spec.iterations < 1) {
+		msg << "A benchmark needs at least one worker thread and one iteration.";
+		error = msg.str();
+		return false;
+	}
+	if (spec.working_set_size_per_thread < 4*KB || spec.working_set_size_per_thread % (4*KB) != 0) {
+		msg << "Working set size per thread must be a multiple of 4 KB.";
+		error = msg.str();
+		return false;
+	}
+	if (spec.sharing_mode != SHARING_PRIVATE && spec.pattern_mode != SEQUENTIAL) {
+		msg << "Shared working sets need the sequential access pattern.";
+		error = msg.str();
+		return false;
+	}
+	if (!spec.workers.empty()) {
+		if (spec.sharing_mode != SHARING_PRIVATE) {
+			msg << "Load threads with their own workloads cannot share the working set.";
+			error = msg.str();
+			return false;
+		}
+		if (spec.num_worker_threads != spec.workers.size() + (spec.latency ? 1 : 0)) {
+			msg << "The number of worker threads (" << spec.num_worker_threads << ") does not match the " << spec.workers.size() << " load threads given with their own workloads.";
+			error = msg.str();
+			return false;
+		}
+		for (uint32_t w = 0; w < spec.workers.size(); w++) {
+			if (spec.workers[w].mem_node >= g_num_nodes || !g_topology.nodeHasMemory(spec.workers[w].mem_node)) {
+				msg << "Memory NUMA node " << spec.workers[w].mem_node << " of a load thread does not exist or has no usable memory.";
+				error = msg.str();
+				return false;
+			}
+		}
+	}
+
+	if (spec.cpu_node >= g_num_nodes || !g_topology.nodeHasCPUs(spec.cpu_node)) {
+		msg << "CPU NUMA node " << spec.cpu_node << " does not exist or has no usable CPUs.";
+		error = msg.str();
+		return false;
+	}
+	if (spec.mem_node >= g_num_nodes || !g_topology.nodeHasMemory(spec.mem_node)) {
+		msg << "Memory NUMA node " << spec.mem_node << " does not exist or has no usable memory.";
+		error = msg.str();
+		return false;
+	}
+
+	uint32_t load_cpu_node = spec_load_cpu_node(spec);
+	uint32_t load_mem_node = spec_load_mem_node(spec);
+	if (load_cpu_node >= g_num_nodes || !g_topology.nodeHasCPUs(load_cpu_node)) {
+		msg << "Load CPU NUMA node " << load_cpu_node << " does not exist or has no usable CPUs.";
+		error = msg.str();
+		return false;
+	}
+	if (load_mem_node >= g_num_nodes || !g_topology.nodeHasMemory(load_mem_node)) {
+		msg << "Load memory NUMA node " << load_mem_node << " does not exist or has no usable memory.";
+		error = msg.str();
+		return false;
+	}
+	if (load_cpu_node != spec.cpu_node && !spec.cpus.empty()) {
+		msg << "An explicit CPU list already places the load threads, so it cannot be combined with a load CPU node.";
+		error = msg.str();
+		return false;
+	}
+
+	if (!spec.cpus.empty()) {
+		for (uint32_t i = 0; i < spec.cpus.size(); i++) {
+			if (g_topology.getNodeOfCPU(spec.cpus[i]) < 0 || !g_topology.isCPUAllowed(spec.cpus[i])) {
+				msg << "CPU " << spec.cpus[i] << " does not exist, is offline, or is outside this process's affinity mask or cpuset.";
+				error = msg.str();
+				return false;
+			}
+			for (uint32_t j = 0; j < i; j++) {
+				if (spec.cpus[j] == spec.cpus[i]) {
+					msg << "CPU " << spec.cpus[i] << " appears more than once in the CPU list.";
+					error = msg.str();
+					return false;
+				}
+			}
+		}
+		if (spec.cpus.size() < spec.num_worker_threads) {
+			msg << "The CPU list must contain at least as many CPUs as worker threads (" << spec.num_worker_threads << ").";
+			error = msg.str();
+			return false;
+		}
+	} else if (load_cpu_node != spec.cpu_node) { //The latency thread runs on cpu_node and the load threads on load_cpu_node
+		if (spec.num_worker_threads-1 > g_topology.getCPUsInNode(load_cpu_node).size()) {
+			msg << "Number of load threads (" << spec.num_worker_threads-1 << ") exceeds the " << g_topology.getCPUsInNode(load_cpu_node).size() << " usable logical CPUs on NUMA node " << load_cpu_node << ".";
+			error = msg.str();
+			return false;
+		}
+	} else if (spec.num_worker_threads > g_topology.getCPUsInNode(spec.cpu_node).size()) {
+		msg << "Number of worker threads (" << spec.num_worker_threads << ") exceeds the " << g_topology.getCPUsInNode(spec.cpu_node).size() << " usable logical CPUs on NUMA node " << spec.cpu_node << ".";
+		error = msg.str();
+		return false;
+	}
+
+	if (spec.latency_cpu >= 0 && (g_topology.getNodeOfCPU(static_cast<uint32_t>(spec.latency_cpu)) < 0 || !g_topology.isCPUAllowed(static_cast<uint32_t>(spec.latency_cpu)))) {
+		msg << "Latency CPU " << spec.latency_cpu << " does not exist, is offline, or is outside this process's affinity mask or cpuset.";
+		error = msg.str();
+		return false;
+	}
+
+	if (g_benchmark_mode == TIME_BASED && g_throughput_bytes_per_pass > spec.working_set_size_per_thread) {
+		msg << "Bytes per pass (" << g_throughput_bytes_per_pass << ") may not exceed the working set size per thread (" << spec.working_set_size_per_thread << " B).";
+		error = msg.str();
+		return false;
+	}
+	if (g_benchmark_mode == TIME_BASED && spec.working_set_size_per_thread % g_throughput_bytes_per_pass != 0) {
+		msg << "Bytes per pass (" << g_throughput_bytes_per_pass << ") must evenly divide the working set size per thread (" << spec.working_set_size_per_thread << " B).";
+		error = msg.str();
+		return false;
+	}
+
+	//Load threads on other memory nodes get regions there in addition to their slices of the working set, and a load memory node gets a whole working set of its own
+	size_t num_regions = spec.num_worker_threads;
+	if (load_mem_node != spec.mem_node)
+		num_regions += spec.num_worker_threads;
+	for (uint32_t w = 0; w < spec.workers.size(); w++)
+		if (spec.workers[w].mem_node != load_mem_node)
+			num_regions++;
+	if (g_topology.getMemoryLimit() > 0 && num_regions * (spec.working_set_size_per_thread + g_page_size) > (g_topology.getMemoryLimit() / 4) * 3) {
+		msg << "The working set of " << spec.num_worker_threads << " threads does not fit within the memory limit of " << g_topology.getMemoryLimit() / MB << " MB.";
+		error = msg.str();
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,96 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the BenchmarkPreparer class.
+ */
+
+//Headers
+#include <BenchmarkPreparer.h>
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstddef>
+#include <iostream>
+
+using namespace xmem;
+
+BenchmarkPreparer::BenchmarkPreparer(
+		Benchmark* benchmark,
+		int32_t cpu_affinity
+	) :
+		Runnable(),
+		__benchmark(benchmark),
+		__cpu_affinity(cpu_affinity),
+		__success(false)
+	{
+}
+
+BenchmarkPreparer::~BenchmarkPreparer() {
+}
+
+void BenchmarkPreparer::run() {
+	Benchmark* benchmark = NULL;
+	int32_t cpu_affinity = -1;
+
+	//Grab relevant setup state thread-safely and keep it local
+	if (_acquireLock(-1)) {
+		benchmark = __benchmark;
+		cpu_affinity = __cpu_affinity;
+		_releaseLock();
+	}
+
+	//Keep off the CPUs being measured
+	bool locked = false;
+	if (cpu_affinity >= 0) {
+		locked = lock_thread_to_cpu(cpu_affinity);
+		if (!locked)
+			std::cerr << "WARNING: Failed to lock the preparation thread to logical CPU " << cpu_affinity << "." << std::endl;
+	}
+
+	bool success = false;
+	if (benchmark != NULL)
+		success = benchmark->prepare();
+
+	if (locked)
+		unlock_thread_to_cpu();
+
+	//Update the object state thread-safely
+	if (_acquireLock(-1)) {
+		__success = success;
+		_releaseLock();
+	}
+}
+
+bool BenchmarkPreparer::succeeded() {
+	bool retval = false;
+	if (_acquireLock(-1)) {
+		retval = __success;
+		_releaseLock();
+	}
+
+	return retval;
+}
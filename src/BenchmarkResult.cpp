@@ -0,0 +1,98 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for helpers of the structured benchmark result model.
+ */
+
+//Headers
+#include <BenchmarkResult.h>
+#include <common.h>
+
+using namespace xmem;
+
+std::string xmem::pattern_mode_name(pattern_mode_t pattern_mode) {
+	switch (pattern_mode) {
+		case SEQUENTIAL:
+			return "SEQUENTIAL";
+		case RANDOM:
+			return "RANDOM";
+		default:
+			return "UNKNOWN";
+	}
+}
+
+std::string xmem::rw_mode_name(rw_mode_t rw_mode) {
+	switch (rw_mode) {
+		case READ:
+			return "READ";
+		case WRITE:
+			return "WRITE";
+		default:
+			return "UNKNOWN";
+	}
+}
+
+std::string xmem::sharing_mode_name(sharing_mode_t sharing_mode) {
+	switch (sharing_mode) {
+		case SHARING_PRIVATE:
+			return "PRIVATE";
+		case SHARING_READ_SHARED:
+			return "READ_SHARED";
+		case SHARING_ONE_WRITER:
+			return "ONE_WRITER";
+		case SHARING_FALSE_SHARING:
+			return "FALSE_SHARING";
+		default:
+			return "UNKNOWN";
+	}
+}
+
+uint32_t xmem::chunk_size_bits(chunk_size_t chunk_size) {
+	switch (chunk_size) {
+		case CHUNK_32b:
+			return 32;
+		case CHUNK_64b:
+			return 64;
+		case CHUNK_128b:
+			return 128;
+		case CHUNK_256b:
+			return 256;
+		default:
+			return 0;
+	}
+}
+
+double xmem::jain_fairness_index(const std::vector<double>& values) {
+	double sum = 0;
+	double sum_squares = 0;
+	for (uint32_t i = 0; i < values.size(); i++) {
+		sum += values[i];
+		sum_squares += values[i] * values[i];
+	}
+	if (sum_squares == 0)
+		return 0;
+	return (sum * sum) / (static_cast<double>(values.size()) * sum_squares);
+}
@@ -0,0 +1,79 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the BenchmarkRunner class.
+ */
+
+//Headers
+#include <BenchmarkRunner.h>
+#include <Benchmark.h>
+
+//Libraries
+#include <cstddef>
+
+using namespace xmem;
+
+BenchmarkRunner::BenchmarkRunner(
+		Benchmark* benchmark
+	) :
+		Runnable(),
+		__benchmark(benchmark),
+		__success(false)
+	{
+}
+
+BenchmarkRunner::~BenchmarkRunner() {
+}
+
+void BenchmarkRunner::run() {
+	Benchmark* benchmark = NULL;
+
+	//Grab relevant setup state thread-safely and keep it local
+	if (_acquireLock(-1)) {
+		benchmark = __benchmark;
+		_releaseLock();
+	}
+
+	bool success = false;
+	if (benchmark != NULL)
+		success = benchmark->run(false);
+
+	//Update the object state thread-safely
+	if (_acquireLock(-1)) {
+		__success = success;
+		_releaseLock();
+	}
+}
+
+bool BenchmarkRunner::succeeded() {
+	bool retval = false;
+	if (_acquireLock(-1)) {
+		retval = __success;
+		_releaseLock();
+	}
+
+	return retval;
+}
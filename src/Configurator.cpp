@@ -32,7 +32,7 @@
 #include <common.h>
 #include <optionparser.h>
 #include <MyArg.h>
-#include <common.h>
+#include <Topology.h>
 
 //Libraries
 #include <cstdint>
@@ -72,7 +72,40 @@ Configurator::Configurator(
 	__use_stride_p8(false),
 	__use_stride_n8(false),
 	__use_stride_p16(false),
-	__use_stride_n16(false)
+	__use_stride_n16(false),
+	__numa_matrix(false),
+	__aggregate(false),
+	__remote_offset(0),
+	__placement(PLACEMENT_COMPACT),
+	__cpu_list(),
+	__latency_cpu(-1),
+	__load_cpu_node(-1),
+	__load_mem_node(-1),
+	__sharing_mode(SHARING_PRIVATE),
+	__target_ci(0),
+	__max_iterations(DEFAULT_MAX_ITERATIONS),
+	__time_budget(0),
+	__reject_noisy(false),
+	__plan_filename(""),
+	__plan(),
+	__command_line(),
+	__prep_overlap(PREP_OVERLAP_OFF),
+	__perm_dir(),
+	__json_filename(""),
+	__compare_filename(""),
+	__compare_threshold(DEFAULT_COMPARE_THRESHOLD),
+	__daemon(false),
+	__daemon_interval(DEFAULT_DAEMON_INTERVAL_SEC),
+	__daemon_budget(DEFAULT_DAEMON_BUDGET),
+	__prom_filename(""),
+	__prom_port(0),
+	__antagonist(false),
+	__antagonist_rate(0),
+	__antagonist_peak_fraction(0),
+	__antagonist_duration(0),
+	__antagonist_cpu_node(0),
+	__antagonist_mem_node(0),
+	__check_kernels(false)
 	{
 }
 
@@ -105,7 +138,38 @@ Configurator::Configurator(
 	bool use_stride_p8,
 	bool use_stride_n8,
 	bool use_stride_p16,
-	bool use_stride_n16
+	bool use_stride_n16,
+	bool numa_matrix,
+	bool aggregate,
+	uint32_t remote_offset,
+	placement_policy_t placement,
+	std::vector<uint32_t> cpu_list,
+	int32_t latency_cpu,
+	int32_t load_cpu_node,
+	int32_t load_mem_node,
+	sharing_mode_t sharing_mode,
+	double target_ci,
+	uint32_t max_iterations,
+	uint32_t time_budget,
+	bool reject_noisy,
+	std::string plan_filename,
+	prep_overlap_t prep_overlap,
+	std::string perm_dir,
+	std::string json_filename,
+	std::string compare_filename,
+	double compare_threshold,
+	bool daemon,
+	uint32_t daemon_interval,
+	double daemon_budget,
+	std::string prom_filename,
+	uint32_t prom_port,
+	bool antagonist,
+	double antagonist_rate,
+	double antagonist_peak_fraction,
+	uint32_t antagonist_duration,
+	uint32_t antagonist_cpu_node,
+	uint32_t antagonist_mem_node,
+	bool check_kernels
 	) :
 	__configured(true),
 	__runLatency(runLatency),
@@ -136,7 +200,40 @@ Configurator::Configurator(
 	__use_stride_p8(use_stride_p8),
 	__use_stride_n8(use_stride_n8),
 	__use_stride_p16(use_stride_p16),
-	__use_stride_n16(use_stride_n16)
+	__use_stride_n16(use_stride_n16),
+	__numa_matrix(numa_matrix),
+	__aggregate(aggregate),
+	__remote_offset(remote_offset),
+	__placement(placement),
+	__cpu_list(cpu_list),
+	__latency_cpu(latency_cpu),
+	__load_cpu_node(load_cpu_node),
+	__load_mem_node(load_mem_node),
+	__sharing_mode(sharing_mode),
+	__target_ci(target_ci),
+	__max_iterations(max_iterations),
+	__time_budget(time_budget),
+	__reject_noisy(reject_noisy),
+	__plan_filename(plan_filename),
+	__plan(),
+	__command_line(),
+	__prep_overlap(prep_overlap),
+	__perm_dir(perm_dir),
+	__json_filename(json_filename),
+	__compare_filename(compare_filename),
+	__compare_threshold(compare_threshold),
+	__daemon(daemon),
+	__daemon_interval(daemon_interval),
+	__daemon_budget(daemon_budget),
+	__prom_filename(prom_filename),
+	__prom_port(prom_port),
+	__antagonist(antagonist),
+	__antagonist_rate(antagonist_rate),
+	__antagonist_peak_fraction(antagonist_peak_fraction),
+	__antagonist_duration(antagonist_duration),
+	__antagonist_cpu_node(antagonist_cpu_node),
+	__antagonist_mem_node(antagonist_mem_node),
+	__check_kernels(check_kernels)
 	{
 }
 
@@ -146,6 +243,13 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 		return -2;
 	}
 
+	//Remember the command line for result file metadata
+	for (int32_t i = 0; i < argc; i++) {
+		if (i > 0)
+			__command_line += " ";
+		__command_line += argv[i];
+	}
+
 	//Throw out first argument which is usually the program name.
 	argc -= (argc > 0);
 	argv += (argc > 0);
@@ -203,6 +307,15 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 	if (options[NUMA_DISABLE])
 		__numa_enabled = false;
 	
+	//Check NUMA matrix mode
+	if (options[NUMA_MATRIX]) {
+		if (!__numa_enabled) {
+			std::cerr << "ERROR: NUMA matrix mode requires all NUMA nodes, so it cannot be combined with forced UMA." << std::endl;
+			goto error;
+		}
+		__numa_matrix = true;
+	}
+	
 	//Check if large pages should be used for allocation of memory under test.
 	if (options[USE_LARGE_PAGES]) {
 #ifdef __gnu_linux__
@@ -222,9 +335,201 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 		char* endptr = NULL;
 		__num_worker_threads = static_cast<uint32_t>(strtoul(options[NUM_WORKER_THREADS].arg, &endptr, 10));
 		if (__num_worker_threads > g_num_logical_cpus) {
-			std::cerr << "ERROR: Number of worker threads may not exceed the number of logical CPUs (" << g_num_logical_cpus << ")" << std::endl;
+			if (g_topology.isCPUConstrained()) { //e.g. a container requested fewer CPUs than the host has
+				std::cerr << "WARNING: Reducing the number of worker threads from " << __num_worker_threads << " to " << g_num_logical_cpus << ", the number of logical CPUs this process is allowed to use." << std::endl;
+				__num_worker_threads = g_num_logical_cpus;
+			} else {
+				std::cerr << "ERROR: Number of worker threads may not exceed the number of logical CPUs (" << g_num_logical_cpus << ")" << std::endl;
+				goto error;
+			}
+		}
+	}
+
+	//Check worker thread placement
+	if (options[PLACEMENT]) {
+		if (!__checkSingleOptionOccurrence(&options[PLACEMENT]))
+			goto error;
+
+		std::string policy(options[PLACEMENT].arg);
+		if (policy == "compact")
+			__placement = PLACEMENT_COMPACT;
+		else if (policy == "scatter")
+			__placement = PLACEMENT_SCATTER;
+		else if (policy == "smt_pairs")
+			__placement = PLACEMENT_SMT_PAIRS;
+		else {
+			std::cerr << "ERROR: Invalid placement policy " << policy << ". Allowed values: compact, scatter, smt_pairs." << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[CPU_LIST]) {
+		if (!__checkSingleOptionOccurrence(&options[CPU_LIST]))
+			goto error;
+
+		if (__numa_matrix) {
+			std::cerr << "ERROR: An explicit CPU list cannot be combined with NUMA matrix mode, which places threads on every node." << std::endl;
+			goto error;
+		}
+
+		//Parse a comma-separated list of CPU IDs and inclusive ranges, e.g. 0,2,4-7
+		if (!parse_cpu_list(options[CPU_LIST].arg, __cpu_list) || __cpu_list.empty()) {
+			std::cerr << "ERROR: Could not parse the CPU list " << options[CPU_LIST].arg << std::endl;
+			goto error;
+		}
+		for (uint32_t i = 0; i < __cpu_list.size(); i++) {
+			if (g_topology.getNodeOfCPU(__cpu_list[i]) < 0) {
+				std::cerr << "ERROR: CPU " << __cpu_list[i] << " in the CPU list does not exist or is offline." << std::endl;
+				goto error;
+			}
+			if (!g_topology.isCPUAllowed(__cpu_list[i])) {
+				std::cerr << "ERROR: CPU " << __cpu_list[i] << " in the CPU list is outside this process's affinity mask or cpuset." << std::endl;
+				goto error;
+			}
+			for (uint32_t j = 0; j < i; j++) {
+				if (__cpu_list[j] == __cpu_list[i]) {
+					std::cerr << "ERROR: CPU " << __cpu_list[i] << " appears more than once in the CPU list." << std::endl;
+					goto error;
+				}
+			}
+		}
+
+		if (!options[NUM_WORKER_THREADS])
+			__num_worker_threads = static_cast<uint32_t>(__cpu_list.size());
+		else if (__num_worker_threads > __cpu_list.size()) {
+			std::cerr << "ERROR: The CPU list must contain at least as many CPUs as worker threads (" << __num_worker_threads << ")" << std::endl;
+			goto error;
+		}
+
+		if (options[PLACEMENT])
+			std::cerr << "WARNING: Ignoring placement policy because an explicit CPU list was given." << std::endl;
+	}
+
+	if (options[LATENCY_CPU]) {
+		if (!__checkSingleOptionOccurrence(&options[LATENCY_CPU]))
+			goto error;
+
+		char* endptr = NULL;
+		__latency_cpu = static_cast<int32_t>(strtoul(options[LATENCY_CPU].arg, &endptr, 10));
+		if (endptr == options[LATENCY_CPU].arg || g_topology.getNodeOfCPU(static_cast<uint32_t>(__latency_cpu)) < 0) {
+			std::cerr << "ERROR: Latency CPU " << options[LATENCY_CPU].arg << " does not exist or is offline." << std::endl;
+			goto error;
+		}
+		if (!g_topology.isCPUAllowed(static_cast<uint32_t>(__latency_cpu))) {
+			std::cerr << "ERROR: Latency CPU " << __latency_cpu << " is outside this process's affinity mask or cpuset." << std::endl;
+			goto error;
+		}
+		if (__numa_matrix) {
+			std::cerr << "ERROR: A fixed latency CPU cannot be combined with NUMA matrix mode, which measures latency from every node." << std::endl;
+			goto error;
+		}
+	}
+
+	//Check aggregate mode
+	if (options[AGGREGATE]) {
+		if (!__cpu_list.empty()) {
+			std::cerr << "ERROR: Aggregate mode places a worker group on every NUMA node, so it cannot be combined with an explicit CPU list." << std::endl;
+			goto error;
+		}
+		if (!__numa_enabled || __numa_matrix) {
+			std::cerr << "ERROR: Aggregate mode runs on all NUMA nodes at once, so it cannot be combined with forced UMA or NUMA matrix mode." << std::endl;
+			goto error;
+		}
+		for (uint32_t n = 0; n < g_num_nodes; n++) {
+			uint32_t node_cpus = static_cast<uint32_t>(g_topology.getCPUsInNode(n).size());
+			if (node_cpus > 0 && __num_worker_threads > node_cpus) { //memory-only nodes get no worker group
+				std::cerr << "ERROR: In aggregate mode, the number of worker threads applies to each NUMA node and may not exceed the number of logical CPUs in any node (" << node_cpus << " in node " << n << ")" << std::endl;
+				goto error;
+			}
+		}
+		if (options[MEAS_LATENCY])
+			std::cerr << "WARNING: Ignoring latency benchmarks. Aggregate mode only measures throughput." << std::endl;
+		__aggregate = true;
+		__runLatency = false;
+		__runThroughput = true;
+	}
+
+	if (options[REMOTE_OFFSET]) {
+		if (!__checkSingleOptionOccurrence(&options[REMOTE_OFFSET]))
+			goto error;
+
+		if (!__aggregate)
+			std::cerr << "WARNING: Ignoring remote offset. It only applies to aggregate mode." << std::endl;
+
+		char* endptr = NULL;
+		__remote_offset = static_cast<uint32_t>(strtoul(options[REMOTE_OFFSET].arg, &endptr, 10));
+		if (__remote_offset >= g_num_nodes) {
+			std::cerr << "ERROR: Remote offset must be less than the number of NUMA nodes (" << g_num_nodes << ")" << std::endl;
+			goto error;
+		}
+	}
+
+	//Check load thread placement for latency benchmarks
+	if (options[LOAD_CPU_NODE]) {
+		if (!__checkSingleOptionOccurrence(&options[LOAD_CPU_NODE]))
+			goto error;
+
+		char* endptr = NULL;
+		__load_cpu_node = static_cast<int32_t>(strtoul(options[LOAD_CPU_NODE].arg, &endptr, 10));
+		if (endptr == options[LOAD_CPU_NODE].arg || static_cast<uint32_t>(__load_cpu_node) >= g_num_nodes || !g_topology.nodeHasCPUs(static_cast<uint32_t>(__load_cpu_node))) {
+			std::cerr << "ERROR: Load CPU NUMA node " << options[LOAD_CPU_NODE].arg << " does not exist or has no usable CPUs." << std::endl;
+			goto error;
+		}
+		if (!__cpu_list.empty()) {
+			std::cerr << "ERROR: An explicit CPU list already places the load threads, so it cannot be combined with a load CPU node." << std::endl;
+			goto error;
+		}
+		if (__num_worker_threads-1 > g_topology.getCPUsInNode(static_cast<uint32_t>(__load_cpu_node)).size()) {
+			std::cerr << "ERROR: Number of load threads (" << __num_worker_threads-1 << ") may not exceed the number of logical CPUs in load CPU NUMA node " << __load_cpu_node << " (" << g_topology.getCPUsInNode(static_cast<uint32_t>(__load_cpu_node)).size() << ")" << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[LOAD_MEM_NODE]) {
+		if (!__checkSingleOptionOccurrence(&options[LOAD_MEM_NODE]))
+			goto error;
+
+		char* endptr = NULL;
+		__load_mem_node = static_cast<int32_t>(strtoul(options[LOAD_MEM_NODE].arg, &endptr, 10));
+		if (endptr == options[LOAD_MEM_NODE].arg || static_cast<uint32_t>(__load_mem_node) >= g_num_nodes || !g_topology.nodeHasMemory(static_cast<uint32_t>(__load_mem_node))) {
+			std::cerr << "ERROR: Load memory NUMA node " << options[LOAD_MEM_NODE].arg << " does not exist or has no usable memory." << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[LOAD_CPU_NODE] || options[LOAD_MEM_NODE]) {
+		if (!__numa_enabled || __numa_matrix) {
+			std::cerr << "ERROR: Load CPU and memory nodes cannot be combined with forced UMA or NUMA matrix mode." << std::endl;
 			goto error;
 		}
+		if (__aggregate)
+			std::cerr << "WARNING: Ignoring the load CPU and memory nodes. They only apply to latency benchmarks, and aggregate mode only measures throughput." << std::endl;
+		else if (__num_worker_threads < 2)
+			std::cerr << "WARNING: Ignoring the load CPU and memory nodes. Latency benchmarks with one worker thread have no load threads." << std::endl;
+	}
+
+	//Check working set sharing
+	if (options[SHARING]) {
+		if (!__checkSingleOptionOccurrence(&options[SHARING]))
+			goto error;
+
+		std::string sharing(options[SHARING].arg);
+		if (sharing == "private")
+			__sharing_mode = SHARING_PRIVATE;
+		else if (sharing == "read_shared")
+			__sharing_mode = SHARING_READ_SHARED;
+		else if (sharing == "one_writer")
+			__sharing_mode = SHARING_ONE_WRITER;
+		else if (sharing == "false_sharing")
+			__sharing_mode = SHARING_FALSE_SHARING;
+		else {
+			std::cerr << "ERROR: Invalid sharing mode " << sharing << ". Allowed values: private, read_shared, one_writer, false_sharing." << std::endl;
+			goto error;
+		}
+		if (__aggregate || __numa_matrix)
+			std::cerr << "WARNING: Ignoring the sharing mode. It does not apply to aggregate or NUMA matrix mode." << std::endl;
+		if (options[RANDOM_ACCESS_PATTERN])
+			std::cerr << "WARNING: Random-access benchmarks always give each worker thread its own slice of the working set." << std::endl;
 	}
 	
 	//Check chunk sizes
@@ -277,6 +582,120 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 		__iterations = static_cast<uint32_t>(strtoul(options[ITERATIONS].arg, &endptr, 10));
 	}
 
+	//Check adaptive iteration control
+	if (options[TARGET_CI]) {
+		if (!__checkSingleOptionOccurrence(&options[TARGET_CI]))
+			goto error;
+
+		char* endptr = NULL;
+		double target_ci_percent = strtod(options[TARGET_CI].arg, &endptr);
+		if (endptr == options[TARGET_CI].arg || *endptr != '\0' || target_ci_percent <= 0 || target_ci_percent >= 100) {
+			std::cerr << "ERROR: Confidence interval target must be a percentage greater than 0 and less than 100." << std::endl;
+			goto error;
+		}
+		__target_ci = target_ci_percent / 100;
+		if (__iterations < 3) //a confidence interval needs a few samples
+			__iterations = 3;
+	}
+
+	if (options[MAX_ITERATIONS]) {
+		if (!__checkSingleOptionOccurrence(&options[MAX_ITERATIONS]))
+			goto error;
+
+		char* endptr = NULL;
+		__max_iterations = static_cast<uint32_t>(strtoul(options[MAX_ITERATIONS].arg, &endptr, 10));
+		if (__target_ci == 0)
+			std::cerr << "WARNING: Ignoring maximum iterations. It only applies to adaptive iteration mode (--target_ci)." << std::endl;
+	}
+
+	if (options[TIME_BUDGET]) {
+		if (!__checkSingleOptionOccurrence(&options[TIME_BUDGET]))
+			goto error;
+
+		char* endptr = NULL;
+		__time_budget = static_cast<uint32_t>(strtoul(options[TIME_BUDGET].arg, &endptr, 10));
+		if (__target_ci == 0)
+			std::cerr << "WARNING: Ignoring time budget. It only applies to adaptive iteration mode (--target_ci)." << std::endl;
+	}
+
+	if (options[REJECT_NOISY])
+		__reject_noisy = true;
+
+	//Check benchmarking methodology
+	if (options[BENCHMARK_MODE]) {
+		if (!__checkSingleOptionOccurrence(&options[BENCHMARK_MODE]))
+			goto error;
+
+		std::string mode = options[BENCHMARK_MODE].arg;
+		if (mode == "time")
+			g_benchmark_mode = TIME_BASED;
+		else if (mode == "size")
+			g_benchmark_mode = SIZE_BASED;
+		else {
+			std::cerr << "ERROR: Benchmarking mode must be one of: time, size." << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[DURATION]) {
+		if (!__checkSingleOptionOccurrence(&options[DURATION]))
+			goto error;
+
+		char* endptr = NULL;
+		g_benchmark_duration_sec = static_cast<uint32_t>(strtoul(options[DURATION].arg, &endptr, 10));
+		if (g_benchmark_mode != TIME_BASED)
+			std::cerr << "WARNING: Ignoring benchmark duration. It only applies to time-based mode." << std::endl;
+	}
+
+	if (options[BYTES_PER_PASS]) {
+		if (!__checkSingleOptionOccurrence(&options[BYTES_PER_PASS]))
+			goto error;
+
+		char* endptr = NULL;
+		g_throughput_bytes_per_pass = static_cast<size_t>(strtoul(options[BYTES_PER_PASS].arg, &endptr, 10));
+		if (endptr == options[BYTES_PER_PASS].arg || g_throughput_bytes_per_pass == 0 || g_throughput_bytes_per_pass % THROUGHPUT_BENCHMARK_BYTES_PER_PASS_GRANULARITY != 0) {
+			std::cerr << "ERROR: Bytes per pass must be a nonzero multiple of " << THROUGHPUT_BENCHMARK_BYTES_PER_PASS_GRANULARITY << ", the block size of the throughput kernels." << std::endl;
+			goto error;
+		}
+		if (g_benchmark_mode != TIME_BASED)
+			std::cerr << "WARNING: Ignoring bytes per pass. It only applies to time-based mode." << std::endl;
+	}
+
+	if (options[LATENCY_UNROLL]) {
+		if (!__checkSingleOptionOccurrence(&options[LATENCY_UNROLL]))
+			goto error;
+
+		char* endptr = NULL;
+		g_latency_unroll_length = static_cast<uint32_t>(strtoul(options[LATENCY_UNROLL].arg, &endptr, 10));
+		if (g_latency_unroll_length != 128 && g_latency_unroll_length != 256 && g_latency_unroll_length != 512 && g_latency_unroll_length != 1024) {
+			std::cerr << "ERROR: Latency unroll length must be one of: 128, 256, 512, 1024." << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[POWER_PERIOD]) {
+		if (!__checkSingleOptionOccurrence(&options[POWER_PERIOD]))
+			goto error;
+
+		char* endptr = NULL;
+		g_power_sampling_period_sec = static_cast<uint32_t>(strtoul(options[POWER_PERIOD].arg, &endptr, 10));
+	}
+
+	if (options[TRACE_PERIOD]) {
+		if (!__checkSingleOptionOccurrence(&options[TRACE_PERIOD]))
+			goto error;
+
+		char* endptr = NULL;
+		g_bandwidth_trace_period_us = static_cast<uint32_t>(strtoul(options[TRACE_PERIOD].arg, &endptr, 10));
+		if (g_bandwidth_trace_period_us > 0 && g_benchmark_mode != TIME_BASED)
+			std::cerr << "WARNING: Bandwidth traces are only recorded in time-based mode." << std::endl;
+	}
+
+	if (__target_ci > 0 && __max_iterations < __iterations) {
+		std::cerr << "ERROR: Maximum iterations (" << __max_iterations << ") may not be less than the minimum number of iterations (" << __iterations << ")." << std::endl;
+		goto error;
+	}
+
 	//Check throughput benchmark access patterns
 	if (options[RANDOM_ACCESS_PATTERN] || options[SEQUENTIAL_ACCESS_PATTERN]) { //override defaults
 		if (!__runThroughput) //These options only make sense for throughput benchmarks, but are otherwise harmless
@@ -429,6 +848,330 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 		__use_stride_n16 = true;
 	}
 
+	//Fit the working sets within the cgroup or job object memory limit. Every memory node gets its own allocation and they are all live at once. Leave a quarter of the limit for everything else.
+	if (g_topology.getMemoryLimit() > 0) {
+		size_t num_mem_nodes = 0;
+		if (!__numa_enabled)
+			num_mem_nodes = 1;
+		else {
+			for (uint32_t n = 0; n < g_num_nodes; n++)
+				if (g_topology.nodeHasMemory(n))
+					num_mem_nodes++;
+		}
+		size_t budget = (g_topology.getMemoryLimit() / 4) * 3;
+		size_t working_set_size_per_thread = __working_set_size_per_thread;
+		while (working_set_size_per_thread > 4*KB && num_mem_nodes * __num_worker_threads * (working_set_size_per_thread + g_page_size) > budget)
+			working_set_size_per_thread = ((working_set_size_per_thread / 2) / (4*KB)) * (4*KB); //keep a multiple of 4 KB
+		if (num_mem_nodes * __num_worker_threads * (working_set_size_per_thread + g_page_size) > budget) {
+			std::cerr << "ERROR: The memory limit of " << g_topology.getMemoryLimit() / MB << " MB is too small for " << __num_worker_threads << " worker threads on " << num_mem_nodes << " memory nodes." << std::endl;
+			goto error;
+		}
+		if (working_set_size_per_thread != __working_set_size_per_thread) {
+			std::cerr << "WARNING: Reducing the working set size per thread from " << __working_set_size_per_thread / KB << " KB to " << working_set_size_per_thread / KB << " KB to fit within the memory limit of " << g_topology.getMemoryLimit() / MB << " MB." << std::endl;
+			__working_set_size_per_thread = working_set_size_per_thread;
+		}
+	}
+
+	//Time-based throughput kernels wrap around the working set in whole passes
+	if (g_benchmark_mode == TIME_BASED && g_throughput_bytes_per_pass > __working_set_size_per_thread) {
+		std::cerr << "ERROR: Bytes per pass (" << g_throughput_bytes_per_pass << ") may not exceed the working set size per thread (" << __working_set_size_per_thread << " B)." << std::endl;
+		goto error;
+	}
+	if (g_benchmark_mode == TIME_BASED && __working_set_size_per_thread % g_throughput_bytes_per_pass != 0) {
+		std::cerr << "ERROR: Bytes per pass (" << g_throughput_bytes_per_pass << ") must evenly divide the working set size per thread (" << __working_set_size_per_thread << " B)." << std::endl;
+		goto error;
+	}
+
+	//Load the benchmark plan. Anything a benchmark does not set itself defaults to the other options.
+	if (options[PLAN_FILE]) {
+		if (!__checkSingleOptionOccurrence(&options[PLAN_FILE]))
+			goto error;
+
+		if (__numa_matrix || __aggregate) {
+			std::cerr << "ERROR: A plan file cannot be combined with NUMA matrix mode or aggregate mode." << std::endl;
+			goto error;
+		}
+
+		BenchmarkSpec defaults;
+		defaults.latency = false;
+		defaults.label = "";
+		defaults.num_worker_threads = __num_worker_threads;
+		defaults.working_set_size_per_thread = __working_set_size_per_thread;
+		defaults.pattern_mode = __use_sequential_access_pattern ? SEQUENTIAL : RANDOM;
+		defaults.rw_mode = __use_reads ? READ : WRITE;
+		if (__use_chunk_32b)
+			defaults.chunk_size = CHUNK_32b;
+		else if (__use_chunk_128b && !__use_chunk_64b)
+			defaults.chunk_size = CHUNK_128b;
+		else if (__use_chunk_256b && !__use_chunk_64b && !__use_chunk_128b)
+			defaults.chunk_size = CHUNK_256b;
+		else
+			defaults.chunk_size = CHUNK_64b;
+		defaults.stride_size = 1;
+		if (!__use_stride_p1) {
+			if (__use_stride_n1)
+				defaults.stride_size = -1;
+			else if (__use_stride_p2)
+				defaults.stride_size = 2;
+			else if (__use_stride_n2)
+				defaults.stride_size = -2;
+			else if (__use_stride_p4)
+				defaults.stride_size = 4;
+			else if (__use_stride_n4)
+				defaults.stride_size = -4;
+			else if (__use_stride_p8)
+				defaults.stride_size = 8;
+			else if (__use_stride_n8)
+				defaults.stride_size = -8;
+			else if (__use_stride_p16)
+				defaults.stride_size = 16;
+			else if (__use_stride_n16)
+				defaults.stride_size = -16;
+		}
+		defaults.cpu_node = 0;
+		if (!__cpu_list.empty())
+			defaults.cpu_node = static_cast<uint32_t>(g_topology.getNodeOfCPU(__cpu_list[0]));
+		else
+			while (defaults.cpu_node + 1 < g_num_nodes && !g_topology.nodeHasCPUs(defaults.cpu_node))
+				defaults.cpu_node++;
+		defaults.mem_node = 0;
+		while (defaults.mem_node + 1 < g_num_nodes && !g_topology.nodeHasMemory(defaults.mem_node))
+			defaults.mem_node++;
+		defaults.placement = __placement;
+		defaults.cpus = __cpu_list;
+		defaults.latency_cpu = __latency_cpu;
+		defaults.load_cpu_node = __load_cpu_node;
+		defaults.load_mem_node = __load_mem_node;
+		defaults.sharing_mode = __sharing_mode;
+		defaults.iterations = __iterations;
+		defaults.line = 0;
+
+		__plan_filename = options[PLAN_FILE].arg;
+		if (!__plan.load(__plan_filename, defaults))
+			goto error;
+	}
+
+	if (options[PREP_OVERLAP]) {
+		if (!__checkSingleOptionOccurrence(&options[PREP_OVERLAP]))
+			goto error;
+
+		std::string overlap(options[PREP_OVERLAP].arg);
+		if (overlap == "off")
+			__prep_overlap = PREP_OVERLAP_OFF;
+		else if (overlap == "isolated")
+			__prep_overlap = PREP_OVERLAP_ISOLATED;
+		else if (overlap == "any")
+			__prep_overlap = PREP_OVERLAP_ANY;
+		else {
+			std::cerr << "ERROR: Invalid preparation overlap policy " << overlap << ". Allowed values: off, isolated, any." << std::endl;
+			goto error;
+		}
+		if (!options[PLAN_FILE])
+			std::cerr << "WARNING: Ignoring the preparation overlap policy. It only applies to plan files (--plan)." << std::endl;
+	}
+
+	if (options[SEED]) {
+		if (!__checkSingleOptionOccurrence(&options[SEED]))
+			goto error;
+
+		char* endptr = NULL;
+		g_permutation_seed = static_cast<uint64_t>(strtoull(options[SEED].arg, &endptr, 10));
+	}
+
+	if (options[PERM_DIR]) {
+		if (!__checkSingleOptionOccurrence(&options[PERM_DIR]))
+			goto error;
+
+		__perm_dir = options[PERM_DIR].arg;
+		if (__perm_dir.empty()) {
+			std::cerr << "ERROR: The permutation index file directory must not be empty." << std::endl;
+			goto error;
+		}
+		if (!options[SEED])
+			std::cerr << "WARNING: Without --seed, every run uses a new seed, so saved permutation index files will not be reused by later runs." << std::endl;
+	}
+
+	if (options[JSON_FILE]) {
+		if (!__checkSingleOptionOccurrence(&options[JSON_FILE]))
+			goto error;
+
+		__json_filename = options[JSON_FILE].arg;
+		if (__json_filename.empty()) {
+			std::cerr << "ERROR: The JSON results filename must not be empty." << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[COMPARE_FILE]) {
+		if (!__checkSingleOptionOccurrence(&options[COMPARE_FILE]))
+			goto error;
+
+		__compare_filename = options[COMPARE_FILE].arg;
+		if (__compare_filename.empty()) {
+			std::cerr << "ERROR: The baseline filename must not be empty." << std::endl;
+			goto error;
+		}
+		if (__iterations < 2 && __target_ci == 0)
+			std::cerr << "WARNING: Comparing against a baseline needs at least 2 iterations per benchmark to estimate the run-to-run variance." << std::endl;
+	}
+
+	if (options[COMPARE_THRESHOLD]) {
+		if (!__checkSingleOptionOccurrence(&options[COMPARE_THRESHOLD]))
+			goto error;
+
+		char* endptr = NULL;
+		double threshold_percent = strtod(options[COMPARE_THRESHOLD].arg, &endptr);
+		if (endptr == options[COMPARE_THRESHOLD].arg || *endptr != '\0' || threshold_percent < 0) {
+			std::cerr << "ERROR: Comparison threshold must be a non-negative percentage." << std::endl;
+			goto error;
+		}
+		__compare_threshold = threshold_percent / 100;
+		if (!options[COMPARE_FILE])
+			std::cerr << "WARNING: Ignoring the comparison threshold. It only applies when comparing against a baseline (--compare)." << std::endl;
+	}
+
+	if (options[DAEMON]) {
+		if (usePlanFile() || __numa_matrix || __aggregate || useCompareFile()) {
+			std::cerr << "ERROR: Daemon mode cannot be combined with a plan file, NUMA matrix mode, aggregate mode, or a baseline comparison." << std::endl;
+			goto error;
+		}
+		__daemon = true;
+	}
+
+	if (options[DAEMON_INTERVAL]) {
+		if (!__checkSingleOptionOccurrence(&options[DAEMON_INTERVAL]))
+			goto error;
+
+		char* endptr = NULL;
+		__daemon_interval = static_cast<uint32_t>(strtoul(options[DAEMON_INTERVAL].arg, &endptr, 10));
+		if (!__daemon)
+			std::cerr << "WARNING: Ignoring the daemon interval. It only applies to daemon mode (--daemon)." << std::endl;
+	}
+
+	if (options[DAEMON_BUDGET]) {
+		if (!__checkSingleOptionOccurrence(&options[DAEMON_BUDGET]))
+			goto error;
+
+		char* endptr = NULL;
+		double budget_percent = strtod(options[DAEMON_BUDGET].arg, &endptr);
+		if (endptr == options[DAEMON_BUDGET].arg || *endptr != '\0' || budget_percent <= 0 || budget_percent > 100) {
+			std::cerr << "ERROR: Daemon budget must be a percentage greater than 0 and at most 100." << std::endl;
+			goto error;
+		}
+		__daemon_budget = budget_percent / 100;
+		if (!__daemon)
+			std::cerr << "WARNING: Ignoring the daemon budget. It only applies to daemon mode (--daemon)." << std::endl;
+	}
+
+	if (options[PROM_FILE]) {
+		if (!__checkSingleOptionOccurrence(&options[PROM_FILE]))
+			goto error;
+
+		__prom_filename = options[PROM_FILE].arg;
+		if (__prom_filename.empty()) {
+			std::cerr << "ERROR: The Prometheus textfile name must not be empty." << std::endl;
+			goto error;
+		}
+	}
+
+	if (options[PROM_PORT]) {
+		if (!__checkSingleOptionOccurrence(&options[PROM_PORT]))
+			goto error;
+
+		char* endptr = NULL;
+		__prom_port = static_cast<uint32_t>(strtoul(options[PROM_PORT].arg, &endptr, 10));
+		if (__prom_port > 65535) {
+			std::cerr << "ERROR: The Prometheus port must be at most 65535." << std::endl;
+			goto error;
+		}
+#ifndef __gnu_linux__
+		std::cerr << "ERROR: The Prometheus HTTP endpoint is only supported on GNU/Linux. Use --prom_file instead." << std::endl;
+		goto error;
+#endif
+	}
+
+	if (__daemon && __prom_filename.empty() && __prom_port == 0) {
+		std::cerr << "ERROR: Daemon mode needs somewhere to export its metrics. Use --prom_file and/or --prom_port." << std::endl;
+		goto error;
+	}
+	if (!__daemon && (!__prom_filename.empty() || __prom_port > 0))
+		std::cerr << "WARNING: Ignoring the Prometheus options. They only apply to daemon mode (--daemon)." << std::endl;
+
+	if (options[ANTAGONIST]) {
+		if (usePlanFile() || __numa_matrix || __aggregate || __daemon || useCompareFile()) {
+			std::cerr << "ERROR: Antagonist mode cannot be combined with a plan file, NUMA matrix mode, aggregate mode, daemon mode, or a baseline comparison." << std::endl;
+			goto error;
+		}
+		__antagonist = true;
+	}
+
+	if (options[ANTAGONIST_RATE]) {
+		if (!__checkSingleOptionOccurrence(&options[ANTAGONIST_RATE]))
+			goto error;
+
+		char* endptr = NULL;
+		double rate = strtod(options[ANTAGONIST_RATE].arg, &endptr);
+		bool relative = (endptr != options[ANTAGONIST_RATE].arg && *endptr == '%');
+		if (relative)
+			endptr++;
+		if (endptr == options[ANTAGONIST_RATE].arg || *endptr != '\0' || rate < 0 || (relative && (rate <= 0 || rate > 100))) {
+			std::cerr << "ERROR: Antagonist rate must be a non-negative number of MB/s, or a percentage of the peak greater than 0 and at most 100." << std::endl;
+			goto error;
+		}
+		if (relative)
+			__antagonist_peak_fraction = rate / 100;
+		else
+			__antagonist_rate = rate;
+		if (!__antagonist)
+			std::cerr << "WARNING: Ignoring the antagonist rate. It only applies to antagonist mode (--antagonist)." << std::endl;
+	}
+
+	if (options[ANTAGONIST_DURATION]) {
+		if (!__checkSingleOptionOccurrence(&options[ANTAGONIST_DURATION]))
+			goto error;
+
+		char* endptr = NULL;
+		__antagonist_duration = static_cast<uint32_t>(strtoul(options[ANTAGONIST_DURATION].arg, &endptr, 10));
+		if (!__antagonist)
+			std::cerr << "WARNING: Ignoring the antagonist duration. It only applies to antagonist mode (--antagonist)." << std::endl;
+	}
+
+	if (options[ANTAGONIST_CPU_NODE]) {
+		if (!__checkSingleOptionOccurrence(&options[ANTAGONIST_CPU_NODE]))
+			goto error;
+
+		char* endptr = NULL;
+		__antagonist_cpu_node = static_cast<uint32_t>(strtoul(options[ANTAGONIST_CPU_NODE].arg, &endptr, 10));
+		if (__antagonist_cpu_node >= g_num_nodes) {
+			std::cerr << "ERROR: The antagonist CPU node must be less than the number of NUMA nodes (" << g_num_nodes << ")" << std::endl;
+			goto error;
+		}
+		if (!__antagonist)
+			std::cerr << "WARNING: Ignoring the antagonist CPU node. It only applies to antagonist mode (--antagonist)." << std::endl;
+	}
+
+	if (options[ANTAGONIST_MEM_NODE]) {
+		if (!__checkSingleOptionOccurrence(&options[ANTAGONIST_MEM_NODE]))
+			goto error;
+
+		char* endptr = NULL;
+		__antagonist_mem_node = static_cast<uint32_t>(strtoul(options[ANTAGONIST_MEM_NODE].arg, &endptr, 10));
+		if (__antagonist_mem_node >= g_num_nodes) {
+			std::cerr << "ERROR: The antagonist memory node must be less than the number of NUMA nodes (" << g_num_nodes << ")" << std::endl;
+			goto error;
+		}
+		if (!__antagonist)
+			std::cerr << "WARNING: Ignoring the antagonist memory node. It only applies to antagonist mode (--antagonist)." << std::endl;
+	}
+
+	if (options[CHECK_KERNELS]) {
+#ifndef __gnu_linux__
+		std::cerr << "ERROR: The kernel self-check is only supported on GNU/Linux." << std::endl;
+		goto error;
+#endif
+		__check_kernels = true;
+	}
+
 	//Check for help or bad options
 	if (options[HELP] || options[UNKNOWN] != NULL)
 		goto error;
@@ -513,16 +1256,111 @@ int32_t Configurator::configureFromInput(int argc, char* argv[]) {
 	}
 	std::cout << "Number of worker threads:  \t";
 	std::cout << __num_worker_threads << std::endl;
+	std::cout << "Worker placement:  \t\t";
+	if (!__cpu_list.empty()) {
+		std::cout << "CPUs ";
+		for (uint32_t i = 0; i < __cpu_list.size(); i++)
+			std::cout << __cpu_list[i] << " ";
+	} else if (__placement == PLACEMENT_SCATTER)
+		std::cout << "scatter";
+	else if (__placement == PLACEMENT_SMT_PAIRS)
+		std::cout << "smt_pairs";
+	else
+		std::cout << "compact";
+	std::cout << std::endl;
+	if (__latency_cpu >= 0)
+		std::cout << "Latency measurement CPU:  \t" << __latency_cpu << std::endl;
+	if (__load_cpu_node >= 0)
+		std::cout << "Load CPU NUMA node:  \t\t" << __load_cpu_node << std::endl;
+	if (__load_mem_node >= 0)
+		std::cout << "Load memory NUMA node:  \t" << __load_mem_node << std::endl;
+	if (__sharing_mode != SHARING_PRIVATE)
+		std::cout << "Working set sharing:  \t\t" << (__sharing_mode == SHARING_READ_SHARED ? "read_shared" : (__sharing_mode == SHARING_ONE_WRITER ? "one_writer" : "false_sharing")) << std::endl;
+	if (g_topology.isCPUConstrained())
+		std::cout << "Allowed logical CPUs:  \t\t" << g_topology.getNumLogicalCPUs() << " of " << g_topology.getNumOnlineCPUs() << " (affinity mask or cpuset)" << std::endl;
+	if (g_topology.hasIsolatedCPUs()) {
+		std::cout << "Isolated logical CPUs:  \t";
+		for (uint32_t n = 0; n < g_num_nodes; n++)
+			for (uint32_t i = 0; i < g_topology.getCPUsInNode(n).size(); i++)
+				if (g_topology.isCPUIsolated(g_topology.getCPUsInNode(n)[i]))
+					std::cout << g_topology.getCPUsInNode(n)[i] << " ";
+		std::cout << "(preferred for measurement threads)" << std::endl;
+	}
+	if (g_topology.isMemoryNodeConstrained()) {
+		std::cout << "Allowed memory nodes:  \t\t";
+		for (uint32_t n = 0; n < g_num_nodes; n++)
+			if (g_topology.nodeHasMemory(n))
+				std::cout << n << " ";
+		std::cout << "(cpuset)" << std::endl;
+	}
+	if (g_topology.getMemoryLimit() > 0) {
+#ifdef _WIN32
+		std::cout << "Memory limit:  \t\t\t" << g_topology.getMemoryLimit() / MB << " MB (job object)" << std::endl;
+#endif
+#ifdef __gnu_linux__
+		std::cout << "Memory limit:  \t\t\t" << g_topology.getMemoryLimit() / MB << " MB (cgroup)" << std::endl;
+#endif
+	}
 	if (!__numa_enabled)
 		std::cout << "NUMA enabled:   \t\tno" << std::endl;
 	else
 		std::cout << "NUMA enabled:   \t\tyes" << std::endl;
+	if (__numa_matrix)
+		std::cout << "NUMA matrix mode:   \t\tyes" << std::endl;
+	if (__aggregate)
+		std::cout << "Aggregate mode:   \t\tyes (memory node offset " << __remote_offset << ")" << std::endl;
 	if (__use_large_pages)
 		std::cout << "Large pages:    \t\tyes" << std::endl;
 	else
 		std::cout << "Large pages:    \t\tno" << std::endl;
+	std::cout << "Benchmark mode:  \t\t";
+	if (g_benchmark_mode == TIME_BASED)
+		std::cout << "time-based (" << g_benchmark_duration_sec << " s per iteration, " << g_throughput_bytes_per_pass << " B per throughput pass)" << std::endl;
+	else
+		std::cout << "size-based" << std::endl;
+	if (__runLatency)
+		std::cout << "Latency kernel unroll:  \t" << g_latency_unroll_length << std::endl;
+	if (g_bandwidth_trace_period_us > 0)
+		std::cout << "Bandwidth trace period:  \t" << g_bandwidth_trace_period_us << " us" << std::endl;
 	std::cout << "Iterations:  \t\t\t";
-	std::cout << __iterations << std::endl;
+	if (__target_ci > 0) {
+		std::cout << __iterations << " to " << __max_iterations << ", until the 95% confidence interval is within +/-" << __target_ci * 100 << "% of the mean";
+		if (__time_budget > 0)
+			std::cout << " or " << __time_budget << " s have elapsed";
+		std::cout << std::endl;
+	} else
+		std::cout << __iterations << std::endl;
+	if (__reject_noisy)
+		std::cout << "Noisy iterations:  \t\trejected" << std::endl;
+	if (usePlanFile())
+		std::cout << "Benchmark plan:  \t\t" << __plan_filename << " (" << __plan.getNumSpecs() << " benchmarks)" << std::endl;
+	if (usePlanFile() && __prep_overlap != PREP_OVERLAP_OFF)
+		std::cout << "Preparation overlap:  \t\t" << (__prep_overlap == PREP_OVERLAP_ISOLATED ? "isolated" : "any") << std::endl;
+	if (useCompareFile())
+		std::cout << "Baseline:  \t\t\t" << __compare_filename << " (threshold " << __compare_threshold * 100 << "%)" << std::endl;
+	if (__daemon) {
+		std::cout << "Daemon mode:  \t\t\tyes (every " << __daemon_interval << " s or more, at most " << __daemon_budget * 100 << "% of the time)" << std::endl;
+		if (!__prom_filename.empty())
+			std::cout << "Prometheus textfile:  \t\t" << __prom_filename << std::endl;
+		if (__prom_port > 0)
+			std::cout << "Prometheus endpoint:  \t\thttp://127.0.0.1:" << __prom_port << "/metrics" << std::endl;
+	}
+	if (__antagonist) {
+		std::cout << "Antagonist mode:  \t\tyes (CPU node " << __antagonist_cpu_node << " -> memory node " << __antagonist_mem_node << ", ";
+		if (__antagonist_peak_fraction > 0)
+			std::cout << __antagonist_peak_fraction * 100 << "% of peak";
+		else if (__antagonist_rate > 0)
+			std::cout << __antagonist_rate << " MB/s";
+		else
+			std::cout << "unthrottled";
+		if (__antagonist_duration > 0)
+			std::cout << ", " << __antagonist_duration << " s)" << std::endl;
+		else
+			std::cout << ", until interrupted)" << std::endl;
+	}
+	std::cout << "Permutation seed:  \t\t" << g_permutation_seed << std::endl;
+	if (!__perm_dir.empty())
+		std::cout << "Permutation index files:  \t" << __perm_dir << std::endl;
 	std::cout << "Starting test index:  \t\t";
 	std::cout << __starting_test_index << std::endl;
 
@@ -0,0 +1,147 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the FrequencyCounter class.
+ */
+
+//Headers
+#include <FrequencyCounter.h>
+#include <common.h>
+
+//Libraries
+#include <sstream>
+#include <fstream>
+#include <cstring>
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+using namespace xmem;
+
+#define MSR_IA32_MPERF 0xE7 /**< Address of the MPERF MSR. */
+#define MSR_IA32_APERF 0xE8 /**< Address of the APERF MSR. */
+#define PERF_MSR_APERF 1 /**< Config of the aperf event of the perf msr PMU. */
+#define PERF_MSR_MPERF 2 /**< Config of the mperf event of the perf msr PMU. */
+
+#ifdef __gnu_linux__
+/**
+ * @brief Opens one event of the perf msr PMU for the calling thread on any CPU.
+ * @param type PMU type of the msr PMU.
+ * @param config The event.
+ * @returns The file descriptor, or -1 on failure.
+ */
+static int32_t open_perf_msr_event(uint32_t type, uint64_t config) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.type = type;
+	attr.size = sizeof(attr);
+	attr.config = config;
+	return static_cast<int32_t>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+FrequencyCounter::FrequencyCounter() :
+	__msr_fd(-1),
+	__aperf_fd(-1),
+	__mperf_fd(-1)
+	{
+}
+
+FrequencyCounter::~FrequencyCounter() {
+	close();
+}
+
+bool FrequencyCounter::open(int32_t cpu) {
+	close();
+	if (cpu < 0)
+		return false;
+
+#ifdef __gnu_linux__
+	std::ostringstream msr_path;
+	msr_path << "/dev/cpu/" << cpu << "/msr";
+	__msr_fd = ::open(msr_path.str().c_str(), O_RDONLY);
+	if (__msr_fd >= 0) {
+		uint64_t aperf, mperf;
+		if (read(aperf, mperf))
+			return true;
+		close();
+	}
+
+	//Fall back to the perf msr PMU, which needs no raw MSR access
+	std::ifstream type_file("/sys/bus/event_source/devices/msr/type");
+	uint32_t type = 0;
+	if (!(type_file >> type))
+		return false;
+	__aperf_fd = open_perf_msr_event(type, PERF_MSR_APERF);
+	__mperf_fd = open_perf_msr_event(type, PERF_MSR_MPERF);
+	if (__aperf_fd >= 0 && __mperf_fd >= 0)
+		return true;
+	close();
+#endif
+	return false;
+}
+
+void FrequencyCounter::close() {
+#ifdef __gnu_linux__
+	if (__msr_fd >= 0)
+		::close(__msr_fd);
+	if (__aperf_fd >= 0)
+		::close(__aperf_fd);
+	if (__mperf_fd >= 0)
+		::close(__mperf_fd);
+#endif
+	__msr_fd = -1;
+	__aperf_fd = -1;
+	__mperf_fd = -1;
+}
+
+bool FrequencyCounter::read(uint64_t& aperf, uint64_t& mperf) {
+#ifdef __gnu_linux__
+	if (__msr_fd >= 0)
+		return pread(__msr_fd, &aperf, sizeof(aperf), MSR_IA32_APERF) == sizeof(aperf) && pread(__msr_fd, &mperf, sizeof(mperf), MSR_IA32_MPERF) == sizeof(mperf);
+	if (__aperf_fd >= 0 && __mperf_fd >= 0)
+		return ::read(__aperf_fd, &aperf, sizeof(aperf)) == sizeof(aperf) && ::read(__mperf_fd, &mperf, sizeof(mperf)) == sizeof(mperf);
+#endif
+	return false;
+}
+
+double xmem::frequency_ratio(uint64_t aperf_start, uint64_t mperf_start, uint64_t aperf_stop, uint64_t mperf_stop) {
+	if (mperf_stop <= mperf_start || aperf_stop < aperf_start)
+		return 0;
+	return static_cast<double>(aperf_stop - aperf_start) / static_cast<double>(mperf_stop - mperf_start);
+}
+
+double xmem::effective_frequency_ghz(double ratio, double ns_per_tick) {
+#ifdef USE_TSC_TIMER
+	if (ns_per_tick > 0)
+		return ratio / ns_per_tick;
+#endif
+	return 0;
+}
@@ -0,0 +1,204 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for snapshots of interrupt, scheduler, and hypervisor activity on the CPUs that run measurements.
+ */
+
+//Headers
+#include <InterferenceMonitor.h>
+#include <common.h>
+
+//Libraries
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#endif
+
+using namespace xmem;
+
+#ifdef __gnu_linux__
+/**
+ * @brief Sums the interrupts handled by some CPUs, from /proc/interrupts.
+ * @param cpus The logical CPUs.
+ * @param interrupts Receives the total.
+ * @returns True if the file could be read.
+ */
+static bool read_interrupts(const std::vector<int32_t>& cpus, uint64_t& interrupts) {
+	std::ifstream in("/proc/interrupts");
+	std::string line;
+	if (!std::getline(in, line))
+		return false;
+
+	//The header names the CPU of each column, which skips offline CPUs
+	std::vector<uint32_t> columns;
+	std::istringstream header(line);
+	std::string name;
+	for (uint32_t column = 0; header >> name; column++) {
+		if (name.compare(0, 3, "CPU") == 0 && std::find(cpus.begin(), cpus.end(), atoi(name.c_str() + 3)) != cpus.end())
+			columns.push_back(column);
+	}
+
+	interrupts = 0;
+	while (std::getline(in, line)) {
+		std::istringstream fields(line);
+		std::string label;
+		fields >> label;
+		for (uint32_t column = 0, c = 0; c < columns.size(); column++) {
+			uint64_t count = 0;
+			if (!(fields >> count))
+				break; //Rows such as ERR have fewer columns
+			if (column == columns[c]) {
+				interrupts += count;
+				c++;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Sums the irq, softirq, and steal time of some CPUs, from /proc/stat.
+ * @param cpus The logical CPUs.
+ * @param snapshot Receives the totals.
+ * @returns True if the file could be read.
+ */
+static bool read_stat(const std::vector<int32_t>& cpus, InterferenceSnapshot& snapshot) {
+	std::ifstream in("/proc/stat");
+	if (!in.is_open())
+		return false;
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.compare(0, 3, "cpu") != 0 || line.size() < 4 || line[3] == ' ')
+			continue;
+		if (std::find(cpus.begin(), cpus.end(), atoi(line.c_str() + 3)) == cpus.end())
+			continue;
+		std::istringstream fields(line);
+		std::string label;
+		uint64_t user = 0, nice = 0, system = 0, idle = 0, iowait = 0, irq = 0, softirq = 0, steal = 0;
+		fields >> label >> user >> nice >> system >> idle >> iowait >> irq >> softirq >> steal;
+		snapshot.irq_ticks += irq;
+		snapshot.softirq_ticks += softirq;
+		snapshot.steal_ticks += steal;
+	}
+	return true;
+}
+
+/**
+ * @brief Sums the run queue wait time of some CPUs, from /proc/schedstat. This needs a kernel built with CONFIG_SCHEDSTATS.
+ * @param cpus The logical CPUs.
+ * @param run_delay_ns Receives the total in ns.
+ * @returns True if the file could be read.
+ */
+static bool read_schedstat(const std::vector<int32_t>& cpus, uint64_t& run_delay_ns) {
+	std::ifstream in("/proc/schedstat");
+	if (!in.is_open())
+		return false;
+	run_delay_ns = 0;
+	std::string line;
+	while (std::getline(in, line)) {
+		if (line.compare(0, 3, "cpu") != 0)
+			continue;
+		if (std::find(cpus.begin(), cpus.end(), atoi(line.c_str() + 3)) == cpus.end())
+			continue;
+
+		//cpuN yld_count legacy sched_count sched_goidle ttwu_count ttwu_local rq_cpu_time run_delay pcount
+		std::istringstream fields(line);
+		std::string label;
+		uint64_t value = 0;
+		fields >> label;
+		for (uint32_t f = 0; f < 8 && fields >> value; f++)
+			;
+		if (fields)
+			run_delay_ns += value;
+	}
+	return true;
+}
+#endif
+
+bool xmem::capture_interference(const std::vector<int32_t>& cpus, InterferenceSnapshot& snapshot) {
+	snapshot.valid = false;
+	snapshot.time = std::chrono::steady_clock::now();
+	snapshot.num_cpus = 0;
+	snapshot.interrupts = 0;
+	snapshot.irq_ticks = 0;
+	snapshot.softirq_ticks = 0;
+	snapshot.steal_ticks = 0;
+	snapshot.has_run_delay = false;
+	snapshot.run_delay_ns = 0;
+
+#ifdef __gnu_linux__
+	std::vector<int32_t> unique_cpus;
+	for (uint32_t i = 0; i < cpus.size(); i++)
+		if (cpus[i] >= 0 && std::find(unique_cpus.begin(), unique_cpus.end(), cpus[i]) == unique_cpus.end())
+			unique_cpus.push_back(cpus[i]);
+	if (unique_cpus.empty())
+		return false;
+
+	snapshot.num_cpus = static_cast<uint32_t>(unique_cpus.size());
+	if (!read_interrupts(unique_cpus, snapshot.interrupts) || !read_stat(unique_cpus, snapshot))
+		return false;
+	snapshot.has_run_delay = read_schedstat(unique_cpus, snapshot.run_delay_ns);
+	snapshot.valid = true;
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool xmem::interference_between(const InterferenceSnapshot& before, const InterferenceSnapshot& after, uint64_t involuntary_switches, uint32_t num_workers, InterferenceResult& result) {
+	result.measured = false;
+	result.noisy = false;
+	if (!before.valid || !after.valid || before.num_cpus == 0)
+		return false;
+
+	double ticks_per_sec = 100;
+#ifdef __gnu_linux__
+	ticks_per_sec = static_cast<double>(sysconf(_SC_CLK_TCK));
+#endif
+	result.measured = true;
+	result.elapsed_sec = std::chrono::duration<double>(after.time - before.time).count();
+	result.interrupts = after.interrupts - before.interrupts;
+	result.irq_sec = static_cast<double>(after.irq_ticks - before.irq_ticks) / ticks_per_sec;
+	result.softirq_sec = static_cast<double>(after.softirq_ticks - before.softirq_ticks) / ticks_per_sec;
+	result.steal_sec = static_cast<double>(after.steal_ticks - before.steal_ticks) / ticks_per_sec;
+	result.run_delay_sec = (before.has_run_delay && after.has_run_delay) ? static_cast<double>(after.run_delay_ns - before.run_delay_ns) / 1e9 : 0;
+	result.involuntary_switches = involuntary_switches;
+
+	//Judge the average CPU, so that the thresholds do not depend on how many CPUs were measured
+	double cpu_sec = result.elapsed_sec * static_cast<double>(before.num_cpus);
+	if (cpu_sec <= 0)
+		return true;
+	double lost_fraction = (result.irq_sec + result.softirq_sec + result.steal_sec) / cpu_sec;
+	double waiting_fraction = result.run_delay_sec / cpu_sec;
+	double preemption_rate = num_workers > 0 ? static_cast<double>(involuntary_switches) / static_cast<double>(num_workers) / result.elapsed_sec : 0;
+	result.noisy = lost_fraction > INTERFERENCE_THRESHOLD || waiting_fraction > INTERFERENCE_THRESHOLD || preemption_rate > INTERFERENCE_MAX_PREEMPTIONS_PER_SEC;
+	return true;
+}
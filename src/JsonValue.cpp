@@ -0,0 +1,249 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the JsonValue class.
+ */
+
+//Headers
+#include <JsonValue.h>
+
+//Libraries
+#include <cstdlib>
+
+#define JSON_MAX_DEPTH 64 /**< Deepest nesting accepted by the parser. X-Mem's own records nest only a few levels. */
+
+using namespace xmem;
+
+/**
+ * @brief Advances pos past any JSON whitespace.
+ * @param text The document.
+ * @param pos Current position in the document.
+ */
+static void skip_whitespace(const std::string& text, size_t& pos) {
+	while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+		pos++;
+}
+
+JsonValue::JsonValue() :
+	__type(JSON_NULL),
+	__bool(false),
+	__number(0),
+	__string(),
+	__array(),
+	__object()
+	{
+}
+
+bool JsonValue::parse(const std::string& text, JsonValue& value, std::string& error) {
+	size_t pos = 0;
+	value = JsonValue();
+	if (!__parseValue(text, pos, value, 0)) {
+		error = "malformed JSON near offset " + std::to_string(static_cast<unsigned long long>(pos));
+		return false;
+	}
+	skip_whitespace(text, pos);
+	if (pos != text.size()) {
+		error = "unexpected trailing characters at offset " + std::to_string(static_cast<unsigned long long>(pos));
+		return false;
+	}
+	return true;
+}
+
+const JsonValue* JsonValue::get(const std::string& key) const {
+	if (__type != JSON_OBJECT)
+		return NULL;
+	for (size_t i = 0; i < __object.size(); i++)
+		if (__object[i].first == key)
+			return &__object[i].second;
+	return NULL;
+}
+
+size_t JsonValue::size() const {
+	return (__type == JSON_ARRAY) ? __array.size() : 0;
+}
+
+const JsonValue& JsonValue::at(size_t i) const {
+	return __array.at(i);
+}
+
+double JsonValue::asNumber(double fallback) const {
+	return (__type == JSON_NUMBER) ? __number : fallback;
+}
+
+bool JsonValue::asBool(bool fallback) const {
+	return (__type == JSON_BOOL) ? __bool : fallback;
+}
+
+std::string JsonValue::asString(const std::string& fallback) const {
+	return (__type == JSON_STRING) ? __string : fallback;
+}
+
+bool JsonValue::__parseValue(const std::string& text, size_t& pos, JsonValue& value, uint32_t depth) {
+	if (depth > JSON_MAX_DEPTH)
+		return false;
+	skip_whitespace(text, pos);
+	if (pos >= text.size())
+		return false;
+
+	char c = text[pos];
+	if (c == '{') {
+		value.__type = JSON_OBJECT;
+		pos++;
+		skip_whitespace(text, pos);
+		if (pos < text.size() && text[pos] == '}') {
+			pos++;
+			return true;
+		}
+		while (true) {
+			skip_whitespace(text, pos);
+			std::string key;
+			if (pos >= text.size() || text[pos] != '"' || !__parseString(text, pos, key))
+				return false;
+			skip_whitespace(text, pos);
+			if (pos >= text.size() || text[pos] != ':')
+				return false;
+			pos++;
+			value.__object.push_back(std::make_pair(key, JsonValue()));
+			if (!__parseValue(text, pos, value.__object.back().second, depth+1))
+				return false;
+			skip_whitespace(text, pos);
+			if (pos < text.size() && text[pos] == ',') {
+				pos++;
+			} else if (pos < text.size() && text[pos] == '}') {
+				pos++;
+				return true;
+			} else
+				return false;
+		}
+	} else if (c == '[') {
+		value.__type = JSON_ARRAY;
+		pos++;
+		skip_whitespace(text, pos);
+		if (pos < text.size() && text[pos] == ']') {
+			pos++;
+			return true;
+		}
+		while (true) {
+			value.__array.push_back(JsonValue());
+			if (!__parseValue(text, pos, value.__array.back(), depth+1))
+				return false;
+			skip_whitespace(text, pos);
+			if (pos < text.size() && text[pos] == ',') {
+				pos++;
+			} else if (pos < text.size() && text[pos] == ']') {
+				pos++;
+				return true;
+			} else
+				return false;
+		}
+	} else if (c == '"') {
+		value.__type = JSON_STRING;
+		return __parseString(text, pos, value.__string);
+	} else if (text.compare(pos, 4, "true") == 0) {
+		value.__type = JSON_BOOL;
+		value.__bool = true;
+		pos += 4;
+		return true;
+	} else if (text.compare(pos, 5, "false") == 0) {
+		value.__type = JSON_BOOL;
+		value.__bool = false;
+		pos += 5;
+		return true;
+	} else if (text.compare(pos, 4, "null") == 0) {
+		value.__type = JSON_NULL;
+		pos += 4;
+		return true;
+	} else if (c == '-' || (c >= '0' && c <= '9')) {
+		const char* start = text.c_str() + pos;
+		char* end = NULL;
+		value.__type = JSON_NUMBER;
+		value.__number = strtod(start, &end);
+		if (end == start)
+			return false;
+		pos += end - start;
+		return true;
+	}
+
+	return false;
+}
+
+bool JsonValue::__parseString(const std::string& text, size_t& pos, std::string& s) {
+	pos++; //opening quote
+	while (pos < text.size()) {
+		char c = text[pos++];
+		if (c == '"')
+			return true;
+		if (c != '\\') {
+			s += c;
+			continue;
+		}
+		if (pos >= text.size())
+			return false;
+		char e = text[pos++];
+		switch (e) {
+			case '"':
+			case '\\':
+			case '/':
+				s += e;
+				break;
+			case 'b':
+				s += '\b';
+				break;
+			case 'f':
+				s += '\f';
+				break;
+			case 'n':
+				s += '\n';
+				break;
+			case 'r':
+				s += '\r';
+				break;
+			case 't':
+				s += '\t';
+				break;
+			case 'u': {
+				if (pos + 4 > text.size())
+					return false;
+				uint32_t code = static_cast<uint32_t>(strtoul(text.substr(pos, 4).c_str(), NULL, 16));
+				pos += 4;
+				if (code < 0x80) //X-Mem only escapes control characters this way. Other code points are kept as UTF-8.
+					s += static_cast<char>(code);
+				else if (code < 0x800) {
+					s += static_cast<char>(0xC0 | (code >> 6));
+					s += static_cast<char>(0x80 | (code & 0x3F));
+				} else {
+					s += static_cast<char>(0xE0 | (code >> 12));
+					s += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					s += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				break;
+			}
+			default:
+				return false;
+		}
+	}
+	return false;
+}
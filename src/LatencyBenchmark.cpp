@@ -35,6 +35,8 @@
 #include <MemoryWorker.h>
 #include <LatencyWorker.h>
 #include <LoadWorker.h>
+#include <PermutationCache.h>
+#include <FrequencyCounter.h>
 
 //Libraries
 #include <iostream>
@@ -53,12 +55,11 @@ LatencyBenchmark::LatencyBenchmark(
 		void* mem_array,
 		size_t len,
 		uint32_t iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-#endif
 		uint32_t num_worker_threads,
 		uint32_t mem_node,
 		uint32_t cpu_node,
+		std::vector<int32_t> cpu_ids,
 		pattern_mode_t pattern_mode,
 		rw_mode_t rw_mode,
 		chunk_size_t chunk_size,
@@ -70,12 +71,11 @@ LatencyBenchmark::LatencyBenchmark(
 			mem_array,
 			len,
 			iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			passes_per_iteration,
-#endif
 			num_worker_threads,
 			mem_node,
 			cpu_node,
+			cpu_ids,
 			pattern_mode,
 			rw_mode,
 			chunk_size,
@@ -85,18 +85,31 @@ LatencyBenchmark::LatencyBenchmark(
 			name
 		),
 		__loadMetricOnIter(),
-		__averageLoadMetric(0)
+		__averageLoadMetric(0),
+		__cyclesOnIter(),
+		__averageCycles(0),
+		__load_cpu_node(cpu_node),
+		__load_mem_node(mem_node),
+		__load_mem_array(mem_array)
 	{ 
 
-	for (uint32_t i = 0; i < _iterations; i++) 
+	for (uint32_t i = 0; i < _iterations; i++) {
 		__loadMetricOnIter.push_back(0);
+		__cyclesOnIter.push_back(0);
+	}
 }
 
 void LatencyBenchmark::report_benchmark_info() const {
 	std::cout << "CPU NUMA Node: " << _cpu_node << std::endl;
 	std::cout << "Memory NUMA Node: " << _mem_node << std::endl;
+	if (_num_worker_threads > 1 && __load_cpu_node != _cpu_node)
+		std::cout << "Load CPU NUMA Node: " << __load_cpu_node << std::endl;
+	if (_num_worker_threads > 1 && __load_mem_node != _mem_node)
+		std::cout << "Load Memory NUMA Node: " << __load_mem_node << std::endl;
 	std::cout << "Latency measurement chunk size: 64-bit" << std::endl;
 	std::cout << "Latency measurement access pattern: random read (pointer-chasing)" << std::endl;
+	if (!_cpu_ids.empty())
+		std::cout << "Latency measurement CPU: " << _cpu_ids[0] << std::endl;
 
 	if (_num_worker_threads > 1) {
 		std::cout << "Load Chunk Size: ";
@@ -160,6 +173,13 @@ void LatencyBenchmark::report_benchmark_info() const {
 
 		std::cout << "Load number of worker threads: " << _num_worker_threads-1;
 		std::cout << std::endl;
+
+		std::cout << "Load CPUs: ";
+		for (uint32_t t = 1; t < _cpu_ids.size(); t++)
+			std::cout << _cpu_ids[t] << " ";
+		std::cout << std::endl;
+		_report_sharing();
+		_report_worker_specs(1);
 	}
 
 	std::cout << std::endl;
@@ -174,15 +194,29 @@ void LatencyBenchmark::report_results() const {
  
 	if (_hasRun) {
 		for (uint32_t i = 0; i < _iterations; i++) {
-			std::cout << "Iter #" << i + 1 << ": " << _metricOnIter[i] << " " << _metricUnits << " @ " << __loadMetricOnIter[i] << " MB/s average imposed load";
+			std::cout << "Iter #" << i + 1 << ": " << _metricOnIter[i] << " " << _metricUnits;
+			if (__cyclesOnIter[i] > 0)
+				std::cout << " (" << __cyclesOnIter[i] << " cycles/access)";
+			std::cout << " @ " << __loadMetricOnIter[i] << " MB/s average imposed load";
+			if (_outlierOnIter[i])
+				std::cout << " (outlier)";
+			if (i < _interferenceOnIter.size() && _interferenceOnIter[i].noisy)
+				std::cout << " (noisy)";
 			if (_warning)
 				std::cout << " (WARNING)";
 			std::cout << std::endl;
 		}
-		std::cout << "Average: " << _averageMetric << " " << _metricUnits << " @ " << __averageLoadMetric << " MB/s average imposed load";
+		std::cout << "Average: " << _averageMetric << " " << _metricUnits;
+		if (__averageCycles > 0)
+			std::cout << " (" << __averageCycles << " cycles/access)";
+		std::cout << " @ " << __averageLoadMetric << " MB/s average imposed load";
 		if (_warning)
 			std::cout << " (WARNING)";
 		std::cout << std::endl;
+		_report_statistics();
+		_report_interference();
+		_report_frequency();
+		_report_workers();
 		
 		for (uint32_t i = 0; i < _dram_power_readers.size(); i++) {
 			if (_dram_power_readers[i] != NULL) {
@@ -210,53 +244,132 @@ double LatencyBenchmark::getAvgLoadMetric() const {
 		return -1;
 }
 
-bool LatencyBenchmark::_run_core() {
-	size_t len_per_thread = _len / _num_worker_threads; //Carve up memory space so each worker has its own area to play in
+double LatencyBenchmark::getAvgCyclesMetric() const {
+	if (_hasRun)
+		return __averageCycles;
+	else //bad call
+		return -1;
+}
 
-	//Set up latency measurement kernel function pointers
-	RandomFunction lat_kernel_fptr = &chasePointers;
-	RandomFunction lat_kernel_dummy_fptr = &dummy_chasePointers;
+void LatencyBenchmark::setLoadNodes(uint32_t load_cpu_node, uint32_t load_mem_node, void* load_mem_array) {
+	__load_cpu_node = load_cpu_node;
+	__load_mem_node = load_mem_node;
+	__load_mem_array = load_mem_array;
+}
+
+uint32_t LatencyBenchmark::getLoadCPUNode() const {
+	return __load_cpu_node;
+}
+
+uint32_t LatencyBenchmark::getLoadMemNode() const {
+	return __load_mem_node;
+}
+
+void LatencyBenchmark::getResult(BenchmarkResult& result) const {
+	Benchmark::getResult(result);
+	result.kind = "latency";
+	result.cycles_on_iter = __cyclesOnIter;
+	result.cycles_on_iter.resize(_iterations);
+	result.average_cycles = __averageCycles;
+	result.num_load_threads = (_num_worker_threads > 0) ? _num_worker_threads-1 : 0;
+	result.load_cpu_node = __load_cpu_node;
+	result.load_mem_node = __load_mem_node;
+	if (_num_worker_threads > 1) {
+		result.load_metric_units = "MB/s";
+		result.load_metric_on_iter = __loadMetricOnIter;
+		result.load_metric_on_iter.resize(_iterations);
+		result.average_load_metric = getAvgLoadMetric();
+	}
+}
 
-	//Initialize memory regions for all threads by writing to them, causing the memory to be physically resident.
-	forwSequentialWrite_Word64(_mem_array,
-							   reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array)+_len)); //static casts to silence compiler warnings
+bool LatencyBenchmark::_prepare_core() {
+	size_t len_per_thread = _len / _num_worker_threads; //Carve up memory space so each worker has its own area to play in
 
 	//Build pointer indices for random-access latency thread. We assume that latency thread is the first one, so we use beginning of memory region.
-	if (!buildRandomPointerPermutation(_mem_array,
-									   reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array)+len_per_thread), //static casts to silence compiler warnings
-									   CHUNK_64b)) { 
-		std::cerr << "ERROR: Failed to build a random pointer permutation for the latency measurement thread!" << std::endl;
+	if (!g_permutation_cache.preparePermutation(_mem_array,
+												reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array)+len_per_thread), //static casts to silence compiler warnings
+												CHUNK_64b,
+												g_permutation_seed,
+												_info_log,
+												_warning_log)) { 
+		_reportError("Failed to build a random pointer permutation for the latency measurement thread!");
 		return false;
 	}
 
-	//Set up load generation kernel function pointers
-	SequentialFunction load_kernel_fptr_seq = NULL;
-	SequentialFunction load_kernel_dummy_fptr_seq = NULL; 
-	RandomFunction load_kernel_fptr_ran = NULL;
-	RandomFunction load_kernel_dummy_fptr_ran = NULL; 
-	if (_num_worker_threads > 1) { //If we only have one worker thread, it is used for latency measurement only, and no load threads will be used.
-		if (_pattern_mode == SEQUENTIAL) {
-			if (!determineSequentialKernel(_rw_mode, _chunk_size, _stride_size, &load_kernel_fptr_seq, &load_kernel_dummy_fptr_seq)) {
-				std::cerr << "ERROR: Failed to find appropriate benchmark kernel." << std::endl;
+	//A load working set on another memory node is not covered by prepare()
+	if (__load_mem_array != _mem_array)
+		g_permutation_cache.touch(__load_mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__load_mem_array) + _len));
+
+	//Build pointer indices for random-access load threads. Note that the pointers for each load thread must stay within its respective region, otherwise sharing may occur. 
+	if (_sharing_mode == SHARING_PRIVATE) {
+		for (uint32_t i = 1; i < _num_worker_threads; i++) {
+			pattern_mode_t pattern_mode = _pattern_mode;
+			rw_mode_t rw_mode = _rw_mode;
+			chunk_size_t chunk_size = _chunk_size;
+			int64_t stride_size = _stride_size;
+			void* region = _loadRegion(i, 1, __load_mem_array, __load_mem_array, len_per_thread, pattern_mode, rw_mode, chunk_size, stride_size);
+			if (pattern_mode != RANDOM)
+				continue;
+			if (!g_permutation_cache.preparePermutation(region,
+														reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(region) + len_per_thread), //static casts to silence compiler warnings
+														chunk_size,
+														g_permutation_seed,
+														_info_log,
+														_warning_log)) {
+				_reportError("Failed to build a random pointer permutation for a load generation thread!");
 				return false;
 			}
-		} else if (_pattern_mode == RANDOM) {
-			if (!determineRandomKernel(_rw_mode, _chunk_size, &load_kernel_fptr_ran, &load_kernel_dummy_fptr_ran)) {
-				std::cerr << "ERROR: Failed to find appropriate benchmark kernel." << std::endl;
+		}
+	}
+
+	return true;
+}
+
+bool LatencyBenchmark::_run_core() {
+	size_t len_per_thread = _len / _num_worker_threads; //Carve up memory space so each worker has its own area to play in
+
+	//Load threads that only read may share the latency thread's slice. Writers would destroy its pointer chain, so they share the next slice instead.
+	//Load threads on another memory node carve the same slices out of their own working set, where slice 0 is not used by the latency thread.
+	void* shared_slice = __load_mem_array;
+	if (_sharing_mode == SHARING_ONE_WRITER || _sharing_mode == SHARING_FALSE_SHARING)
+		shared_slice = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(__load_mem_array) + len_per_thread);
+
+	//Set up latency measurement kernel function pointers
+	RandomFunction lat_kernel_fptr = NULL;
+	RandomFunction lat_kernel_dummy_fptr = NULL;
+	if (!determineLatencyKernel(g_latency_unroll_length, &lat_kernel_fptr, &lat_kernel_dummy_fptr)) {
+		_reportError("No latency kernel is available for an unroll length of " + std::to_string(g_latency_unroll_length) + "!");
+		return false;
+	}
+
+	//Set up load generation regions and kernel function pointers. If we only have one worker thread, it is used for latency measurement only, and no load threads will be used.
+	std::vector<void*> load_mem_arrays(_num_worker_threads, static_cast<void*>(NULL));
+	std::vector<pattern_mode_t> load_pattern_modes(_num_worker_threads, _pattern_mode);
+	std::vector<SequentialFunction> load_kernel_fptrs_seq(_num_worker_threads, static_cast<SequentialFunction>(NULL));
+	std::vector<SequentialFunction> load_kernel_dummy_fptrs_seq(_num_worker_threads, static_cast<SequentialFunction>(NULL));
+	std::vector<RandomFunction> load_kernel_fptrs_ran(_num_worker_threads, static_cast<RandomFunction>(NULL));
+	std::vector<RandomFunction> load_kernel_dummy_fptrs_ran(_num_worker_threads, static_cast<RandomFunction>(NULL));
+	for (uint32_t t = 1; t < _num_worker_threads; t++) {
+		rw_mode_t rw_mode = _rw_mode;
+		chunk_size_t chunk_size = _chunk_size;
+		int64_t stride_size = _stride_size;
+		load_mem_arrays[t] = _loadRegion(t, 1, __load_mem_array, shared_slice, len_per_thread, load_pattern_modes[t], rw_mode, chunk_size, stride_size);
+		if (load_pattern_modes[t] == SEQUENTIAL) {
+			if (!determineSequentialKernel(rw_mode, chunk_size, stride_size, &load_kernel_fptrs_seq[t], &load_kernel_dummy_fptrs_seq[t])) {
+				_reportError("Failed to find appropriate benchmark kernel.");
 				return false;
 			}
 
-			//Build pointer indices for random-access load threads. Note that the pointers for each load thread must stay within its respective region, otherwise sharing may occur. 
-			for (uint32_t i = 1; i < _num_worker_threads; i++) {
-				if (!buildRandomPointerPermutation(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + i*len_per_thread), //static casts to silence compiler warnings
-												   reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + (i+1)*len_per_thread), //static casts to silence compiler warnings
-							 					   _chunk_size)) {
-					std::cerr << "ERROR: Failed to build a random pointer permutation for a load generation thread!" << std::endl;
-					return false;
-				}
+			//Sequential writes clobber any pointer permutation left in the load thread's region. The latency thread's slice is only read.
+			if (rw_mode == WRITE)
+				g_permutation_cache.invalidate(load_mem_arrays[t], reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(load_mem_arrays[t]) + len_per_thread));
+		} else if (load_pattern_modes[t] == RANDOM) {
+			if (!determineRandomKernel(rw_mode, chunk_size, &load_kernel_fptrs_ran[t], &load_kernel_dummy_fptrs_ran[t])) {
+				_reportError("Failed to find appropriate benchmark kernel.");
+				return false;
 			}
 		} else {
-			std::cerr << "ERROR: Got an invalid pattern mode." << std::endl;
+			_reportError("Got an invalid pattern mode.");
 			return false;
 		}
 	}
@@ -269,71 +382,72 @@ bool LatencyBenchmark::_run_core() {
 	std::vector<Thread*> worker_threads;
 	
 	//Start power measurement
-	if (g_verbose)
-		std::cout << "Starting power measurement threads...";
+	if (_info_log != NULL)
+		*_info_log << "Starting power measurement threads...";
 	
 	if (!_start_power_threads()) {
-		if (g_verbose)
-			std::cout << "FAIL" << std::endl;
-		std::cerr << "WARNING: Failed to start power threads." << std::endl;
-	} else if (g_verbose)
-		std::cout << "done" << std::endl;
+		if (_info_log != NULL)
+			*_info_log << "FAIL" << std::endl;
+		_reportWarning("Failed to start power threads.");
+	} else if (_info_log != NULL)
+		*_info_log << "done" << std::endl;
 	
 	//Run benchmark
-	if (g_verbose)
-		std::cout << "Running benchmark." << std::endl << std::endl;
+	if (_info_log != NULL)
+		*_info_log << "Running benchmark." << std::endl << std::endl;
 
 	//Do a bunch of iterations of the core benchmark routine
-	for (uint32_t i = 0; i < _iterations; i++) {
+	for (uint32_t i = 0; _beginIteration(i); i++) {
+		if (i >= __loadMetricOnIter.size())
+			__loadMetricOnIter.push_back(0);
+		if (i >= __cyclesOnIter.size())
+			__cyclesOnIter.push_back(0);
 
 		//Create load workers and load worker threads
 		for (uint32_t t = 0; t < _num_worker_threads; t++) {
-			void* thread_mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + t*len_per_thread);
-			int32_t cpu_id = cpu_id_in_numa_node(_cpu_node, t);
+			int32_t cpu_id = t < _cpu_ids.size() ? _cpu_ids[t] : -1;
 			if (cpu_id < 0)
-				std::cerr << "WARNING: Failed to find logical CPU " << t << " in NUMA node " << _cpu_node << std::endl;
+				_reportWarning("No logical CPU was found for worker thread " + std::to_string(t));
 			if (t == 0) { //special case: thread 0 is always latency thread
-				workers.push_back(new LatencyWorker(thread_mem_array,
+				workers.push_back(new LatencyWorker(_mem_array,
 												    len_per_thread,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 												    _passes_per_iteration,
-#endif
 												    lat_kernel_fptr,
 												    lat_kernel_dummy_fptr,
 												    cpu_id));
 			} else {
-				if (_pattern_mode == SEQUENTIAL)
-					workers.push_back(new LoadWorker(thread_mem_array,
+				if (load_pattern_modes[t] == SEQUENTIAL)
+					workers.push_back(new LoadWorker(load_mem_arrays[t],
 													 len_per_thread,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 													 _passes_per_iteration,
-#endif
-													 load_kernel_fptr_seq,
-													 load_kernel_dummy_fptr_seq,
+													 load_kernel_fptrs_seq[t],
+													 load_kernel_dummy_fptrs_seq[t],
 													 cpu_id));
-				else if (_pattern_mode == RANDOM)
-					workers.push_back(new LoadWorker(thread_mem_array,
+				else if (load_pattern_modes[t] == RANDOM)
+					workers.push_back(new LoadWorker(load_mem_arrays[t],
 													 len_per_thread,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 													 _passes_per_iteration,
-#endif
-													 load_kernel_fptr_ran,
-													 load_kernel_dummy_fptr_ran,
+													 load_kernel_fptrs_ran[t],
+													 load_kernel_dummy_fptrs_ran[t],
 													 cpu_id));
 				else
-					std::cerr << "WARNING: Invalid benchmark pattern mode." << std::endl;
+					_reportWarning("Invalid benchmark pattern mode.");
+				const WorkerSpec* spec = _workerSpec(t, 1);
+				if (spec != NULL && spec->throttle_bytes_per_sec > 0)
+					static_cast<LoadWorker*>(workers[t])->setThrottle(spec->throttle_bytes_per_sec);
 			}
 			worker_threads.push_back(new Thread(workers[t]));
 		}
 
 		//Start worker threads! gogogo
+		_beginInterferenceCheck();
 		for (uint32_t t = 0; t < _num_worker_threads; t++)
 			worker_threads[t]->create_and_start();
 
 		//Wait for all threads to complete
 		for (uint32_t t = 0; t < _num_worker_threads; t++)
 			if (!worker_threads[t]->join())
-				std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+				_reportWarning("A worker thread failed to complete correctly!");
 		
 		//Compute metrics for this iteration
 		bool iter_warning = false;
@@ -345,71 +459,76 @@ bool LatencyBenchmark::_run_core() {
 		uint64_t lat_bytes_per_pass = workers[0]->getBytesPerPass();
 		uint64_t lat_accesses_per_pass = lat_bytes_per_pass / 8;
 		iter_warning |= workers[0]->hadWarning();
+		_recordWorker(i, workers[0], true, helper_timer.get_ns_per_tick());
 		
 		//Compute throughput generated by load threads
 		uint64_t load_total_passes = 0;
+		double load_total_bytes = 0;
 		uint64_t load_total_adjusted_ticks = 0;
 		uint64_t load_total_elapsed_dummy_ticks = 0;
 		uint64_t load_bytes_per_pass = 0;
 		double load_avg_adjusted_ticks = 0;
 		for (uint32_t t = 1; t < _num_worker_threads; t++) {
 			load_total_passes += workers[t]->getPasses();
+			load_total_bytes += static_cast<double>(workers[t]->getPasses()) * static_cast<double>(workers[t]->getBytesPerPass());
 			load_total_adjusted_ticks += workers[t]->getAdjustedTicks();
 			load_total_elapsed_dummy_ticks += workers[t]->getElapsedDummyTicks();
-			load_bytes_per_pass = workers[t]->getBytesPerPass(); //all should be the same.
+			load_bytes_per_pass = workers[t]->getBytesPerPass(); //all should be the same, unless load threads have their own workloads.
 			iter_warning |= workers[t]->hadWarning();
+			_recordWorker(i, workers[t], false, helper_timer.get_ns_per_tick());
 		}
 
 		//Compute load metrics for this iteration
 		load_avg_adjusted_ticks = static_cast<double>(load_total_adjusted_ticks) / (_num_worker_threads-1);
 		if (_num_worker_threads > 1)
-			__loadMetricOnIter[i] = (((static_cast<double>(load_total_passes) * static_cast<double>(load_bytes_per_pass)) / static_cast<double>(MB)))   /  ((load_avg_adjusted_ticks * helper_timer.get_ns_per_tick()) / 1e9);
+			__loadMetricOnIter[i] = (load_total_bytes / static_cast<double>(MB))   /  ((load_avg_adjusted_ticks * helper_timer.get_ns_per_tick()) / 1e9);
 
 		if (iter_warning)
 			_warning = true;
+		_endInterferenceCheck(i);
 	
-		if (g_verbose) { //Report metrics for this iteration
+		if (_info_log != NULL) { //Report metrics for this iteration
 			//Latency thread
-			std::cout << "Iter " << i+1 << " had " << lat_passes << " latency measurement passes, with " << lat_accesses_per_pass << " accesses per pass:";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+			*_info_log << "Iter " << i+1 << " had " << lat_passes << " latency measurement passes, with " << lat_accesses_per_pass << " accesses per pass:";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
 
-			std::cout << "...lat clock ticks == " << lat_adjusted_ticks << " (adjusted by -" << lat_elapsed_dummy_ticks << ")";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+			*_info_log << "...lat clock ticks == " << lat_adjusted_ticks << " (adjusted by -" << lat_elapsed_dummy_ticks << ")";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
 
-			std::cout << "...lat ns == " << lat_adjusted_ticks * helper_timer.get_ns_per_tick() << " (adjusted by -" << lat_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() << ")";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+			*_info_log << "...lat ns == " << lat_adjusted_ticks * helper_timer.get_ns_per_tick() << " (adjusted by -" << lat_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() << ")";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
 
-			std::cout << "...lat sec == " << lat_adjusted_ticks * helper_timer.get_ns_per_tick() / 1e9 << " (adjusted by -" << lat_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() / 1e9 << ")";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+			*_info_log << "...lat sec == " << lat_adjusted_ticks * helper_timer.get_ns_per_tick() / 1e9 << " (adjusted by -" << lat_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() / 1e9 << ")";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
 
 			//Load threads
 			if (_num_worker_threads > 1) {
-				std::cout << "Iter " << i+1 << " had " << load_total_passes << " total load generation passes, with " << load_bytes_per_pass << " bytes per pass:";
-				if (iter_warning) std::cout << " -- WARNING";
-				std::cout << std::endl;
+				*_info_log << "Iter " << i+1 << " had " << load_total_passes << " total load generation passes, with " << load_bytes_per_pass << " bytes per pass:";
+				if (iter_warning) *_info_log << " -- WARNING";
+				*_info_log << std::endl;
 
-				std::cout << "...load total clock ticks across " << _num_worker_threads-1 << " threads == " << load_total_adjusted_ticks << " (adjusted by -" << load_total_elapsed_dummy_ticks << ")";
-				if (iter_warning) std::cout << " -- WARNING";
-				std::cout << std::endl;
+				*_info_log << "...load total clock ticks across " << _num_worker_threads-1 << " threads == " << load_total_adjusted_ticks << " (adjusted by -" << load_total_elapsed_dummy_ticks << ")";
+				if (iter_warning) *_info_log << " -- WARNING";
+				*_info_log << std::endl;
 
-				std::cout << "...load total ns across " << _num_worker_threads-1 << " threads == " << load_total_adjusted_ticks * helper_timer.get_ns_per_tick() << " (adjusted by -" << load_total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() << ")";
-				if (iter_warning) std::cout << " -- WARNING";
-				std::cout << std::endl;
+				*_info_log << "...load total ns across " << _num_worker_threads-1 << " threads == " << load_total_adjusted_ticks * helper_timer.get_ns_per_tick() << " (adjusted by -" << load_total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() << ")";
+				if (iter_warning) *_info_log << " -- WARNING";
+				*_info_log << std::endl;
 
-				std::cout << "...load total sec across " << _num_worker_threads-1 << " threads == " << load_total_adjusted_ticks * helper_timer.get_ns_per_tick() / 1e9 << " (adjusted by -" << load_total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() / 1e9 << ")";
-				if (iter_warning) std::cout << " -- WARNING";
-				std::cout << std::endl;
+				*_info_log << "...load total sec across " << _num_worker_threads-1 << " threads == " << load_total_adjusted_ticks * helper_timer.get_ns_per_tick() / 1e9 << " (adjusted by -" << load_total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() / 1e9 << ")";
+				if (iter_warning) *_info_log << " -- WARNING";
+				*_info_log << std::endl;
 			}
 
 		}
 		
 		//Compute overall metrics for this iteration
 		_metricOnIter[i] = static_cast<double>(lat_adjusted_ticks * helper_timer.get_ns_per_tick())  /  static_cast<double>(lat_accesses_per_pass * lat_passes);
-		_averageMetric += _metricOnIter[i];
+		__cyclesOnIter[i] = _metricOnIter[i] * effective_frequency_ghz(workers[0]->getFrequencyRatio(), helper_timer.get_ns_per_tick());
 		__averageLoadMetric += __loadMetricOnIter[i];
 		
 		//Clean up workers and threads for this iteration
@@ -422,21 +541,31 @@ bool LatencyBenchmark::_run_core() {
 	}
 
 	//Stop power measurement
-	if (g_verbose) {
-		std::cout << std::endl;
-		std::cout << "Stopping power measurement threads...";
+	if (_info_log != NULL) {
+		*_info_log << std::endl;
+		*_info_log << "Stopping power measurement threads...";
 	}
 	
 	if (!_stop_power_threads()) {
-		if (g_verbose)
-			std::cout << "FAIL" << std::endl;
-		std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
-	} else if (g_verbose)
-		std::cout << "done" << std::endl;
+		if (_info_log != NULL)
+			*_info_log << "FAIL" << std::endl;
+		_reportWarning("Failed to stop power measurement threads.");
+	} else if (_info_log != NULL)
+		*_info_log << "done" << std::endl;
 	
 	//Run metadata
-	_averageMetric /= static_cast<double>(_iterations);
+	_finishIterations();
 	__averageLoadMetric /= static_cast<double>(_iterations);
+	__averageCycles = 0;
+	uint32_t num_cycles = 0;
+	for (uint32_t i = 0; i < _iterations; i++) {
+		if (__cyclesOnIter[i] > 0 && !_outlierOnIter[i]) {
+			__averageCycles += __cyclesOnIter[i];
+			num_cycles++;
+		}
+	}
+	if (num_cycles > 0)
+		__averageCycles /= static_cast<double>(num_cycles);
 	_hasRun = true;
 
 	return true;
@@ -32,9 +32,11 @@
 #include <benchmark_kernels.h>
 #include <common.h>
 #include <Timer.h>
+#include <FrequencyCounter.h>
 
 //Libraries
-#include <iostream>
+#include <string>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -50,9 +52,7 @@ using namespace xmem;
 LatencyWorker::LatencyWorker(
 		void* mem_array,
 		size_t len,
-	#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-	#endif
 		RandomFunction kernel_fptr,
 		RandomFunction kernel_dummy_fptr,
 		int32_t cpu_affinity
@@ -60,9 +60,7 @@ LatencyWorker::LatencyWorker(
 		MemoryWorker(
 			mem_array,
 			len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			passes_per_iteration,
-#endif
 			cpu_affinity
 		),
 		__kernel_fptr(kernel_fptr),
@@ -88,34 +86,48 @@ void LatencyWorker::run() {
 	uint64_t elapsed_dummy_ticks = 0;
 	uint64_t adjusted_ticks = 0;
 	bool warning = false;
+	std::vector<std::string> warning_messages; //Reported by the benchmark after the run, since this thread should not print
 		
-#ifdef USE_TIME_BASED_BENCHMARKS
 	void* mem_array = NULL;
 	size_t len = 0;
-	Timer helper_timer;
-	uint64_t target_ticks = helper_timer.get_ticks_per_sec() * BENCHMARK_DURATION_SEC; //Rough target run duration in seconds 
-#endif
+	benchmark_mode_t benchmark_mode = TIME_BASED;
+	uint64_t unroll_length = 0;
+	uint64_t target_ticks = 0;
+	FrequencyCounter frequency_counter;
+	bool count_frequency = false;
+	uint64_t aperf_start = 0, mperf_start = 0, aperf_stop = 0, mperf_stop = 0;
+	double frequency_ratio_measured = 0;
+	uint64_t switches_start = 0;
+	uint64_t switches_measured = 0;
 	
 	//Grab relevant setup state thread-safely and keep it local
 	if (_acquireLock(-1)) {
-#ifdef USE_TIME_BASED_BENCHMARKS
 		mem_array = _mem_array;
 		len = _len;
-#endif
-#ifdef USE_SIZE_BASED_BENCHMARKS
-		passes = _passes_per_iteration;
-#endif
-		bytes_per_pass = LATENCY_BENCHMARK_UNROLL_LENGTH * 8;
+		benchmark_mode = g_benchmark_mode;
+		unroll_length = g_latency_unroll_length;
+		if (benchmark_mode == TIME_BASED) {
+			bytes_per_pass = unroll_length * 8; //One kernel call per pass
+		} else {
+			bytes_per_pass = ((len / 8 + unroll_length - 1) / unroll_length) * unroll_length * 8; //One sweep of the working set per pass, rounded up to whole unrolled blocks
+			passes = _passes_per_iteration;
+		}
 		cpu_affinity = _cpu_affinity;
 		kernel_fptr = __kernel_fptr;
 		kernel_dummy_fptr = __kernel_dummy_fptr;
 		_releaseLock();
 	}
+
+	if (benchmark_mode == TIME_BASED) {
+		Timer helper_timer;
+		target_ticks = helper_timer.get_ticks_per_sec() * g_benchmark_duration_sec; //Rough target run duration in seconds 
+	}
 	
 	//Set processor affinity
 	bool locked = lock_thread_to_cpu(cpu_affinity);
 	if (!locked)
-		std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+		warning_messages.push_back("Failed to lock thread to logical CPU " + std::to_string(cpu_affinity) + "! Results may not be correct.");
+	count_frequency = locked && frequency_counter.open(cpu_affinity);
 
 	//Increase scheduling priority
 #ifdef _WIN32
@@ -126,7 +138,7 @@ void LatencyWorker::run() {
 #ifdef __gnu_linux__
 	if (!boostSchedulingPriority())
 #endif
-		std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+		warning_messages.push_back("Failed to boost scheduling priority. Perhaps running in Administrator mode would help.");
 
 	//Prime memory
 	for (uint64_t i = 0; i < 4; i++) {
@@ -136,45 +148,55 @@ void LatencyWorker::run() {
 	}
 
 	//Run benchmark
-#ifdef USE_TIME_BASED_BENCHMARKS
-	//Run actual version of function and loop overhead
-	next_address = static_cast<uintptr_t*>(mem_array); 
-	while (elapsed_ticks < target_ticks) {
+	if (benchmark_mode == TIME_BASED) {
+		//Run actual version of function and loop overhead
+		next_address = static_cast<uintptr_t*>(mem_array); 
+		switches_start = thread_involuntary_switches();
+		if (count_frequency)
+			count_frequency = frequency_counter.read(aperf_start, mperf_start);
+		while (elapsed_ticks < target_ticks) {
+			start_tick = start_timer();
+			UNROLL256((*kernel_fptr)(next_address, &next_address, 0);)
+			stop_tick = stop_timer();
+			elapsed_ticks += (stop_tick - start_tick);
+			passes+=256;
+		}
+		if (count_frequency && frequency_counter.read(aperf_stop, mperf_stop))
+			frequency_ratio_measured = frequency_ratio(aperf_start, mperf_start, aperf_stop, mperf_stop);
+		switches_measured = thread_involuntary_switches() - switches_start;
+
+		//Run dummy version of function and loop overhead
+		next_address = static_cast<uintptr_t*>(mem_array); 
+		while (p < passes) {
+			start_tick = start_timer();
+			UNROLL256((*kernel_dummy_fptr)(next_address, &next_address, 0);)
+			stop_tick = stop_timer();
+			elapsed_dummy_ticks += (stop_tick - start_tick);
+			p+=256;
+		}
+	} else { //SIZE_BASED
+		//Time actual version of function and loop overhead
+		next_address = static_cast<uintptr_t*>(mem_array); 
+		switches_start = thread_involuntary_switches();
+		if (count_frequency)
+			count_frequency = frequency_counter.read(aperf_start, mperf_start);
 		start_tick = start_timer();
-		UNROLL256((*kernel_fptr)(next_address, &next_address, 0);)
+		for (p = 0; p < passes; p++)
+			(*kernel_fptr)(next_address, &next_address, len);
 		stop_tick = stop_timer();
 		elapsed_ticks += (stop_tick - start_tick);
-		passes+=256;
-	}
+		if (count_frequency && frequency_counter.read(aperf_stop, mperf_stop))
+			frequency_ratio_measured = frequency_ratio(aperf_start, mperf_start, aperf_stop, mperf_stop);
+		switches_measured = thread_involuntary_switches() - switches_start;
 
-	//Run dummy version of function and loop overhead
-	next_address = static_cast<uintptr_t*>(mem_array); 
-	while (p < passes) {
+		//Time dummy version of function and loop overhead
+		next_address = static_cast<uintptr_t*>(mem_array); 
 		start_tick = start_timer();
-		UNROLL256((*kernel_dummy_fptr)(next_address, &next_address, 0);)
+		for (p = 0; p < passes; p++)
+			(*kernel_dummy_fptr)(next_address, &next_address, len);
 		stop_tick = stop_timer();
 		elapsed_dummy_ticks += (stop_tick - start_tick);
-		p+=256;
 	}
-#endif
-
-#ifdef USE_SIZE_BASED_BENCHMARKS
-	//Time actual version of function and loop overhead
-	next_address = static_cast<uintptr_t*>(mem_array); 
-	start_tick = start_timer();
-	for (p = 0; p < passes; p++)
-		(*kernel_fptr)(next_address, &next_address, len);
-	stop_tick = stop_timer();
-	elapsed_ticks += (start_tick - stop_tick);
-
-	//Time dummy version of function and loop overhead
-	next_address = static_cast<uintptr_t*>(_mem_array); 
-	start_tick = start_timer();
-	for (p = 0; p < passes; p++)
-		(*kernel_dummy_fptr)(next_address, &next_address, len);
-	stop_tick = stop_timer();
-	elapsed_dummy_ticks += (start_tick - stop_tick);
-#endif
 
 	adjusted_ticks = elapsed_ticks - elapsed_dummy_ticks;
 	
@@ -193,7 +215,7 @@ void LatencyWorker::run() {
 #ifdef __gnu_linux__
 	if (!revertSchedulingPriority())
 #endif
-		std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+		warning_messages.push_back("Failed to revert scheduling priority. Perhaps running in Administrator mode would help.");
 
 	//Update the object state thread-safely
 	if (_acquireLock(-1)) {
@@ -201,6 +223,9 @@ void LatencyWorker::run() {
 		_elapsed_ticks = elapsed_ticks;
 		_elapsed_dummy_ticks = elapsed_dummy_ticks;
 		_warning = warning;
+		_warning_messages = warning_messages;
+		_frequency_ratio = frequency_ratio_measured;
+		_involuntary_switches = switches_measured;
 		_bytes_per_pass = bytes_per_pass;
 		_completed = true;
 		_passes = passes;
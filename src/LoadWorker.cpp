@@ -32,9 +32,13 @@
 #include <benchmark_kernels.h>
 #include <common.h>
 #include <Timer.h>
+#include <FrequencyCounter.h>
 
 //Libraries
-#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -47,12 +51,122 @@
 
 using namespace xmem;
 
+/**
+ * @brief Waits until enough time has passed for the bytes accessed so far to be within a target rate.
+ * @param base_tick Timer tick when the rate took effect.
+ * @param bytes Bytes accessed since base_tick.
+ * @param bytes_per_sec Target rate in bytes per second.
+ * @param ticks_per_sec Timer ticks per second.
+ */
+static void pace_to_rate(uint64_t base_tick, uint64_t bytes, uint64_t bytes_per_sec, uint64_t ticks_per_sec) {
+	uint64_t due_tick = base_tick + static_cast<uint64_t>(static_cast<double>(bytes) / static_cast<double>(bytes_per_sec) * static_cast<double>(ticks_per_sec));
+	while (true) {
+		uint64_t now_tick = start_timer();
+		if (now_tick >= due_tick)
+			return;
+		double remaining_sec = static_cast<double>(due_tick - now_tick) / static_cast<double>(ticks_per_sec);
+		if (remaining_sec > 0.001) //Sleep through long gaps, and spin through short ones where sleeping would overshoot
+			std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>((remaining_sec - 0.0005) * 1e6)));
+	}
+}
+
+typedef void(*SequentialBlockFunction)(SequentialFunction, uint8_t*, size_t, size_t, size_t&); /**< Runs one timed block of passes of a sequential kernel. */
+typedef void(*RandomBlockFunction)(RandomFunction, uintptr_t*&); /**< Runs one timed block of calls to a random kernel. */
+
+/**
+ * @brief Advances to the next pass of a sequential kernel, wrapping around to the start of the working set before a pass would run past its end. This is branch-free.
+ * @param offset Offset of the current pass from the start of the working set, in bytes.
+ * @param bytes_per_pass Length of each pass in bytes.
+ * @param len Length of the working set in bytes.
+ * @returns The offset of the next pass.
+ */
+static inline size_t next_pass_offset(size_t offset, size_t bytes_per_pass, size_t len) {
+	offset += bytes_per_pass;
+	return offset & (0 - static_cast<size_t>(offset + bytes_per_pass <= len)); //all ones keeps the offset, zero wraps around
+}
+
+/**
+ * @brief Runs one timed block of 1024 passes of a sequential kernel that is known at compile time, so that the block makes no indirect calls.
+ * @param mem_array Start of the working set.
+ * @param len Length of the working set in bytes.
+ * @param bytes_per_pass Length of each pass in bytes.
+ * @param offset Offset of the next pass. Updated to the pass after the block.
+ */
+template<SequentialFunction Kernel>
+static void sequential_block(SequentialFunction, uint8_t* mem_array, size_t len, size_t bytes_per_pass, size_t& offset) {
+	size_t pass_offset = offset; //kept in a register, since the kernel could alias offset
+	for (uint32_t i = 0; i < 1024; i++) {
+		Kernel(mem_array + pass_offset, mem_array + pass_offset + bytes_per_pass);
+		pass_offset = next_pass_offset(pass_offset, bytes_per_pass, len);
+	}
+	offset = pass_offset;
+}
+
+/**
+ * @brief Runs one timed block of 1024 passes of any sequential kernel through its function pointer.
+ * @param kernel The kernel.
+ * @param mem_array Start of the working set.
+ * @param len Length of the working set in bytes.
+ * @param bytes_per_pass Length of each pass in bytes.
+ * @param offset Offset of the next pass. Updated to the pass after the block.
+ */
+static void generic_sequential_block(SequentialFunction kernel, uint8_t* mem_array, size_t len, size_t bytes_per_pass, size_t& offset) {
+	size_t pass_offset = offset; //kept in a register, since the kernel could alias offset
+	for (uint32_t i = 0; i < 1024; i++) {
+		(*kernel)(mem_array + pass_offset, mem_array + pass_offset + bytes_per_pass);
+		pass_offset = next_pass_offset(pass_offset, bytes_per_pass, len);
+	}
+	offset = pass_offset;
+}
+
+/**
+ * @brief Runs one timed block of 256 calls to a random kernel that is known at compile time, so that the block makes no indirect calls.
+ * @param next_address Address to start chasing from. Updated to where the block left off.
+ */
+template<RandomFunction Kernel>
+static void random_block(RandomFunction, uintptr_t*& next_address) {
+	for (uint32_t i = 0; i < 256; i++)
+		Kernel(next_address, &next_address, 0);
+}
+
+/**
+ * @brief Runs one timed block of 256 calls to any random kernel through its function pointer.
+ * @param kernel The kernel.
+ * @param next_address Address to start chasing from. Updated to where the block left off.
+ */
+static void generic_random_block(RandomFunction kernel, uintptr_t*& next_address) {
+	for (uint32_t i = 0; i < 256; i++)
+		(*kernel)(next_address, &next_address, 0);
+}
+
+/**
+ * @brief Finds the block function made for a sequential kernel.
+ * @param kernel The kernel.
+ * @returns The block function specialized for the kernel, or one that calls through the function pointer if the kernel is not a built-in one.
+ */
+static SequentialBlockFunction sequential_block_for(SequentialFunction kernel) {
+#define SEQUENTIAL_BLOCK_FOR(name) if (kernel == &name) return &sequential_block<&name>;
+	XMEM_SEQUENTIAL_KERNELS(SEQUENTIAL_BLOCK_FOR)
+#undef SEQUENTIAL_BLOCK_FOR
+	return &generic_sequential_block;
+}
+
+/**
+ * @brief Finds the block function made for a random kernel.
+ * @param kernel The kernel.
+ * @returns The block function specialized for the kernel, or one that calls through the function pointer if the kernel is not a built-in one.
+ */
+static RandomBlockFunction random_block_for(RandomFunction kernel) {
+#define RANDOM_BLOCK_FOR(name) if (kernel == &name) return &random_block<&name>;
+	XMEM_RANDOM_KERNELS(RANDOM_BLOCK_FOR)
+#undef RANDOM_BLOCK_FOR
+	return &generic_random_block;
+}
+
 LoadWorker::LoadWorker(
 		void* mem_array,
 		size_t len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-#endif
 		SequentialFunction kernel_fptr,
 		SequentialFunction kernel_dummy_fptr,
 		int32_t cpu_affinity
@@ -60,25 +174,25 @@ LoadWorker::LoadWorker(
 		MemoryWorker(
 			mem_array,
 			len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			passes_per_iteration,
-#endif
 			cpu_affinity
 		),
 		__use_sequential_kernel_fptr(true),
 		__kernel_fptr_seq(kernel_fptr),
 		__kernel_dummy_fptr_seq(kernel_dummy_fptr),
 		__kernel_fptr_ran(NULL),
-		__kernel_dummy_fptr_ran(NULL)
+		__kernel_dummy_fptr_ran(NULL),
+		__free_running(false),
+		__trace(NULL),
+		__throttle_bytes_per_sec(0),
+		__live_passes(0)
 	{
 }
 
 LoadWorker::LoadWorker(
 		void* mem_array,
 		size_t len,
-	#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-	#endif
 		RandomFunction kernel_fptr,
 		RandomFunction kernel_dummy_fptr,
 		int32_t cpu_affinity
@@ -86,20 +200,52 @@ LoadWorker::LoadWorker(
 		MemoryWorker(
 			mem_array,
 			len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			passes_per_iteration,
-#endif
 			cpu_affinity
 		),
 		__use_sequential_kernel_fptr(false),
 		__kernel_fptr_seq(NULL),
 		__kernel_dummy_fptr_seq(NULL),
 		__kernel_fptr_ran(kernel_fptr),
-		__kernel_dummy_fptr_ran(kernel_fptr)
+		__kernel_dummy_fptr_ran(kernel_fptr),
+		__free_running(false),
+		__trace(NULL),
+		__throttle_bytes_per_sec(0),
+		__live_passes(0)
 	{
 }
 
 LoadWorker::~LoadWorker() {
+	if (__trace != NULL)
+		delete __trace;
+}
+
+void LoadWorker::setFreeRunning() {
+	if (_acquireLock(-1)) {
+		__free_running = true;
+		_releaseLock();
+	}
+}
+
+void LoadWorker::setThrottle(uint64_t bytes_per_sec) {
+	__throttle_bytes_per_sec.store(bytes_per_sec, std::memory_order_relaxed);
+}
+
+uint64_t LoadWorker::getLivePasses() const {
+	return __live_passes.load(std::memory_order_relaxed);
+}
+
+void LoadWorker::enableTrace(uint64_t period_ticks, size_t capacity) {
+	if (_acquireLock(-1)) {
+		if (__trace != NULL)
+			delete __trace;
+		__trace = new BandwidthTrace(capacity, period_ticks);
+		_releaseLock();
+	}
+}
+
+const BandwidthTrace* LoadWorker::getTrace() const {
+	return __trace;
 }
 
 void LoadWorker::run() {
@@ -122,26 +268,36 @@ void LoadWorker::run() {
 	uint64_t elapsed_dummy_ticks = 0;
 	uint64_t adjusted_ticks = 0;
 	bool warning = false;
+	std::vector<std::string> warning_messages; //Reported by the benchmark after the run, since this thread should not print
+	WorkerGroupSync* group_sync = NULL;
 
-#ifdef USE_TIME_BASED_BENCHMARKS
 	void* mem_array = NULL;
 	size_t len = 0;
-	Timer helper_timer;
-	uint64_t target_ticks = helper_timer.get_ticks_per_sec() * BENCHMARK_DURATION_SEC; //Rough target run duration in seconds 
+	benchmark_mode_t benchmark_mode = TIME_BASED;
+	uint64_t target_ticks = 0;
+	uint64_t ticks_per_sec = 0;
+	bool free_running = false;
+	BandwidthTrace* trace = NULL;
+	FrequencyCounter frequency_counter;
+	bool count_frequency = false;
+	uint64_t aperf_start = 0, mperf_start = 0, aperf_stop = 0, mperf_stop = 0;
+	double frequency_ratio_measured = 0;
+	uint64_t switches_start = 0;
+	uint64_t switches_measured = 0;
 	uint64_t p = 0;
-	bytes_per_pass = THROUGHPUT_BENCHMARK_BYTES_PER_PASS;
-#endif
 	
 	//Grab relevant setup state thread-safely and keep it local
 	if (_acquireLock(-1)) {
-#ifdef USE_TIME_BASED_BENCHMARKS
 		mem_array = _mem_array;
 		len = _len;
-#endif
-#ifdef USE_SIZE_BASED_BENCHMARKS
-		bytes_per_pass = _len;
-		passes = _passes_per_iteration;
-#endif
+		free_running = __free_running && _group_sync != NULL;
+		benchmark_mode = free_running ? TIME_BASED : g_benchmark_mode;
+		if (benchmark_mode == TIME_BASED) {
+			bytes_per_pass = g_throughput_bytes_per_pass;
+		} else {
+			bytes_per_pass = _len;
+			passes = _passes_per_iteration;
+		}
 		cpu_affinity = _cpu_affinity;
 		use_sequential_kernel_fptr = __use_sequential_kernel_fptr;
 		kernel_fptr_seq = __kernel_fptr_seq;
@@ -152,13 +308,25 @@ void LoadWorker::run() {
 		end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array)+bytes_per_pass);
 		prime_start_address = _mem_array; 
 		prime_end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + _len);
+		group_sync = _group_sync;
+		trace = __trace;
 		_releaseLock();
 	}
+
+	if (benchmark_mode == TIME_BASED) {
+		Timer helper_timer;
+		ticks_per_sec = helper_timer.get_ticks_per_sec();
+		if (free_running)
+			target_ticks = UINT64_MAX; //Only the group stop ends the run
+		else
+			target_ticks = ticks_per_sec * g_benchmark_duration_sec; //Rough target run duration in seconds 
+	}
 	
 	//Set processor affinity
 	bool locked = lock_thread_to_cpu(cpu_affinity);
 	if (!locked)
-		std::cerr << "WARNING: Failed to lock thread to logical CPU " << cpu_affinity << "! Results may not be correct." << std::endl;
+		warning_messages.push_back("Failed to lock thread to logical CPU " + std::to_string(cpu_affinity) + "! Results may not be correct.");
+	count_frequency = locked && frequency_counter.open(cpu_affinity);
 
 	//Increase scheduling priority
 #ifdef _WIN32
@@ -169,84 +337,124 @@ void LoadWorker::run() {
 #ifdef __gnu_linux__
 	if (!boostSchedulingPriority())
 #endif
-		std::cerr << "WARNING: Failed to boost scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+		warning_messages.push_back("Failed to boost scheduling priority. Perhaps running in Administrator mode would help.");
 
 	//Prime memory
 	for (uint64_t i = 0; i < 4; i++) {
 		forwSequentialRead_Word64(prime_start_address, prime_end_address); //dependent reads on the memory, make sure caches are ready, coherence, etc...
 	}
 
+	//Wait for the rest of the group, if any, so that all timed sections overlap
+	if (group_sync != NULL)
+		group_sync->arriveAndWait();
+
 	//Run the benchmark!
 	uintptr_t* next_address = static_cast<uintptr_t*>(mem_array);
-#ifdef USE_TIME_BASED_BENCHMARKS
-	//Run actual version of function and loop overhead
-	while (elapsed_ticks < target_ticks) {
+	if (benchmark_mode == TIME_BASED) {
+		//Each block runs the kernel through a loop specialized for it, and the dummy through an identical one
+		SequentialBlockFunction seq_block = use_sequential_kernel_fptr ? sequential_block_for(kernel_fptr_seq) : NULL;
+		SequentialBlockFunction dummy_seq_block = use_sequential_kernel_fptr ? sequential_block_for(kernel_dummy_fptr_seq) : NULL;
+		RandomBlockFunction ran_block = use_sequential_kernel_fptr ? NULL : random_block_for(kernel_fptr_ran);
+		RandomBlockFunction dummy_ran_block = use_sequential_kernel_fptr ? NULL : random_block_for(kernel_dummy_fptr_ran);
+		size_t offset = 0;
+		uint64_t throttle_bytes_per_sec = 0;
+		uint64_t throttle_base_tick = 0;
+		uint64_t throttle_base_passes = 0;
+		switches_start = thread_involuntary_switches();
+		if (count_frequency)
+			count_frequency = frequency_counter.read(aperf_start, mperf_start);
+		uint64_t window_start_tick = start_timer();
+		uint64_t window_ticks = 0;
+		if (trace != NULL)
+			trace->begin(window_start_tick, bytes_per_pass);
+
+		//Run actual version of function and loop overhead
+		while (window_ticks < target_ticks && (group_sync == NULL || !group_sync->stopRequested())) {
+			//Pace to the throttle, if any, outside of the timed section. A rate change starts a new pacing baseline.
+			uint64_t rate = __throttle_bytes_per_sec.load(std::memory_order_relaxed);
+			if (rate != throttle_bytes_per_sec) {
+				throttle_bytes_per_sec = rate;
+				throttle_base_tick = start_timer();
+				throttle_base_passes = passes;
+			}
+			if (throttle_bytes_per_sec > 0)
+				pace_to_rate(throttle_base_tick, (passes - throttle_base_passes) * bytes_per_pass, throttle_bytes_per_sec, ticks_per_sec);
+
+			start_tick = start_timer();
+			if (use_sequential_kernel_fptr) //sequential function semantics
+				(*seq_block)(kernel_fptr_seq, static_cast<uint8_t*>(mem_array), len, bytes_per_pass, offset);
+			else //random function semantics
+				(*ran_block)(kernel_fptr_ran, next_address);
+			stop_tick = stop_timer();
+			elapsed_ticks += (stop_tick - start_tick);
+			passes+=1024;
+			__live_passes.store(passes, std::memory_order_relaxed);
+			if (trace != NULL)
+				trace->sample(stop_tick, passes);
+			window_ticks = throttle_bytes_per_sec > 0 ? stop_tick - window_start_tick : elapsed_ticks; //A throttled worker spends most of its window asleep
+		}
+
+		//A throttled worker's throughput is the rate it achieved over the whole window, not its speed while in the kernel. The window lasts until the next block would have been due, since the last block ran ahead of its share of time.
+		if (throttle_bytes_per_sec > 0) {
+			uint64_t due_tick = throttle_base_tick + static_cast<uint64_t>(static_cast<double>((passes - throttle_base_passes) * bytes_per_pass) / static_cast<double>(throttle_bytes_per_sec) * static_cast<double>(ticks_per_sec));
+			elapsed_ticks = (due_tick > stop_tick ? due_tick : stop_tick) - window_start_tick;
+		}
+
+		//The first worker in a group to finish ends the measurement window for everyone
+		if (group_sync != NULL)
+			group_sync->requestStop();
+		if (count_frequency && frequency_counter.read(aperf_stop, mperf_stop))
+			frequency_ratio_measured = frequency_ratio(aperf_start, mperf_start, aperf_stop, mperf_stop);
+		switches_measured = thread_involuntary_switches() - switches_start;
+
+		//Run dummy version of function and loop overhead. Load generation does not need it, and neither does a throttled worker, whose window is wall clock time.
+		p = (free_running || throttle_bytes_per_sec > 0) ? passes : 0;
+		offset = 0;
+		next_address = static_cast<uintptr_t*>(mem_array);
+		while (p < passes) {
+			start_tick = start_timer();
+			if (use_sequential_kernel_fptr) //sequential function semantics
+				(*dummy_seq_block)(kernel_dummy_fptr_seq, static_cast<uint8_t*>(mem_array), len, bytes_per_pass, offset);
+			else //random function semantics
+				(*dummy_ran_block)(kernel_dummy_fptr_ran, next_address);
+
+			stop_tick = stop_timer();
+			elapsed_dummy_ticks += (stop_tick - start_tick);
+			p+=1024;
+		}
+	} else { //SIZE_BASED
+		next_address = static_cast<uintptr_t*>(mem_array);
+		switches_start = thread_involuntary_switches();
+		if (count_frequency)
+			count_frequency = frequency_counter.read(aperf_start, mperf_start);
 		start_tick = start_timer();
 		if (use_sequential_kernel_fptr) { //sequential function semantics
-			UNROLL1024(
+			for (p = 0; p < passes; p++)
 				(*kernel_fptr_seq)(start_address, end_address);
-				start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uint64_t>(start_address)+bytes_per_pass) % len);
-				end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
-			)
 		} else { //random function semantics
-			UNROLL256((*kernel_fptr_ran)(next_address, &next_address, 0);)
+			for (p = 0; p < passes; p++)
+				(*kernel_fptr_ran)(next_address, &next_address, 0);
 		}
 		stop_tick = stop_timer();
-		elapsed_ticks += (stop_tick - start_tick);
-		passes+=1024;
-	}
+		elapsed_ticks = stop_tick - start_tick;
+		if (count_frequency && frequency_counter.read(aperf_stop, mperf_stop))
+			frequency_ratio_measured = frequency_ratio(aperf_start, mperf_start, aperf_stop, mperf_stop);
+		switches_measured = thread_involuntary_switches() - switches_start;
 
-	//Run dummy version of function and loop overhead
-	p = 0;
-	start_address = mem_array;
-	end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + bytes_per_pass);
-	next_address = static_cast<uintptr_t*>(mem_array);
-	while (p < passes) {
+		//Time dummy version of function and loop overhead
+		next_address = static_cast<uintptr_t*>(mem_array);
 		start_tick = start_timer();
 		if (use_sequential_kernel_fptr) { //sequential function semantics
-			UNROLL1024(
+			for (p = 0; p < passes; p++)
 				(*kernel_dummy_fptr_seq)(start_address, end_address);
-				start_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array)+(reinterpret_cast<uint64_t>(start_address)+bytes_per_pass) % len);
-				end_address = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(start_address) + bytes_per_pass);
-			)
 		} else { //random function semantics
-			UNROLL256((*kernel_dummy_fptr_ran)(next_address, &next_address, 0);)
+			for (p = 0; p < passes; p++)
+				(*kernel_dummy_fptr_ran)(next_address, &next_address, 0);
 		}
-
 		stop_tick = stop_timer();
-		elapsed_dummy_ticks += (stop_tick - start_tick);
-		p+=1024;
+		elapsed_dummy_ticks = stop_tick - start_tick;
 	}
 
-#endif
-
-#ifdef USE_SIZE_BASED_BENCHMARKS
-	next_address = static_cast<uintptr_t*>(mem_array);
-	start_tick = start_timer();
-	if (use_sequential_kernel_fptr) { //sequential function semantics
-		for (uint64_t p = 0; p < __passes_per_iteration; p++)
-			(*kernel_fptr_seq)(start_address, end_address);
-	} else { //random function semantics
-		for (uint64_t p = 0; p < __passes_per_iteration; p++)
-			(*kernel_fptr_ran)(next_address, &next_address, 0);
-	}
-	stop_tick = stop_timer();
-	elapsed_ticks = stop_tick - start_tick;
-
-	//Time dummy version of function and loop overhead
-	next_address = static_cast<uintptr_t*>(mem_array);
-	start_tick = start_timer();
-	if (use_sequential_kernel_fptr) { //sequential function semantics
-		for (uint64_t p = 0; p < __passes_per_iteration; p++)
-			(*kernel_dummy_fptr_seq)(start_address, end_address);
-	} else { //random function semantics
-		for (uint64_t p = 0; p < __passes_per_iteration; p++)
-			(*kernel_dummy_fptr_ran)(next_address, &next_address, 0);
-	}
-	stop_tick = stop_timer();
-	elapsed_dummy_ticks = stop_tick - start_tick;
-#endif
-
 	//Unset processor affinity
 	if (locked)
 		unlock_thread_to_numa_node();
@@ -258,7 +466,7 @@ void LoadWorker::run() {
 #ifdef __gnu_linux__
 	if (!revertSchedulingPriority())
 #endif
-		std::cerr << "WARNING: Failed to revert scheduling priority. Perhaps running in Administrator mode would help." << std::endl;
+		warning_messages.push_back("Failed to revert scheduling priority. Perhaps running in Administrator mode would help.");
 
 	adjusted_ticks = elapsed_ticks - elapsed_dummy_ticks;
 	
@@ -272,6 +480,9 @@ void LoadWorker::run() {
 		_elapsed_ticks = elapsed_ticks;
 		_elapsed_dummy_ticks = elapsed_dummy_ticks;
 		_warning = warning;
+		_warning_messages = warning_messages;
+		_frequency_ratio = frequency_ratio_measured;
+		_involuntary_switches = switches_measured;
 		_bytes_per_pass = bytes_per_pass;
 		_completed = true;
 		_passes = passes;
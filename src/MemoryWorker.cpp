@@ -32,12 +32,36 @@
 
 using namespace xmem;
 
+WorkerGroupSync::WorkerGroupSync(
+		uint32_t num_workers
+	) :
+		__num_workers(num_workers),
+		__num_arrived(0),
+		__go(false),
+		__stop(false)
+	{
+}
+
+void WorkerGroupSync::arriveAndWait() {
+	if (__num_arrived.fetch_add(1) + 1 >= __num_workers) //last one in opens the gate
+		__go.store(true);
+	while (!__go.load())
+		;
+}
+
+void WorkerGroupSync::requestStop() {
+	__stop.store(true);
+	__go.store(true); //workers still at the start gate must not wait for ones that will never arrive
+}
+
+bool WorkerGroupSync::stopRequested() const {
+	return __stop.load();
+}
+
 MemoryWorker::MemoryWorker(
 		void* mem_array,
 		size_t len,
-	#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-	#endif
 		int32_t cpu_affinity
 	) :
 		_mem_array(mem_array),
@@ -49,10 +73,12 @@ MemoryWorker::MemoryWorker(
 		_elapsed_dummy_ticks(0),
 		_adjusted_ticks(0),
 		_warning(false),
-#ifdef USE_SIZE_BASED_BENCHMARKS
-		_passes_per_iteration(passes_per_iteration),
-#endif
-		_completed(false)
+		_warning_messages(),
+		_frequency_ratio(0),
+		_involuntary_switches(0),
+		_completed(false),
+		_group_sync(NULL),
+		_passes_per_iteration(passes_per_iteration)
 	{
 }
 
@@ -79,6 +105,16 @@ uint64_t MemoryWorker::getBytesPerPass() {
 	return retval;
 }
 
+int32_t MemoryWorker::getCPUAffinity() {
+	int32_t retval = -1;
+	if (_acquireLock(-1)) {
+		retval = _cpu_affinity;
+		_releaseLock();
+	}
+
+	return retval;
+}
+
 uint64_t MemoryWorker::getPasses() {
 	size_t retval = 0;
 	if (_acquireLock(-1)) {
@@ -128,3 +164,40 @@ bool MemoryWorker::hadWarning() {
 
 	return retval;
 }
+
+std::vector<std::string> MemoryWorker::getWarningMessages() {
+	std::vector<std::string> retval;
+	if (_acquireLock(-1)) {
+		retval = _warning_messages;
+		_releaseLock();
+	}
+
+	return retval;
+}
+
+double MemoryWorker::getFrequencyRatio() {
+	double retval = 0;
+	if (_acquireLock(-1)) {
+		retval = _frequency_ratio;
+		_releaseLock();
+	}
+
+	return retval;
+}
+
+uint64_t MemoryWorker::getInvoluntarySwitches() {
+	uint64_t retval = 0;
+	if (_acquireLock(-1)) {
+		retval = _involuntary_switches;
+		_releaseLock();
+	}
+
+	return retval;
+}
+
+void MemoryWorker::setGroupSync(WorkerGroupSync* group_sync) {
+	if (_acquireLock(-1)) {
+		_group_sync = group_sync;
+		_releaseLock();
+	}
+}
@@ -0,0 +1,197 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the MetricsServer class.
+ */
+
+//Headers
+#include <MetricsServer.h>
+
+//Libraries
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#ifdef __gnu_linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+using namespace xmem;
+
+MetricsServer::MetricsServer(uint16_t port) :
+	Runnable(),
+	__port(port),
+	__socket(-1),
+	__metrics(),
+	__stop(false)
+{
+}
+
+MetricsServer::~MetricsServer() {
+#ifdef __gnu_linux__
+	if (__socket >= 0)
+		close(__socket);
+#endif
+}
+
+bool MetricsServer::listen() {
+#ifdef __gnu_linux__
+	int sock = socket(AF_INET, SOCK_STREAM, 0);
+	if (sock < 0) {
+		std::cerr << "ERROR: Failed to create a socket for the Prometheus endpoint." << std::endl;
+		return false;
+	}
+	int reuse = 1;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	//Only serve locally. A scraper on another host can go through a local agent or the textfile instead.
+	struct sockaddr_in addr;
+	std::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(__port);
+	if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(sock, 8) != 0) {
+		std::cerr << "ERROR: Failed to listen on 127.0.0.1:" << __port << " for the Prometheus endpoint. Is the port in use?" << std::endl;
+		close(sock);
+		return false;
+	}
+
+	if (_acquireLock(-1)) {
+		__socket = sock;
+		_releaseLock();
+	}
+	return true;
+#else
+	std::cerr << "ERROR: The Prometheus HTTP endpoint is only supported on GNU/Linux." << std::endl;
+	return false;
+#endif
+}
+
+void MetricsServer::run() {
+#ifdef __gnu_linux__
+	int sock = -1;
+	if (_acquireLock(-1)) {
+		sock = __socket;
+		_releaseLock();
+	}
+	if (sock < 0)
+		return;
+
+	while (true) {
+		bool stop = true;
+		if (_acquireLock(-1)) {
+			stop = __stop;
+			_releaseLock();
+		}
+		if (stop)
+			break;
+
+		//Wake up regularly to notice stop()
+		struct pollfd pfd;
+		pfd.fd = sock;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, 500) <= 0)
+			continue;
+
+		int client = accept(sock, NULL, NULL);
+		if (client < 0)
+			continue;
+		__serveClient(client);
+		close(client);
+	}
+#endif
+}
+
+void MetricsServer::setMetrics(const std::string& text) {
+	if (_acquireLock(-1)) {
+		__metrics = text;
+		_releaseLock();
+	}
+}
+
+void MetricsServer::stop() {
+	if (_acquireLock(-1)) {
+		__stop = true;
+		_releaseLock();
+	}
+}
+
+void MetricsServer::__serveClient(int client) {
+#ifdef __gnu_linux__
+	//A slow or idle client must not hold up the daemon
+	struct timeval timeout;
+	timeout.tv_sec = 1;
+	timeout.tv_usec = 0;
+	setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	//Only the request line matters. Headers are read and ignored.
+	std::string request;
+	char buffer[1024];
+	while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+		ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+		if (received <= 0)
+			break;
+		request.append(buffer, static_cast<size_t>(received));
+	}
+
+	std::string body;
+	std::string status;
+	if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0) {
+		status = "200 OK";
+		if (_acquireLock(-1)) {
+			body = __metrics;
+			_releaseLock();
+		}
+	} else {
+		status = "404 Not Found";
+		body = "Metrics are served at /metrics\n";
+	}
+
+	std::ostringstream response;
+	response << "HTTP/1.0 " << status << "\r\n"
+			 << "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+			 << "Content-Length: " << body.size() << "\r\n"
+			 << "Connection: close\r\n\r\n"
+			 << body;
+	std::string text = response.str();
+	size_t sent = 0;
+	while (sent < text.size()) {
+		ssize_t n = send(client, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0)
+			break;
+		sent += static_cast<size_t>(n);
+	}
+#endif
+}
@@ -0,0 +1,326 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the MonitorDaemon class.
+ */
+
+//Headers
+#include <MonitorDaemon.h>
+#include <common.h>
+#include <libxmem.h>
+#include <BenchmarkResult.h>
+#include <Topology.h>
+
+//Libraries
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace xmem;
+
+/**
+ * @brief Formats the labels that identify a probe's time series.
+ * @param probe The probe.
+ * @returns The label set including braces.
+ */
+static std::string probe_labels(const MonitorProbe& probe) {
+	std::ostringstream labels;
+	labels << "{probe=\"" << (probe.spec.latency ? "latency" : "throughput") << "\"";
+	labels << ",cpu_node=\"" << probe.spec.cpu_node << "\",mem_node=\"" << probe.spec.mem_node << "\"";
+	if (!probe.spec.latency)
+		labels << ",rw=\"" << (probe.spec.rw_mode == READ ? "read" : "write") << "\",chunk_bits=\"" << chunk_size_bits(probe.spec.chunk_size) << "\"";
+	labels << "}";
+	return labels.str();
+}
+
+MonitorDaemon::MonitorDaemon(Configurator& config) :
+	__config(config),
+	__probes(),
+	__server(NULL),
+	__server_thread(NULL),
+	__busy_sec(0),
+	__start_ns(0)
+{
+}
+
+MonitorDaemon::~MonitorDaemon() {
+	if (__server_thread != NULL) {
+		__server->stop();
+		__server_thread->join();
+		delete __server_thread;
+	}
+	if (__server != NULL)
+		delete __server;
+}
+
+bool MonitorDaemon::run() {
+	if (!__setupProbes())
+		return false;
+
+	if (__config.getPrometheusPort() > 0) {
+		__server = new MetricsServer(static_cast<uint16_t>(__config.getPrometheusPort()));
+		if (!__server->listen())
+			return false;
+		__server_thread = new Thread(__server);
+		if (!__server_thread->create_and_start()) {
+			std::cerr << "ERROR: Failed to start the Prometheus endpoint thread." << std::endl;
+			return false;
+		}
+	}
+
+	catch_stop_signals(true);
+
+	__start_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	__busy_sec = 0;
+	__publish(); //Let scrapers see the daemon before the first probe finishes
+
+	std::cout << std::endl << "Running as a monitoring daemon with " << __probes.size() << " probes. Send SIGINT or SIGTERM to stop." << std::endl;
+
+	double round_start = -1;
+	bool running = true;
+	while (running) {
+		for (size_t i = 0; i < __probes.size() && running; i++) {
+			//Stay within the budget: probes may only have run for a fraction of the time elapsed so far
+			double earliest = __busy_sec / __config.getDaemonBudget();
+			if (i == 0 && round_start >= 0)
+				earliest = std::max(earliest, round_start + __config.getDaemonInterval());
+			if (!__waitUntil(earliest)) {
+				running = false;
+				break;
+			}
+			if (i == 0)
+				round_start = __elapsed();
+
+			__runProbe(__probes[i]);
+			__publish();
+			running = !stop_signal_received();
+		}
+	}
+
+	catch_stop_signals(false);
+	std::cout << std::endl << "Monitoring daemon stopped after " << __elapsed() << " s, of which " << __busy_sec << " s were spent probing." << std::endl;
+	return true;
+}
+
+bool MonitorDaemon::__setupProbes() {
+	std::vector<uint32_t> mem_nodes;
+	if (__config.isNUMAEnabled()) {
+		for (uint32_t node = 0; node < g_num_nodes; node++)
+			if (g_topology.nodeHasMemory(node))
+				mem_nodes.push_back(node);
+	} else
+		mem_nodes.push_back(0);
+
+	BenchmarkSpec base = default_benchmark_spec();
+	base.working_set_size_per_thread = __config.getWorkingSetSizePerThread();
+	base.iterations = __config.getIterationsPerTest();
+	base.num_worker_threads = 1; //One thread keeps the probe's share of CPU and bandwidth small
+	base.pattern_mode = (__config.useSequentialAccessPattern() || !__config.useRandomAccessPattern()) ? SEQUENTIAL : RANDOM;
+	base.rw_mode = __config.useReads() ? READ : WRITE;
+	if (__config.useChunk64b())
+		base.chunk_size = CHUNK_64b;
+	else if (__config.useChunk32b())
+		base.chunk_size = CHUNK_32b;
+	else if (__config.useChunk128b())
+		base.chunk_size = CHUNK_128b;
+	else if (__config.useChunk256b())
+		base.chunk_size = CHUNK_256b;
+
+	for (uint32_t i = 0; i < mem_nodes.size(); i++) {
+		base.mem_node = mem_nodes[i];
+		//Probe from the nearest CPUs, i.e. the node's own CPUs unless it is a memory-only node
+		base.cpu_node = 0;
+		if (__config.isNUMAEnabled()) {
+			std::vector<uint32_t> order = cpu_placement_order(base.mem_node, PLACEMENT_COMPACT);
+			int32_t node = order.empty() ? -1 : numa_node_of_cpu_id(order[0]);
+			base.cpu_node = node < 0 ? 0 : static_cast<uint32_t>(node);
+		}
+
+		for (uint32_t kind = 0; kind < 2; kind++) {
+			bool latency = (kind == 0);
+			if ((latency && !__config.latencyTestSelected()) || (!latency && !__config.throughputTestSelected()))
+				continue;
+
+			MonitorProbe probe;
+			probe.spec = base;
+			probe.spec.latency = latency;
+			probe.spec.label = latency ? "Latency probe" : "Throughput probe";
+			probe.value = 0;
+			probe.has_value = false;
+			probe.up = false;
+			probe.warning = false;
+			probe.duration_sec = 0;
+			probe.last_run = 0;
+			probe.runs = 0;
+			probe.failures = 0;
+
+			std::string error;
+			if (!validate_benchmark_spec(probe.spec, error)) {
+				std::cerr << "ERROR: Cannot probe memory node " << base.mem_node << ": " << error << std::endl;
+				return false;
+			}
+			__probes.push_back(probe);
+		}
+	}
+
+	if (__probes.empty()) {
+		std::cerr << "ERROR: Daemon mode has no probes to run." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void MonitorDaemon::__runProbe(MonitorProbe& probe) {
+	BenchmarkResult result;
+	std::string error;
+	double start = __elapsed();
+	bool success = run_benchmark(probe.spec, result, error, g_verbose ? &std::cout : NULL, &std::cerr);
+	probe.duration_sec = __elapsed() - start;
+	__busy_sec += probe.duration_sec;
+	probe.last_run = time(NULL);
+	probe.runs++;
+	probe.up = success;
+
+	if (!success) {
+		probe.failures++;
+		std::cerr << "WARNING: " << probe.spec.label << " on memory node " << probe.spec.mem_node << " failed: " << error << std::endl;
+		return;
+	}
+
+	//Prometheus convention is base units
+	if (probe.spec.latency)
+		probe.value = result.average_metric * 1e-9;
+	else
+		probe.value = result.average_metric * MB;
+	probe.has_value = true;
+	probe.warning = result.warning;
+
+	if (g_verbose)
+		std::cout << probe.spec.label << " on CPU node " << probe.spec.cpu_node << ", memory node " << probe.spec.mem_node << ": " << result.average_metric << " " << result.metric_units << (result.warning ? " (WARNING)" : "") << std::endl;
+}
+
+std::string MonitorDaemon::__formatMetrics() const {
+	std::ostringstream out;
+	out.precision(9);
+
+	out << "# HELP xmem_probe_latency_seconds Average memory latency measured by the pointer-chasing probe." << std::endl;
+	out << "# TYPE xmem_probe_latency_seconds gauge" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		if (__probes[i].spec.latency && __probes[i].has_value)
+			out << "xmem_probe_latency_seconds" << probe_labels(__probes[i]) << " " << __probes[i].value << std::endl;
+
+	out << "# HELP xmem_probe_throughput_bytes_per_second Memory throughput of the single-threaded throughput probe." << std::endl;
+	out << "# TYPE xmem_probe_throughput_bytes_per_second gauge" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		if (!__probes[i].spec.latency && __probes[i].has_value)
+			out << "xmem_probe_throughput_bytes_per_second" << probe_labels(__probes[i]) << " " << __probes[i].value << std::endl;
+
+	out << "# HELP xmem_probe_up Whether the last run of the probe succeeded." << std::endl;
+	out << "# TYPE xmem_probe_up gauge" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		out << "xmem_probe_up" << probe_labels(__probes[i]) << " " << (__probes[i].up ? 1 : 0) << std::endl;
+
+	out << "# HELP xmem_probe_warning Whether the last successful run's results are questionable, e.g. because a worker could not be pinned." << std::endl;
+	out << "# TYPE xmem_probe_warning gauge" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		out << "xmem_probe_warning" << probe_labels(__probes[i]) << " " << (__probes[i].warning ? 1 : 0) << std::endl;
+
+	out << "# HELP xmem_probe_duration_seconds Wall clock duration of the last run of the probe." << std::endl;
+	out << "# TYPE xmem_probe_duration_seconds gauge" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		out << "xmem_probe_duration_seconds" << probe_labels(__probes[i]) << " " << __probes[i].duration_sec << std::endl;
+
+	out << "# HELP xmem_probe_last_run_timestamp_seconds Unix time when the last run of the probe finished." << std::endl;
+	out << "# TYPE xmem_probe_last_run_timestamp_seconds gauge" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		out << "xmem_probe_last_run_timestamp_seconds" << probe_labels(__probes[i]) << " " << static_cast<uint64_t>(__probes[i].last_run) << std::endl;
+
+	out << "# HELP xmem_probe_runs_total Number of runs of the probe." << std::endl;
+	out << "# TYPE xmem_probe_runs_total counter" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		out << "xmem_probe_runs_total" << probe_labels(__probes[i]) << " " << __probes[i].runs << std::endl;
+
+	out << "# HELP xmem_probe_failures_total Number of failed runs of the probe." << std::endl;
+	out << "# TYPE xmem_probe_failures_total counter" << std::endl;
+	for (size_t i = 0; i < __probes.size(); i++)
+		out << "xmem_probe_failures_total" << probe_labels(__probes[i]) << " " << __probes[i].failures << std::endl;
+
+	double elapsed = __elapsed();
+	out << "# HELP xmem_daemon_busy_ratio Share of wall clock time spent running probes since the daemon started." << std::endl;
+	out << "# TYPE xmem_daemon_busy_ratio gauge" << std::endl;
+	out << "xmem_daemon_busy_ratio " << (elapsed > 0 ? __busy_sec / elapsed : 0) << std::endl;
+
+	out << "# HELP xmem_daemon_budget_ratio Largest share of wall clock time that probes may run." << std::endl;
+	out << "# TYPE xmem_daemon_budget_ratio gauge" << std::endl;
+	out << "xmem_daemon_budget_ratio " << __config.getDaemonBudget() << std::endl;
+
+	return out.str();
+}
+
+void MonitorDaemon::__publish() {
+	std::string text = __formatMetrics();
+
+	if (__server != NULL)
+		__server->setMetrics(text);
+
+	std::string filename = __config.getPrometheusFilename();
+	if (!filename.empty()) {
+		//Write a temporary file and rename it, so that the collector never reads a partial file
+		std::string tmp_filename = filename + ".tmp";
+		std::ofstream out(tmp_filename.c_str(), std::ios::out | std::ios::trunc);
+		out << text;
+		out.close();
+		if (!out) {
+			std::cerr << "WARNING: Failed to write the Prometheus textfile " << tmp_filename << std::endl;
+			return;
+		}
+#ifdef _WIN32
+		std::remove(filename.c_str()); //rename() does not replace an existing file on Windows
+#endif
+		if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0)
+			std::cerr << "WARNING: Failed to replace the Prometheus textfile " << filename << std::endl;
+	}
+}
+
+bool MonitorDaemon::__waitUntil(double seconds) const {
+	while (!stop_signal_received()) {
+		double remaining = seconds - __elapsed();
+		if (remaining <= 0)
+			return true;
+		//Sleep in short steps so that a stop request is noticed quickly
+		std::this_thread::sleep_for(std::chrono::milliseconds(remaining < 0.2 ? static_cast<int64_t>(remaining * 1000) + 1 : 200));
+	}
+	return false;
+}
+
+double MonitorDaemon::__elapsed() const {
+	uint64_t now_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	return static_cast<double>(now_ns - __start_ns) / 1e9;
+}
@@ -0,0 +1,319 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the PermutationCache class.
+ */
+
+//Headers
+#include <PermutationCache.h>
+#include <common.h>
+#include <benchmark_kernels.h>
+
+//Libraries
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+#ifdef __gnu_linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace xmem {
+	PermutationCache g_permutation_cache;
+};
+
+using namespace xmem;
+
+/**
+ * @brief Gets the number of bytes in a pointer chunk.
+ * @param chunk_size The chunk size.
+ * @returns The number of bytes, or 0 if the chunk size cannot hold a pointer.
+ */
+static size_t pointer_chunk_bytes(chunk_size_t chunk_size) {
+	switch (chunk_size) {
+		case CHUNK_64b:
+			return sizeof(Word64_t);
+		case CHUNK_128b:
+			return sizeof(Word128_t);
+		case CHUNK_256b:
+			return sizeof(Word256_t);
+		default:
+			return 0;
+	}
+}
+
+PermutationCache::PermutationCache() :
+	__layouts(),
+	__resident(),
+	__index_dir(),
+	__num_reused(0),
+	__num_loaded(0),
+	__num_built(0),
+	__lock()
+	{
+}
+
+void PermutationCache::setIndexDirectory(const std::string& dir) {
+	std::lock_guard<std::mutex> guard(__lock);
+	__index_dir = dir;
+}
+
+void PermutationCache::touch(void* start_address, void* end_address) {
+	uintptr_t start = reinterpret_cast<uintptr_t>(start_address);
+	uintptr_t end = reinterpret_cast<uintptr_t>(end_address);
+
+	{
+		std::lock_guard<std::mutex> guard(__lock);
+		for (size_t i = 0; i < __resident.size(); i++)
+			if (__resident[i].first <= start && end <= __resident[i].second)
+				return;
+	}
+
+	//Write to all of the memory region of interest to make sure
+	//pages are resident in physical memory and are not shared
+	invalidate(start_address, end_address);
+	forwSequentialWrite_Word64(start_address, end_address);
+
+	std::lock_guard<std::mutex> guard(__lock);
+	__resident.push_back(std::make_pair(start, end));
+}
+
+bool PermutationCache::preparePermutation(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed, std::ostream* info_log, std::ostream* warning_log) {
+	uintptr_t start = reinterpret_cast<uintptr_t>(start_address);
+	uintptr_t end = reinterpret_cast<uintptr_t>(end_address);
+	std::string index_dir;
+
+	{
+		std::lock_guard<std::mutex> guard(__lock);
+		for (size_t i = 0; i < __layouts.size(); i++) {
+			if (__layouts[i].start == start && __layouts[i].end == end && __layouts[i].chunk_size == chunk_size && __layouts[i].seed == seed) {
+				__num_reused++;
+				if (info_log != NULL)
+					*info_log << "Reusing the pointer permutation already in a memory region under test." << std::endl;
+				return true;
+			}
+		}
+		index_dir = __index_dir;
+	}
+
+	//The region is about to be overwritten, so whatever was there before is gone even if we fail below
+	invalidate(start_address, end_address);
+
+	bool loaded = false;
+	if (!index_dir.empty())
+		loaded = __loadIndexFile(start_address, end_address, chunk_size, seed, info_log, warning_log);
+	if (!loaded) {
+		if (!buildRandomPointerPermutation(start_address, end_address, chunk_size, seed, info_log, warning_log))
+			return false;
+		if (!index_dir.empty() && !__saveIndexFile(start_address, end_address, chunk_size, seed) && warning_log != NULL)
+			*warning_log << "WARNING: Failed to save a pointer permutation index file in " << index_dir << "." << std::endl;
+	}
+
+	std::lock_guard<std::mutex> guard(__lock);
+	if (loaded)
+		__num_loaded++;
+	else
+		__num_built++;
+	Layout layout;
+	layout.start = start;
+	layout.end = end;
+	layout.chunk_size = chunk_size;
+	layout.seed = seed;
+	__layouts.push_back(layout);
+	return true;
+}
+
+void PermutationCache::invalidate(void* start_address, void* end_address) {
+	uintptr_t start = reinterpret_cast<uintptr_t>(start_address);
+	uintptr_t end = reinterpret_cast<uintptr_t>(end_address);
+
+	std::lock_guard<std::mutex> guard(__lock);
+	for (size_t i = 0; i < __layouts.size(); ) {
+		if (__layouts[i].start < end && start < __layouts[i].end)
+			__layouts.erase(__layouts.begin() + i);
+		else
+			i++;
+	}
+}
+
+void PermutationCache::release(void* start_address, void* end_address) {
+	uintptr_t start = reinterpret_cast<uintptr_t>(start_address);
+	uintptr_t end = reinterpret_cast<uintptr_t>(end_address);
+
+	invalidate(start_address, end_address);
+
+	std::lock_guard<std::mutex> guard(__lock);
+	for (size_t i = 0; i < __resident.size(); ) {
+		if (__resident[i].first < end && start < __resident[i].second)
+			__resident.erase(__resident.begin() + i);
+		else
+			i++;
+	}
+}
+
+std::string PermutationCache::__indexFileName(chunk_size_t chunk_size, size_t num_pointers, uint64_t seed) const {
+	std::ostringstream name;
+	name << __index_dir;
+#ifdef _WIN32
+	if (__index_dir.back() != '\\' && __index_dir.back() != '/')
+		name << "\\";
+#else
+	if (__index_dir.back() != '/')
+		name << "/";
+#endif
+	name << "xmem-perm-" << pointer_chunk_bytes(chunk_size)*8 << "b-" << num_pointers << "-" << seed << ".idx";
+	return name.str();
+}
+
+bool PermutationCache::__loadIndexFile(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed, std::ostream* info_log, std::ostream* warning_log) const {
+	size_t chunk_bytes = pointer_chunk_bytes(chunk_size);
+	if (chunk_bytes == 0)
+		return false;
+	size_t words_per_chunk = chunk_bytes / sizeof(Word64_t);
+	size_t num_pointers = (reinterpret_cast<uint8_t*>(end_address) - reinterpret_cast<uint8_t*>(start_address)) / chunk_bytes;
+	Word64_t* mem_region_base = reinterpret_cast<Word64_t*>(start_address);
+	std::string filename = __indexFileName(chunk_size, num_pointers, seed);
+
+#ifdef __gnu_linux__
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != num_pointers * sizeof(uint64_t)) {
+		close(fd);
+		return false;
+	}
+	void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return false;
+	madvise(mapping, st.st_size, MADV_SEQUENTIAL);
+
+	const uint64_t* indices = static_cast<const uint64_t*>(mapping);
+	bool valid = true;
+	for (size_t i = 0; i < num_pointers && valid; i++) {
+		if (indices[i] >= num_pointers) {
+			valid = false;
+			break;
+		}
+		mem_region_base[i*words_per_chunk] = reinterpret_cast<Word64_t>(mem_region_base + indices[i]*words_per_chunk);
+		for (size_t w = 1; w < words_per_chunk; w++)
+			mem_region_base[i*words_per_chunk+w] = 0xFFFFFFFFFFFFFFFF; //1-fill upper bits, like buildRandomPointerPermutation()
+	}
+	munmap(mapping, st.st_size);
+#else
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+	file.seekg(0, std::ios::end);
+	if (static_cast<size_t>(file.tellg()) != num_pointers * sizeof(uint64_t))
+		return false;
+	file.seekg(0, std::ios::beg);
+
+	std::vector<uint64_t> indices(4096);
+	bool valid = true;
+	for (size_t i = 0; i < num_pointers && valid; ) {
+		size_t n = std::min(indices.size(), num_pointers - i);
+		if (!file.read(reinterpret_cast<char*>(indices.data()), n * sizeof(uint64_t))) {
+			valid = false;
+			break;
+		}
+		for (size_t k = 0; k < n; k++, i++) {
+			if (indices[k] >= num_pointers) {
+				valid = false;
+				break;
+			}
+			mem_region_base[i*words_per_chunk] = reinterpret_cast<Word64_t>(mem_region_base + indices[k]*words_per_chunk);
+			for (size_t w = 1; w < words_per_chunk; w++)
+				mem_region_base[i*words_per_chunk+w] = 0xFFFFFFFFFFFFFFFF; //1-fill upper bits, like buildRandomPointerPermutation()
+		}
+	}
+#endif
+
+	//In-range indices can still form several short cycles, e.g. in a stale or damaged file, and the chase would then stay in cache. Walk the chain: it must return to the first chunk after visiting every chunk once.
+	if (valid) {
+		const Word64_t* p = mem_region_base;
+		for (size_t step = 1; step <= num_pointers; step++) {
+			p = reinterpret_cast<const Word64_t*>(*p);
+			if ((p == mem_region_base) != (step == num_pointers)) {
+				valid = false;
+				break;
+			}
+		}
+	}
+
+	if (!valid) {
+		if (warning_log != NULL)
+			*warning_log << "WARNING: Pointer permutation index file " << filename << " is corrupt. Ignoring it." << std::endl;
+		return false;
+	}
+	if (info_log != NULL)
+		*info_log << "Loaded a pointer permutation from " << filename << "." << std::endl;
+	return true;
+}
+
+bool PermutationCache::__saveIndexFile(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed) const {
+	size_t chunk_bytes = pointer_chunk_bytes(chunk_size);
+	if (chunk_bytes == 0)
+		return false;
+	size_t words_per_chunk = chunk_bytes / sizeof(Word64_t);
+	size_t num_pointers = (reinterpret_cast<uint8_t*>(end_address) - reinterpret_cast<uint8_t*>(start_address)) / chunk_bytes;
+	const Word64_t* mem_region_base = reinterpret_cast<const Word64_t*>(start_address);
+	std::string filename = __indexFileName(chunk_size, num_pointers, seed);
+	std::string tmp_filename = filename + ".tmp"; //Renamed once complete, so a concurrent run never loads a partial file
+
+	std::ofstream file(tmp_filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	std::vector<uint64_t> indices(4096);
+	for (size_t i = 0; i < num_pointers; ) {
+		size_t n = std::min(indices.size(), num_pointers - i);
+		for (size_t k = 0; k < n; k++, i++)
+			indices[k] = (mem_region_base[i*words_per_chunk] - reinterpret_cast<Word64_t>(mem_region_base)) / chunk_bytes;
+		file.write(reinterpret_cast<const char*>(indices.data()), n * sizeof(uint64_t));
+	}
+	file.close();
+	if (file.fail()) {
+		std::remove(tmp_filename.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	std::remove(filename.c_str()); //rename() does not replace an existing file on Windows
+#endif
+	if (std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+		std::remove(tmp_filename.c_str());
+		return false;
+	}
+	return true;
+}
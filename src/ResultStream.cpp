@@ -0,0 +1,498 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the ResultStream class.
+ */
+
+//Headers
+#include <ResultStream.h>
+#include <common.h>
+#include <Topology.h>
+
+//Libraries
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#include <sys/utsname.h>
+#endif
+
+using namespace xmem;
+
+/**
+ * @brief Quotes and escapes a string as a JSON string.
+ * @param s The string.
+ * @returns The JSON string literal.
+ */
+static std::string json_string(const std::string& s) {
+	std::ostringstream out;
+	out << "\"";
+	for (size_t i = 0; i < s.size(); i++) {
+		unsigned char c = static_cast<unsigned char>(s[i]);
+		switch (c) {
+			case '"':
+				out << "\\\"";
+				break;
+			case '\\':
+				out << "\\\\";
+				break;
+			case '\n':
+				out << "\\n";
+				break;
+			case '\r':
+				out << "\\r";
+				break;
+			case '\t':
+				out << "\\t";
+				break;
+			default:
+				if (c < 0x20)
+					out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<uint32_t>(c) << std::dec << std::setfill(' ');
+				else
+					out << s[i];
+				break;
+		}
+	}
+	out << "\"";
+	return out.str();
+}
+
+/**
+ * @brief Formats a number for JSON. JSON has no representation for NaN or infinity, so those become null.
+ * @param x The number.
+ * @returns The JSON number literal, or null.
+ */
+static std::string json_number(double x) {
+	if (std::isnan(x) || std::isinf(x))
+		return "null";
+	std::ostringstream out;
+	out << std::setprecision(15) << x;
+	return out.str();
+}
+
+/**
+ * @brief Formats a boolean for JSON.
+ * @param b The boolean.
+ * @returns true or false.
+ */
+static std::string json_bool(bool b) {
+	return b ? "true" : "false";
+}
+
+#ifdef __gnu_linux__
+/**
+ * @brief Reads the first line of a file.
+ * @param path Path of the file.
+ * @returns The line, or an empty string if the file could not be read.
+ */
+static std::string first_line_of(const std::string& path) {
+	std::ifstream in(path.c_str());
+	std::string line;
+	if (in.is_open())
+		std::getline(in, line);
+	return line;
+}
+
+/**
+ * @brief Extracts the selected value from a sysfs setting such as "always [madvise] never".
+ * @param path Path of the setting.
+ * @returns The value in brackets, the whole line if there are no brackets, or an empty string if the setting could not be read.
+ */
+static std::string selected_sysfs_value(const std::string& path) {
+	std::string line = first_line_of(path);
+	size_t open = line.find('[');
+	size_t close = line.find(']');
+	if (open != std::string::npos && close != std::string::npos && close > open)
+		return line.substr(open+1, close-open-1);
+	return line;
+}
+
+/**
+ * @brief Gets a field of the first processor in /proc/cpuinfo.
+ * @param field Name of the field, e.g. "model name".
+ * @returns The value, or an empty string if the field is not present.
+ */
+static std::string cpuinfo_field(const std::string& field) {
+	std::ifstream in("/proc/cpuinfo");
+	std::string line;
+	while (std::getline(in, line)) {
+		size_t colon = line.find(':');
+		if (colon == std::string::npos)
+			continue;
+		std::string key = line.substr(0, colon);
+		key.erase(key.find_last_not_of(" \t") + 1);
+		if (key == field) {
+			size_t start = line.find_first_not_of(" \t", colon+1);
+			return (start == std::string::npos) ? "" : line.substr(start);
+		}
+	}
+	return "";
+}
+#endif
+
+#ifdef _WIN32
+/**
+ * @brief Gets the processor brand string from CPUID.
+ * @returns The brand string, or an empty string if the processor does not report one.
+ */
+static std::string cpuid_brand_string() {
+	int32_t regs[4];
+	__cpuid(regs, 0x80000000);
+	if (static_cast<uint32_t>(regs[0]) < 0x80000004)
+		return "";
+
+	char brand[49];
+	for (uint32_t i = 0; i < 3; i++) {
+		__cpuid(regs, 0x80000002 + i);
+		memcpy(brand + i*16, regs, 16);
+	}
+	brand[48] = '\0';
+	std::string s(brand);
+	size_t start = s.find_first_not_of(' ');
+	return (start == std::string::npos) ? "" : s.substr(start);
+}
+#endif
+
+ResultStream::ResultStream() :
+	__file()
+	{
+}
+
+ResultStream::~ResultStream() {
+	if (__file.is_open())
+		__file.close();
+}
+
+bool ResultStream::open(const std::string& filename) {
+	__file.open(filename.c_str(), std::fstream::out | std::fstream::trunc);
+	return __file.is_open();
+}
+
+bool ResultStream::isOpen() const {
+	return __file.is_open();
+}
+
+void ResultStream::writeRunHeader(const Configurator& config) {
+	if (!__file.is_open())
+		return;
+
+	//Collect host information
+	std::string hostname, os, kernel_release, kernel_version, machine, cpu_model, microcode, thp_enabled, thp_defrag;
+#ifdef __gnu_linux__
+	struct utsname uts;
+	if (uname(&uts) == 0) {
+		hostname = uts.nodename;
+		os = uts.sysname;
+		kernel_release = uts.release;
+		kernel_version = uts.version;
+		machine = uts.machine;
+	}
+	cpu_model = cpuinfo_field("model name");
+	microcode = cpuinfo_field("microcode");
+	thp_enabled = selected_sysfs_value("/sys/kernel/mm/transparent_hugepage/enabled");
+	thp_defrag = selected_sysfs_value("/sys/kernel/mm/transparent_hugepage/defrag");
+#endif
+#ifdef _WIN32
+	char name[MAX_COMPUTERNAME_LENGTH+1];
+	DWORD name_len = sizeof(name);
+	if (GetComputerNameA(name, &name_len))
+		hostname = name;
+	os = "Windows";
+	cpu_model = cpuid_brand_string();
+#endif
+
+	char start_time[32] = "";
+	time_t now = time(NULL);
+	struct tm utc;
+#ifdef _WIN32
+	if (gmtime_s(&utc, &now) == 0)
+#else
+	if (gmtime_r(&now, &utc) != NULL)
+#endif
+		strftime(start_time, sizeof(start_time), "%Y-%m-%dT%H:%M:%SZ", &utc);
+
+	std::ostringstream rec;
+	rec << "{\"record\":\"run\"";
+	rec << ",\"xmem_version\":" << json_string(VERSION);
+	rec << ",\"start_time\":" << json_string(start_time);
+	rec << ",\"command_line\":" << json_string(config.getCommandLine());
+
+	rec << ",\"host\":{";
+	rec << "\"hostname\":" << json_string(hostname);
+	rec << ",\"os\":" << json_string(os);
+	rec << ",\"kernel_release\":" << json_string(kernel_release);
+	rec << ",\"kernel_version\":" << json_string(kernel_version);
+	rec << ",\"machine\":" << json_string(machine);
+	rec << ",\"cpu_model\":" << json_string(cpu_model);
+	rec << ",\"microcode\":" << json_string(microcode);
+	rec << ",\"thp_enabled\":" << json_string(thp_enabled);
+	rec << ",\"thp_defrag\":" << json_string(thp_defrag);
+	rec << ",\"page_size\":" << g_page_size;
+	rec << ",\"large_page_size\":" << g_large_page_size;
+	rec << "}";
+
+	rec << ",\"topology\":{";
+	rec << "\"numa_nodes\":" << g_num_nodes;
+	rec << ",\"packages\":" << g_num_physical_packages;
+	rec << ",\"physical_cores\":" << g_topology.getNumPhysicalCores();
+	rec << ",\"logical_cpus\":" << g_num_logical_cpus;
+	rec << ",\"node_cpus\":[";
+	for (uint32_t n = 0; n < g_num_nodes; n++) {
+		const std::vector<uint32_t>& cpus = g_topology.getCPUsInNode(n);
+		rec << (n > 0 ? "," : "") << "[";
+		for (uint32_t c = 0; c < cpus.size(); c++)
+			rec << (c > 0 ? "," : "") << cpus[c];
+		rec << "]";
+	}
+	rec << "],\"node_distances\":[";
+	for (uint32_t from = 0; from < g_num_nodes; from++) {
+		rec << (from > 0 ? "," : "") << "[";
+		for (uint32_t to = 0; to < g_num_nodes; to++)
+			rec << (to > 0 ? "," : "") << g_topology.getDistance(from, to);
+		rec << "]";
+	}
+	rec << "],\"caches\":[";
+	const std::vector<CacheDomain>& caches = g_topology.getCaches();
+	for (uint32_t i = 0; i < caches.size(); i++) {
+		rec << (i > 0 ? "," : "") << "{\"level\":" << caches[i].level;
+		rec << ",\"type\":" << json_string(caches[i].type);
+		rec << ",\"size\":" << caches[i].size;
+		rec << ",\"cpus\":[";
+		for (uint32_t c = 0; c < caches[i].cpus.size(); c++)
+			rec << (c > 0 ? "," : "") << caches[i].cpus[c];
+		rec << "]}";
+	}
+	rec << "]}";
+
+	rec << ",\"config\":{";
+	rec << "\"benchmark_mode\":" << json_string(g_benchmark_mode == TIME_BASED ? "time" : "size");
+	rec << ",\"duration_sec\":" << g_benchmark_duration_sec;
+	rec << ",\"bytes_per_pass\":" << g_throughput_bytes_per_pass;
+	rec << ",\"latency_unroll\":" << g_latency_unroll_length;
+	rec << ",\"power_period_sec\":" << g_power_sampling_period_sec;
+	rec << ",\"trace_period_us\":" << g_bandwidth_trace_period_us;
+	rec << ",\"permutation_seed\":" << g_permutation_seed;
+	rec << ",\"working_set_size_per_thread\":" << config.getWorkingSetSizePerThread();
+	rec << ",\"worker_threads\":" << config.getNumWorkerThreads();
+	rec << ",\"iterations\":" << config.getIterationsPerTest();
+	rec << ",\"max_iterations\":" << config.getMaxIterations();
+	rec << ",\"target_relative_ci\":" << json_number(config.getTargetRelativeCI());
+	rec << ",\"time_budget_sec\":" << config.getTimeBudget();
+	rec << ",\"large_pages\":" << json_bool(config.useLargePages());
+	rec << ",\"plan\":" << json_string(config.getPlanFilename());
+	rec << "}";
+
+	rec << "}";
+	__file << rec.str() << std::endl; //Flushes, so the record is visible right away
+}
+
+void ResultStream::writeResult(const BenchmarkResult& result) {
+	if (!__file.is_open())
+		return;
+
+	std::ostringstream rec;
+	rec << "{\"record\":\"benchmark\"";
+	rec << ",\"name\":" << json_string(result.name);
+	rec << ",\"kind\":" << json_string(result.kind);
+	rec << ",\"completed\":" << json_bool(result.completed);
+	rec << ",\"warning\":" << json_bool(result.warning);
+
+	rec << ",\"config\":{";
+	rec << "\"working_set_size_per_thread\":" << result.working_set_size_per_thread;
+	rec << ",\"threads\":" << result.num_threads;
+	rec << ",\"load_threads\":" << result.num_load_threads;
+	rec << ",\"cpu_node\":" << result.cpu_node;
+	rec << ",\"mem_node\":" << result.mem_node;
+	rec << ",\"load_cpu_node\":" << result.load_cpu_node;
+	rec << ",\"load_mem_node\":" << result.load_mem_node;
+	rec << ",\"cpus\":[";
+	for (uint32_t i = 0; i < result.cpus.size(); i++)
+		rec << (i > 0 ? "," : "") << result.cpus[i];
+	rec << "]";
+	rec << ",\"pattern\":" << json_string(pattern_mode_name(result.pattern_mode));
+	rec << ",\"rw\":" << json_string(rw_mode_name(result.rw_mode));
+	rec << ",\"chunk_bits\":" << chunk_size_bits(result.chunk_size);
+	rec << ",\"stride\":" << result.stride_size;
+	rec << ",\"sharing\":" << json_string(sharing_mode_name(result.sharing_mode));
+	if (!result.worker_specs.empty()) {
+		rec << ",\"worker_specs\":[";
+		for (uint32_t w = 0; w < result.worker_specs.size(); w++) {
+			const WorkerSpec& spec = result.worker_specs[w];
+			rec << (w > 0 ? "," : "") << "{";
+			rec << "\"pattern\":" << json_string(pattern_mode_name(spec.pattern_mode));
+			rec << ",\"rw\":" << json_string(rw_mode_name(spec.rw_mode));
+			rec << ",\"chunk_bits\":" << chunk_size_bits(spec.chunk_size);
+			rec << ",\"stride\":" << spec.stride_size;
+			rec << ",\"mem_node\":" << spec.mem_node;
+			rec << ",\"throttle_bytes_per_sec\":" << spec.throttle_bytes_per_sec;
+			rec << "}";
+		}
+		rec << "]";
+	}
+	rec << ",\"passes_per_iteration\":" << result.passes_per_iteration;
+	rec << "}";
+
+	rec << ",\"metric\":{";
+	rec << "\"units\":" << json_string(result.metric_units);
+	rec << ",\"mean\":" << json_number(result.average_metric);
+	rec << ",\"median\":" << json_number(result.median_metric);
+	rec << ",\"min\":" << json_number(result.min_metric);
+	rec << ",\"max\":" << json_number(result.max_metric);
+	rec << ",\"stddev\":" << json_number(result.stddev_metric);
+	rec << ",\"ci95\":" << json_number(result.ci_metric);
+	rec << ",\"outliers\":" << result.num_outliers;
+	rec << ",\"noisy_iterations\":" << result.num_noisy;
+	rec << ",\"reject_noisy\":" << json_bool(result.reject_noisy);
+	rec << "}";
+
+	if (!result.load_metric_units.empty()) {
+		rec << ",\"load_metric\":{";
+		rec << "\"units\":" << json_string(result.load_metric_units);
+		rec << ",\"mean\":" << json_number(result.average_load_metric);
+		rec << "}";
+	}
+
+	if (!result.group_metrics.empty()) {
+		rec << ",\"groups\":[";
+		for (uint32_t g = 0; g < result.group_metrics.size(); g++) {
+			rec << (g > 0 ? "," : "") << "{";
+			rec << "\"cpu_node\":" << (g < result.group_cpu_nodes.size() ? result.group_cpu_nodes[g] : 0);
+			rec << ",\"mem_node\":" << (g < result.group_mem_nodes.size() ? result.group_mem_nodes[g] : 0);
+			rec << ",\"metric\":" << json_number(result.group_metrics[g]);
+			rec << "}";
+		}
+		rec << "]";
+	}
+
+	if (result.average_frequency > 0) {
+		rec << ",\"frequency\":{";
+		rec << "\"mean_ghz\":" << json_number(result.average_frequency);
+		rec << ",\"min_ghz\":" << json_number(result.min_frequency);
+		rec << ",\"max_ghz\":" << json_number(result.max_frequency);
+		rec << ",\"varied\":" << json_bool(result.frequency_varied);
+		if (result.average_cycles > 0)
+			rec << ",\"mean_cycles_per_access\":" << json_number(result.average_cycles);
+		rec << "}";
+	}
+
+	if (result.trace_period_sec > 0)
+		rec << ",\"bandwidth_trace_period_sec\":" << json_number(result.trace_period_sec);
+
+	if (!result.worker_metrics.empty()) {
+		rec << ",\"fairness\":{";
+		rec << "\"units\":\"MB/s\"";
+		rec << ",\"thread_means\":[";
+		for (uint32_t t = 0; t < result.worker_metrics.size(); t++)
+			rec << (t > 0 ? "," : "") << json_number(result.worker_metrics[t]);
+		rec << "]";
+		rec << ",\"min\":" << json_number(result.min_worker_metric);
+		rec << ",\"max\":" << json_number(result.max_worker_metric);
+		rec << ",\"jain_index\":" << json_number(result.worker_fairness);
+		rec << "}";
+	}
+
+	rec << ",\"iterations\":[";
+	for (uint32_t i = 0; i < result.metric_on_iter.size(); i++) {
+		rec << (i > 0 ? "," : "") << "{";
+		rec << "\"metric\":" << json_number(result.metric_on_iter[i]);
+		if (i < result.load_metric_on_iter.size())
+			rec << ",\"load_metric\":" << json_number(result.load_metric_on_iter[i]);
+		if (i < result.frequency_on_iter.size() && result.frequency_on_iter[i] > 0)
+			rec << ",\"frequency_ghz\":" << json_number(result.frequency_on_iter[i]);
+		if (i < result.cycles_on_iter.size() && result.cycles_on_iter[i] > 0)
+			rec << ",\"cycles_per_access\":" << json_number(result.cycles_on_iter[i]);
+		rec << ",\"outlier\":" << json_bool(i < result.outlier_on_iter.size() && result.outlier_on_iter[i]);
+		rec << ",\"warning\":" << json_bool(i < result.warning_on_iter.size() && result.warning_on_iter[i]);
+		if (i < result.fairness_on_iter.size())
+			rec << ",\"fairness\":" << json_number(result.fairness_on_iter[i]);
+		if (i < result.interference_on_iter.size() && result.interference_on_iter[i].measured) {
+			const InterferenceResult& noise = result.interference_on_iter[i];
+			rec << ",\"interference\":{";
+			rec << "\"interrupts\":" << noise.interrupts;
+			rec << ",\"irq_sec\":" << json_number(noise.irq_sec);
+			rec << ",\"softirq_sec\":" << json_number(noise.softirq_sec);
+			rec << ",\"steal_sec\":" << json_number(noise.steal_sec);
+			rec << ",\"run_delay_sec\":" << json_number(noise.run_delay_sec);
+			rec << ",\"involuntary_switches\":" << noise.involuntary_switches;
+			rec << ",\"noisy\":" << json_bool(noise.noisy);
+			rec << "}";
+		}
+		if (i < result.trace_on_iter.size() && !result.trace_on_iter[i].empty()) {
+			rec << ",\"bandwidth_trace\":[";
+			for (uint32_t s = 0; s < result.trace_on_iter[i].size(); s++)
+				rec << (s > 0 ? "," : "") << json_number(result.trace_on_iter[i][s]);
+			rec << "]";
+		}
+		rec << ",\"workers\":[";
+		if (i < result.workers_on_iter.size()) {
+			const std::vector<WorkerResult>& workers = result.workers_on_iter[i];
+			for (uint32_t w = 0; w < workers.size(); w++) {
+				rec << (w > 0 ? "," : "") << "{";
+				rec << "\"cpu\":" << workers[w].cpu;
+				rec << ",\"role\":" << json_string(workers[w].latency ? "latency" : "load");
+				rec << ",\"passes\":" << workers[w].passes;
+				rec << ",\"bytes_per_pass\":" << workers[w].bytes_per_pass;
+				rec << ",\"elapsed_ticks\":" << workers[w].elapsed_ticks;
+				rec << ",\"elapsed_dummy_ticks\":" << workers[w].elapsed_dummy_ticks;
+				rec << ",\"adjusted_ticks\":" << workers[w].adjusted_ticks;
+				rec << ",\"throughput\":" << json_number(workers[w].throughput);
+				rec << ",\"frequency_ghz\":" << json_number(workers[w].frequency_ghz);
+				rec << ",\"involuntary_switches\":" << workers[w].involuntary_switches;
+				rec << ",\"warning\":" << json_bool(workers[w].warning);
+				rec << "}";
+			}
+		}
+		rec << "]}";
+	}
+	rec << "]";
+
+	rec << ",\"power\":[";
+	for (uint32_t p = 0; p < result.power.size(); p++) {
+		rec << (p > 0 ? "," : "") << "{";
+		rec << "\"name\":" << json_string(result.power[p].name);
+		rec << ",\"average_watts\":" << json_number(result.power[p].average_watts);
+		rec << ",\"peak_watts\":" << json_number(result.power[p].peak_watts);
+		rec << ",\"sampling_period_sec\":" << json_number(result.power[p].sampling_period_sec);
+		rec << ",\"trace_watts\":[";
+		for (uint32_t s = 0; s < result.power[p].trace_watts.size(); s++)
+			rec << (s > 0 ? "," : "") << json_number(result.power[p].trace_watts[s]);
+		rec << "]}";
+	}
+	rec << "]";
+
+	rec << "}";
+	__file << rec.str() << std::endl; //Flushes, so the record is visible as soon as the benchmark completes
+}
@@ -33,6 +33,7 @@
 #include <LoadWorker.h>
 #include <Thread.h>
 #include <Timer.h>
+#include <PermutationCache.h>
 
 //Libraries
 #include <iostream>
@@ -45,12 +46,11 @@ ThroughputBenchmark::ThroughputBenchmark(
 		void* mem_array,
 		size_t len,
 		uint32_t iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 		uint64_t passes_per_iteration,
-#endif
 		uint32_t num_worker_threads,
 		uint32_t mem_node,
 		uint32_t cpu_node,
+		std::vector<int32_t> cpu_ids,
 		pattern_mode_t pattern_mode,
 		rw_mode_t rw_mode,
 		chunk_size_t chunk_size,
@@ -62,12 +62,11 @@ ThroughputBenchmark::ThroughputBenchmark(
 		mem_array,
 		len,
 		iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 		passes_per_iteration,
-#endif
 		num_worker_threads,
 		mem_node,
 		cpu_node,
+		cpu_ids,
 		pattern_mode,
 		rw_mode,
 		chunk_size,
@@ -79,38 +78,72 @@ ThroughputBenchmark::ThroughputBenchmark(
 	{
 }
 
-bool ThroughputBenchmark::_run_core() {
-	size_t len_per_thread = _len / _num_worker_threads; //Carve up memory space so each worker has its own area to play in
+void ThroughputBenchmark::getResult(BenchmarkResult& result) const {
+	Benchmark::getResult(result);
+	result.kind = "throughput";
+}
 
-	//Set up kernel function pointers
-	SequentialFunction kernel_fptr_seq = NULL;
-	SequentialFunction kernel_dummy_fptr_seq = NULL; 
-	RandomFunction kernel_fptr_ran = NULL;
-	RandomFunction kernel_dummy_fptr_ran = NULL; 
+bool ThroughputBenchmark::_prepare_core() {
+	size_t len_per_thread = _len / _num_worker_threads; //Carve up memory space so each worker has its own area to play in
 
-	if (_pattern_mode == SEQUENTIAL) {
-		if (!determineSequentialKernel(_rw_mode, _chunk_size, _stride_size, &kernel_fptr_seq, &kernel_dummy_fptr_seq)) {
-			std::cerr << "ERROR: Failed to find appropriate benchmark kernel." << std::endl;
-			return false;
-		}
-	} else if (_pattern_mode == RANDOM) {
-		if (!determineRandomKernel(_rw_mode, _chunk_size, &kernel_fptr_ran, &kernel_dummy_fptr_ran)) {
-			std::cerr << "ERROR: Failed to find appropriate benchmark kernel." << std::endl;
+	//Build pointer indices for random-access workers. Note that the pointers for each thread must stay within its respective region, otherwise sharing may occur. Shared workers use the first region only.
+	uint32_t num_regions = (_sharing_mode == SHARING_PRIVATE) ? _num_worker_threads : 1;
+	for (uint32_t i = 0; i < num_regions; i++) {
+		pattern_mode_t pattern_mode = _pattern_mode;
+		rw_mode_t rw_mode = _rw_mode;
+		chunk_size_t chunk_size = _chunk_size;
+		int64_t stride_size = _stride_size;
+		void* region = _loadRegion(i, 0, _mem_array, _mem_array, len_per_thread, pattern_mode, rw_mode, chunk_size, stride_size);
+		if (pattern_mode != RANDOM)
+			continue;
+		if (!g_permutation_cache.preparePermutation(region,
+													reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(region) + len_per_thread), //casts to silence compiler warnings
+													chunk_size,
+													g_permutation_seed,
+													_info_log,
+													_warning_log)) {
+			_reportError("Failed to build a random pointer permutation for a worker thread!");
 			return false;
 		}
-			
-		//Build pointer indices. Note that the pointers for each thread must stay within its respective region, otherwise sharing may occur. 
-		for (uint32_t i = 0; i < _num_worker_threads; i++) {
-			if (!buildRandomPointerPermutation(reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + i*len_per_thread), //casts to silence compiler warnings
-											   reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + (i+1)*len_per_thread), //casts to silence compiler warnings
-											   _chunk_size)) {
-				std::cerr << "ERROR: Failed to build a random pointer permutation for a worker thread!" << std::endl;
+	}
+
+	return true;
+}
+
+bool ThroughputBenchmark::_run_core() {
+	size_t len_per_thread = _len / _num_worker_threads; //Carve up memory space so each worker has its own area to play in
+
+	//Set up each worker's region and kernel function pointers, which differ between workers that share memory or have their own workloads
+	std::vector<void*> thread_mem_arrays(_num_worker_threads, static_cast<void*>(NULL));
+	std::vector<pattern_mode_t> thread_pattern_modes(_num_worker_threads, _pattern_mode);
+	std::vector<SequentialFunction> kernel_fptrs_seq(_num_worker_threads, static_cast<SequentialFunction>(NULL));
+	std::vector<SequentialFunction> kernel_dummy_fptrs_seq(_num_worker_threads, static_cast<SequentialFunction>(NULL));
+	std::vector<RandomFunction> kernel_fptrs_ran(_num_worker_threads, static_cast<RandomFunction>(NULL));
+	std::vector<RandomFunction> kernel_dummy_fptrs_ran(_num_worker_threads, static_cast<RandomFunction>(NULL));
+
+	for (uint32_t t = 0; t < _num_worker_threads; t++) {
+		rw_mode_t rw_mode = _rw_mode;
+		chunk_size_t chunk_size = _chunk_size;
+		int64_t stride_size = _stride_size;
+		thread_mem_arrays[t] = _loadRegion(t, 0, _mem_array, _mem_array, len_per_thread, thread_pattern_modes[t], rw_mode, chunk_size, stride_size);
+		if (thread_pattern_modes[t] == SEQUENTIAL) {
+			if (!determineSequentialKernel(rw_mode, chunk_size, stride_size, &kernel_fptrs_seq[t], &kernel_dummy_fptrs_seq[t])) {
+				_reportError("Failed to find appropriate benchmark kernel.");
 				return false;
 			}
+
+			//Sequential writes clobber any pointer permutation left in the worker's region
+			if (rw_mode == WRITE)
+				g_permutation_cache.invalidate(thread_mem_arrays[t], reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(thread_mem_arrays[t]) + len_per_thread));
+		} else if (thread_pattern_modes[t] == RANDOM) {
+			if (!determineRandomKernel(rw_mode, chunk_size, &kernel_fptrs_ran[t], &kernel_dummy_fptrs_ran[t])) {
+				_reportError("Failed to find appropriate benchmark kernel.");
+				return false;
+			}
+		} else {
+			_reportError("Got an invalid pattern mode.");
+			return false;
 		}
-	} else {
-		std::cerr << "ERROR: Got an invalid pattern mode." << std::endl;
-		return false;
 	}
 
 	//For getting timer frequency info, etc.
@@ -121,99 +154,110 @@ bool ThroughputBenchmark::_run_core() {
 	std::vector<Thread*> worker_threads;
 
 	//Start power measurement
-	if (g_verbose) 
-		std::cout << "Starting power measurement threads...";
+	if (_info_log != NULL) 
+		*_info_log << "Starting power measurement threads...";
 	if (!_start_power_threads()) {
-		if (g_verbose)
-			std::cout << "FAIL" << std::endl;
-		std::cerr << "WARNING: Failed to start power measurement threads." << std::endl;
-	} else if (g_verbose)
-		std::cout << "done" << std::endl;
+		if (_info_log != NULL)
+			*_info_log << "FAIL" << std::endl;
+		_reportWarning("Failed to start power measurement threads.");
+	} else if (_info_log != NULL)
+		*_info_log << "done" << std::endl;
 
 	//Run benchmark
-	if (g_verbose)
-		std::cout << "Running benchmark." << std::endl << std::endl;
+	if (_info_log != NULL)
+		*_info_log << "Running benchmark." << std::endl << std::endl;
 
 	//Do a bunch of iterations of the core benchmark routines
-	for (uint32_t i = 0; i < _iterations; i++) {
+	for (uint32_t i = 0; _beginIteration(i); i++) {
 		//Create workers and worker threads
 		for (uint32_t t = 0; t < _num_worker_threads; t++) {
-			void* thread_mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(_mem_array) + t * len_per_thread);
-			int32_t cpu_id = cpu_id_in_numa_node(_cpu_node, t);
+			int32_t cpu_id = t < _cpu_ids.size() ? _cpu_ids[t] : -1;
 			if (cpu_id < 0)
-				std::cerr << "WARNING: Failed to find logical CPU " << t << " in NUMA node " << _cpu_node << std::endl;
-			if (_pattern_mode == SEQUENTIAL)
-				workers.push_back(new LoadWorker(thread_mem_array,
+				_reportWarning("No logical CPU was found for worker thread " + std::to_string(t));
+			if (thread_pattern_modes[t] == SEQUENTIAL)
+				workers.push_back(new LoadWorker(thread_mem_arrays[t],
 												 len_per_thread,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 									   			 _passes_per_iteration,
-#endif
-												 kernel_fptr_seq,
-												 kernel_dummy_fptr_seq,
+												 kernel_fptrs_seq[t],
+												 kernel_dummy_fptrs_seq[t],
 												 cpu_id));
-			else if (_pattern_mode == RANDOM)
-				workers.push_back(new LoadWorker(thread_mem_array,
+			else if (thread_pattern_modes[t] == RANDOM)
+				workers.push_back(new LoadWorker(thread_mem_arrays[t],
 												 len_per_thread,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 									   			 _passes_per_iteration,
-#endif
-												 kernel_fptr_ran,
-												 kernel_dummy_fptr_ran,
+												 kernel_fptrs_ran[t],
+												 kernel_dummy_fptrs_ran[t],
 												 cpu_id));
 			else
-				std::cerr << "WARNING: Invalid benchmark pattern mode." << std::endl;
+				_reportWarning("Invalid benchmark pattern mode.");
+			const WorkerSpec* spec = _workerSpec(t, 0);
+			if (spec != NULL && spec->throttle_bytes_per_sec > 0)
+				workers[t]->setThrottle(spec->throttle_bytes_per_sec);
+			_traceWorker(workers[t], helper_timer.get_ticks_per_sec());
 			worker_threads.push_back(new Thread(workers[t]));
 		}
 
 		//Start worker threads! gogogo
+		_beginInterferenceCheck();
 		for (uint32_t t = 0; t < _num_worker_threads; t++)
 			worker_threads[t]->create_and_start();
 
 		//Wait for all threads to complete
 		for (uint32_t t = 0; t < _num_worker_threads; t++)
 			if (!worker_threads[t]->join())
-				std::cerr << "WARNING: A worker thread failed to complete correctly!" << std::endl;
+				_reportWarning("A worker thread failed to complete correctly!");
 
 		//Compute throughput achieved with all workers
 		uint64_t total_passes = 0;
+		double total_bytes = 0;
 		uint64_t total_adjusted_ticks = 0;
 		uint64_t avg_adjusted_ticks = 0;
 		uint64_t total_elapsed_dummy_ticks = 0;
-		uint64_t bytes_per_pass = workers[0]->getBytesPerPass(); //all should be the same.
+		uint64_t bytes_per_pass = workers[0]->getBytesPerPass(); //all should be the same, unless workers have their own workloads.
 		bool iter_warning = false;
 		for (uint32_t t = 0; t < _num_worker_threads; t++) {
 			total_passes += workers[t]->getPasses();
+			total_bytes += static_cast<double>(workers[t]->getPasses()) * static_cast<double>(workers[t]->getBytesPerPass());
 			total_adjusted_ticks += workers[t]->getAdjustedTicks();
 			total_elapsed_dummy_ticks += workers[t]->getElapsedDummyTicks();
 			iter_warning |= workers[t]->hadWarning();
+			_recordWorker(i, workers[t], false, helper_timer.get_ns_per_tick());
 		}
 
 		avg_adjusted_ticks = total_adjusted_ticks / _num_worker_threads;
+		_recordTrace(i, workers, helper_timer.get_ticks_per_sec(), helper_timer.get_ns_per_tick());
 
 		if (iter_warning)
 			_warning = true;
+		_endInterferenceCheck(i);
 			
-		if (g_verbose ) { //Report duration for this iteration
-			std::cout << "Iter " << i+1 << " had " << total_passes << " passes in total across " << _num_worker_threads << " threads, with " << bytes_per_pass << " bytes touched per pass:";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
-
-			std::cout << "...clock ticks in total across " << _num_worker_threads << " threads == " << total_adjusted_ticks << " (adjusted by -" << total_elapsed_dummy_ticks << ")";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+		if (_info_log != NULL) { //Report duration for this iteration
+			*_info_log << "Iter " << i+1 << " had " << total_passes << " passes in total across " << _num_worker_threads << " threads, with " << bytes_per_pass << " bytes touched per pass:";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
+
+			*_info_log << "...clock ticks in total across " << _num_worker_threads << " threads == " << total_adjusted_ticks << " (adjusted by -" << total_elapsed_dummy_ticks << ")";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
 			
-			std::cout << "...ns in total across " << _num_worker_threads << " threads == " << total_adjusted_ticks * helper_timer.get_ns_per_tick() << " (adjusted by -" << total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() << ")";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+			*_info_log << "...ns in total across " << _num_worker_threads << " threads == " << total_adjusted_ticks * helper_timer.get_ns_per_tick() << " (adjusted by -" << total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() << ")";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
 
-			std::cout << "...sec in total across " << _num_worker_threads << " threads == " << total_adjusted_ticks * helper_timer.get_ns_per_tick() / 1e9 << " (adjusted by -" << total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() / 1e9 << ")";
-			if (iter_warning) std::cout << " -- WARNING";
-			std::cout << std::endl;
+			*_info_log << "...sec in total across " << _num_worker_threads << " threads == " << total_adjusted_ticks * helper_timer.get_ns_per_tick() / 1e9 << " (adjusted by -" << total_elapsed_dummy_ticks * helper_timer.get_ns_per_tick() / 1e9 << ")";
+			if (iter_warning) *_info_log << " -- WARNING";
+			*_info_log << std::endl;
+
+			for (uint32_t t = 0; t < _num_worker_threads; t++) {
+				const WorkerResult& w = _workersOnIter[i][t];
+				*_info_log << "...thread " << t << " on CPU " << w.cpu << " == " << w.passes << " passes, " << w.adjusted_ticks << " ticks, " << w.throughput << " MB/s";
+				if (w.warning) *_info_log << " -- WARNING";
+				*_info_log << std::endl;
+			}
 		}
 		
 		//Compute metric for this iteration
-		_metricOnIter[i] = ((static_cast<double>(total_passes) * static_cast<double>(bytes_per_pass)) / static_cast<double>(MB))   /   ((static_cast<double>(avg_adjusted_ticks) * helper_timer.get_ns_per_tick()) / 1e9);
-		_averageMetric += _metricOnIter[i];
+		_metricOnIter[i] = (total_bytes / static_cast<double>(MB))   /   ((static_cast<double>(avg_adjusted_ticks) * helper_timer.get_ns_per_tick()) / 1e9);
 
 
 		//Clean up workers and threads for this iteration
@@ -226,17 +270,17 @@ bool ThroughputBenchmark::_run_core() {
 	}
 
 	//Stopping power measurement
-	if (g_verbose) 
-		std::cout << "Stopping power measurement threads...";
+	if (_info_log != NULL) 
+		*_info_log << "Stopping power measurement threads...";
 	if (!_stop_power_threads()) {
-		if (g_verbose)
-			std::cout << "FAIL" << std::endl;
-		std::cerr << "WARNING: Failed to stop power measurement threads." << std::endl;
-	} else if (g_verbose)
-		std::cout << "done" << std::endl;
+		if (_info_log != NULL)
+			*_info_log << "FAIL" << std::endl;
+		_reportWarning("Failed to stop power measurement threads.");
+	} else if (_info_log != NULL)
+		*_info_log << "done" << std::endl;
 	
 	//Run metadata
-	_averageMetric /= static_cast<double>(_iterations);
+	_finishIterations();
 	_hasRun = true;
 
 	return true;
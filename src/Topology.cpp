@@ -0,0 +1,800 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the Topology class.
+ */
+
+//Headers
+#include <Topology.h>
+#include <common.h>
+
+//Libraries
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <unistd.h>
+#include <sched.h>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#endif
+
+namespace xmem {
+	Topology g_topology;
+};
+
+using namespace xmem;
+
+#ifdef __gnu_linux__
+/**
+ * @brief Reads the first line of a sysfs file.
+ * @param path Path of the file.
+ * @param line Filled with the line on success.
+ * @returns True on success.
+ */
+static bool read_sysfs_line(const std::string& path, std::string& line) {
+	std::ifstream in(path.c_str());
+	if (!in.is_open())
+		return false;
+	std::getline(in, line);
+	return !line.empty();
+}
+
+/**
+ * @brief Reads an integer from a sysfs file.
+ * @param path Path of the file.
+ * @param default_value Returned if the file is missing or malformed.
+ * @returns The integer.
+ */
+static int64_t read_sysfs_int(const std::string& path, int64_t default_value) {
+	std::string line;
+	if (!read_sysfs_line(path, line))
+		return default_value;
+	char* endptr = NULL;
+	int64_t value = strtoll(line.c_str(), &endptr, 10);
+	if (endptr == line.c_str())
+		return default_value;
+	return value;
+}
+
+/**
+ * @brief Reads the first line of a cgroup control file. Without a cgroup namespace, /proc/self/cgroup gives the path from the hierarchy root, but a container may only see its own cgroup mounted at the root, so fall back to that.
+ * @param mount The mount point of the hierarchy, e.g. /sys/fs/cgroup.
+ * @param path The cgroup path from /proc/self/cgroup.
+ * @param file The control file name.
+ * @param line Filled with the line on success.
+ * @returns True on success.
+ */
+static bool read_cgroup_file(const std::string& mount, const std::string& path, const std::string& file, std::string& line) {
+	if (read_sysfs_line(mount + path + "/" + file, line))
+		return true;
+	return read_sysfs_line(mount + "/" + file, line);
+}
+#endif
+
+Topology::Topology() :
+		__built(false),
+		__num_logical_cpus(0),
+		__num_online_cpus(0),
+		__num_physical_cores(0),
+		__num_packages(0),
+		__has_cache_info(false),
+		__cpu_node(),
+		__cpu_package(),
+		__cpu_die(),
+		__cpu_core(),
+		__cpu_siblings(),
+		__node_cpus(),
+		__node_has_memory(),
+		__distances(),
+		__caches(),
+		__cpu_allowed(),
+		__cpu_isolated(),
+		__mems_constrained(false),
+		__memory_limit(0),
+		__empty()
+	{
+}
+
+bool Topology::build() {
+	if (__built)
+		return true;
+
+#ifdef _WIN32
+	//Per-CPU tables are indexed by the bit position in a processor mask
+	uint32_t max_cpus = static_cast<uint32_t>(sizeof(ULONG_PTR) * 8);
+	__cpu_node.assign(max_cpus, -1);
+	__cpu_package.assign(max_cpus, -1);
+	__cpu_die.assign(max_cpus, -1);
+	__cpu_core.assign(max_cpus, -1);
+	__cpu_siblings.assign(max_cpus, std::vector<uint32_t>());
+
+	ULONG highest_node = 0;
+	if (!GetNumaHighestNodeNumber(&highest_node))
+		highest_node = 0;
+	uint32_t num_nodes = static_cast<uint32_t>(highest_node) + 1;
+	__node_cpus.assign(num_nodes, std::vector<uint32_t>());
+	__node_has_memory.assign(num_nodes, false);
+	__distances.assign(num_nodes, std::vector<int32_t>(num_nodes, -1)); //TODO: Windows does not directly expose the SLIT distances.
+	for (uint32_t n = 0; n < num_nodes; n++) {
+		ULONGLONG mask = 0;
+		if (GetNumaNodeProcessorMask(static_cast<UCHAR>(n), &mask)) {
+			for (uint32_t cpu = 0; cpu < max_cpus; cpu++) {
+				if ((mask >> cpu) & 0x1) {
+					__node_cpus[n].push_back(cpu);
+					__cpu_node[cpu] = static_cast<int32_t>(n);
+				}
+			}
+		}
+		ULONGLONG available_bytes = 0;
+		__node_has_memory[n] = GetNumaAvailableMemoryNode(static_cast<UCHAR>(n), &available_bytes) && available_bytes > 0;
+		__distances[n][n] = 10;
+	}
+
+	//Cores, packages and caches
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION buffer = NULL;
+	DWORD len = 0;
+	GetLogicalProcessorInformation(buffer, &len); //this will fail because buffer is not yet allocated.
+	buffer = static_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION>(malloc(len));
+	if (!buffer || !GetLogicalProcessorInformation(buffer, &len)) {
+		std::cerr << "WARNING: Failed to query logical processor information for the topology." << std::endl;
+		if (buffer)
+			free(buffer);
+		return false;
+	}
+
+	int64_t core_index = 0;
+	int32_t package_index = 0;
+	PSYSTEM_LOGICAL_PROCESSOR_INFORMATION curr = buffer;
+	for (DWORD offset = 0; offset + sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION) <= len; offset += sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION), curr++) {
+		std::vector<uint32_t> cpus;
+		for (uint32_t cpu = 0; cpu < max_cpus; cpu++)
+			if ((curr->ProcessorMask >> cpu) & 0x1)
+				cpus.push_back(cpu);
+
+		if (curr->Relationship == RelationProcessorCore) {
+			for (uint32_t i = 0; i < cpus.size(); i++) {
+				__cpu_core[cpus[i]] = core_index;
+				__cpu_siblings[cpus[i]] = cpus;
+			}
+			core_index++;
+		} else if (curr->Relationship == RelationProcessorPackage) {
+			for (uint32_t i = 0; i < cpus.size(); i++) {
+				__cpu_package[cpus[i]] = package_index;
+				__cpu_die[cpus[i]] = 0;
+			}
+			package_index++;
+		} else if (curr->Relationship == RelationCache) {
+			CacheDomain cache;
+			cache.level = curr->Cache.Level;
+			switch (curr->Cache.Type) {
+				case CacheInstruction:
+					cache.type = "Instruction";
+					break;
+				case CacheData:
+					cache.type = "Data";
+					break;
+				default:
+					cache.type = "Unified";
+					break;
+			}
+			cache.size = curr->Cache.Size;
+			cache.cpus = cpus;
+			__caches.push_back(cache);
+		}
+	}
+	free(buffer);
+
+	__num_logical_cpus = 0;
+	for (uint32_t cpu = 0; cpu < max_cpus; cpu++) {
+		if (!__cpu_siblings[cpu].empty())
+			__num_logical_cpus++;
+	}
+#endif
+
+#ifdef __gnu_linux__
+	std::string line;
+
+	//Online logical CPUs
+	std::vector<uint32_t> online_cpus;
+	if (!read_sysfs_line("/sys/devices/system/cpu/online", line) || !parse_cpu_list(line, online_cpus) || online_cpus.empty()) {
+		online_cpus.clear();
+		int32_t total_num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		for (int32_t c = 0; c < total_num_cpus; c++)
+			online_cpus.push_back(static_cast<uint32_t>(c));
+	}
+	__num_logical_cpus = static_cast<uint32_t>(online_cpus.size());
+	uint32_t max_cpus = online_cpus.back() + 1;
+	__cpu_node.assign(max_cpus, -1);
+	__cpu_package.assign(max_cpus, -1);
+	__cpu_die.assign(max_cpus, -1);
+	__cpu_core.assign(max_cpus, -1);
+	__cpu_siblings.assign(max_cpus, std::vector<uint32_t>());
+
+	//Packages, dies, cores and SMT siblings
+	for (uint32_t i = 0; i < online_cpus.size(); i++) {
+		uint32_t cpu = online_cpus[i];
+		std::ostringstream prefix;
+		prefix << "/sys/devices/system/cpu/cpu" << cpu << "/topology/";
+
+		int64_t package_id = read_sysfs_int(prefix.str() + "physical_package_id", -1);
+		int64_t die_id = read_sysfs_int(prefix.str() + "die_id", 0); //Older kernels do not report dies
+		int64_t core_id = read_sysfs_int(prefix.str() + "core_id", -1);
+		__cpu_package[cpu] = static_cast<int32_t>(package_id);
+		__cpu_die[cpu] = static_cast<int32_t>(die_id);
+		if (package_id >= 0 && die_id >= 0 && core_id >= 0)
+			__cpu_core[cpu] = (package_id << 40) | (die_id << 24) | core_id; //core_id is only unique within a die
+
+		std::vector<uint32_t> siblings;
+		if (read_sysfs_line(prefix.str() + "thread_siblings_list", line))
+			parse_cpu_list(line, siblings);
+		for (uint32_t s = 0; s < siblings.size(); s++)
+			if (siblings[s] < max_cpus && std::binary_search(online_cpus.begin(), online_cpus.end(), siblings[s]))
+				__cpu_siblings[cpu].push_back(siblings[s]);
+		if (__cpu_siblings[cpu].empty())
+			__cpu_siblings[cpu].push_back(cpu);
+	}
+
+	//NUMA nodes. Node IDs may be sparse, and some nodes may have memory but no CPUs.
+	std::vector<uint32_t> online_nodes;
+	if (!read_sysfs_line("/sys/devices/system/node/online", line) || !parse_cpu_list(line, online_nodes) || online_nodes.empty()) {
+		__buildSingleNode(online_cpus);
+	} else {
+		uint32_t num_nodes = online_nodes.back() + 1;
+		__node_cpus.assign(num_nodes, std::vector<uint32_t>());
+		__distances.assign(num_nodes, std::vector<int32_t>(num_nodes, -1));
+
+		std::vector<uint32_t> memory_nodes;
+		if (read_sysfs_line("/sys/devices/system/node/has_memory", line) && parse_cpu_list(line, memory_nodes)) {
+			__node_has_memory.assign(num_nodes, false);
+			for (uint32_t i = 0; i < memory_nodes.size(); i++)
+				if (memory_nodes[i] < num_nodes)
+					__node_has_memory[memory_nodes[i]] = true;
+		} else
+			__node_has_memory.assign(num_nodes, true);
+
+		for (uint32_t i = 0; i < online_nodes.size(); i++) {
+			uint32_t node = online_nodes[i];
+			std::ostringstream prefix;
+			prefix << "/sys/devices/system/node/node" << node << "/";
+
+			std::vector<uint32_t> node_cpus;
+			if (read_sysfs_line(prefix.str() + "cpulist", line))
+				parse_cpu_list(line, node_cpus);
+			for (uint32_t c = 0; c < node_cpus.size(); c++) {
+				if (node_cpus[c] < max_cpus && !__cpu_siblings[node_cpus[c]].empty()) { //online CPUs only
+					__node_cpus[node].push_back(node_cpus[c]);
+					__cpu_node[node_cpus[c]] = static_cast<int32_t>(node);
+				}
+			}
+
+			//The distance file lists one entry per online node, in node order
+			if (read_sysfs_line(prefix.str() + "distance", line)) {
+				std::istringstream distances(line);
+				int32_t distance = 0;
+				for (uint32_t j = 0; j < online_nodes.size() && (distances >> distance); j++)
+					__distances[node][online_nodes[j]] = distance;
+			}
+		}
+	}
+
+	//Caches. Each distinct combination of level, type and sharing CPUs is one cache.
+	for (uint32_t i = 0; i < online_cpus.size(); i++) {
+		for (uint32_t index = 0; ; index++) {
+			std::ostringstream prefix;
+			prefix << "/sys/devices/system/cpu/cpu" << online_cpus[i] << "/cache/index" << index << "/";
+
+			int64_t level = read_sysfs_int(prefix.str() + "level", -1);
+			if (level < 0)
+				break;
+
+			CacheDomain cache;
+			cache.level = static_cast<uint32_t>(level);
+			if (!read_sysfs_line(prefix.str() + "type", cache.type))
+				cache.type = "Unified";
+			cache.size = 0;
+			if (read_sysfs_line(prefix.str() + "size", line)) {
+				char* endptr = NULL;
+				cache.size = strtoul(line.c_str(), &endptr, 10);
+				if (*endptr == 'K')
+					cache.size *= KB;
+				else if (*endptr == 'M')
+					cache.size *= MB;
+			}
+			if (!read_sysfs_line(prefix.str() + "shared_cpu_list", line) || !parse_cpu_list(line, cache.cpus))
+				cache.cpus.assign(1, online_cpus[i]);
+
+			bool seen = false;
+			for (uint32_t c = 0; c < __caches.size() && !seen; c++)
+				seen = (__caches[c].level == cache.level && __caches[c].type == cache.type && __caches[c].cpus == cache.cpus);
+			if (!seen)
+				__caches.push_back(cache);
+		}
+	}
+#endif
+
+	__has_cache_info = !__caches.empty();
+	__num_online_cpus = __num_logical_cpus;
+	__applyConstraints();
+	__computeCounts();
+	__built = true;
+	return true;
+}
+
+void Topology::__applyConstraints() {
+	__cpu_allowed.assign(__cpu_siblings.size(), false);
+	for (uint32_t cpu = 0; cpu < __cpu_siblings.size(); cpu++)
+		__cpu_allowed[cpu] = !__cpu_siblings[cpu].empty(); //online
+	__cpu_isolated.assign(__cpu_siblings.size(), false);
+
+#ifdef _WIN32
+	DWORD_PTR process_mask = 0;
+	DWORD_PTR system_mask = 0;
+	if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask)) {
+		for (uint32_t cpu = 0; cpu < __cpu_allowed.size(); cpu++)
+			if (!((process_mask >> cpu) & 0x1))
+				__cpu_allowed[cpu] = false;
+	}
+
+	//Memory limit of the job object the process runs in, e.g. a Windows container. Both the per-process and the per-job limit apply, so take the smaller.
+	JOBOBJECT_EXTENDED_LIMIT_INFORMATION job_limits;
+	if (QueryInformationJobObject(NULL, JobObjectExtendedLimitInformation, &job_limits, sizeof(job_limits), NULL)) {
+		if ((job_limits.BasicLimitInformation.LimitFlags & JOB_OBJECT_LIMIT_PROCESS_MEMORY) && job_limits.ProcessMemoryLimit > 0)
+			__memory_limit = job_limits.ProcessMemoryLimit;
+		if ((job_limits.BasicLimitInformation.LimitFlags & JOB_OBJECT_LIMIT_JOB_MEMORY) && job_limits.JobMemoryLimit > 0 && (__memory_limit == 0 || job_limits.JobMemoryLimit < __memory_limit))
+			__memory_limit = job_limits.JobMemoryLimit;
+	}
+#endif
+
+#ifdef __gnu_linux__
+	//CPUs set aside by isolcpus= or nohz_full= on the kernel command line. The latter reads "(null)" when unused.
+	const char* isolation_files[] = { "/sys/devices/system/cpu/isolated", "/sys/devices/system/cpu/nohz_full" };
+	for (uint32_t f = 0; f < 2; f++) {
+		std::string isolation_line;
+		std::vector<uint32_t> isolated_cpus;
+		if (read_sysfs_line(isolation_files[f], isolation_line) && parse_cpu_list(isolation_line, isolated_cpus))
+			for (uint32_t i = 0; i < isolated_cpus.size(); i++)
+				if (isolated_cpus[i] < __cpu_isolated.size() && __cpu_allowed[isolated_cpus[i]])
+					__cpu_isolated[isolated_cpus[i]] = true;
+	}
+
+	//Affinity mask inherited from the launcher, e.g. taskset or a container runtime
+	cpu_set_t affinity;
+	CPU_ZERO(&affinity);
+	if (sched_getaffinity(0, sizeof(affinity), &affinity) == 0) {
+		//With isolcpus, the kernel's default mask is exactly the housekeeping CPUs. That is not a restriction chosen by the user, so keep the isolated CPUs.
+		bool default_isolation_mask = false;
+		for (uint32_t cpu = 0; cpu < __cpu_allowed.size() && cpu < CPU_SETSIZE; cpu++) {
+			if (__cpu_isolated[cpu])
+				default_isolation_mask = true;
+		}
+		for (uint32_t cpu = 0; cpu < __cpu_allowed.size() && cpu < CPU_SETSIZE && default_isolation_mask; cpu++) {
+			if (__cpu_allowed[cpu] && CPU_ISSET(cpu, &affinity) == __cpu_isolated[cpu])
+				default_isolation_mask = false;
+		}
+		for (uint32_t cpu = 0; cpu < __cpu_allowed.size() && cpu < CPU_SETSIZE; cpu++)
+			if (!CPU_ISSET(cpu, &affinity) && !(default_isolation_mask && __cpu_isolated[cpu]))
+				__cpu_allowed[cpu] = false;
+	}
+
+	//Find our cgroups. Each line is hierarchy-ID:controller-list:path, and the cgroup v2 unified hierarchy has ID 0 and no controllers.
+	std::string v2_path;
+	std::string cpuset_path;
+	std::string memory_path;
+	bool have_v2 = false;
+	bool have_cpuset = false;
+	bool have_memory = false;
+	std::ifstream cgroups("/proc/self/cgroup");
+	std::string line;
+	while (std::getline(cgroups, line)) {
+		size_t first = line.find(':');
+		size_t second = line.find(':', first + 1);
+		if (first == std::string::npos || second == std::string::npos)
+			continue;
+		std::string controllers = "," + line.substr(first + 1, second - first - 1) + ",";
+		std::string path = line.substr(second + 1);
+		if (path == "/")
+			path = "";
+		if (line.substr(0, first) == "0" && controllers == ",,") {
+			v2_path = path;
+			have_v2 = true;
+		}
+		if (controllers.find(",cpuset,") != std::string::npos) {
+			cpuset_path = path;
+			have_cpuset = true;
+		}
+		if (controllers.find(",memory,") != std::string::npos) {
+			memory_path = path;
+			have_memory = true;
+		}
+	}
+
+	std::string cpus_line;
+	std::string mems_line;
+	if (have_cpuset) { //cgroup v1
+		if (!read_cgroup_file("/sys/fs/cgroup/cpuset", cpuset_path, "cpuset.effective_cpus", cpus_line))
+			read_cgroup_file("/sys/fs/cgroup/cpuset", cpuset_path, "cpuset.cpus", cpus_line);
+		if (!read_cgroup_file("/sys/fs/cgroup/cpuset", cpuset_path, "cpuset.effective_mems", mems_line))
+			read_cgroup_file("/sys/fs/cgroup/cpuset", cpuset_path, "cpuset.mems", mems_line);
+	} else if (have_v2) {
+		read_cgroup_file("/sys/fs/cgroup", v2_path, "cpuset.cpus.effective", cpus_line);
+		read_cgroup_file("/sys/fs/cgroup", v2_path, "cpuset.mems.effective", mems_line);
+	}
+
+	std::vector<uint32_t> cgroup_cpus;
+	if (!cpus_line.empty() && parse_cpu_list(cpus_line, cgroup_cpus)) {
+		std::vector<bool> in_cpuset(__cpu_allowed.size(), false);
+		for (uint32_t i = 0; i < cgroup_cpus.size(); i++)
+			if (cgroup_cpus[i] < in_cpuset.size())
+				in_cpuset[cgroup_cpus[i]] = true;
+		for (uint32_t cpu = 0; cpu < __cpu_allowed.size(); cpu++)
+			__cpu_allowed[cpu] = __cpu_allowed[cpu] && in_cpuset[cpu];
+	}
+	for (uint32_t cpu = 0; cpu < __cpu_isolated.size(); cpu++)
+		__cpu_isolated[cpu] = __cpu_isolated[cpu] && __cpu_allowed[cpu];
+
+	std::vector<uint32_t> cgroup_mems;
+	if (!mems_line.empty() && parse_cpu_list(mems_line, cgroup_mems)) {
+		std::vector<bool> in_cpuset(__node_has_memory.size(), false);
+		for (uint32_t i = 0; i < cgroup_mems.size(); i++)
+			if (cgroup_mems[i] < in_cpuset.size())
+				in_cpuset[cgroup_mems[i]] = true;
+		for (uint32_t node = 0; node < __node_has_memory.size(); node++) {
+			if (__node_has_memory[node] && !in_cpuset[node]) {
+				__node_has_memory[node] = false;
+				__mems_constrained = true;
+			}
+		}
+	}
+
+	//Memory limit. In cgroup v2 every ancestor's memory.max applies, so take the smallest.
+	if (have_memory) { //cgroup v1
+		if (read_cgroup_file("/sys/fs/cgroup/memory", memory_path, "memory.limit_in_bytes", line)) {
+			unsigned long long limit = strtoull(line.c_str(), NULL, 10);
+			if (limit > 0 && limit < (1ULL << 62)) //v1 reports a huge page-aligned value when unlimited
+				__memory_limit = static_cast<size_t>(limit);
+		}
+	} else if (have_v2) {
+		std::string path = v2_path;
+		while (true) {
+			if (read_sysfs_line("/sys/fs/cgroup" + path + "/memory.max", line) && line != "max") {
+				size_t limit = static_cast<size_t>(strtoull(line.c_str(), NULL, 10));
+				if (limit > 0 && (__memory_limit == 0 || limit < __memory_limit))
+					__memory_limit = limit;
+			}
+			if (path.empty())
+				break;
+			path = path.substr(0, path.rfind('/'));
+		}
+	}
+#endif
+
+	//Drop disallowed CPUs so that every placement query only sees usable CPUs
+	__num_logical_cpus = 0;
+	for (uint32_t cpu = 0; cpu < __cpu_allowed.size(); cpu++) {
+		if (!__cpu_allowed[cpu]) {
+			__cpu_siblings[cpu].clear();
+			continue;
+		}
+		__num_logical_cpus++;
+		std::vector<uint32_t> siblings;
+		for (uint32_t s = 0; s < __cpu_siblings[cpu].size(); s++)
+			if (__cpu_siblings[cpu][s] < __cpu_allowed.size() && __cpu_allowed[__cpu_siblings[cpu][s]])
+				siblings.push_back(__cpu_siblings[cpu][s]);
+		__cpu_siblings[cpu] = siblings;
+	}
+	for (uint32_t node = 0; node < __node_cpus.size(); node++) {
+		std::vector<uint32_t> cpus;
+		for (uint32_t i = 0; i < __node_cpus[node].size(); i++)
+			if (isCPUAllowed(__node_cpus[node][i]))
+				cpus.push_back(__node_cpus[node][i]);
+		__node_cpus[node] = cpus;
+	}
+}
+
+void Topology::__buildSingleNode(const std::vector<uint32_t>& cpus) {
+	__node_cpus.assign(1, cpus);
+	__node_has_memory.assign(1, true);
+	__distances.assign(1, std::vector<int32_t>(1, 10));
+	for (uint32_t i = 0; i < cpus.size(); i++)
+		__cpu_node[cpus[i]] = 0;
+}
+
+void Topology::__computeCounts() {
+	std::vector<int64_t> cores;
+	std::vector<int32_t> packages;
+	for (uint32_t cpu = 0; cpu < __cpu_siblings.size(); cpu++) {
+		if (__cpu_siblings[cpu].empty()) //offline or nonexistent
+			continue;
+		int64_t core = __cpu_core[cpu] >= 0 ? __cpu_core[cpu] : -1 - static_cast<int64_t>(cpu); //unknown core: count the CPU as its own
+		if (std::find(cores.begin(), cores.end(), core) == cores.end())
+			cores.push_back(core);
+		if (__cpu_package[cpu] >= 0 && std::find(packages.begin(), packages.end(), __cpu_package[cpu]) == packages.end())
+			packages.push_back(__cpu_package[cpu]);
+	}
+	__num_physical_cores = static_cast<uint32_t>(cores.size());
+	__num_packages = packages.empty() ? 1 : static_cast<uint32_t>(packages.size());
+}
+
+void Topology::report() const {
+	std::cout << std::endl << "System topology:" << std::endl;
+	for (uint32_t node = 0; node < __node_cpus.size(); node++) {
+		if (!nodeHasCPUs(node) && !nodeHasMemory(node))
+			continue;
+		std::cout << "NUMA node " << node << ": ";
+		if (nodeHasCPUs(node)) {
+			std::cout << __node_cpus[node].size() << " logical CPUs (";
+			for (uint32_t i = 0; i < __node_cpus[node].size(); i++)
+				std::cout << (i > 0 ? " " : "") << __node_cpus[node][i];
+			std::cout << ")";
+		} else
+			std::cout << "memory only";
+		if (!nodeHasMemory(node))
+			std::cout << ", no memory";
+		std::cout << ", distances:";
+		for (uint32_t to = 0; to < __distances[node].size(); to++)
+			std::cout << " " << __distances[node][to];
+		std::cout << std::endl;
+	}
+	if (isCPUConstrained())
+		std::cout << "Allowed logical CPUs: " << __num_logical_cpus << " of " << __num_online_cpus << " online (affinity mask or cpuset cgroup)" << std::endl;
+	if (hasIsolatedCPUs()) {
+		std::cout << "Isolated logical CPUs (isolcpus or nohz_full):";
+		for (uint32_t cpu = 0; cpu < __cpu_isolated.size(); cpu++)
+			if (__cpu_isolated[cpu])
+				std::cout << " " << cpu;
+		std::cout << std::endl;
+	}
+	if (isMemoryNodeConstrained())
+		std::cout << "Some NUMA nodes are excluded by the cpuset cgroup and will not be used as memory nodes." << std::endl;
+	if (__memory_limit > 0) {
+#ifdef _WIN32
+		std::cout << "Job object memory limit: " << __memory_limit / MB << " MB" << std::endl;
+#endif
+#ifdef __gnu_linux__
+		std::cout << "cgroup memory limit: " << __memory_limit / MB << " MB" << std::endl;
+#endif
+	}
+	for (uint32_t level = 1; level <= 4; level++) {
+		uint32_t count = getNumCaches(level);
+		if (count == 0)
+			continue;
+		std::cout << "L" << level << " caches: " << count;
+		for (uint32_t c = 0; c < __caches.size(); c++) {
+			if (__caches[c].level == level) {
+				std::cout << " (" << __caches[c].type << ", " << __caches[c].size / KB << " KB, shared by " << __caches[c].cpus.size() << " logical CPUs)";
+				break;
+			}
+		}
+		std::cout << std::endl;
+	}
+}
+
+uint32_t Topology::getNumNodes() const {
+	return static_cast<uint32_t>(__node_cpus.size());
+}
+
+uint32_t Topology::getNumLogicalCPUs() const {
+	return __num_logical_cpus;
+}
+
+uint32_t Topology::getNumPhysicalCores() const {
+	return __num_physical_cores;
+}
+
+uint32_t Topology::getNumPackages() const {
+	return __num_packages;
+}
+
+uint32_t Topology::getNumCaches(uint32_t level) const {
+	uint32_t count = 0;
+	for (uint32_t c = 0; c < __caches.size(); c++)
+		if (__caches[c].level == level)
+			count++;
+	return count;
+}
+
+bool Topology::hasCacheInfo() const {
+	return __has_cache_info;
+}
+
+const std::vector<uint32_t>& Topology::getCPUsInNode(uint32_t numa_node) const {
+	if (numa_node < __node_cpus.size())
+		return __node_cpus[numa_node];
+	return __empty;
+}
+
+int32_t Topology::getNodeOfCPU(uint32_t cpu_id) const {
+	if (cpu_id < __cpu_node.size())
+		return __cpu_node[cpu_id];
+	return -1;
+}
+
+int32_t Topology::getPackageOfCPU(uint32_t cpu_id) const {
+	if (cpu_id < __cpu_package.size())
+		return __cpu_package[cpu_id];
+	return -1;
+}
+
+int32_t Topology::getDieOfCPU(uint32_t cpu_id) const {
+	if (cpu_id < __cpu_die.size())
+		return __cpu_die[cpu_id];
+	return -1;
+}
+
+int64_t Topology::getCoreOfCPU(uint32_t cpu_id) const {
+	if (cpu_id < __cpu_core.size())
+		return __cpu_core[cpu_id];
+	return -1;
+}
+
+const std::vector<uint32_t>& Topology::getSMTSiblings(uint32_t cpu_id) const {
+	if (cpu_id < __cpu_siblings.size())
+		return __cpu_siblings[cpu_id];
+	return __empty;
+}
+
+int32_t Topology::getDistance(uint32_t from_node, uint32_t to_node) const {
+	if (from_node < __distances.size() && to_node < __distances[from_node].size())
+		return __distances[from_node][to_node];
+	return -1;
+}
+
+bool Topology::nodeHasCPUs(uint32_t numa_node) const {
+	return numa_node < __node_cpus.size() && !__node_cpus[numa_node].empty();
+}
+
+bool Topology::nodeHasMemory(uint32_t numa_node) const {
+	return numa_node < __node_has_memory.size() && __node_has_memory[numa_node];
+}
+
+bool Topology::isMemoryOnlyNode(uint32_t numa_node) const {
+	return nodeHasMemory(numa_node) && !nodeHasCPUs(numa_node);
+}
+
+const std::vector<CacheDomain>& Topology::getCaches() const {
+	return __caches;
+}
+
+bool Topology::isCPUAllowed(uint32_t cpu_id) const {
+	return cpu_id < __cpu_allowed.size() && __cpu_allowed[cpu_id];
+}
+
+bool Topology::isCPUConstrained() const {
+	return __num_logical_cpus < __num_online_cpus;
+}
+
+bool Topology::isMemoryNodeConstrained() const {
+	return __mems_constrained;
+}
+
+uint32_t Topology::getNumOnlineCPUs() const {
+	return __num_online_cpus;
+}
+
+size_t Topology::getMemoryLimit() const {
+	return __memory_limit;
+}
+
+bool Topology::isCPUIsolated(uint32_t cpu_id) const {
+	return cpu_id < __cpu_isolated.size() && __cpu_isolated[cpu_id];
+}
+
+bool Topology::hasIsolatedCPUs() const {
+	return std::find(__cpu_isolated.begin(), __cpu_isolated.end(), true) != __cpu_isolated.end();
+}
+
+std::vector<uint32_t> Topology::getHousekeepingCPUs() const {
+	std::vector<uint32_t> cpus;
+	for (uint32_t cpu = 0; cpu < __cpu_allowed.size(); cpu++)
+		if (__cpu_allowed[cpu] && !isCPUIsolated(cpu))
+			cpus.push_back(cpu);
+	return cpus;
+}
+
+std::vector<uint32_t> Topology::getPlacementOrder(uint32_t numa_node, placement_policy_t policy) const {
+	//Visit the requested node first, then the others from nearest to farthest. Unknown distances sort last.
+	std::vector<uint32_t> nodes;
+	for (uint32_t n = 0; n < __node_cpus.size(); n++)
+		if (n != numa_node && nodeHasCPUs(n))
+			nodes.push_back(n);
+	for (uint32_t i = 1; i < nodes.size(); i++) { //insertion sort by distance, stable so ties keep ascending node order
+		uint32_t n = nodes[i];
+		uint32_t d = static_cast<uint32_t>(getDistance(numa_node, n));
+		uint32_t j = i;
+		while (j > 0 && static_cast<uint32_t>(getDistance(numa_node, nodes[j-1])) > d) {
+			nodes[j] = nodes[j-1];
+			j--;
+		}
+		nodes[j] = n;
+	}
+	nodes.insert(nodes.begin(), numa_node);
+
+	std::vector<uint32_t> order;
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		const std::vector<uint32_t>& node_cpus = getCPUsInNode(nodes[i]);
+
+		//Group this node's CPUs by physical core, in order of first appearance
+		std::vector<int64_t> core_keys;
+		std::vector< std::vector<uint32_t> > core_cpus;
+		for (uint32_t c = 0; c < node_cpus.size(); c++) {
+			int64_t key = getCoreOfCPU(node_cpus[c]);
+			if (key < 0)
+				key = -1 - static_cast<int64_t>(node_cpus[c]); //unknown core: treat as its own
+			uint32_t k = 0;
+			while (k < core_keys.size() && core_keys[k] != key)
+				k++;
+			if (k == core_keys.size()) {
+				core_keys.push_back(key);
+				core_cpus.push_back(std::vector<uint32_t>());
+			}
+			core_cpus[k].push_back(node_cpus[c]);
+		}
+
+		switch (policy) {
+			case PLACEMENT_SCATTER: {
+				bool added = true;
+				for (uint32_t sibling = 0; added; sibling++) {
+					added = false;
+					for (uint32_t k = 0; k < core_cpus.size(); k++) {
+						if (sibling < core_cpus[k].size()) {
+							order.push_back(core_cpus[k][sibling]);
+							added = true;
+						}
+					}
+				}
+				break;
+			}
+			case PLACEMENT_SMT_PAIRS:
+				for (uint32_t k = 0; k < core_cpus.size(); k++)
+					order.insert(order.end(), core_cpus[k].begin(), core_cpus[k].end());
+				break;
+			case PLACEMENT_COMPACT:
+			default:
+				order.insert(order.end(), node_cpus.begin(), node_cpus.end()); //already ascending
+				break;
+		}
+
+		//Isolated CPUs of this node go first, keeping the policy's order within isolated and housekeeping CPUs
+		std::vector<uint32_t> housekeeping;
+		size_t node_begin = order.size() - node_cpus.size();
+		size_t next = node_begin;
+		for (size_t c = node_begin; c < order.size(); c++) {
+			if (isCPUIsolated(order[c]))
+				order[next++] = order[c];
+			else
+				housekeeping.push_back(order[c]);
+		}
+		std::copy(housekeeping.begin(), housekeeping.end(), order.begin() + next);
+	}
+
+	return order;
+}
@@ -44,8 +44,16 @@
 #include <random>
 #include <algorithm>
 #include <time.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sstream>
+#include <map>
 #ifdef __gnu_linux__
 #include <immintrin.h> //for Intel AVX intrinsics
+#include <unistd.h>
+#include <limits.h>
 #endif
 
 using namespace xmem;
@@ -499,9 +507,43 @@ bool xmem::determineRandomKernel(rw_mode_t rw_mode, chunk_size_t chunk_size, Ran
 	return false;
 }
 
-bool xmem::buildRandomPointerPermutation(void* start_address, void* end_address, chunk_size_t chunk_size) {
-	if (g_verbose)
-		std::cout << "Preparing a memory region under test. This might take a while...";
+bool xmem::determineLatencyKernel(uint32_t unroll_length, RandomFunction* kernel_function, RandomFunction* dummy_kernel_function) {
+	switch (unroll_length) {
+		case 128:
+			*kernel_function = &chasePointers_Unroll128;
+			*dummy_kernel_function = &dummy_chasePointers_Unroll128;
+			return true;
+		case 256:
+			*kernel_function = &chasePointers_Unroll256;
+			*dummy_kernel_function = &dummy_chasePointers_Unroll256;
+			return true;
+		case 512:
+			*kernel_function = &chasePointers_Unroll512;
+			*dummy_kernel_function = &dummy_chasePointers_Unroll512;
+			return true;
+		case 1024:
+			*kernel_function = &chasePointers_Unroll1024;
+			*dummy_kernel_function = &dummy_chasePointers_Unroll1024;
+			return true;
+		default:
+			return false;
+	}
+}
+
+/**
+ * @brief Shuffles an array of chunks with Sattolo's algorithm. Starting from chunks that point at themselves, this gives a single cycle through every chunk, so a chase from any chunk visits the whole region.
+ */
+template<typename T>
+static void shuffle_single_cycle(T* chunks, size_t num_chunks, std::mt19937_64& gen) {
+	for (size_t i = num_chunks; i > 1; i--) {
+		std::uniform_int_distribution<size_t> dist(0, i-2);
+		std::swap(chunks[i-1], chunks[dist(gen)]);
+	}
+}
+
+bool xmem::buildRandomPointerPermutation(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed, std::ostream* info_log, std::ostream* warning_log) {
+	if (info_log != NULL)
+		*info_log << "Preparing a memory region under test. This might take a while...";
 
 	size_t length = reinterpret_cast<uint8_t*>(end_address) - reinterpret_cast<uint8_t*>(start_address); //length of region in bytes
 	size_t num_pointers = 0; //Number of pointers that fit into the memory region of interest
@@ -516,11 +558,12 @@ bool xmem::buildRandomPointerPermutation(void* start_address, void* end_address,
 			num_pointers = length / sizeof(Word256_t);
 			break;
 		default:
-			std::cerr << "ERROR: Chunk size must be at least 64 bits for building a random pointer permutation. This should not have happened." << std::endl;
+			if (warning_log != NULL)
+				*warning_log << "ERROR: Chunk size must be at least 64 bits for building a random pointer permutation. This should not have happened." << std::endl;
 			return false;
 	}
 			
-	std::mt19937_64 gen(time(NULL)); //Mersenne Twister random number generator, seeded at current time
+	std::mt19937_64 gen(seed); //Mersenne Twister random number generator
 	
 	/*
 	//Build a random directed Hamiltonian Cycle across the memory region 
@@ -561,21 +604,21 @@ bool xmem::buildRandomPointerPermutation(void* start_address, void* end_address,
 	}
 	*/
 	
-	//Do a random shuffle of memory pointers
+	//Do a random shuffle of memory pointers into a single cycle
 	Word64_t* mem_region_base = reinterpret_cast<Word64_t*>(start_address);
 	switch (chunk_size) {
 		case CHUNK_64b:
 			for (size_t i = 0; i < num_pointers; i++) { //Initialize pointers to point at themselves (identity mapping)
 				mem_region_base[i] = reinterpret_cast<Word64_t>(mem_region_base+i);
 			}
-			std::shuffle(mem_region_base, mem_region_base + num_pointers, gen);
+			shuffle_single_cycle(mem_region_base, num_pointers, gen);
 			break;
 		case CHUNK_128b:
 			for (size_t i = 0; i < num_pointers; i++) { //Initialize pointers to point at themselves (identity mapping)
 				mem_region_base[i*2] = reinterpret_cast<Word64_t>(mem_region_base+(i*2));
 				mem_region_base[(i*2)+1] = 0xFFFFFFFFFFFFFFFF; //1-fill upper 64 bits
 			}
-			std::shuffle(reinterpret_cast<Word128_t*>(mem_region_base), reinterpret_cast<Word128_t*>(mem_region_base) + num_pointers, gen);
+			shuffle_single_cycle(reinterpret_cast<Word128_t*>(mem_region_base), num_pointers, gen);
 			break;
 		case CHUNK_256b:
 			for (size_t i = 0; i < num_pointers; i++) { //Initialize pointers to point at themselves (identity mapping)
@@ -584,53 +627,291 @@ bool xmem::buildRandomPointerPermutation(void* start_address, void* end_address,
 				mem_region_base[(i*4)+2] = 0xFFFFFFFFFFFFFFFF; 
 				mem_region_base[(i*4)+3] = 0xFFFFFFFFFFFFFFFF;
 			}
-			std::shuffle(reinterpret_cast<Word256_t*>(mem_region_base), reinterpret_cast<Word256_t*>(mem_region_base) + num_pointers, gen);
+			shuffle_single_cycle(reinterpret_cast<Word256_t*>(mem_region_base), num_pointers, gen);
 			break;
 		default:
-			std::cerr << "ERROR: Got an invalid chunk size. This should not have happened." << std::endl;
+			if (warning_log != NULL)
+				*warning_log << "ERROR: Got an invalid chunk size. This should not have happened." << std::endl;
 			return false;
 	}
 
-	if (g_verbose) {
-		std::cout << "done" << std::endl;
-		std::cout << std::endl;
+	if (info_log != NULL) {
+		*info_log << "done" << std::endl;
+		*info_log << std::endl;
 	}
 
 	return true;
 }
 
+bool xmem::checkKernelInstructions() {
+#ifdef _WIN32
+	std::cerr << "ERROR: The kernel self-check is only supported on GNU/Linux." << std::endl;
+	return false;
+#endif
+#ifdef __gnu_linux__
+	//Disassemble this executable. popen() runs a shell, so /proc/self/exe must be resolved here.
+	char exe_path[PATH_MAX];
+	ssize_t path_len = readlink("/proc/self/exe", exe_path, sizeof(exe_path) - 1);
+	if (path_len <= 0) {
+		std::cerr << "ERROR: Failed to find the path of this executable for the kernel self-check." << std::endl;
+		return false;
+	}
+	exe_path[path_len] = '\0';
+	std::string command = std::string("objdump -d --no-show-raw-insn -M intel '") + exe_path + "' 2>/dev/null";
+	FILE* pipe = popen(command.c_str(), "r");
+	if (pipe == NULL) {
+		std::cerr << "ERROR: Failed to run objdump for the kernel self-check." << std::endl;
+		return false;
+	}
+
+	//Count the memory instructions of each kernel, split into the expected kind and anything else
+	std::map<std::string, uint32_t> expected_counts;
+	std::map<std::string, uint32_t> other_counts;
+	std::string kernel;
+	char line[512];
+	while (fgets(line, sizeof(line), pipe) != NULL) {
+		std::string text(line);
+		size_t name_start = text.find("<linux_asm_");
+		if (name_start != std::string::npos && text.find(">:") != std::string::npos) { //start of a kernel's disassembly
+			kernel = text.substr(name_start + 1, text.find(">:") - name_start - 1);
+			expected_counts[kernel] = 0;
+			other_counts[kernel] = 0;
+			continue;
+		}
+		if (text == "\n") { //end of a symbol's disassembly
+			kernel.clear();
+			continue;
+		}
+		if (kernel.empty())
+			continue;
+
+		//Instruction lines are "address:\tmnemonic operands". Alignment padding uses nops with memory operands, and pushes, pops, and calls touch the stack without one.
+		size_t insn_start = text.find('\t');
+		std::string insn = (insn_start == std::string::npos) ? text : text.substr(insn_start + 1);
+		if (insn.compare(0, 4, "push") == 0 || insn.compare(0, 3, "pop") == 0 || insn.compare(0, 4, "call") == 0) {
+			other_counts[kernel]++;
+			continue;
+		}
+		if (text.find('[') == std::string::npos || insn.compare(0, 3, "nop") == 0 || insn.compare(0, 3, "cs ") == 0 || insn.compare(0, 6, "data16") == 0)
+			continue;
+
+		uint32_t width_bits = (kernel.find("_Word") == std::string::npos) ? 64 : static_cast<uint32_t>(strtoul(kernel.substr(kernel.rfind("_Word") + 5).c_str(), NULL, 10)); //latency kernels chase 64-bit pointers
+		const char* mnemonic = (width_bits <= 64) ? "mov " : "vmovdqa ";
+		const char* operand = (width_bits == 32) ? "DWORD PTR" : (width_bits == 64) ? "QWORD PTR" : (width_bits == 128) ? "XMMWORD PTR" : "YMMWORD PTR";
+		if (insn.compare(0, strlen(mnemonic), mnemonic) == 0 && insn.find(operand) != std::string::npos)
+			expected_counts[kernel]++;
+		else
+			other_counts[kernel]++;
+	}
+	pclose(pipe);
+
+	if (expected_counts.empty()) {
+		std::cerr << "ERROR: Found no kernels to check. Is objdump installed?" << std::endl;
+		return false;
+	}
+
+	//Every unrolled loop iteration spans 4096 bytes, and accesses every stride-th word in it
+	const char* patterns[] = { "Sequential", "Stride2", "Stride4", "Stride8", "Stride16" };
+	const uint32_t strides[] = { 1, 2, 4, 8, 16 };
+	const uint32_t widths[] = { 32, 64, 128, 256 };
+	const char* ops[] = { "Read", "Write", "Loop" };
+	const char* dirs[] = { "forw", "rev" };
+	uint32_t num_kernels = 0;
+	uint32_t num_failed = 0;
+	for (uint32_t w = 0; w < 4; w++) {
+		for (uint32_t p = 0; p < 5; p++) {
+			for (uint32_t o = 0; o < 3; o++) {
+				for (uint32_t d = 0; d < 2; d++) {
+					std::ostringstream name;
+					name << "linux_asm_" << (o == 2 ? "dummy_" : "") << dirs[d] << patterns[p] << ops[o] << "_Word" << widths[w];
+					uint32_t expected = (o == 2) ? 0 : 4096 / (widths[w] / 8 * strides[p]);
+					num_kernels++;
+					if (expected_counts.find(name.str()) == expected_counts.end()) {
+						std::cerr << "FAIL: " << name.str() << " was not found." << std::endl;
+						num_failed++;
+					} else if (expected_counts[name.str()] != expected || other_counts[name.str()] != 0) {
+						std::cerr << "FAIL: " << name.str() << " has " << expected_counts[name.str()] << " " << widths[w] << "-bit memory instructions and " << other_counts[name.str()] << " others per block. Expected " << expected << " and 0." << std::endl;
+						num_failed++;
+					} else if (g_verbose) {
+						std::cout << "OK: " << name.str() << " has " << expected << " " << widths[w] << "-bit memory instructions per block." << std::endl;
+					}
+				}
+			}
+		}
+	}
+
+	uint32_t num_throughput_kernels = num_kernels;
+
+	//Every latency kernel chases unroll pointers per block, then stores the last pointer it reached
+	const uint32_t unroll_lengths[] = { 128, 256, 512, 1024 };
+	for (uint32_t u = 0; u < 4; u++) {
+		for (uint32_t o = 0; o < 2; o++) {
+			std::ostringstream name;
+			name << "linux_asm_" << (o == 1 ? "dummy_" : "") << "chasePointers_Unroll" << unroll_lengths[u];
+			uint32_t expected = (o == 1) ? 0 : unroll_lengths[u] + 1;
+			num_kernels++;
+			if (expected_counts.find(name.str()) == expected_counts.end()) {
+				std::cerr << "FAIL: " << name.str() << " was not found." << std::endl;
+				num_failed++;
+			} else if (expected_counts[name.str()] != expected || other_counts[name.str()] != 0) {
+				std::cerr << "FAIL: " << name.str() << " has " << expected_counts[name.str()] << " 64-bit memory instructions and " << other_counts[name.str()] << " others. Expected " << expected << " and 0." << std::endl;
+				num_failed++;
+			} else if (g_verbose) {
+				std::cout << "OK: " << name.str() << " has " << expected << " 64-bit memory instructions." << std::endl;
+			}
+		}
+	}
+
+	std::cout << "Kernel self-check: " << num_kernels - num_failed << " of " << num_kernels << " kernels passed (" << num_throughput_kernels << " sequential and strided throughput kernels, " << num_kernels - num_throughput_kernels << " latency kernels)." << std::endl;
+	std::cout << "The random throughput kernels are not implemented yet and were not checked." << std::endl;
+	return num_failed == 0;
+#endif
+}
+
 /***********************************************************************
  ***********************************************************************
  ********************** LATENCY-RELATED BENCHMARK KERNELS **************
  ***********************************************************************
  ***********************************************************************/
 
+#ifdef __gnu_linux__
+//GNU assembler versions of the latency kernels, in x86_64/linux_asm_kernels.S.
+extern "C" int32_t linux_asm_chasePointers_Unroll128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_chasePointers_Unroll256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_chasePointers_Unroll512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_chasePointers_Unroll1024(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_dummy_chasePointers_Unroll128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_dummy_chasePointers_Unroll256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_dummy_chasePointers_Unroll512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+extern "C" int32_t linux_asm_dummy_chasePointers_Unroll1024(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+#endif
+
 /* --------------------- DUMMY BENCHMARK ROUTINES --------------------------- */
 
-int32_t xmem::dummy_chasePointers(uintptr_t*, uintptr_t**, size_t len) {
+int32_t xmem::dummy_chasePointers_Unroll128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
+	volatile uintptr_t placeholder = 0; //Try to defeat compiler optimizations removing this method
+	for (size_t i = 0; i < len / sizeof(uintptr_t); i += 128) //len is 0 for time-based benchmarks, in which case this is a single call
+		placeholder = 0;
+	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_chasePointers_Unroll128(first_address, last_touched_address, len);
+#endif
+}
+
+int32_t xmem::dummy_chasePointers_Unroll256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
+	volatile uintptr_t placeholder = 0; //Try to defeat compiler optimizations removing this method
+	for (size_t i = 0; i < len / sizeof(uintptr_t); i += 256) //len is 0 for time-based benchmarks, in which case this is a single call
+		placeholder = 0;
+	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_chasePointers_Unroll256(first_address, last_touched_address, len);
+#endif
+}
+
+int32_t xmem::dummy_chasePointers_Unroll512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
 	volatile uintptr_t placeholder = 0; //Try to defeat compiler optimizations removing this method
-#ifdef USE_SIZE_BASED_BENCHMARKS
-	for (size_t i = 0; i < len / sizeof(uintptr_t); i += 512)
+	for (size_t i = 0; i < len / sizeof(uintptr_t); i += 512) //len is 0 for time-based benchmarks, in which case this is a single call
 		placeholder = 0;
+	return 0;
 #endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_chasePointers_Unroll512(first_address, last_touched_address, len);
+#endif
+}
+
+int32_t xmem::dummy_chasePointers_Unroll1024(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
+	volatile uintptr_t placeholder = 0; //Try to defeat compiler optimizations removing this method
+	for (size_t i = 0; i < len / sizeof(uintptr_t); i += 1024) //len is 0 for time-based benchmarks, in which case this is a single call
+		placeholder = 0;
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_chasePointers_Unroll1024(first_address, last_touched_address, len);
+#endif
 }
 
 /* -------------------- CORE BENCHMARK ROUTINES -------------------------- */
 
-int32_t xmem::chasePointers(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+int32_t xmem::chasePointers_Unroll128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
+	volatile uintptr_t* p = first_address;
+
+	if (len == 0) { //Time-based: one unrolled block per call
+		UNROLL128(p = reinterpret_cast<uintptr_t*>(*p);)
+	} else { //Size-based: walk the whole working set per call
+		for (size_t i = 0; i < len / sizeof(uintptr_t); i += 128) {
+			UNROLL128(p = reinterpret_cast<uintptr_t*>(*p);)
+		}
+	}
+	*last_touched_address = const_cast<uintptr_t*>(p);
+	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_chasePointers_Unroll128(first_address, last_touched_address, len);
+#endif
+}
+
+int32_t xmem::chasePointers_Unroll256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
 	volatile uintptr_t* p = first_address;
 
-#ifdef USE_TIME_BASED_BENCHMARKS
-	UNROLL512(p = reinterpret_cast<uintptr_t*>(*p);)
+	if (len == 0) { //Time-based: one unrolled block per call
+		UNROLL256(p = reinterpret_cast<uintptr_t*>(*p);)
+	} else { //Size-based: walk the whole working set per call
+		for (size_t i = 0; i < len / sizeof(uintptr_t); i += 256) {
+			UNROLL256(p = reinterpret_cast<uintptr_t*>(*p);)
+		}
+	}
+	*last_touched_address = const_cast<uintptr_t*>(p);
+	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_chasePointers_Unroll256(first_address, last_touched_address, len);
 #endif
-#ifdef USE_SIZE_BASED_BENCHMARKS
-	for (size_t i = 0; i < len / sizeof(uintptr_t); i += 512) {
+}
+
+int32_t xmem::chasePointers_Unroll512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
+	volatile uintptr_t* p = first_address;
+
+	if (len == 0) { //Time-based: one unrolled block per call
 		UNROLL512(p = reinterpret_cast<uintptr_t*>(*p);)
+	} else { //Size-based: walk the whole working set per call
+		for (size_t i = 0; i < len / sizeof(uintptr_t); i += 512) {
+			UNROLL512(p = reinterpret_cast<uintptr_t*>(*p);)
+		}
 	}
+	*last_touched_address = const_cast<uintptr_t*>(p);
+	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_chasePointers_Unroll512(first_address, last_touched_address, len);
 #endif
+}
+
+int32_t xmem::chasePointers_Unroll1024(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len) {
+#ifdef _WIN32
+	volatile uintptr_t* p = first_address;
+
+	if (len == 0) { //Time-based: one unrolled block per call
+		UNROLL1024(p = reinterpret_cast<uintptr_t*>(*p);)
+	} else { //Size-based: walk the whole working set per call
+		for (size_t i = 0; i < len / sizeof(uintptr_t); i += 1024) {
+			UNROLL1024(p = reinterpret_cast<uintptr_t*>(*p);)
+		}
+	}
 	*last_touched_address = const_cast<uintptr_t*>(p);
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_chasePointers_Unroll1024(first_address, last_touched_address, len);
+#endif
 }
 
 
@@ -659,6 +940,145 @@ extern "C" int win_asm_dummy_forwSequentialLoop_Word256(Word256_t* first_word, W
 extern "C" int win_asm_dummy_revSequentialLoop_Word256(Word256_t* first_word, Word256_t* last_word);
 #endif
 
+#ifdef __gnu_linux__
+//GNU assembler versions of the sequential and strided kernels, in x86_64/linux_asm_kernels.S.
+//Compiled C++ loops change with the compiler version and flags, so these pin the exact instruction sequence of every kernel.
+
+//32-bit
+extern "C" int32_t linux_asm_forwSequentialRead_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialRead_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwSequentialWrite_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialWrite_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Read_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Write_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Write_Word32(void* start_address, void* end_address);
+
+//64-bit
+extern "C" int32_t linux_asm_forwSequentialRead_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialRead_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwSequentialWrite_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialWrite_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Read_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Write_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Write_Word64(void* start_address, void* end_address);
+
+//128-bit
+extern "C" int32_t linux_asm_forwSequentialRead_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialRead_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwSequentialWrite_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialWrite_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Read_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Write_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Write_Word128(void* start_address, void* end_address);
+
+//256-bit
+extern "C" int32_t linux_asm_forwSequentialRead_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialRead_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwSequentialWrite_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revSequentialWrite_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride2Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride2Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride4Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride4Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride8Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride8Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Read_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_forwStride16Write_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_revStride16Write_Word256(void* start_address, void* end_address);
+
+//Dummies
+//32-bit
+extern "C" int32_t linux_asm_dummy_forwSequentialLoop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revSequentialLoop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride2Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride2Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride4Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride4Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride8Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride8Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride16Loop_Word32(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride16Loop_Word32(void* start_address, void* end_address);
+//64-bit
+extern "C" int32_t linux_asm_dummy_forwSequentialLoop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revSequentialLoop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride2Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride2Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride4Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride4Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride8Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride8Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride16Loop_Word64(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride16Loop_Word64(void* start_address, void* end_address);
+//128-bit
+extern "C" int32_t linux_asm_dummy_forwSequentialLoop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revSequentialLoop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride2Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride2Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride4Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride4Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride8Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride8Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride16Loop_Word128(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride16Loop_Word128(void* start_address, void* end_address);
+//256-bit
+extern "C" int32_t linux_asm_dummy_forwSequentialLoop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revSequentialLoop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride2Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride2Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride4Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride4Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride8Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride8Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_forwStride16Loop_Word256(void* start_address, void* end_address);
+extern "C" int32_t linux_asm_dummy_revStride16Loop_Word256(void* start_address, void* end_address);
+#endif
+
 /* --------------------- DUMMY BENCHMARK ROUTINES --------------------------- */
 
 int32_t xmem::dummy_empty(void*, void*) { 
@@ -668,30 +1088,45 @@ int32_t xmem::dummy_empty(void*, void*) {
 /* ------------ SEQUENTIAL LOOP --------------*/
 
 int32_t xmem::dummy_forwSequentialLoop_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
 	for (volatile Word32_t* wordptr = static_cast<Word32_t*>(start_address), *endptr = static_cast<Word32_t*>(end_address); wordptr < endptr;) {
 		UNROLL1024(wordptr++;) 
 		placeholder = 0;
 	}
 	return placeholder;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwSequentialLoop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwSequentialLoop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
 	for (volatile Word64_t* wordptr = static_cast<Word64_t*>(start_address), *endptr = static_cast<Word64_t*>(end_address); wordptr < endptr;) {
 		UNROLL512(wordptr++;) 
 		placeholder = 0;
 	}
 	return placeholder;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwSequentialLoop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwSequentialLoop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
 	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address), *endptr = static_cast<Word128_t*>(end_address); wordptr < endptr;) {
 		UNROLL256(wordptr++;) 
 		placeholder = 0;
 	}
 	return placeholder;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwSequentialLoop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwSequentialLoop_Word256(void* start_address, void* end_address) {
@@ -700,40 +1135,50 @@ int32_t xmem::dummy_forwSequentialLoop_Word256(void* start_address, void* end_ad
 	return win_asm_dummy_forwSequentialLoop_Word256(static_cast<Word256_t*>(start_address), static_cast<Word256_t*>(end_address));
 #endif
 #ifdef __gnu_linux__
-	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address), *endptr = static_cast<Word256_t*>(end_address); wordptr < endptr;) {
-		UNROLL128(wordptr++;) 
-		placeholder = 0;
-	}
-	return placeholder;
+	return linux_asm_dummy_forwSequentialLoop_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::dummy_revSequentialLoop_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
 	for (volatile Word32_t* wordptr = static_cast<Word32_t*>(end_address), *begptr = static_cast<Word32_t*>(start_address); wordptr > begptr;) {
 		UNROLL1024(wordptr--;)
 		placeholder = 0;
 	}
 	return placeholder;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revSequentialLoop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revSequentialLoop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
 	for (volatile Word64_t* wordptr = static_cast<Word64_t*>(end_address), *begptr = static_cast<Word64_t*>(start_address); wordptr > begptr;) {
 		UNROLL512(wordptr--;)
 		placeholder = 0;
 	}
 	return placeholder;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revSequentialLoop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revSequentialLoop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
 	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address), *begptr = static_cast<Word128_t*>(start_address); wordptr > begptr;) {
 		UNROLL256(wordptr--;) 
 		placeholder = 0;
 	}
 	return placeholder;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revSequentialLoop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revSequentialLoop_Word256(void* start_address, void* end_address) {
@@ -742,18 +1187,14 @@ int32_t xmem::dummy_revSequentialLoop_Word256(void* start_address, void* end_add
 	return win_asm_dummy_revSequentialLoop_Word256(static_cast<Word256_t*>(end_address), static_cast<Word256_t*>(start_address));
 #endif
 #ifdef __gnu_linux__
-	volatile int32_t placeholder = 0; //Try our best to defeat compiler optimizations
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address), *begptr = static_cast<Word256_t*>(start_address); wordptr > begptr;) {
-		UNROLL128(wordptr--;) 
-		placeholder = 0;
-	}
-	return placeholder;
+	return linux_asm_dummy_revSequentialLoop_Word256(start_address, end_address);
 #endif
 }
 		
 /* ------------ STRIDE 2 LOOP --------------*/
 
 int32_t xmem::dummy_forwStride2Loop_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -763,9 +1204,14 @@ int32_t xmem::dummy_forwStride2Loop_Word32(void* start_address, void* end_addres
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride2Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride2Loop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -775,9 +1221,14 @@ int32_t xmem::dummy_forwStride2Loop_Word64(void* start_address, void* end_addres
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride2Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride2Loop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -787,9 +1238,14 @@ int32_t xmem::dummy_forwStride2Loop_Word128(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride2Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride2Loop_Word256(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -799,9 +1255,14 @@ int32_t xmem::dummy_forwStride2Loop_Word256(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride2Loop_Word256(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride2Loop_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -811,9 +1272,14 @@ int32_t xmem::dummy_revStride2Loop_Word32(void* start_address, void* end_address
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride2Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride2Loop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -823,9 +1289,14 @@ int32_t xmem::dummy_revStride2Loop_Word64(void* start_address, void* end_address
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride2Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride2Loop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -835,9 +1306,14 @@ int32_t xmem::dummy_revStride2Loop_Word128(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride2Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride2Loop_Word256(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -847,11 +1323,16 @@ int32_t xmem::dummy_revStride2Loop_Word256(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride2Loop_Word256(start_address, end_address);
+#endif
 }
 
 /* ------------ STRIDE 4 LOOP --------------*/
 
 int32_t xmem::dummy_forwStride4Loop_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -861,9 +1342,14 @@ int32_t xmem::dummy_forwStride4Loop_Word32(void* start_address, void* end_addres
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride4Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride4Loop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -873,9 +1359,14 @@ int32_t xmem::dummy_forwStride4Loop_Word64(void* start_address, void* end_addres
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride4Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride4Loop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -885,9 +1376,14 @@ int32_t xmem::dummy_forwStride4Loop_Word128(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride4Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride4Loop_Word256(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -897,9 +1393,14 @@ int32_t xmem::dummy_forwStride4Loop_Word256(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride4Loop_Word256(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride4Loop_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -909,9 +1410,14 @@ int32_t xmem::dummy_revStride4Loop_Word32(void* start_address, void* end_address
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride4Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride4Loop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -921,9 +1427,14 @@ int32_t xmem::dummy_revStride4Loop_Word64(void* start_address, void* end_address
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride4Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride4Loop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -933,9 +1444,14 @@ int32_t xmem::dummy_revStride4Loop_Word128(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride4Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride4Loop_Word256(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -945,11 +1461,16 @@ int32_t xmem::dummy_revStride4Loop_Word256(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride4Loop_Word256(start_address, end_address);
+#endif
 }
 
 /* ------------ STRIDE 8 LOOP --------------*/
 
 int32_t xmem::dummy_forwStride8Loop_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -959,9 +1480,14 @@ int32_t xmem::dummy_forwStride8Loop_Word32(void* start_address, void* end_addres
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride8Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride8Loop_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -971,9 +1497,14 @@ int32_t xmem::dummy_forwStride8Loop_Word64(void* start_address, void* end_addres
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride8Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride8Loop_Word128(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -983,9 +1514,14 @@ int32_t xmem::dummy_forwStride8Loop_Word128(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride8Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride8Loop_Word256(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -995,9 +1531,14 @@ int32_t xmem::dummy_forwStride8Loop_Word256(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride8Loop_Word256(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride8Loop_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1007,9 +1548,14 @@ int32_t xmem::dummy_revStride8Loop_Word32(void* start_address, void* end_address
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride8Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride8Loop_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1019,9 +1565,14 @@ int32_t xmem::dummy_revStride8Loop_Word64(void* start_address, void* end_address
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride8Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride8Loop_Word128(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -1031,9 +1582,14 @@ int32_t xmem::dummy_revStride8Loop_Word128(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride8Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride8Loop_Word256(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -1043,11 +1599,16 @@ int32_t xmem::dummy_revStride8Loop_Word256(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride8Loop_Word256(start_address, end_address);
+#endif
 }
 
 /* ------------ STRIDE 16 LOOP --------------*/
 
 int32_t xmem::dummy_forwStride16Loop_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1057,9 +1618,14 @@ int32_t xmem::dummy_forwStride16Loop_Word32(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride16Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride16Loop_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1069,9 +1635,14 @@ int32_t xmem::dummy_forwStride16Loop_Word64(void* start_address, void* end_addre
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride16Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride16Loop_Word128(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -1081,9 +1652,14 @@ int32_t xmem::dummy_forwStride16Loop_Word128(void* start_address, void* end_addr
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride16Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_forwStride16Loop_Word256(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -1093,9 +1669,14 @@ int32_t xmem::dummy_forwStride16Loop_Word256(void* start_address, void* end_addr
 			wordptr -= len;
 	}
 	return 0;
-}
-
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_forwStride16Loop_Word256(start_address, end_address);
+#endif
+}
+
 int32_t xmem::dummy_revStride16Loop_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1105,9 +1686,14 @@ int32_t xmem::dummy_revStride16Loop_Word32(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride16Loop_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride16Loop_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1117,9 +1703,14 @@ int32_t xmem::dummy_revStride16Loop_Word64(void* start_address, void* end_addres
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride16Loop_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride16Loop_Word128(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word128_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
@@ -1129,9 +1720,14 @@ int32_t xmem::dummy_revStride16Loop_Word128(void* start_address, void* end_addre
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride16Loop_Word128(start_address, end_address);
+#endif
 }
 
 int32_t xmem::dummy_revStride16Loop_Word256(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word256_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
@@ -1141,6 +1737,10 @@ int32_t xmem::dummy_revStride16Loop_Word256(void* start_address, void* end_addre
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_dummy_revStride16Loop_Word256(start_address, end_address);
+#endif
 }
 
 /* ------------ RANDOM LOOP --------------*/
@@ -1178,19 +1778,29 @@ int32_t xmem::dummy_randomLoop_Word256(uintptr_t* first_address, uintptr_t** las
 /* ------------ SEQUENTIAL READ --------------*/
 
 int32_t xmem::forwSequentialRead_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	for (volatile Word32_t* wordptr = static_cast<Word32_t*>(start_address), *endptr = static_cast<Word32_t*>(end_address); wordptr < endptr;) {
 		UNROLL1024(val = *wordptr++;) 
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwSequentialRead_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwSequentialRead_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val;
 	for (volatile Word64_t* wordptr = static_cast<Word64_t*>(start_address), *endptr = static_cast<Word64_t*>(end_address); wordptr < endptr;) {
 		UNROLL512(val = *wordptr++;)
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwSequentialRead_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwSequentialRead_Word128(void* start_address, void* end_address) { 
@@ -1198,11 +1808,7 @@ int32_t xmem::forwSequentialRead_Word128(void* start_address, void* end_address)
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address), *endptr = static_cast<Word128_t*>(end_address); wordptr < endptr;) {
-		UNROLL256(val = *wordptr++;)
-	}
-	return 0;
+	return linux_asm_forwSequentialRead_Word128(start_address, end_address);
 #endif
 }
 
@@ -1211,28 +1817,34 @@ int32_t xmem::forwSequentialRead_Word256(void* start_address, void* end_address)
 	return win_asm_forwSequentialRead_Word256(static_cast<Word256_t*>(start_address), static_cast<Word256_t*>(end_address));
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address), *endptr = static_cast<Word256_t*>(end_address); wordptr < endptr;) {
-		UNROLL128(val = *wordptr++;)
-	}
-	return 0;
+	return linux_asm_forwSequentialRead_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revSequentialRead_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val;
 	for (volatile Word32_t* wordptr = static_cast<Word32_t*>(end_address), *begptr = static_cast<Word32_t*>(start_address); wordptr > begptr;) {
 		UNROLL1024(val = *wordptr--;)
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revSequentialRead_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revSequentialRead_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val;
 	for (volatile Word64_t* wordptr = static_cast<Word64_t*>(end_address), *begptr = static_cast<Word64_t*>(start_address); wordptr > begptr;) {
 		UNROLL512(val = *wordptr--;)
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revSequentialRead_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revSequentialRead_Word128(void* start_address, void* end_address) { 
@@ -1240,11 +1852,7 @@ int32_t xmem::revSequentialRead_Word128(void* start_address, void* end_address)
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address), *begptr = static_cast<Word128_t*>(start_address); wordptr > begptr;) {
-		UNROLL256(val = *wordptr--;)
-	}
-	return 0;
+	return linux_asm_revSequentialRead_Word128(start_address, end_address);
 #endif
 }
 
@@ -1253,30 +1861,36 @@ int32_t xmem::revSequentialRead_Word256(void* start_address, void* end_address)
 	return win_asm_revSequentialRead_Word256(static_cast<Word256_t*>(end_address), static_cast<Word256_t*>(start_address));
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address), *begptr = static_cast<Word256_t*>(start_address); wordptr > begptr;) {
-		UNROLL128(val = *wordptr--;)
-	}
-	return 0;
+	return linux_asm_revSequentialRead_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ SEQUENTIAL WRITE --------------*/
 
 int32_t xmem::forwSequentialWrite_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	for (volatile Word32_t* wordptr = static_cast<Word32_t*>(start_address), *endptr = static_cast<Word32_t*>(end_address); wordptr < endptr;) {
 		UNROLL1024(*wordptr++ = val;) 
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwSequentialWrite_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwSequentialWrite_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	for (volatile Word64_t* wordptr = static_cast<Word64_t*>(start_address), *endptr = static_cast<Word64_t*>(end_address); wordptr < endptr;) {
 		UNROLL512(*wordptr++ = val;) 
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwSequentialWrite_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwSequentialWrite_Word128(void* start_address, void* end_address) { 
@@ -1284,12 +1898,7 @@ int32_t xmem::forwSequentialWrite_Word128(void* start_address, void* end_address
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address), *endptr = static_cast<Word128_t*>(end_address); wordptr < endptr;) {
-		UNROLL256(*wordptr++ = val;) 
-	}
-	return 0;
+	return linux_asm_forwSequentialWrite_Word128(start_address, end_address);
 #endif
 }
 
@@ -1298,29 +1907,34 @@ int32_t xmem::forwSequentialWrite_Word256(void* start_address, void* end_address
 	return win_asm_forwSequentialWrite_Word256(static_cast<Word256_t*>(start_address), static_cast<Word256_t*>(end_address));
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address), *endptr = static_cast<Word256_t*>(end_address); wordptr < endptr;) {
-		UNROLL128(*wordptr++ = val;) 
-	}
-	return 0;
+	return linux_asm_forwSequentialWrite_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revSequentialWrite_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF;
 	for (volatile Word32_t* wordptr = static_cast<Word32_t*>(end_address), *begptr = static_cast<Word32_t*>(start_address); wordptr > begptr;) {
 		UNROLL1024(*wordptr-- = val;)
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revSequentialWrite_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revSequentialWrite_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF;
 	for (volatile Word64_t* wordptr = static_cast<Word64_t*>(end_address), *begptr = static_cast<Word64_t*>(start_address); wordptr > begptr;) {
 		UNROLL512(*wordptr-- = val;)
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revSequentialWrite_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revSequentialWrite_Word128(void* start_address, void* end_address) { 
@@ -1328,12 +1942,7 @@ int32_t xmem::revSequentialWrite_Word128(void* start_address, void* end_address)
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address), *begptr = static_cast<Word128_t*>(start_address); wordptr > begptr;) {
-		UNROLL256(*wordptr-- = val;)
-	}
-	return 0;
+	return linux_asm_revSequentialWrite_Word128(start_address, end_address);
 #endif
 }
 
@@ -1342,18 +1951,14 @@ int32_t xmem::revSequentialWrite_Word256(void* start_address, void* end_address)
 	return win_asm_revSequentialWrite_Word256(static_cast<Word256_t*>(end_address), static_cast<Word256_t*>(start_address));
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address), *begptr = static_cast<Word256_t*>(start_address); wordptr > begptr;) {
-		UNROLL128(*wordptr-- = val;)
-	}
-	return 0;
+	return linux_asm_revSequentialWrite_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 2 READ --------------*/
 
 int32_t xmem::forwStride2Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1363,9 +1968,14 @@ int32_t xmem::forwStride2Read_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride2Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride2Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1375,6 +1985,10 @@ int32_t xmem::forwStride2Read_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride2Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride2Read_Word128(void* start_address, void* end_address) { 
@@ -1382,15 +1996,7 @@ int32_t xmem::forwStride2Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 128) {
-		UNROLL128(val = *wordptr; wordptr += 2;) 
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride2Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -1399,19 +2005,12 @@ int32_t xmem::forwStride2Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 64) {
-		UNROLL64(val = *wordptr; wordptr += 2;) 
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride2Read_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride2Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1421,9 +2020,14 @@ int32_t xmem::revStride2Read_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride2Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride2Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1433,6 +2037,10 @@ int32_t xmem::revStride2Read_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride2Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride2Read_Word128(void* start_address, void* end_address) { 
@@ -1440,15 +2048,7 @@ int32_t xmem::revStride2Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 128) {
-		UNROLL128(val = *wordptr; wordptr -= 2;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride2Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -1457,21 +2057,14 @@ int32_t xmem::revStride2Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 64) {
-		UNROLL64(val = *wordptr; wordptr -= 2;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride2Read_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 2 WRITE --------------*/
 
 int32_t xmem::forwStride2Write_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1481,9 +2074,14 @@ int32_t xmem::forwStride2Write_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride2Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride2Write_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1493,6 +2091,10 @@ int32_t xmem::forwStride2Write_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride2Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride2Write_Word128(void* start_address, void* end_address) { 
@@ -1500,16 +2102,7 @@ int32_t xmem::forwStride2Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 128) {
-		UNROLL128(*wordptr = val; wordptr += 2;)
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride2Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -1518,20 +2111,12 @@ int32_t xmem::forwStride2Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 64) {
-		UNROLL64(*wordptr = val; wordptr += 2;)
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride2Write_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride2Write_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1541,9 +2126,14 @@ int32_t xmem::revStride2Write_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride2Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride2Write_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1553,6 +2143,10 @@ int32_t xmem::revStride2Write_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride2Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride2Write_Word128(void* start_address, void* end_address) { 
@@ -1560,16 +2154,7 @@ int32_t xmem::revStride2Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 128) {
-		UNROLL128(*wordptr = val; wordptr -= 2;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride2Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -1578,22 +2163,14 @@ int32_t xmem::revStride2Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 64) {
-		UNROLL64(*wordptr = val; wordptr -= 2;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride2Write_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 4 READ --------------*/
 
 int32_t xmem::forwStride4Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1603,9 +2180,14 @@ int32_t xmem::forwStride4Read_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride4Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride4Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1615,6 +2197,10 @@ int32_t xmem::forwStride4Read_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride4Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride4Read_Word128(void* start_address, void* end_address) { 
@@ -1622,15 +2208,7 @@ int32_t xmem::forwStride4Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 64) {
-		UNROLL64(val = *wordptr; wordptr += 4;) 
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride4Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -1639,19 +2217,12 @@ int32_t xmem::forwStride4Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 32) {
-		UNROLL32(val = *wordptr; wordptr += 4;) 
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride4Read_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride4Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1661,9 +2232,14 @@ int32_t xmem::revStride4Read_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride4Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride4Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1673,6 +2249,10 @@ int32_t xmem::revStride4Read_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride4Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride4Read_Word128(void* start_address, void* end_address) { 
@@ -1680,15 +2260,7 @@ int32_t xmem::revStride4Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 64) {
-		UNROLL64(val = *wordptr; wordptr -= 4;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride4Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -1697,21 +2269,14 @@ int32_t xmem::revStride4Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 32) {
-		UNROLL32(val = *wordptr; wordptr -= 4;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride4Read_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 4 WRITE --------------*/
 
 int32_t xmem::forwStride4Write_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1721,9 +2286,14 @@ int32_t xmem::forwStride4Write_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride4Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride4Write_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1733,6 +2303,10 @@ int32_t xmem::forwStride4Write_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride4Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride4Write_Word128(void* start_address, void* end_address) { 
@@ -1740,16 +2314,7 @@ int32_t xmem::forwStride4Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 64) {
-		UNROLL64(*wordptr = val; wordptr += 4;)
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride4Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -1758,20 +2323,12 @@ int32_t xmem::forwStride4Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 32) {
-		UNROLL32(*wordptr = val; wordptr += 4;)
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride4Write_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride4Write_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1781,9 +2338,14 @@ int32_t xmem::revStride4Write_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride4Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride4Write_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1793,6 +2355,10 @@ int32_t xmem::revStride4Write_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride4Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride4Write_Word128(void* start_address, void* end_address) { 
@@ -1800,16 +2366,7 @@ int32_t xmem::revStride4Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 64) {
-		UNROLL64(*wordptr = val; wordptr -= 4;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride4Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -1818,22 +2375,14 @@ int32_t xmem::revStride4Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 32) {
-		UNROLL32(*wordptr = val; wordptr -= 4;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride4Write_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 8 READ --------------*/
 
 int32_t xmem::forwStride8Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1843,9 +2392,14 @@ int32_t xmem::forwStride8Read_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride8Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride8Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1855,6 +2409,10 @@ int32_t xmem::forwStride8Read_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride8Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride8Read_Word128(void* start_address, void* end_address) { 
@@ -1862,15 +2420,7 @@ int32_t xmem::forwStride8Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 32) {
-		UNROLL32(val = *wordptr; wordptr += 8;) 
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride8Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -1879,19 +2429,12 @@ int32_t xmem::forwStride8Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 16) {
-		UNROLL16(val = *wordptr; wordptr += 8;) 
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride8Read_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride8Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1901,9 +2444,14 @@ int32_t xmem::revStride8Read_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride8Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride8Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1913,6 +2461,10 @@ int32_t xmem::revStride8Read_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride8Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride8Read_Word128(void* start_address, void* end_address) { 
@@ -1920,15 +2472,7 @@ int32_t xmem::revStride8Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 32) {
-		UNROLL32(val = *wordptr; wordptr -= 8;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride8Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -1937,21 +2481,14 @@ int32_t xmem::revStride8Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 16) {
-		UNROLL16(val = *wordptr; wordptr -= 8;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride8Read_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 8 WRITE --------------*/
 
 int32_t xmem::forwStride8Write_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -1961,9 +2498,14 @@ int32_t xmem::forwStride8Write_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride8Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride8Write_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -1973,6 +2515,10 @@ int32_t xmem::forwStride8Write_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride8Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride8Write_Word128(void* start_address, void* end_address) { 
@@ -1980,16 +2526,7 @@ int32_t xmem::forwStride8Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 32) {
-		UNROLL32(*wordptr = val; wordptr += 8;)
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride8Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -1998,20 +2535,12 @@ int32_t xmem::forwStride8Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 16) {
-		UNROLL16(*wordptr = val; wordptr += 8;)
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride8Write_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride8Write_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -2021,9 +2550,14 @@ int32_t xmem::revStride8Write_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride8Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride8Write_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -2033,6 +2567,10 @@ int32_t xmem::revStride8Write_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride8Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride8Write_Word128(void* start_address, void* end_address) { 
@@ -2040,16 +2578,7 @@ int32_t xmem::revStride8Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 32) {
-		UNROLL32(*wordptr = val; wordptr -= 8;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride8Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -2058,22 +2587,14 @@ int32_t xmem::revStride8Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 16) {
-		UNROLL16(*wordptr = val; wordptr -= 8;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride8Write_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 16 READ --------------*/
 
 int32_t xmem::forwStride16Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -2083,9 +2604,14 @@ int32_t xmem::forwStride16Read_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride16Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride16Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -2095,6 +2621,10 @@ int32_t xmem::forwStride16Read_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride16Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride16Read_Word128(void* start_address, void* end_address) { 
@@ -2102,15 +2632,7 @@ int32_t xmem::forwStride16Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 16) {
-		UNROLL16(val = *wordptr; wordptr += 16;) 
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride16Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -2119,19 +2641,12 @@ int32_t xmem::forwStride16Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 8) {
-		UNROLL8(val = *wordptr; wordptr += 16;) 
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride16Read_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride16Read_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -2141,9 +2656,14 @@ int32_t xmem::revStride16Read_Word32(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride16Read_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride16Read_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -2153,6 +2673,10 @@ int32_t xmem::revStride16Read_Word64(void* start_address, void* end_address) {
 			wordptr += len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride16Read_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride16Read_Word128(void* start_address, void* end_address) { 
@@ -2160,15 +2684,7 @@ int32_t xmem::revStride16Read_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 16) {
-		UNROLL16(val = *wordptr; wordptr -= 16;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride16Read_Word128(start_address, end_address);
 #endif
 }
 
@@ -2177,21 +2693,14 @@ int32_t xmem::revStride16Read_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val; 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 8) {
-		UNROLL8(val = *wordptr; wordptr -= 16;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-	return 0;
+	return linux_asm_revStride16Read_Word256(start_address, end_address);
 #endif
 }
 
 /* ------------ STRIDE 16 WRITE --------------*/
 
 int32_t xmem::forwStride16Write_Word32(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -2201,9 +2710,14 @@ int32_t xmem::forwStride16Write_Word32(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride16Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride16Write_Word64(void* start_address, void* end_address) {
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -2213,6 +2727,10 @@ int32_t xmem::forwStride16Write_Word64(void* start_address, void* end_address) {
 			wordptr -= len;
 	}
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_forwStride16Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::forwStride16Write_Word128(void* start_address, void* end_address) { 
@@ -2220,16 +2738,7 @@ int32_t xmem::forwStride16Write_Word128(void* start_address, void* end_address)
 	return 0;
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(start_address); i < len; i += 16) {
-		UNROLL16(*wordptr = val; wordptr += 16;)
-		if (wordptr >= static_cast<Word128_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride16Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -2238,20 +2747,12 @@ int32_t xmem::forwStride16Write_Word256(void* start_address, void* end_address)
 	return 0;
 #endif
 #ifdef __gnu_linux__
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(start_address); i < len; i += 8) {
-		UNROLL8(*wordptr = val; wordptr += 16;)
-		if (wordptr >= static_cast<Word256_t*>(end_address)) //end, modulo
-			wordptr -= len;
-	}
-	return 0;
+	return linux_asm_forwStride16Write_Word256(start_address, end_address);
 #endif
 }
 
 int32_t xmem::revStride16Write_Word32(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word32_t val = 0xFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word32_t);
@@ -2262,9 +2763,14 @@ int32_t xmem::revStride16Write_Word32(void* start_address, void* end_address) {
 	}
 
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride16Write_Word32(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride16Write_Word64(void* start_address, void* end_address) { 
+#ifdef _WIN32
 	register Word64_t val = 0xFFFFFFFFFFFFFFFF; 
 	register uint64_t i = 0;
 	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word64_t);
@@ -2275,6 +2781,10 @@ int32_t xmem::revStride16Write_Word64(void* start_address, void* end_address) {
 	}
 
 	return 0;
+#endif
+#ifdef __gnu_linux__
+	return linux_asm_revStride16Write_Word64(start_address, end_address);
+#endif
 }
 
 int32_t xmem::revStride16Write_Word128(void* start_address, void* end_address) { 
@@ -2282,17 +2792,7 @@ int32_t xmem::revStride16Write_Word128(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	register Word128_t val;
-	val = _mm_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word128_t);
-	for (volatile Word128_t* wordptr = static_cast<Word128_t*>(end_address); i < len; i += 16) {
-		UNROLL16(*wordptr = val; wordptr -= 16;)
-		if (wordptr <= static_cast<Word128_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-
-	return 0;
+	return linux_asm_revStride16Write_Word128(start_address, end_address);
 #endif
 }
 
@@ -2301,18 +2801,7 @@ int32_t xmem::revStride16Write_Word256(void* start_address, void* end_address) {
 	return 0; //TODO
 #endif
 #ifdef __gnu_linux__
-	//FIXME: segfaults?
-	register Word256_t val;
-	val = _mm256_set_epi64x(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF); 
-	register uint64_t i = 0;
-	register uint64_t len = (reinterpret_cast<uint64_t>(end_address)-reinterpret_cast<uint64_t>(start_address)) / sizeof(Word256_t);
-	for (volatile Word256_t* wordptr = static_cast<Word256_t*>(end_address); i < len; i += 8) {
-		UNROLL8(*wordptr = val; wordptr -= 16;)
-		if (wordptr <= static_cast<Word256_t*>(start_address)) //end, modulo
-			wordptr += len;
-	}
-
-	return 0;
+	return linux_asm_revStride16Write_Word256(start_address, end_address);
 #endif
 }
 
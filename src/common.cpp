@@ -30,9 +30,13 @@
 //Headers
 #include <common.h>
 #include <Timer.h>
+#include <Topology.h>
 
 //Libraries
 #include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <csignal>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -42,6 +46,7 @@
 #ifdef __gnu_linux__
 #include <unistd.h>
 #include <pthread.h>
+#include <sys/resource.h>
 #include <numa.h>
 #include <fstream> //for std::ifstream
 #include <vector> //for std::vector
@@ -69,8 +74,20 @@ namespace xmem {
 	uint32_t g_total_l4_caches; /**< Total number of L4 caches in the system. */
 	uint32_t g_starting_test_index; /**< Numeric identifier for the first benchmark test. */
 	uint32_t g_test_index; /**< Numeric identifier for the current benchmark test. */
+	bool g_sys_info_ready = false; /**< True once query_sys_info() has filled in the system information. */
+	benchmark_mode_t g_benchmark_mode = DEFAULT_BENCHMARK_MODE; /**< Whether benchmarks are time-based or size-based. */
+	uint32_t g_benchmark_duration_sec = DEFAULT_BENCHMARK_DURATION_SEC; /**< Number of seconds to run in each time-based benchmark iteration. */
+	size_t g_throughput_bytes_per_pass = DEFAULT_THROUGHPUT_BENCHMARK_BYTES_PER_PASS; /**< Number of bytes read or written per timed pass of a time-based throughput benchmark. */
+	uint32_t g_latency_unroll_length = DEFAULT_LATENCY_BENCHMARK_UNROLL_LENGTH; /**< Number of pointer dereferences per call of the latency kernel. */
+	uint32_t g_power_sampling_period_sec = DEFAULT_POWER_SAMPLING_PERIOD_SEC; /**< Sampling period in seconds for all power measurement mechanisms. */
+	uint32_t g_bandwidth_trace_period_us = DEFAULT_BANDWIDTH_TRACE_PERIOD_US; /**< Sampling period in microseconds of the per-worker bandwidth traces, or 0 to not trace. */
+	uint64_t g_permutation_seed = 0; /**< Seed for building random pointer permutations. The same seed gives the same layout, which lets permutations be reused. */
 };
 
+static volatile std::sig_atomic_t s_stop_signal_received = 0; /**< Set when SIGINT or SIGTERM arrives while stop signals are caught. */
+static void (*s_previous_sigint_handler)(int) = SIG_DFL; /**< SIGINT handler to restore when stop signals are no longer caught. */
+static void (*s_previous_sigterm_handler)(int) = SIG_DFL; /**< SIGTERM handler to restore when stop signals are no longer caught. */
+
 using namespace xmem;
 
 void xmem::print_types_report() {
@@ -147,26 +164,11 @@ void xmem::print_compile_time_options() {
 #ifdef USE_TSC_TIMER
 	std::cout << "USE_TSC_TIMER" << std::endl;
 #endif
-#ifdef USE_TIME_BASED_BENCHMARKS
-	std::cout << "USE_TIME_BASED_BENCHMARKS" << std::endl;
-#endif
-#ifdef BENCHMARK_DURATION_SEC
-	std::cout << "BENCHMARK_DURATION_SEC = " << BENCHMARK_DURATION_SEC << std::endl; //This must be defined
-#endif
-#ifdef THROUGHPUT_BENCHMARK_BYTES_PER_PASS
-	std::cout << "THROUGHPUT_BENCHMARK_BYTES_PER_PASS == " << THROUGHPUT_BENCHMARK_BYTES_PER_PASS << std::endl;
-#endif
-#ifdef USE_SIZE_BASED_BENCHMARKS
-	std::cout << "USE_SIZE_BASED_BENCHMARKS" << std::endl;
-#endif
 #ifdef USE_PASSES_CURVE_1
 	std::cout << "USE_PASSES_CURVE_1" << std::endl;
 #endif
 #ifdef USE_PASSES_CURVE_2
 	std::cout << "USE_PASSES_CURVE_2" << std::endl;
-#endif
-#ifdef POWER_SAMPLING_PERIOD_SEC
-	std::cout << "POWER_SAMPLING_PERIOD_SEC == " << POWER_SAMPLING_PERIOD_SEC << std::endl;
 #endif
 	std::cout << std::endl;
 }
@@ -252,64 +254,188 @@ bool xmem::unlock_thread_to_cpu() {
 	return (!pthread_setaffinity_np(tid, sizeof(cpu_set_t), &cpus));
 #endif
 }
-		
-int32_t xmem::cpu_id_in_numa_node(uint32_t numa_node, uint32_t cpu_in_node) {
-	int32_t cpu_id = -1;
-	uint32_t rank_in_node = 0;
+
+bool xmem::lock_thread_to_housekeeping_cpus() {
+	if (!g_topology.hasIsolatedCPUs())
+		return true;
+	std::vector<uint32_t> housekeeping = g_topology.getHousekeepingCPUs();
+	if (housekeeping.empty())
+		return false;
 #ifdef _WIN32
-	uint64_t processorMask = 0;
-	GetNumaNodeProcessorMask(numa_node, &processorMask);
-	//Select Nth CPU in the node
-	uint32_t shifts = 0;
-	uint64_t shiftmask = processorMask;
-	bool done = false;
-	while (!done && shifts < sizeof(shiftmask)*8) {
-		if ((shiftmask & 0x1) == 0x1) { //current CPU is in the NUMA node
-			if (cpu_in_node == rank_in_node) { //found the CPU of interest in the NUMA node
-				cpu_id = static_cast<int32_t>(shifts);
-				done = true;
-			}
-			rank_in_node++;
-		}
-		shiftmask = shiftmask >> 1; //shift right by one to examine next CPU
-		shifts++;
-	}
+	HANDLE tid = GetCurrentThread();
+	if (tid == 0)
+		return false;
+	DWORD_PTR threadAffinityMask = 0;
+	for (uint32_t i = 0; i < housekeeping.size(); i++)
+		threadAffinityMask |= static_cast<DWORD_PTR>(1) << housekeeping[i];
+	return (SetThreadAffinityMask(tid, threadAffinityMask) != 0);
 #endif
 #ifdef __gnu_linux__
-	struct bitmask *bm_ptr = numa_allocate_cpumask();
-	if (!bm_ptr) {
-		std::cerr << "WARNING: Failed to allocate a bitmask for loading NUMA information." << std::endl;
-		return -1;
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	for (uint32_t i = 0; i < housekeeping.size(); i++)
+		if (housekeeping[i] < CPU_SETSIZE)
+			CPU_SET(static_cast<int32_t>(housekeeping[i]), &cpus);
+
+	pthread_t tid = pthread_self();
+	return (!pthread_setaffinity_np(tid, sizeof(cpu_set_t), &cpus));
+#endif
+}
+		
+/**
+ * @brief Records that the process was asked to stop.
+ * @param signum The signal received.
+ */
+static void record_stop_signal(int signum) {
+	s_stop_signal_received = 1;
+}
+
+void xmem::catch_stop_signals(bool enable) {
+	if (enable) {
+		s_stop_signal_received = 0;
+		s_previous_sigint_handler = std::signal(SIGINT, record_stop_signal);
+		s_previous_sigterm_handler = std::signal(SIGTERM, record_stop_signal);
+	} else {
+		std::signal(SIGINT, s_previous_sigint_handler == SIG_ERR ? SIG_DFL : s_previous_sigint_handler);
+		std::signal(SIGTERM, s_previous_sigterm_handler == SIG_ERR ? SIG_DFL : s_previous_sigterm_handler);
 	}
-	if (numa_node_to_cpus(static_cast<int32_t>(numa_node), bm_ptr)) //error
+}
+
+bool xmem::stop_signal_received() {
+	return s_stop_signal_received != 0;
+}
+
+int32_t xmem::cpu_id_in_numa_node(uint32_t numa_node, uint32_t cpu_in_node) {
+	const std::vector<uint32_t>& cpus = g_topology.getCPUsInNode(numa_node);
+	if (cpu_in_node >= cpus.size())
 		return -1;
+	return static_cast<int32_t>(cpus[cpu_in_node]);
+}
 
-	//Select Nth CPU in the node
-	for (uint32_t i = 0; i < bm_ptr->size; i++) {
-		if (numa_bitmask_isbitset(bm_ptr, i) == 1) {
-			if (cpu_in_node == rank_in_node) { //found the CPU of interest in the NUMA node
-				cpu_id = i;
-				if (bm_ptr)
-					free(bm_ptr);
-				return cpu_id;
-			}
-			rank_in_node++;
+int32_t xmem::housekeeping_cpu_in_numa_node(uint32_t numa_node) {
+	const std::vector<uint32_t>& cpus = g_topology.getCPUsInNode(numa_node);
+	if (cpus.empty())
+		return -1;
+	for (size_t i = cpus.size(); i > 0; i--)
+		if (!g_topology.isCPUIsolated(cpus[i-1]))
+			return static_cast<int32_t>(cpus[i-1]);
+	return static_cast<int32_t>(cpus.back());
+}
+	
+int32_t xmem::numa_node_of_cpu_id(uint32_t cpu_id) {
+	return g_topology.getNodeOfCPU(cpu_id);
+}
+
+int64_t xmem::physical_core_of_cpu_id(uint32_t cpu_id) {
+	return g_topology.getCoreOfCPU(cpu_id);
+}
+
+std::vector<uint32_t> xmem::cpu_placement_order(uint32_t numa_node, placement_policy_t policy) {
+	return g_topology.getPlacementOrder(numa_node, policy);
+}
+
+void xmem::choose_worker_cpus(uint32_t cpu_node, uint32_t num_threads, const std::vector<uint32_t>& cpu_list, placement_policy_t policy, int32_t latency_cpu, std::vector<int32_t>& tp_cpus, std::vector<int32_t>& lat_cpus) {
+	std::vector<uint32_t> order = cpu_list;
+	if (order.empty())
+		order = cpu_placement_order(cpu_node, policy);
+
+	//Throughput workers take CPUs in placement order
+	tp_cpus.clear();
+	for (uint32_t t = 0; t < num_threads; t++)
+		tp_cpus.push_back(t < order.size() ? static_cast<int32_t>(order[t]) : -1);
+
+	//The latency thread is chosen first, then load threads fill the remaining CPUs in placement order
+	if (latency_cpu < 0)
+		latency_cpu = order.empty() ? -1 : static_cast<int32_t>(order[0]);
+	lat_cpus.clear();
+	lat_cpus.push_back(latency_cpu);
+	for (uint32_t i = 0; i < order.size() && lat_cpus.size() < num_threads; i++)
+		if (static_cast<int32_t>(order[i]) != latency_cpu)
+			lat_cpus.push_back(static_cast<int32_t>(order[i]));
+	while (lat_cpus.size() < num_threads)
+		lat_cpus.push_back(-1);
+}
+
+void xmem::choose_split_latency_cpus(uint32_t cpu_node, uint32_t load_cpu_node, uint32_t num_threads, placement_policy_t policy, int32_t latency_cpu, std::vector<int32_t>& lat_cpus) {
+	if (latency_cpu < 0) {
+		std::vector<uint32_t> order = cpu_placement_order(cpu_node, policy);
+		latency_cpu = order.empty() ? -1 : static_cast<int32_t>(order[0]);
+	}
+
+	//Load threads fill the load node in placement order, skipping the latency thread's CPU in case the order spills over to its node
+	std::vector<uint32_t> load_order = cpu_placement_order(load_cpu_node, policy);
+	lat_cpus.clear();
+	lat_cpus.push_back(latency_cpu);
+	for (uint32_t i = 0; i < load_order.size() && lat_cpus.size() < num_threads; i++)
+		if (static_cast<int32_t>(load_order[i]) != latency_cpu)
+			lat_cpus.push_back(static_cast<int32_t>(load_order[i]));
+	while (lat_cpus.size() < num_threads)
+		lat_cpus.push_back(-1);
+}
+
+int32_t xmem::numa_node_distance(uint32_t from_node, uint32_t to_node) {
+	return g_topology.getDistance(from_node, to_node);
+}
+
+bool xmem::parse_cpu_list(const std::string& list, std::vector<uint32_t>& ids) {
+	const char* curr = list.c_str();
+	while (*curr != '\0' && *curr != ' ' && *curr != '\n') {
+		char* endptr = NULL;
+		uint32_t first = static_cast<uint32_t>(strtoul(curr, &endptr, 10));
+		uint32_t last = first;
+		if (endptr == curr)
+			return false;
+		curr = endptr;
+		if (*curr == '-') {
+			curr++;
+			last = static_cast<uint32_t>(strtoul(curr, &endptr, 10));
+			if (endptr == curr || last < first)
+				return false;
+			curr = endptr;
 		}
+		for (uint32_t id = first; id <= last; id++)
+			ids.push_back(id);
+		if (*curr == ',')
+			curr++;
+		else if (*curr != '\0' && *curr != ' ' && *curr != '\n')
+			return false;
 	}
-	
-	if (bm_ptr)
-		free(bm_ptr);
-#endif
-	return cpu_id;
+	return true;
 }
 	
+double xmem::student_t_critical_95(uint32_t degrees_of_freedom) {
+	static const double table[30] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+									  2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+									  2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+	if (degrees_of_freedom == 0)
+		return 0;
+	if (degrees_of_freedom <= 30)
+		return table[degrees_of_freedom-1];
+	if (degrees_of_freedom < 40)
+		return 2.042;
+	if (degrees_of_freedom < 60)
+		return 2.021;
+	if (degrees_of_freedom < 120)
+		return 2.000;
+	return 1.980;
+}
+
+double xmem::median_of_sorted(const std::vector<double>& sorted) {
+	if (sorted.empty())
+		return 0;
+	size_t mid = sorted.size() / 2;
+	if (sorted.size() % 2 == 0)
+		return (sorted[mid-1] + sorted[mid]) / 2;
+	return sorted[mid];
+}
+
 size_t xmem::compute_number_of_passes(size_t working_set_size_KB) {
 	size_t passes = 0;
 #ifdef USE_PASSES_CURVE_1
 	passes = 65536 / working_set_size_KB;
 #else
 #ifdef USE_PASSES_CURVE_2
-	passes = (4*2097152) / working_set_size_KB^2;
+	passes = (4*2097152) / (working_set_size_KB * working_set_size_KB);
 #endif
 #endif
 	if (passes < 1)
@@ -330,6 +456,14 @@ void xmem::init_globals() {
 	g_total_l4_caches = DEFAULT_NUM_L4_CACHES;
 	g_page_size = DEFAULT_PAGE_SIZE;
 	g_large_page_size = DEFAULT_LARGE_PAGE_SIZE; 
+	g_benchmark_mode = DEFAULT_BENCHMARK_MODE;
+	g_benchmark_duration_sec = DEFAULT_BENCHMARK_DURATION_SEC;
+	g_throughput_bytes_per_pass = DEFAULT_THROUGHPUT_BENCHMARK_BYTES_PER_PASS;
+	g_latency_unroll_length = DEFAULT_LATENCY_BENCHMARK_UNROLL_LENGTH;
+	g_power_sampling_period_sec = DEFAULT_POWER_SAMPLING_PERIOD_SEC;
+	g_bandwidth_trace_period_us = DEFAULT_BANDWIDTH_TRACE_PERIOD_US;
+	g_permutation_seed = static_cast<uint64_t>(time(NULL));
+	g_sys_info_ready = false;
 }
 
 int32_t xmem::query_sys_info() {
@@ -352,6 +486,9 @@ int32_t xmem::query_sys_info() {
 		return -1;
 	}
 	retval = GetLogicalProcessorInformation(buffer, &len); //try again
+
+	if (!g_topology.build())
+		std::cerr << "WARNING: Failed to build the system topology." << std::endl;
 #endif
 
 	//Get NUMA info
@@ -373,26 +510,13 @@ int32_t xmem::query_sys_info() {
 		return -1;
 	}
 
-	//Get number of nodes. This is easy.
-	g_num_nodes = numa_max_node()+1;
-
-	//Get number of physical packages. This is somewhat convoluted, but not sure of a better way on Linux. Technically there could be on-chip NUMA, so...
-	std::ifstream in;
-	in.open("/proc/cpuinfo");
-	char line[512];
-	std::vector<uint32_t> phys_package_ids;
-	uint32_t id = 0;
-	while (!in.eof()) {
-		in.getline(line, 512, '\n'); //FIXME: buffer overflow risk.
-		std::string line_string(line);
-		if (line_string.find("physical id") != std::string::npos) {
-			sscanf(line, "physical id\t\t\t: %u", &id);
-			if (std::find(phys_package_ids.begin(), phys_package_ids.end(), id) == phys_package_ids.end()) //have not seen this physical processor yet
-				phys_package_ids.push_back(id); //add to list
-		}
+	//Build the topology model once from sysfs. Everything else is derived from it.
+	if (!g_topology.build()) {
+		std::cerr << "WARNING: Failed to build the system topology." << std::endl;
+		return -1;
 	}
-	g_num_physical_packages = phys_package_ids.size();
-	in.close();
+	g_num_nodes = g_topology.getNumNodes();
+	g_num_physical_packages = g_topology.getNumPackages();
 #endif
 
 	//Get number of CPUs
@@ -421,24 +545,8 @@ int32_t xmem::query_sys_info() {
 	}
 #endif
 #ifdef __gnu_linux__
-	//Get number of logical CPUs
-	g_num_logical_cpus = sysconf(_SC_NPROCESSORS_ONLN); //This isn't really portable -- requires glibc extensions to sysconf()
-
-
-	//Get number of physical CPUs. This is somewhat convoluted, but not sure of a better way on Linux. I don't want to assume anything about HyperThreading-like things. TODO: currently this assumes each processor package has an equal number of cores, e.g. same processor model.
-	std::vector<uint32_t> core_ids;
-	in.open("/proc/cpuinfo");
-	while (!in.eof()) {
-		in.getline(line, 512, '\n'); //FIXME: buffer overflow risk.
-		std::string line_string(line);
-		if (line_string.find("core id") != std::string::npos) {
-			sscanf(line, "core id\t\t\t: %u", &id);
-			if (std::find(core_ids.begin(), core_ids.end(), id) == core_ids.end()) //have not seen this physical core yet
-				core_ids.push_back(id); //add to list
-		}
-	}
-	g_num_physical_cpus = core_ids.size() * g_num_physical_packages;
-	in.close();
+	g_num_logical_cpus = g_topology.getNumLogicalCPUs();
+	g_num_physical_cpus = g_topology.getNumPhysicalCores();
 #endif
 
 	//Get number of caches
@@ -470,10 +578,17 @@ int32_t xmem::query_sys_info() {
 	}
 #endif
 #ifdef __gnu_linux__
-	g_total_l1_caches = g_num_physical_cpus; //TODO: this is an absolute guess. How to do this on Linux?
-	g_total_l2_caches = g_num_physical_cpus; //TODO: this is an absolute guess. How to do this on Linux?
-	g_total_l3_caches = g_num_physical_packages; //TODO: this is an absolute guess. How to do this on Linux?
-	g_total_l4_caches = 0; //TODO: this is an absolute guess. How to do this on Linux?
+	if (g_topology.hasCacheInfo()) {
+		g_total_l1_caches = g_topology.getNumCaches(1);
+		g_total_l2_caches = g_topology.getNumCaches(2);
+		g_total_l3_caches = g_topology.getNumCaches(3);
+		g_total_l4_caches = g_topology.getNumCaches(4);
+	} else {
+		g_total_l1_caches = g_num_physical_cpus; //No cache information in sysfs, so guess.
+		g_total_l2_caches = g_num_physical_cpus;
+		g_total_l3_caches = g_num_physical_packages;
+		g_total_l4_caches = 0;
+	}
 #endif
 
 	//Get page size
@@ -504,12 +619,11 @@ int32_t xmem::query_sys_info() {
 			<< g_total_l3_caches
 			<< "/"
 			<< g_total_l4_caches
-#ifdef __gnu_linux__
-			<< " (guess)"
-#endif
+			<< (g_topology.hasCacheInfo() ? "" : " (guess)")
 			<< std::endl; 
 		std::cout << "Regular page size: " << g_page_size << " B" << std::endl;
 		std::cout << "Large page size: " << g_large_page_size << " B" << std::endl;
+		g_topology.report();
 	}
 
 #ifdef _WIN32
@@ -517,6 +631,7 @@ int32_t xmem::query_sys_info() {
 		free(buffer);
 #endif
 
+	g_sys_info_ready = true;
 	return 0;
 }
 
@@ -629,3 +744,12 @@ bool xmem::revertSchedulingPriority() {
 	return true;
 }
 #endif
+
+uint64_t xmem::thread_involuntary_switches() {
+#ifdef __gnu_linux__
+	struct rusage usage;
+	if (getrusage(RUSAGE_THREAD, &usage) == 0)
+		return static_cast<uint64_t>(usage.ru_nivcsw);
+#endif
+	return 0;
+}
@@ -0,0 +1,145 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the AggregateThroughputBenchmark class.
+ */
+
+#ifndef __AGGREGATE_THROUGHPUT_BENCHMARK_H
+#define __AGGREGATE_THROUGHPUT_BENCHMARK_H
+
+//Headers
+#include <Benchmark.h>
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+
+	/**
+	 * @brief A type of benchmark that measures whole-system memory throughput. A group of worker threads runs on each CPU NUMA node at the same time, each group loading its own memory region, and all workers start and stop their timed sections together.
+	 */
+	class AggregateThroughputBenchmark : public Benchmark {
+	public:
+		/**
+		 * @brief Constructor. Remaining parameters are passed directly to the Benchmark constructor. See Benchmark class documentation for parameter semantics.
+		 * @param mem_arrays Memory region for each worker group. Each must hold at least the per-thread working set size times threads_per_group.
+		 * @param lens Length of each memory region in bytes.
+		 * @param threads_per_group Number of worker threads in each group.
+		 * @param cpu_nodes CPU NUMA node for each worker group.
+		 * @param mem_nodes Memory NUMA node of each region, for reporting.
+		 * @param cpu_ids Logical CPU for every worker, group by group. Worker t of group g uses entry g * threads_per_group + t.
+		 */
+		AggregateThroughputBenchmark(
+			std::vector<void*> mem_arrays,
+			std::vector<size_t> lens,
+			uint32_t iterations,
+			uint64_t passes_per_iteration,
+			uint32_t threads_per_group,
+			std::vector<uint32_t> mem_nodes,
+			std::vector<uint32_t> cpu_nodes,
+			std::vector<int32_t> cpu_ids,
+			pattern_mode_t pattern_mode,
+			rw_mode_t rw_mode,
+			chunk_size_t chunk_size,
+			int64_t stride_size,
+			std::vector<PowerReader*> dram_power_readers,
+			std::string name
+		);
+
+		/**
+		 * @brief Destructor.
+		 */
+		virtual ~AggregateThroughputBenchmark() {}
+
+		/**
+		 * @brief Reports benchmark configuration details to the console.
+		 */
+		virtual void report_benchmark_info() const;
+
+		/**
+		 * @brief Reports results to the console.
+		 */
+		virtual void report_results() const;
+
+		/**
+		 * @brief Gets the number of worker groups.
+		 * @returns The number of worker groups.
+		 */
+		uint32_t getNumGroups() const;
+
+		virtual void getResult(BenchmarkResult& result) const;
+
+		/**
+		 * @brief Gets the number of worker threads in each group.
+		 * @returns The number of worker threads per group.
+		 */
+		uint32_t getThreadsPerGroup() const;
+
+		/**
+		 * @brief Gets the CPU NUMA node of a worker group.
+		 * @param group Index of the worker group.
+		 * @returns The CPU NUMA node.
+		 */
+		uint32_t getGroupCPUNode(uint32_t group) const;
+
+		/**
+		 * @brief Gets the memory NUMA node of a worker group.
+		 * @param group Index of the worker group.
+		 * @returns The memory NUMA node.
+		 */
+		uint32_t getGroupMemNode(uint32_t group) const;
+
+		/**
+		 * @brief Gets the average throughput of one worker group over all iterations.
+		 * @param group Index of the worker group.
+		 * @returns The average throughput in MB/s, or -1 if the benchmark has not run or the group does not exist.
+		 */
+		double getAverageGroupMetric(uint32_t group) const;
+
+	protected:
+		virtual bool _run_core();
+
+		/**
+		 * @brief Makes every group's region resident, and builds the pointer permutations for random-access worker threads.
+		 * @returns True on success.
+		 */
+		virtual bool _prepare_core();
+
+	private:
+		std::vector<void*> __mem_arrays; /**< Memory region for each worker group. */
+		std::vector<size_t> __lens; /**< Length of each memory region in bytes. */
+		uint32_t __threads_per_group; /**< Number of worker threads in each group. */
+		std::vector<uint32_t> __mem_nodes; /**< Memory NUMA node for each worker group. */
+		std::vector<uint32_t> __cpu_nodes; /**< CPU NUMA node for each worker group. */
+		std::vector< std::vector<double> > __groupMetricOnIter; /**< Throughput of each worker group on each iteration. */
+		std::vector<double> __averageGroupMetric; /**< Average throughput of each worker group over all iterations. */
+	};
+};
+
+#endif
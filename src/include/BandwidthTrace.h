@@ -0,0 +1,125 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the BandwidthTrace class, which records how far a load worker has progressed over time.
+ */
+
+#ifndef __BANDWIDTH_TRACE_H
+#define __BANDWIDTH_TRACE_H
+
+//Libraries
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace xmem {
+	/**
+	 * @brief One point of a bandwidth trace.
+	 */
+	struct TraceSample {
+		uint64_t tick; /**< Timer tick when the sample was taken. */
+		uint64_t passes; /**< Passes the worker had completed by then. */
+	};
+
+	/**
+	 * @brief Ring buffer of samples of a load worker's progress, taken inside its timed loop. All storage is allocated by the constructor, so recording a sample neither allocates nor locks. Only the worker that owns the trace writes to it, and it is read only after that worker has joined. When the ring is full, the oldest samples are overwritten.
+	 */
+	class BandwidthTrace {
+		public:
+			/**
+			 * @brief Constructor.
+			 * @param capacity Minimum number of samples to keep. It is rounded up to a power of two and limited to BANDWIDTH_TRACE_MAX_SAMPLES.
+			 * @param period_ticks Minimum number of timer ticks between samples.
+			 */
+			BandwidthTrace(size_t capacity, uint64_t period_ticks);
+
+			/**
+			 * @brief Discards all samples and records the start of a measurement window.
+			 * @param tick Timer tick at the start of the window.
+			 * @param bytes_per_pass Bytes touched in each pass by the worker.
+			 */
+			void begin(uint64_t tick, uint64_t bytes_per_pass);
+
+			/**
+			 * @brief Records a sample if at least one period has passed since the last one. Meant to be called after every block of passes.
+			 * @param tick Current timer tick.
+			 * @param passes Passes completed so far.
+			 */
+			inline void sample(uint64_t tick, uint64_t passes) {
+				if (tick < __next_sample_tick)
+					return;
+				TraceSample& s = __samples[__count & __mask];
+				s.tick = tick;
+				s.passes = passes;
+				__count++;
+				__next_sample_tick = tick + __period_ticks;
+			}
+
+			/**
+			 * @brief Gets the number of samples held.
+			 * @returns The number of samples, which is at most the capacity.
+			 */
+			size_t size() const;
+
+			/**
+			 * @brief Gets a sample, counting from the oldest one held.
+			 * @param index Index of the sample. Must be less than size().
+			 * @returns The sample.
+			 */
+			const TraceSample& at(size_t index) const;
+
+			/**
+			 * @brief Indicates whether old samples were overwritten because the ring was full.
+			 * @returns True if samples were lost.
+			 */
+			bool wrapped() const;
+
+			/**
+			 * @brief Gets the bytes touched in each pass by the worker.
+			 * @returns Bytes per pass.
+			 */
+			uint64_t getBytesPerPass() const;
+
+		private:
+			std::vector<TraceSample> __samples; /**< Ring storage. Its size is a power of two. */
+			size_t __mask; /**< Size of the ring minus one, to wrap indices. */
+			uint64_t __count; /**< Number of samples recorded since begin(), including overwritten ones. */
+			uint64_t __period_ticks; /**< Minimum number of ticks between samples. */
+			uint64_t __next_sample_tick; /**< Earliest tick at which the next sample is due. */
+			uint64_t __bytes_per_pass; /**< Bytes touched in each pass by the worker. */
+	};
+
+	/**
+	 * @brief Merges the traces of load workers that measured at the same time into system-wide bandwidth over time. Each worker's progress is interpolated linearly between its samples, and the result covers only the time during which every worker has samples.
+	 * @param traces Trace of each worker.
+	 * @param period_ticks Length of each interval of the merged trace in timer ticks.
+	 * @param ns_per_tick Nanoseconds per timer tick.
+	 * @param mb_per_sec Receives the total bandwidth of the workers in MB/s for each interval, in order. Empty if the traces do not overlap by at least one interval.
+	 */
+	void merge_bandwidth_traces(const std::vector<const BandwidthTrace*>& traces, uint64_t period_ticks, double ns_per_tick, std::vector<double>& mb_per_sec);
+};
+
+#endif
@@ -0,0 +1,145 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the BaselineComparison class.
+ */
+
+#ifndef __BASELINE_COMPARISON_H
+#define __BASELINE_COMPARISON_H
+
+//Headers
+#include <common.h>
+#include <BenchmarkResult.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+	/**
+	 * @brief Outcome of comparing one benchmark against its baseline.
+	 */
+	typedef enum {
+		COMPARISON_UNCHANGED, /**< No significant change. */
+		COMPARISON_IMPROVED, /**< Significantly better than the baseline. */
+		COMPARISON_REGRESSED, /**< Significantly worse than the baseline. */
+		COMPARISON_UNTESTED, /**< Too few iterations on one side to estimate the run-to-run variance. */
+		COMPARISON_NO_BASELINE /**< The baseline has no benchmark with the same parameters. */
+	} comparison_verdict_t;
+
+	/**
+	 * @brief Comparison of one benchmark against its baseline.
+	 */
+	struct ComparisonEntry {
+		std::string name; /**< Name of the current benchmark. */
+		std::string key; /**< Parameter key the benchmarks were matched by. */
+		std::string units; /**< Units of the metric. */
+		double baseline_mean; /**< Mean of the baseline iterations, excluding outliers. */
+		double current_mean; /**< Mean of the current iterations, excluding outliers. */
+		uint32_t baseline_samples; /**< Number of baseline iterations used. */
+		uint32_t current_samples; /**< Number of current iterations used. */
+		double relative_change; /**< (current - baseline) / baseline. */
+		double t; /**< Welch's t statistic. */
+		double t_critical; /**< Two-sided 95% critical value of t for the Welch-Satterthwaite degrees of freedom. */
+		comparison_verdict_t verdict; /**< Outcome. */
+	};
+
+	/**
+	 * @brief Compares benchmark results against a baseline JSON results file from an earlier run, to detect performance regressions.
+	 * Benchmarks are matched by their full parameter key. Each difference is tested against the run-to-run variance with Welch's t-test on the per-iteration metrics, so noisy benchmarks need a larger change to be flagged.
+	 */
+	class BaselineComparison {
+		public:
+			/**
+			 * @brief Constructor. No baseline is loaded.
+			 */
+			BaselineComparison();
+
+			/**
+			 * @brief Loads a baseline written by --json.
+			 * @param filename Name of the baseline file.
+			 * @returns True on success.
+			 */
+			bool load(const std::string& filename);
+
+			/**
+			 * @brief Indicates whether a baseline is loaded.
+			 * @returns True if benchmarks can be compared.
+			 */
+			bool isLoaded() const { return __loaded; }
+
+			/**
+			 * @brief Sets the smallest relative change that can be flagged. Statistically significant changes smaller than this are considered unchanged.
+			 * @param min_relative_change The threshold as a fraction, e.g. 0.02 for 2%.
+			 */
+			void setThreshold(double min_relative_change) { __min_relative_change = min_relative_change; }
+
+			/**
+			 * @brief Compares a benchmark against the first baseline benchmark with the same parameter key that has not been matched yet.
+			 * @param result The current benchmark's results.
+			 */
+			void compare(const BenchmarkResult& result);
+
+			/**
+			 * @brief Prints the comparison of every benchmark to the console.
+			 */
+			void report() const;
+
+			/**
+			 * @brief Gets the number of significant regressions found so far.
+			 * @returns The number of regressions.
+			 */
+			uint32_t getNumRegressions() const;
+
+			/**
+			 * @brief Builds the parameter key that matches a benchmark with its baseline.
+			 * @param result The benchmark's results.
+			 * @returns The key.
+			 */
+			static std::string makeKey(const BenchmarkResult& result);
+
+		private:
+			/**
+			 * @brief A benchmark from the baseline file.
+			 */
+			struct BaselineEntry {
+				std::string name; /**< Name of the baseline benchmark. */
+				std::string key; /**< Parameter key. */
+				std::string units; /**< Units of the metric. */
+				std::vector<double> samples; /**< Per-iteration metrics, excluding outliers. */
+				bool matched; /**< True once a current benchmark has been compared against it. */
+			};
+
+			std::string __filename; /**< Name of the baseline file. */
+			bool __loaded; /**< True if a baseline is loaded. */
+			double __min_relative_change; /**< Smallest relative change that can be flagged. */
+			std::vector<BaselineEntry> __baseline; /**< Benchmarks from the baseline file, in order. */
+			std::vector<ComparisonEntry> __entries; /**< Comparisons made so far, in order. */
+	};
+};
+
+#endif
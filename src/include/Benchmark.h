@@ -36,11 +36,15 @@
 #include <PowerReader.h>
 #include <Thread.h>
 #include <Runnable.h>
+#include <BenchmarkResult.h>
+#include <InterferenceMonitor.h>
 
 //Libraries
 #include <cstdint>
+#include <ostream>
 #include <string>
 #include <vector>
+#include <time.h>
 
 #ifdef _WIN32
 #include <intrin.h>
@@ -48,6 +52,9 @@
 
 namespace xmem {
 
+	class MemoryWorker;
+	class LoadWorker;
+
 	/**
 	 * @brief Flexible abstract class for any memory benchmark.
 	 *
@@ -65,6 +72,7 @@ namespace xmem {
 		 * @param num_worker_threads The number of worker threads to use in the benchmark.
 		 * @param mem_node The logical memory NUMA node used in the benchmark.
 		 * @param cpu_node The logical CPU NUMA node to use for the benchmark.
+		 * @param cpu_ids The logical CPU to lock each worker thread to, in worker order. For latency benchmarks, the first entry is the latency measurement thread. A negative entry means no suitable CPU was found.
 		 * @param pattern_mode This indicates the general type of access pattern used, e.g. sequential or random.
 		 * @param rw_mode This indicates the general type of read/write mix used, e.g. pure reads or pure writes.
 		 * @param chunk_size Size of an individual memory access for load-generating worker threads.
@@ -76,12 +84,11 @@ namespace xmem {
 			void* mem_array,
 			size_t len,
 			uint32_t iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			uint64_t passes_per_iteration,
-#endif
 			uint32_t num_worker_threads,
 			uint32_t mem_node,
 			uint32_t cpu_node,
+			std::vector<int32_t> cpu_ids,
 			pattern_mode_t pattern_mode,
 			rw_mode_t rw_mode,
 			chunk_size_t chunk_size,
@@ -98,9 +105,35 @@ namespace xmem {
 
 		/**
 		 * @brief Runs the benchmark.
+		 * @param print_info If true, print the benchmark header and configuration to the console before running. Callers that run several benchmarks concurrently should pass false and print these beforehand, so that console output is not interleaved.
 		 * @returns True on benchmark success
 		 */
-		bool run();
+		bool run(bool print_info = true);
+
+		/**
+		 * @brief Chooses where the benchmark reports while it prepares and runs. By default progress details are not reported, and warnings and errors go to std::cerr. Must be called before prepare() and run().
+		 * @param info_log Stream for progress details, such as the per-iteration breakdown, or NULL to not report them.
+		 * @param warning_log Stream for warnings and errors, or NULL to discard them. Errors are also kept for getError().
+		 */
+		void setReporting(std::ostream* info_log, std::ostream* warning_log);
+
+		/**
+		 * @brief Gets why prepare() or run() failed.
+		 * @returns The first error reported, or an empty string if there was none.
+		 */
+		std::string getError() const;
+
+		/**
+		 * @brief Prepares the working set for measurement: writes to all of it so that its pages are resident, then builds any pointer permutations the kernels need. run() does this itself if it has not been done yet. It may be called from a different thread than run(), as long as the two do not overlap.
+		 * @returns True on success.
+		 */
+		bool prepare();
+
+		/**
+		 * @brief Checks to see if the working set has been prepared.
+		 * @returns True if prepare() has already completed successfully.
+		 */
+		bool isPrepared() const;
 
 		/** 
 		 * @brief Prints a header piece of information describing the benchmark to the console.
@@ -142,6 +175,80 @@ namespace xmem {
 		 */
 		double getAverageMetric() const;
 
+		/**
+		 * @brief Gets the median benchmark metric across all iterations, excluding outliers.
+		 * @returns The median metric.
+		 */
+		double getMedianMetric() const;
+
+		/**
+		 * @brief Gets the smallest benchmark metric across all iterations, excluding outliers.
+		 * @returns The minimum metric.
+		 */
+		double getMinMetric() const;
+
+		/**
+		 * @brief Gets the largest benchmark metric across all iterations, excluding outliers.
+		 * @returns The maximum metric.
+		 */
+		double getMaxMetric() const;
+
+		/**
+		 * @brief Gets the sample standard deviation of the benchmark metric across all iterations, excluding outliers.
+		 * @returns The standard deviation of the metric.
+		 */
+		double getStdDevMetric() const;
+
+		/**
+		 * @brief Gets the half-width of the 95% confidence interval of the average metric, i.e. the average is reported as getAverageMetric() +/- this value.
+		 * @returns The confidence interval half-width, or 0 if there were too few iterations to estimate it.
+		 */
+		double getConfidenceInterval() const;
+
+		/**
+		 * @brief Gets the number of iterations that were excluded from the statistics as outliers.
+		 * @returns The number of outlier iterations.
+		 */
+		uint32_t getNumOutliers() const;
+
+		/**
+		 * @brief Enables adaptive iteration control. The benchmark then runs at least the number of iterations given to the constructor, and stops once the 95% confidence interval of the average metric is narrow enough, or a limit is reached. Must be called before run().
+		 * @param target_relative_ci Target half-width of the confidence interval as a fraction of the average metric, e.g. 0.02 for +/-2%.
+		 * @param max_iterations Maximum number of iterations.
+		 * @param time_budget_sec Stop after this many seconds even if the target was not met. 0 means no time budget.
+		 */
+		void setAdaptiveIterations(double target_relative_ci, uint32_t max_iterations, uint32_t time_budget_sec);
+
+		/**
+		 * @brief Chooses what happens to iterations with significant interference on the measurement CPUs. By default they are flagged with a warning. Must be called before run().
+		 * @param reject If true, exclude noisy iterations from the statistics like outliers instead of flagging them. In adaptive mode, more iterations are then run to make up for them.
+		 */
+		void setRejectNoisy(bool reject);
+
+		/**
+		 * @brief Chooses how the load workers share the working set. By default each has its own slice. Must be called before prepare() and run().
+		 * @param sharing_mode The sharing mode. Modes other than SHARING_PRIVATE apply to sequential access patterns only.
+		 */
+		void setSharingMode(sharing_mode_t sharing_mode);
+
+		/**
+		 * @brief Gets how the load workers share the working set.
+		 * @returns The sharing mode.
+		 */
+		sharing_mode_t getSharingMode() const;
+
+		/**
+		 * @brief Gives each load worker its own workload instead of the benchmark's access pattern, read/write mode, chunk size and stride. Must be called before prepare() and run(), and cannot be combined with a sharing mode other than SHARING_PRIVATE.
+		 * @param worker_specs The workload of each load worker, in worker order. For latency benchmarks, these are the workers after the latency measurement thread. Regions on other memory nodes must stay allocated until the benchmark is destroyed.
+		 */
+		void setWorkerSpecs(const std::vector<WorkerSpec>& worker_specs);
+
+		/**
+		 * @brief Gets the workload of each load worker, if they have their own.
+		 * @returns The worker specifications, or an empty list if all load workers run the benchmark's kernel.
+		 */
+		const std::vector<WorkerSpec>& getWorkerSpecs() const;
+
 		/**
 		 * @brief Gets the units of the metric for this benchmark.
 		 * @returns A string representing the units for printing to console and file.
@@ -167,18 +274,16 @@ namespace xmem {
 		size_t getLen() const;
 
 		/**
-		 * @brief Gets the number of iterations for this benchmark.
+		 * @brief Gets the number of iterations for this benchmark. After an adaptive run, this is the number of iterations that actually ran.
 		 * @returns The number of iterations for this benchmark.
 		 */
 		uint32_t getIterations() const;
 
-#ifdef USE_SIZE_BASED_BENCHMARKS
 		/**
 		 * @brief Gets the number of passes in each iteration.
 		 * @returns The number of passes per iteration for this benchmark.
 		 */
 		uint64_t getPassesPerIteration() const;
-#endif
 
 		/**
 		 * @brief Gets the width of memory access used in this benchmark.
@@ -228,6 +333,12 @@ namespace xmem {
 		 */
 		rw_mode_t getRWMode() const;
 
+		/**
+		 * @brief Gathers this benchmark's configuration and measurements into the structured result model.
+		 * @param result Filled with the results. Derived classes add their own metrics.
+		 */
+		virtual void getResult(BenchmarkResult& result) const;
+
 	protected:
 	
 		/**
@@ -236,6 +347,24 @@ namespace xmem {
 		 */
 		virtual bool _run_core() = 0;
 
+		/**
+		 * @brief Benchmark-specific preparation of the working set, such as building pointer permutations. Called by prepare() after the working set has been made resident.
+		 * @returns True on success.
+		 */
+		virtual bool _prepare_core();
+
+		/**
+		 * @brief Reports a warning to the warning log.
+		 * @param message The warning, without a "WARNING:" prefix.
+		 */
+		void _reportWarning(const std::string& message) const;
+
+		/**
+		 * @brief Reports an error to the warning log, and keeps it for getError() if it is the first one.
+		 * @param message The error, without an "ERROR:" prefix.
+		 */
+		void _reportError(const std::string& message);
+
 		/**
 		 * @brief Starts the DRAM power measurement threads.
 		 * @returns True on success.
@@ -249,27 +378,158 @@ namespace xmem {
 		 */
 		bool _stop_power_threads();
 
+		/**
+		 * @brief Decides whether to run another iteration. Derived classes call this as the condition of their iteration loop.
+		 * In fixed mode this runs exactly the configured number of iterations. In adaptive mode it stops once the confidence interval target, the maximum number of iterations, or the time budget is reached.
+		 * @param iter Index of the iteration that would run next. All iterations before it must have recorded their metric.
+		 * @returns True if iteration iter should run. Space for its metric is then available in _metricOnIter.
+		 */
+		bool _beginIteration(uint32_t iter);
+
+		/**
+		 * @brief Reports the summary statistics of the metric to the console. Used by report_results().
+		 */
+		void _report_statistics() const;
+
+		/**
+		 * @brief Finalizes the iteration count and computes the summary statistics of the metric. Derived classes call this once their iteration loop has ended.
+		 */
+		void _finishIterations();
+
+		/**
+		 * @brief Computes the summary statistics over the first num_samples iterations. Outliers are found with the median absolute deviation, which is robust to the outliers themselves, and are excluded.
+		 * @param num_samples Number of iterations to include.
+		 */
+		void _computeStatistics(uint32_t num_samples);
+
+		/**
+		 * @brief Records what one worker measured in an iteration, for the structured results. Call once per worker after it has joined.
+		 * @param iter Index of the iteration.
+		 * @param worker The worker.
+		 * @param latency True if the worker measured latency, false if it generated load.
+		 * @param ns_per_tick Nanoseconds per timer tick, to convert the worker's ticks into its throughput.
+		 */
+		void _recordWorker(uint32_t iter, MemoryWorker* worker, bool latency, double ns_per_tick);
+
+		/**
+		 * @brief Takes a snapshot of the activity on the measurement CPUs. Call right before starting an iteration's workers.
+		 */
+		void _beginInterferenceCheck();
+
+		/**
+		 * @brief Measures the activity on the measurement CPUs since _beginInterferenceCheck(), and flags the iteration if it was noisy. Call after the iteration's workers have been recorded with _recordWorker().
+		 * @param iter Index of the iteration.
+		 */
+		void _endInterferenceCheck(uint32_t iter);
+
+		/**
+		 * @brief Reports how many iterations had significant interference, if any did. Used by report_results().
+		 */
+		void _report_interference() const;
+
+		/**
+		 * @brief Computes the effective core frequency of each iteration and its spread, and flags the results with a warning if the frequency varied by more than FREQUENCY_VARIATION_THRESHOLD. Used by _finishIterations().
+		 */
+		void _computeFrequency();
+
+		/**
+		 * @brief Reports the effective core frequency to the console, if it is known. Used by report_results().
+		 */
+		void _report_frequency() const;
+
+		/**
+		 * @brief Makes a load worker trace its bandwidth over time, if bandwidth tracing is enabled and the benchmark is time-based. Call before the worker runs.
+		 * @param worker The worker.
+		 * @param ticks_per_sec Timer ticks per second.
+		 */
+		void _traceWorker(LoadWorker* worker, uint64_t ticks_per_sec) const;
+
+		/**
+		 * @brief Merges the bandwidth traces of the load workers of an iteration into the system-wide bandwidth over time for that iteration. Does nothing if the workers were not traced.
+		 * @param iter Index of the iteration.
+		 * @param workers The load workers, all of which measured at the same time.
+		 * @param ticks_per_sec Timer ticks per second.
+		 * @param ns_per_tick Nanoseconds per timer tick.
+		 */
+		void _recordTrace(uint32_t iter, const std::vector<LoadWorker*>& workers, uint64_t ticks_per_sec, double ns_per_tick);
+
+		/**
+		 * @brief Reports the range of the system-wide bandwidth traces to the console, if there are any. Used by report_results().
+		 */
+		void _report_trace() const;
+
+		/**
+		 * @brief Gets the workload of a load worker that has its own.
+		 * @param t Index of the worker.
+		 * @param first_load_worker Index of the first load worker.
+		 * @returns The worker's specification, or NULL if it runs the benchmark's kernel.
+		 */
+		const WorkerSpec* _workerSpec(uint32_t t, uint32_t first_load_worker) const;
+
+		/**
+		 * @brief Determines the memory region and kernel of a load worker. A worker with its own WorkerSpec gets that kernel, and its own region or else slice t of the working set. Otherwise the sharing mode decides: private workers get slice t of the working set, or else the load workers share one slice: all read it, or the first load worker writes it while the others read it, or all write it with their chunks interleaved within each cache line.
+		 * @param t Index of the worker.
+		 * @param first_load_worker Index of the first load worker, which is the writer in SHARING_ONE_WRITER mode.
+		 * @param mem_array Start of the working set that the load workers' slices are carved from.
+		 * @param shared_slice Start of the slice that shared load workers use.
+		 * @param len_per_thread Length of each worker's region in bytes.
+		 * @param pattern_mode Set to the access pattern of the worker's kernel.
+		 * @param rw_mode Set to the read/write mode of the worker's kernel.
+		 * @param chunk_size Set to the chunk size of the worker's kernel.
+		 * @param stride_size Set to the stride of the worker's kernel in chunks.
+		 * @returns Start of the worker's region.
+		 */
+		void* _loadRegion(uint32_t t, uint32_t first_load_worker, void* mem_array, void* shared_slice, size_t len_per_thread, pattern_mode_t& pattern_mode, rw_mode_t& rw_mode, chunk_size_t& chunk_size, int64_t& stride_size) const;
+
+		/**
+		 * @brief Reports the sharing mode to the console if the load workers share memory. Used by report_benchmark_info().
+		 */
+		void _report_sharing() const;
+
+		/**
+		 * @brief Reports the workload of each load worker to the console if they have their own. Used by report_benchmark_info().
+		 * @param first_load_worker Index of the first load worker.
+		 */
+		void _report_worker_specs(uint32_t first_load_worker) const;
+
+		/**
+		 * @brief Computes the mean throughput of each load thread over the non-outlier iterations and how fairly it was shared. Used by _finishIterations().
+		 */
+		void _computeWorkerFairness();
+
+		/**
+		 * @brief Reports the throughput of each load thread and the fairness summary to the console, if there is more than one load thread. Used by report_results().
+		 */
+		void _report_workers() const;
+
 
 		//Memory region under test
 		void* _mem_array; /**< Pointer to the memory region to use in this benchmark. */
 		size_t _len; /**< Length of the memory region in bytes. This is not the working set size per thread! */
 
 		//Benchmark repetition
-		uint32_t _iterations; /**< Number of iterations used in this benchmark. */
-#ifdef USE_SIZE_BASED_BENCHMARKS
+		uint32_t _iterations; /**< Number of iterations used in this benchmark. In adaptive mode this is the minimum until the benchmark has run. */
+		uint32_t _max_iterations; /**< Maximum number of iterations. Equal to _iterations unless adaptive iteration control is enabled. */
+		double _target_relative_ci; /**< Target half-width of the confidence interval relative to the average metric. 0 in fixed mode. */
+		uint32_t _time_budget_sec; /**< Time budget for adaptive iteration control in seconds, or 0 for none. */
+		bool _reject_noisy; /**< If true, iterations with significant interference are excluded from the statistics. Otherwise they are flagged. */
+		time_t _run_start_time; /**< Wall clock time when run() was called. */
+		uint32_t _completed_iterations; /**< Number of iterations completed so far. */
 		uint64_t _passes_per_iteration; /**< Number of passes per iteration in this benchmark. */
-#endif
 	
 		//Threading and affinity
 		uint32_t _num_worker_threads; /**< The number of worker threads used in this benchmark. */
 		uint32_t _mem_node; /**< The memory NUMA node used in this benchmark. */
 		uint32_t _cpu_node; /**< The CPU NUMA node used in this benchmark. */
+		std::vector<int32_t> _cpu_ids; /**< The logical CPU for each worker thread. */
 		
 		//Benchmarking settings
 		pattern_mode_t _pattern_mode; /**< Access pattern mode. */
 		rw_mode_t _rw_mode; /**< Read/write mode. */
 		chunk_size_t _chunk_size; /**< Chunk size of memory accesses in this benchmark. */
 		int64_t _stride_size; /**< Stride size in chunks for sequential pattern mode only. */
+		sharing_mode_t _sharing_mode; /**< How the load workers share the working set. */
+		std::vector<WorkerSpec> _worker_specs; /**< Workload of each load worker, or empty if they all run the kernel above. */
 		
 		//Power measurement
 		std::vector<PowerReader*> _dram_power_readers; /**< The power reading objects for measuring DRAM power on a per-socket basis during the benchmark. */
@@ -277,16 +537,44 @@ namespace xmem {
 		
 		//Benchmark results
 		std::vector<double> _metricOnIter; /**< Metrics for each iteration of the benchmark. Unit-less because any benchmark can set this metric as needed. It is up to the descendant class to interpret units. */
-		double _averageMetric; /**< Average metric over all iterations. Unit-less because any benchmark can set this metric as needed. It is up to the descendant class to interpret units. */
+		double _averageMetric; /**< Average metric over all iterations, excluding outliers. Unit-less because any benchmark can set this metric as needed. It is up to the descendant class to interpret units. */
+		double _medianMetric; /**< Median metric over all iterations, excluding outliers. */
+		double _minMetric; /**< Minimum metric over all iterations, excluding outliers. */
+		double _maxMetric; /**< Maximum metric over all iterations, excluding outliers. */
+		double _stddevMetric; /**< Sample standard deviation of the metric over all iterations, excluding outliers. */
+		double _ciMetric; /**< Half-width of the 95% confidence interval of the average metric. */
+		std::vector<bool> _outlierOnIter; /**< Whether each iteration was excluded from the statistics as an outlier. */
+		std::vector<bool> _warningOnIter; /**< Whether each iteration's results are questionable. */
+		std::vector< std::vector<WorkerResult> > _workersOnIter; /**< What each worker measured, for each iteration. */
+		std::vector<double> _workerMetrics; /**< Mean throughput of each load thread in MB/s, excluding outlier iterations. */
+		std::vector<double> _fairnessOnIter; /**< Jain fairness index of the load thread throughputs in each iteration. */
+		double _minWorkerMetric; /**< Lowest mean load thread throughput in MB/s. */
+		double _maxWorkerMetric; /**< Highest mean load thread throughput in MB/s. */
+		double _workerFairness; /**< Jain fairness index of the mean load thread throughputs. */
+		std::vector<InterferenceResult> _interferenceOnIter; /**< Activity on the measurement CPUs during each iteration. */
+		InterferenceSnapshot _interferenceBefore; /**< Snapshot taken at the start of the current iteration. */
+		std::vector<double> _frequencyOnIter; /**< Mean effective core frequency of the workers in each iteration in GHz, or 0 if unknown. */
+		double _averageFrequency; /**< Mean effective core frequency over the iterations where it is known, in GHz. */
+		double _minFrequency; /**< Lowest known effective core frequency of any iteration in GHz. */
+		double _maxFrequency; /**< Highest known effective core frequency of any iteration in GHz. */
+		bool _frequencyVaried; /**< True if the frequency spread across iterations exceeded FREQUENCY_VARIATION_THRESHOLD. */
+		std::vector< std::vector<double> > _traceOnIter; /**< System-wide bandwidth over time in MB/s for each iteration, one value per trace period. Empty unless bandwidth tracing is enabled. */
 		std::string _metricUnits; /**< String representing the units of measurement for the metric. */
 		std::vector<double> _average_dram_power_socket; /**< The average DRAM power in this benchmark, per socket. */
 		std::vector<double> _peak_dram_power_socket; /**< The peak DRAM power in this benchmark, per socket. */
+		std::vector<PowerResult> _dram_power_results; /**< Power summary and full sample trace of each DRAM power reader. */
 
 		//Metadata
 		std::string _name; /**< Name of this benchmark. */
 		bool _obj_valid; /**< Indicates whether this benchmark object is valid. */
 		bool _hasRun; /**< Indicates whether the benchmark has run. */
+		bool _prepared; /**< Indicates whether the working set has been prepared. */
 		bool _warning; /**< Indicates whether the benchmarks results might be clearly questionable/inaccurate/incorrect due to a variety of factors. */
+
+		//Reporting
+		std::ostream* _info_log; /**< Where progress details are reported, or NULL if they are not wanted. */
+		std::ostream* _warning_log; /**< Where warnings and errors are reported, or NULL to discard them. */
+		std::string _error; /**< The first error reported while preparing or running, if any. */
 	};
 };
 
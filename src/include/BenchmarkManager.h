@@ -37,12 +37,19 @@
 #include <Benchmark.h>
 #include <ThroughputBenchmark.h>
 #include <LatencyBenchmark.h>
+#include <AggregateThroughputBenchmark.h>
 #include <Configurator.h>
+#include <BenchmarkResult.h>
+#include <ResultStream.h>
+#include <BaselineComparison.h>
 
 //Libraries
 #include <cstdint>
 #include <vector>
 #include <fstream>
+#include <string>
+
+#define STATISTICS_CSV_HEADER "Metric Median,Metric Min,Metric Max,Metric Standard Deviation,Metric 95% Confidence Interval (+/-),Outlier Iterations,Min Thread Throughput (MB/s),Max Thread Throughput (MB/s),Thread Fairness Index," /**< Results file columns for the summary statistics of each benchmark's metric and the fairness of its load threads, excluding outliers. */
 
 namespace xmem {
 	/**
@@ -79,6 +86,36 @@ namespace xmem {
 		 */
 		bool runLatencyBenchmarks();
 
+		/**
+		 * @brief Runs the benchmarks described by the plan file, in order. Each benchmark and its working set are created just before they are needed and freed right after the benchmark runs. Depending on the configured overlap policy, the next benchmark may be prepared in the background while the current one measures.
+		 * @returns True if all of the benchmarks succeeded.
+		 */
+		bool runPlanBenchmarks();
+
+		/**
+		 * @brief Prints the comparison of all benchmarks run so far against the baseline, if one was loaded.
+		 * @returns The number of significant regressions.
+		 */
+		uint32_t reportComparison() const;
+
+		/**
+		 * @brief Runs the NUMA matrix benchmarks. For a single kernel, every CPU NUMA node is measured against every memory NUMA node, and the results are reported as tables.
+		 * @returns True on benchmarking success.
+		 */
+		bool runMatrixBenchmarks();
+
+		/**
+		 * @brief Runs the aggregate throughput benchmarks. Each configured kernel is run by a worker group on every NUMA node at the same time.
+		 * @returns True on benchmarking success.
+		 */
+		bool runAggregateBenchmarks();
+
+		/**
+		 * @brief Generates a steady background load for other workloads to be measured against, instead of running benchmarks. The worker threads run the first configured kernel until the configured duration passes or the process is asked to stop, throttled to the configured rate. The achieved bandwidth is printed every second, with a summary at the end.
+		 * @returns True if the load ran.
+		 */
+		bool runAntagonist();
+
 	private:
 		/**
 		 * @brief Allocates memory for all working sets.
@@ -86,12 +123,105 @@ namespace xmem {
 		 */
 		void __setupWorkingSets(size_t working_set_size);
 
+		/**
+		 * @brief Allocates one page-aligned working set on a NUMA node, using large pages if configured.
+		 * @param numa_node The memory NUMA node.
+		 * @param len Size of the working set in bytes.
+		 * @returns The working set, or nullptr on failure.
+		 */
+		void* __allocateWorkingSet(uint32_t numa_node, size_t len);
+
+		/**
+		 * @brief Frees a working set allocated by __allocateWorkingSet().
+		 * @param mem_array The working set.
+		 * @param len Size of the working set in bytes.
+		 */
+		void __freeWorkingSet(void* mem_array, size_t len);
+
 		/**
 		 * @brief Constructs and initializes all configured benchmarks.
 		 * @returns True on success.
 		 */
 		bool __buildBenchmarks();
 
+		/**
+		 * @brief Chooses the logical CPUs for worker threads on each CPU NUMA node, according to the configured placement policy or explicit CPU list. This is done once, and the results are passed to every benchmark.
+		 */
+		void __placeWorkers();
+
+		/**
+		 * @brief Allocates the working set for a plan benchmark, places its workers, and constructs it.
+		 * @param spec The benchmark specification.
+		 * @param mem_array Set to the allocated working set.
+		 * @param len Set to the length of the working set in bytes.
+		 * @param worker_arrays Set to the working sets allocated for load threads on other memory nodes, one per node, starting with the load threads' working set if a latency benchmark has a load memory node.
+		 * @param worker_lens Set to the length of each of worker_arrays in bytes.
+		 * @param worker_cpus Set to the logical CPUs the benchmark's worker threads will run on.
+		 * @returns The benchmark, or NULL if its working sets could not be allocated.
+		 */
+		Benchmark* __buildPlanBenchmark(const BenchmarkSpec& spec, void*& mem_array, size_t& len, std::vector<void*>& worker_arrays, std::vector<size_t>& worker_lens, std::vector<int32_t>& worker_cpus);
+
+		/**
+		 * @brief Chooses a logical CPU to prepare the next plan benchmark on while the current one measures, according to the configured overlap policy.
+		 * @param measured The benchmark that will be measuring.
+		 * @param measured_cpus Logical CPUs of the measured benchmark's worker threads.
+		 * @param next The benchmark to prepare.
+		 * @returns A logical CPU, or -1 if preparation must not overlap with this measurement.
+		 */
+		int32_t __choosePrepCPU(const BenchmarkSpec& measured, const std::vector<int32_t>& measured_cpus, const BenchmarkSpec& next) const;
+
+		/**
+		 * @brief Gathers the configured kernel options into vectors, so that benchmark construction can loop over them.
+		 * @param chunks Filled with the selected chunk sizes.
+		 * @param rws Filled with the selected read/write modes.
+		 * @param strides Filled with the selected stride sizes for sequential patterns.
+		 */
+		void __getKernelOptions(std::vector<chunk_size_t>& chunks, std::vector<rw_mode_t>& rws, std::vector<int64_t>& strides) const;
+
+		/**
+		 * @brief Applies the configured iteration control, fixed or adaptive, to a benchmark before it runs, and has it report to the console: progress details in verbose mode, and warnings and errors always.
+		 * @param benchmark The benchmark to configure.
+		 */
+		void __applyRunSettings(Benchmark* benchmark) const;
+
+		/**
+		 * @brief Writes a benchmark's results to every results file in use: a CSV row, unless the mode writes its own CSV table, and a JSON record.
+		 * @param benchmark The benchmark that has run.
+		 */
+		void __writeResults(const Benchmark* benchmark);
+
+		/**
+		 * @brief Writes the summary statistics of a benchmark's metric to the results file, as comma-terminated columns matching STATISTICS_CSV_HEADER.
+		 * @param result The benchmark's results.
+		 */
+		void __writeStatistics(const BenchmarkResult& result);
+
+		/**
+		 * @brief Writes one row of results for a throughput or latency benchmark to the results file.
+		 * @param result The benchmark's results.
+		 */
+		void __writeCSVResult(const BenchmarkResult& result);
+
+		/**
+		 * @brief Writes one row of results for an aggregate throughput benchmark to the results file.
+		 * @param result The benchmark's results.
+		 */
+		void __writeAggregateCSVResult(const BenchmarkResult& result);
+
+		/**
+		 * @brief Runs a set of benchmarks at the same time, each in its own thread. The benchmarks must not share CPUs or memory.
+		 * @param benchmarks The benchmarks to run. Entries must not be NULL.
+		 * @returns True if all of the benchmarks succeeded.
+		 */
+		bool __runConcurrently(std::vector<Benchmark*> benchmarks);
+
+		/**
+		 * @brief Prints an NxN CPU node by memory node table to the console, and also to the results file if applicable.
+		 * @param title Name of the table.
+		 * @param cells Values indexed as cells[cpu_node][mem_node].
+		 */
+		void __reportMatrix(std::string title, const std::vector< std::vector<double> >& cells);
+
 		Configurator __config;
 
 		uint32_t __num_numa_nodes; /**< Number of NUMA nodes in the system. */
@@ -101,7 +231,12 @@ namespace xmem {
 		std::vector<ThroughputBenchmark*> __tp_benchmarks; /**< Set of throughput benchmarks. */
 		std::vector<LatencyBenchmark*> __lat_benchmarks; /**< Set of latency benchmarks. */
 		std::vector<PowerReader*> __dram_power_readers; /**< Set of power measurement objects for DRAM on each NUMA node. */
+		std::vector<uint32_t> __benchmark_cpu_nodes; /**< CPU NUMA nodes to run benchmarks from. */
+		std::vector< std::vector<int32_t> > __tp_cpus; /**< For each CPU NUMA node, the logical CPU of each throughput worker thread. */
+		std::vector< std::vector<int32_t> > __lat_cpus; /**< For each CPU NUMA node, the logical CPU of the latency thread followed by those of the load threads. */
 		std::fstream __results_file; /**< The results CSV file. */
+		ResultStream __json_stream; /**< The newline-delimited JSON results file, if enabled. */
+		BaselineComparison __baseline; /**< Baseline results to compare against, if enabled. */
 		bool __built_benchmarks; /**< If true, finished building all benchmarks. */
 	};
 };
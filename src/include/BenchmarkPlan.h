@@ -0,0 +1,162 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the BenchmarkPlan class.
+ */
+
+#ifndef __BENCHMARK_PLAN_H
+#define __BENCHMARK_PLAN_H
+
+//Headers
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+	/**
+	 * @brief Everything needed to construct one benchmark from a plan file.
+	 */
+	struct BenchmarkSpec {
+		bool latency; /**< If true, this is a LatencyBenchmark. Otherwise it is a ThroughputBenchmark. */
+		std::string label; /**< Label used in the benchmark name. If empty, "Throughput" or "Latency" is used. */
+		uint32_t num_worker_threads; /**< Number of worker threads. For latency benchmarks this includes the latency measurement thread. */
+		size_t working_set_size_per_thread; /**< Working set size per thread in bytes. */
+		pattern_mode_t pattern_mode; /**< Access pattern of the (load) kernel. */
+		rw_mode_t rw_mode; /**< Read/write mode of the (load) kernel. */
+		chunk_size_t chunk_size; /**< Chunk size of the (load) kernel. */
+		int64_t stride_size; /**< Stride size in chunks for sequential patterns. Ignored for random patterns. */
+		uint32_t cpu_node; /**< NUMA node whose CPUs run the worker threads. */
+		uint32_t mem_node; /**< NUMA node the working set is allocated on. */
+		placement_policy_t placement; /**< Policy for choosing CPUs within cpu_node. Ignored if cpus is not empty. */
+		std::vector<uint32_t> cpus; /**< Explicit logical CPUs for the worker threads, or empty to use the placement policy. */
+		int32_t latency_cpu; /**< Logical CPU for the latency measurement thread, or -1 to use the first placed CPU. */
+		int32_t load_cpu_node; /**< NUMA node whose CPUs run the load threads of a latency benchmark, or -1 for cpu_node. Ignored for throughput benchmarks. */
+		int32_t load_mem_node; /**< NUMA node the load threads' working set is allocated on in a latency benchmark, or -1 for mem_node. Ignored for throughput benchmarks. */
+		sharing_mode_t sharing_mode; /**< How the load threads share the working set. Modes other than SHARING_PRIVATE need the sequential pattern. */
+		std::vector<WorkerSpec> workers; /**< Workload of each load thread, or empty if they all run the kernel above. If not empty, num_worker_threads must count one load thread per entry, plus the latency measurement thread. Memory regions are allocated when the benchmark is built. */
+		uint32_t iterations; /**< Iterations of the benchmark. */
+		uint32_t line; /**< Line in the plan file where this benchmark's section begins. */
+	};
+
+	/**
+	 * @brief Checks that a benchmark specification can be run on this machine.
+	 * @param spec The specification to check.
+	 * @param error Set to a description of the problem if the specification is not usable.
+	 * @returns True if the specification is usable.
+	 */
+	bool validate_benchmark_spec(const BenchmarkSpec& spec, std::string& error);
+
+	/**
+	 * @brief Gets the NUMA node whose CPUs run a benchmark's load threads.
+	 * @param spec The benchmark specification.
+	 * @returns The load CPU node of a latency benchmark if one was given, or else cpu_node.
+	 */
+	uint32_t spec_load_cpu_node(const BenchmarkSpec& spec);
+
+	/**
+	 * @brief Gets the NUMA node that a benchmark's load threads take their slices of the working set from.
+	 * @param spec The benchmark specification.
+	 * @returns The load memory node of a latency benchmark if one was given, or else mem_node.
+	 */
+	uint32_t spec_load_mem_node(const BenchmarkSpec& spec);
+
+	/**
+	 * @brief An ordered list of benchmark specifications read from a plan file.
+	 *
+	 * A plan file is a small INI-style text file. Each [throughput] or [latency] section describes one benchmark, in the order they are to be run. A [defaults] section changes the starting values for all of the sections after it. Lines starting with # or ; are comments. Keys are:
+	 * name, threads, working_set_kb, pattern (sequential|random), rw (read|write), chunk (32|64|128|256), stride, cpu_node, mem_node, placement (compact|scatter|smt_pairs), cpus (e.g. 0,2,4-7), latency_cpu, load_cpu_node, load_mem_node, sharing (private|read_shared|one_writer|false_sharing), iterations, workers.
+	 * Each workers line in a [throughput] or [latency] section adds a group of load threads with their own workload, e.g. "workers = 4 pattern=sequential rw=write chunk=256 mem_node=1 rate=2000". It starts with the number of threads, followed by any of pattern, rw, chunk, stride, mem_node, and rate (MB/s per thread, 0 for no limit). Settings not given take the section's values, and mem_node defaults to load_mem_node if that is set. Groups replace the threads setting.
+	 * load_cpu_node and load_mem_node move the load threads of a [latency] section to other NUMA nodes than its latency measurement thread. They are ignored in [throughput] sections.
+	 */
+	class BenchmarkPlan {
+		public:
+			/**
+			 * @brief Constructor. The plan is empty until load() is called.
+			 */
+			BenchmarkPlan();
+
+			/**
+			 * @brief Reads and validates a plan file.
+			 * @param filename Path of the plan file.
+			 * @param defaults Starting values for every benchmark, usually taken from the command line options.
+			 * @returns True on success. On failure, an error is printed and the plan is left empty.
+			 */
+			bool load(const std::string& filename, const BenchmarkSpec& defaults);
+
+			/**
+			 * @brief Gets the name of the loaded plan file.
+			 * @returns The plan filename.
+			 */
+			const std::string& getFilename() const;
+
+			/**
+			 * @brief Gets the number of benchmarks in the plan.
+			 * @returns The number of benchmarks.
+			 */
+			size_t getNumSpecs() const;
+
+			/**
+			 * @brief Gets one benchmark specification.
+			 * @param index Position in the plan, starting from 0.
+			 * @returns The specification.
+			 */
+			const BenchmarkSpec& getSpec(size_t index) const;
+
+		private:
+			/**
+			 * @brief Applies one key = value line to a specification.
+			 * @param spec The specification to modify.
+			 * @param key Key name.
+			 * @param value Value text.
+			 * @returns True if the key is known and the value is well-formed.
+			 */
+			bool __setKey(BenchmarkSpec& spec, const std::string& key, const std::string& value) const;
+
+			/**
+			 * @brief Replaces the load threads of a completed specification with the worker groups given in its section, if any.
+			 * @param spec The specification to modify.
+			 * @param groups Value of each workers line in the section.
+			 * @param lines Line of each workers line in the plan file.
+			 * @returns True if every group is well-formed. Otherwise an error is printed.
+			 */
+			bool __setWorkers(BenchmarkSpec& spec, const std::vector<std::string>& groups, const std::vector<uint32_t>& lines) const;
+
+			/**
+			 * @brief Checks that a completed specification can be run on this machine.
+			 * @param spec The specification to check.
+			 * @returns True if the specification is usable. Otherwise an error is printed.
+			 */
+			bool __validate(const BenchmarkSpec& spec) const;
+
+			std::string __filename; /**< Name of the loaded plan file. */
+			std::vector<BenchmarkSpec> __specs; /**< Benchmarks in the order they are to be run. */
+	};
+};
+
+#endif
@@ -0,0 +1,77 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the BenchmarkPreparer class.
+ */
+
+#ifndef __BENCHMARK_PREPARER_H
+#define __BENCHMARK_PREPARER_H
+
+//Headers
+#include <Runnable.h>
+#include <Benchmark.h>
+
+//Libraries
+#include <cstdint>
+
+namespace xmem {
+	/**
+	 * @brief Multithreading-friendly wrapper that prepares a Benchmark's working set in its own Thread. This lets setup for the next benchmark overlap with measurement of the current one.
+	 */
+	class BenchmarkPreparer : public Runnable {
+		public:
+			/**
+			 * @brief Constructor.
+			 * @param benchmark The benchmark to prepare. It must outlive this object.
+			 * @param cpu_affinity Logical CPU to do the preparation on, or -1 to let the OS choose.
+			 */
+			BenchmarkPreparer(Benchmark* benchmark, int32_t cpu_affinity);
+
+			/**
+			 * @brief Destructor.
+			 */
+			virtual ~BenchmarkPreparer();
+
+			/**
+			 * @brief Thread-safe worker method. Prepares the benchmark's working set.
+			 */
+			virtual void run();
+
+			/**
+			 * @brief Indicates whether the preparation succeeded.
+			 * @returns True if the benchmark was prepared successfully.
+			 */
+			bool succeeded();
+
+		private:
+			// ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+			Benchmark* __benchmark; /**< The benchmark to prepare. */
+			int32_t __cpu_affinity; /**< Logical CPU to do the preparation on, or -1. */
+			bool __success; /**< True if the benchmark was prepared successfully. */
+	};
+};
+
+#endif
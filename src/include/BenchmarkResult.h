@@ -0,0 +1,195 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the structured benchmark result model.
+ */
+
+#ifndef __BENCHMARK_RESULT_H
+#define __BENCHMARK_RESULT_H
+
+//Headers
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+	/**
+	 * @brief What one worker thread measured in one benchmark iteration.
+	 */
+	struct WorkerResult {
+		int32_t cpu; /**< Logical CPU the worker was placed on, or -1 if it was not pinned. */
+		bool latency; /**< True for a latency measurement thread, false for a load thread. */
+		uint64_t passes; /**< Number of kernel passes. */
+		uint64_t bytes_per_pass; /**< Number of bytes touched in each pass. */
+		uint64_t elapsed_ticks; /**< Timer ticks spent in the kernel. */
+		uint64_t elapsed_dummy_ticks; /**< Timer ticks spent in the dummy kernel, which measures loop overhead. */
+		uint64_t adjusted_ticks; /**< Elapsed ticks minus elapsed dummy ticks. */
+		double throughput; /**< Bytes touched by this worker over its own adjusted time, in MB/s. */
+		double frequency_ghz; /**< Effective core frequency during the timed section in GHz, from APERF and MPERF, or 0 if unknown. */
+		uint64_t involuntary_switches; /**< Number of times the worker was preempted during its timed section. */
+		bool warning; /**< True if the worker's results are questionable. */
+	};
+
+	/**
+	 * @brief Activity on the measurement CPUs during one benchmark iteration that may have disturbed it. Times are summed over the CPUs.
+	 */
+	struct InterferenceResult {
+		bool measured; /**< True if the activity could be measured. */
+		bool noisy; /**< True if the activity exceeded the interference thresholds. */
+		double elapsed_sec; /**< Wall clock time between the snapshots. */
+		uint64_t interrupts; /**< Interrupts handled. */
+		double irq_sec; /**< Time spent servicing hardware interrupts. */
+		double softirq_sec; /**< Time spent servicing softirqs. */
+		double steal_sec; /**< Time stolen by the hypervisor. */
+		double run_delay_sec; /**< Time that tasks spent waiting on the run queues, or 0 if unknown. */
+		uint64_t involuntary_switches; /**< Involuntary context switches of the workers during their timed sections. */
+	};
+
+	/**
+	 * @brief DRAM power measured by one power reader during a benchmark.
+	 */
+	struct PowerResult {
+		std::string name; /**< Name of the power reader, e.g. "Socket 0 DRAM". */
+		double average_watts; /**< Average power in watts. */
+		double peak_watts; /**< Peak power in watts. */
+		double sampling_period_sec; /**< Time between samples in the trace, in seconds. */
+		std::vector<double> trace_watts; /**< Every power sample in watts, in order. */
+	};
+
+	/**
+	 * @brief Everything known about one benchmark after it has run. Result writers consume this instead of querying benchmarks directly.
+	 */
+	struct BenchmarkResult {
+		std::string name; /**< Benchmark name. */
+		std::string kind; /**< "throughput", "latency", or "aggregate". */
+		bool completed; /**< True if the benchmark ran. */
+		bool warning; /**< True if any iteration's results are questionable. */
+
+		//Configuration
+		uint64_t working_set_size_per_thread; /**< Working set size per worker thread in bytes. */
+		uint32_t num_threads; /**< Total number of worker threads. */
+		uint32_t num_load_threads; /**< Number of load generating threads. For latency benchmarks, this excludes the latency measurement thread. */
+		uint32_t cpu_node; /**< CPU NUMA node. */
+		uint32_t mem_node; /**< Memory NUMA node. */
+		uint32_t load_cpu_node; /**< CPU NUMA node of the load threads of a latency benchmark. Otherwise the same as cpu_node. */
+		uint32_t load_mem_node; /**< Memory NUMA node of the load threads of a latency benchmark. Otherwise the same as mem_node. */
+		std::vector<int32_t> cpus; /**< Logical CPU of each worker thread. */
+		pattern_mode_t pattern_mode; /**< Access pattern of the load threads. */
+		rw_mode_t rw_mode; /**< Read/write mix of the load threads. */
+		chunk_size_t chunk_size; /**< Chunk size of the load threads. */
+		int64_t stride_size; /**< Stride of the load threads in chunks. */
+		sharing_mode_t sharing_mode; /**< How the load threads share the working set. */
+		std::vector<WorkerSpec> worker_specs; /**< Workload of each load thread, or empty if they all run the kernel above. Memory regions are not meaningful here. */
+		uint64_t passes_per_iteration; /**< Passes per iteration in size-based mode. */
+
+		//Primary metric
+		std::string metric_units; /**< Units of the primary metric. */
+		std::vector<double> metric_on_iter; /**< Primary metric of each iteration. */
+		std::vector<bool> outlier_on_iter; /**< Whether each iteration was excluded from the statistics as an outlier. */
+		std::vector<bool> warning_on_iter; /**< Whether each iteration's results are questionable. */
+		std::vector<InterferenceResult> interference_on_iter; /**< Activity on the measurement CPUs during each iteration. */
+		uint32_t num_noisy; /**< Number of iterations with significant interference. */
+		bool reject_noisy; /**< True if noisy iterations were excluded from the statistics, false if they were only flagged. */
+		double average_metric; /**< Mean of the primary metric, excluding outliers. */
+		double median_metric; /**< Median of the primary metric, excluding outliers. */
+		double min_metric; /**< Minimum of the primary metric, excluding outliers. */
+		double max_metric; /**< Maximum of the primary metric, excluding outliers. */
+		double stddev_metric; /**< Sample standard deviation of the primary metric, excluding outliers. */
+		double ci_metric; /**< Half-width of the 95% confidence interval of the mean. */
+		uint32_t num_outliers; /**< Number of outlier iterations. */
+
+		//Load metric, for latency benchmarks with load threads
+		std::string load_metric_units; /**< Units of the load metric, or empty if there is none. */
+		std::vector<double> load_metric_on_iter; /**< Load throughput of each iteration. */
+		double average_load_metric; /**< Mean load throughput over all iterations. */
+
+		//Worker groups, for aggregate benchmarks
+		std::vector<uint32_t> group_cpu_nodes; /**< CPU NUMA node of each worker group. */
+		std::vector<uint32_t> group_mem_nodes; /**< Memory NUMA node of each worker group. */
+		std::vector<double> group_metrics; /**< Average throughput of each worker group. */
+
+		//Core frequency, from APERF and MPERF. All 0 if the counters could not be read.
+		std::vector<double> frequency_on_iter; /**< Mean effective core frequency of the workers in each iteration in GHz, or 0 if unknown. */
+		double average_frequency; /**< Mean effective core frequency over all iterations in GHz. */
+		double min_frequency; /**< Lowest effective core frequency of any iteration in GHz. */
+		double max_frequency; /**< Highest effective core frequency of any iteration in GHz. */
+		bool frequency_varied; /**< True if the frequency spread across iterations exceeded FREQUENCY_VARIATION_THRESHOLD. */
+		std::vector<double> cycles_on_iter; /**< For latency benchmarks, the latency of each iteration in core cycles per access, or 0 if unknown. */
+		double average_cycles; /**< For latency benchmarks, the mean latency in core cycles per access, excluding outliers, or 0 if unknown. */
+
+		//Per-thread fairness of the load threads
+		std::vector<double> worker_metrics; /**< Mean throughput of each load thread in MB/s, excluding outlier iterations. */
+		std::vector<double> fairness_on_iter; /**< Jain fairness index of the load thread throughputs in each iteration. */
+		double min_worker_metric; /**< Lowest mean load thread throughput in MB/s. */
+		double max_worker_metric; /**< Highest mean load thread throughput in MB/s. */
+		double worker_fairness; /**< Jain fairness index of the mean load thread throughputs. */
+
+		std::vector< std::vector<WorkerResult> > workers_on_iter; /**< Per-worker counters, for each iteration. */
+		double trace_period_sec; /**< Length of each interval of the bandwidth traces in seconds, or 0 if bandwidth was not traced. */
+		std::vector< std::vector<double> > trace_on_iter; /**< System-wide bandwidth over time in MB/s for each iteration, one value per trace period. */
+		std::vector<PowerResult> power; /**< One entry for each DRAM power reader that measured. */
+	};
+
+	/**
+	 * @brief Gets the name of an access pattern as used in result files.
+	 * @param pattern_mode The access pattern.
+	 * @returns "SEQUENTIAL", "RANDOM", or "UNKNOWN".
+	 */
+	std::string pattern_mode_name(pattern_mode_t pattern_mode);
+
+	/**
+	 * @brief Gets the name of a read/write mix as used in result files.
+	 * @param rw_mode The read/write mix.
+	 * @returns "READ", "WRITE", or "UNKNOWN".
+	 */
+	std::string rw_mode_name(rw_mode_t rw_mode);
+
+	/**
+	 * @brief Gets the name of a sharing mode as used in result files.
+	 * @param sharing_mode The sharing mode.
+	 * @returns "PRIVATE", "READ_SHARED", "ONE_WRITER", "FALSE_SHARING", or "UNKNOWN".
+	 */
+	std::string sharing_mode_name(sharing_mode_t sharing_mode);
+
+	/**
+	 * @brief Gets the width of a chunk size in bits.
+	 * @param chunk_size The chunk size.
+	 * @returns The width in bits, or 0 if the chunk size is invalid.
+	 */
+	uint32_t chunk_size_bits(chunk_size_t chunk_size);
+
+	/**
+	 * @brief Computes Jain's fairness index, (sum x)^2 / (n * sum x^2), of a set of throughputs. It is 1 when all are equal and falls towards 1/n as one of them takes everything.
+	 * @param values The throughputs.
+	 * @returns The index, or 0 if there are no values or all of them are 0.
+	 */
+	double jain_fairness_index(const std::vector<double>& values);
+};
+
+#endif
@@ -0,0 +1,72 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the BenchmarkRunner class.
+ */
+
+#ifndef __BENCHMARK_RUNNER_H
+#define __BENCHMARK_RUNNER_H
+
+//Headers
+#include <Runnable.h>
+#include <Benchmark.h>
+
+namespace xmem {
+	/**
+	 * @brief Multithreading-friendly wrapper that runs a Benchmark in its own Thread. This allows several benchmarks that do not interfere with each other to be measured at the same time.
+	 */
+	class BenchmarkRunner : public Runnable {
+		public:
+			/**
+			 * @brief Constructor.
+			 * @param benchmark The benchmark to run. It must outlive this object.
+			 */
+			BenchmarkRunner(Benchmark* benchmark);
+
+			/**
+			 * @brief Destructor.
+			 */
+			virtual ~BenchmarkRunner();
+
+			/**
+			 * @brief Thread-safe worker method. Runs the benchmark without printing its header and configuration to the console.
+			 */
+			virtual void run();
+
+			/**
+			 * @brief Indicates whether the benchmark ran successfully.
+			 * @returns True if the benchmark completed successfully.
+			 */
+			bool succeeded();
+
+		private:
+			// ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+			Benchmark* __benchmark; /**< The benchmark to run. */
+			bool __success; /**< True if the benchmark completed successfully. */
+	};
+};
+
+#endif
@@ -34,10 +34,12 @@
 #include <common.h>
 #include <optionparser.h>
 #include <MyArg.h>
+#include <BenchmarkPlan.h>
 
 //Libraries
 #include <cstdint>
 #include <string>
+#include <vector>
 
 namespace xmem {
 	/**
@@ -62,7 +64,44 @@ namespace xmem {
 		USE_LARGE_PAGES,
 		USE_READS,
 		USE_WRITES,
-		STRIDE_SIZE
+		STRIDE_SIZE,
+		NUMA_MATRIX,
+		AGGREGATE,
+		REMOTE_OFFSET,
+		PLACEMENT,
+		CPU_LIST,
+		LATENCY_CPU,
+		LOAD_CPU_NODE,
+		LOAD_MEM_NODE,
+		SHARING,
+		TARGET_CI,
+		MAX_ITERATIONS,
+		TIME_BUDGET,
+		REJECT_NOISY,
+		BENCHMARK_MODE,
+		DURATION,
+		BYTES_PER_PASS,
+		LATENCY_UNROLL,
+		POWER_PERIOD,
+		TRACE_PERIOD,
+		PLAN_FILE,
+		PREP_OVERLAP,
+		SEED,
+		PERM_DIR,
+		JSON_FILE,
+		COMPARE_FILE,
+		COMPARE_THRESHOLD,
+		DAEMON,
+		DAEMON_INTERVAL,
+		DAEMON_BUDGET,
+		PROM_FILE,
+		PROM_PORT,
+		ANTAGONIST,
+		ANTAGONIST_RATE,
+		ANTAGONIST_DURATION,
+		ANTAGONIST_CPU_NODE,
+		ANTAGONIST_MEM_NODE,
+		CHECK_KERNELS
 	};
 
 	/**
@@ -89,11 +128,52 @@ namespace xmem {
 		{ USE_READS, 0, "R", "reads", Arg::None, "    -R, --reads    \tUse memory reads in throughput benchmarks." },
 		{ USE_WRITES, 0, "W", "writes", Arg::None, "    -W, --writes    \tUse memory writes in throughput benchmarks." },
 		{ STRIDE_SIZE, 0, "S", "stride_size", MyArg::Integer, "    -S, --stride_size    \tA stride size to use for sequential throughput benchmarks, specified in powers-of-two multiples of the chunk size(s). Allowed values: 1, -1, 2, -2, 4, -4, 8, -8, 16, -16. Positive indicates the forward direction (increasing addresses), while negative indicates the reverse direction." },
+		{ NUMA_MATRIX, 0, "M", "numa_matrix", Arg::None, "    -M, --numa_matrix    \tNUMA matrix mode. For a single kernel, given by the first selected access pattern, read/write mode, chunk size and stride size, report an NxN table of unloaded latency and of throughput between every CPU NUMA node and every memory NUMA node, alongside the NUMA distances reported by the OS. The local cells on the diagonal are measured concurrently, since each stays within its own node. Remote cells are measured one at a time, because their traffic would share the interconnect and the remote memory controllers. This cannot be combined with --force_uma." },
+		{ AGGREGATE, 0, "A", "aggregate", Arg::None, "    -A, --aggregate    \tAggregate mode. Run a group of worker threads on every NUMA node at the same time, with synchronized start and stop, and report per-node and total system throughput. The number of worker threads applies to each group. This cannot be combined with --force_uma or --numa_matrix." },
+		{ REMOTE_OFFSET, 0, "", "remote_offset", MyArg::NonnegativeInteger, "    --remote_offset    \tIn aggregate mode, the worker group on CPU node c loads memory node (c + offset) mod N. The default of 0 keeps every group on its local node." },
+		{ PLACEMENT, 0, "", "placement", MyArg::Required, "    --placement    \tHow worker threads are placed on the logical CPUs of a NUMA node. Allowed values: compact (ascending CPU IDs, the default), scatter (one thread per physical core before using SMT siblings), and smt_pairs (fill both SMT siblings of a core before moving to the next). If there are more threads than CPUs in the node, the remaining threads spill over to the nearest other nodes." },
+		{ CPU_LIST, 0, "", "cpus", MyArg::Required, "    --cpus    \tExplicit list of logical CPUs for worker threads, e.g. 0,2,4-7. This overrides --placement, and benchmarks run only from the NUMA node of the first listed CPU. If the number of worker threads is not specified, one worker thread is used per listed CPU." },
+		{ LATENCY_CPU, 0, "", "latency_cpu", MyArg::NonnegativeInteger, "    --latency_cpu    \tLogical CPU for the latency measurement thread. Load threads in latency benchmarks are placed on the other CPUs. By default the latency thread takes the first CPU chosen by the placement policy." },
+		{ LOAD_CPU_NODE, 0, "", "load_cpu_node", MyArg::NonnegativeInteger, "    --load_cpu_node    \tNUMA node whose CPUs run the load threads of latency benchmarks. The latency thread stays on the CPU node being benchmarked. By default the load threads run on the same node as the latency thread. Cannot be combined with -C, -M, or -u." },
+		{ LOAD_MEM_NODE, 0, "", "load_mem_node", MyArg::NonnegativeInteger, "    --load_mem_node    \tNUMA node whose memory the load threads of latency benchmarks use. The latency thread keeps chasing pointers in the memory node being benchmarked. By default the load threads use the same node as the latency thread. Cannot be combined with -M or -u." },
+		{ SHARING, 0, "", "sharing", MyArg::Required, "    --sharing    \tHow the worker threads of sequential benchmarks share the working set. Allowed values: private (each thread has its own slice, the default), read_shared (all threads read one slice), one_writer (one thread writes a slice while the others read it), and false_sharing (all threads write the same cache lines, each to its own chunk within every line). In latency benchmarks this applies to the load threads. They read the latency thread's slice in read_shared mode, and share a slice of their own in the writing modes. Random-access benchmarks always use private slices." },
+		{ TARGET_CI, 0, "", "target_ci", MyArg::Required, "    --target_ci    \tAdaptive iteration mode. Keep running iterations of each benchmark until the half-width of the 95% confidence interval of its metric is within this percentage of the mean, e.g. 2 for +/-2%. The number of iterations given by -n is the minimum (at least 3). Iterations that are outliers by the median absolute deviation, such as warmup iterations, are excluded from the statistics." },
+		{ MAX_ITERATIONS, 0, "", "max_iterations", MyArg::PositiveInteger, "    --max_iterations    \tIn adaptive iteration mode, the maximum number of iterations of each benchmark. Default: 50." },
+		{ TIME_BUDGET, 0, "", "time_budget", MyArg::PositiveInteger, "    --time_budget    \tIn adaptive iteration mode, stop iterating a benchmark once this many seconds have elapsed, even if the confidence interval target was not met. By default there is no time budget." },
+		{ REJECT_NOISY, 0, "", "reject_noisy", Arg::None, "    --reject_noisy    \tExclude iterations disturbed by interrupts, softirqs, steal time, run queue delay or preemption of worker threads on the measurement CPUs from the reported statistics, like outliers. Without this option, such iterations are only flagged with a warning." },
+		{ BENCHMARK_MODE, 0, "", "mode", MyArg::Required, "    --mode    \tBenchmarking methodology: time (each iteration runs for a fixed duration and the metric is derived from the accesses completed) or size (each iteration performs a fixed number of passes over the working set, scaled by its size, and the metric is derived from the time taken). Default: time." },
+		{ DURATION, 0, "", "duration", MyArg::PositiveInteger, "    --duration    \tIn time-based mode, the number of seconds to run each benchmark iteration. Default: 4." },
+		{ BYTES_PER_PASS, 0, "", "bytes_per_pass", MyArg::PositiveInteger, "    --bytes_per_pass    \tIn time-based mode, the number of bytes each throughput kernel call reads or writes. Must be a nonzero multiple of 4096, the block size of the throughput kernels, that evenly divides the working set size per thread. Default: 4096." },
+		{ LATENCY_UNROLL, 0, "", "latency_unroll", MyArg::PositiveInteger, "    --latency_unroll    \tNumber of dependent loads unrolled in each call of the latency kernel. Allowed values: 128, 256, 512, and 1024. Default: 512." },
+		{ POWER_PERIOD, 0, "", "power_period", MyArg::PositiveInteger, "    --power_period    \tSampling period in seconds for power measurement. Default: 1." },
+		{ TRACE_PERIOD, 0, "", "trace_period", MyArg::NonnegativeInteger, "    --trace_period    \tSampling period in microseconds of bandwidth traces. In time-based throughput benchmarks, each load thread records its progress at this period into a preallocated ring buffer, and the samples are merged into the bandwidth of all threads over time. Samples are taken between blocks of passes, so a period shorter than one block is rounded up to it. Traces appear in --json results, and their range on the console. Default: 0, which means no tracing." },
+		{ PLAN_FILE, 0, "", "plan", MyArg::Required, "    --plan    \tRun the ordered list of benchmarks described in this plan file instead of every combination of the selected options. Each [throughput] or [latency] section is one benchmark, and a [defaults] section sets starting values for the sections after it. Settings are key = value lines: name, threads, working_set_kb, pattern, rw, chunk, stride, sharing, cpu_node, mem_node, placement, cpus, latency_cpu, load_cpu_node, load_mem_node, iterations, and workers, which adds a group of load threads with their own workload, e.g. workers = 4 pattern=random rw=read chunk=64 mem_node=1 rate=500. Settings not given default to the command line options. Cannot be combined with -M or -A." },
+		{ PREP_OVERLAP, 0, "", "prep_overlap", MyArg::Required, "    --prep_overlap    \tWith a plan file, whether to prepare the next benchmark's working set (first touch and pointer permutations) in the background while the current benchmark is measuring. off: never (default). isolated: only on a CPU outside the measured CPU and memory nodes, and only if the next working set is on a different memory node than the measured one; otherwise preparation waits. any: on any CPU not running a measured thread, which may perturb results." },
+		{ SEED, 0, "", "seed", MyArg::NonnegativeInteger, "    --seed    \tSeed for building random pointer permutations. Benchmarks that need the same permutation in the same memory reuse it instead of rebuilding it. Default: the current time." },
+		{ PERM_DIR, 0, "", "perm_dir", MyArg::Required, "    --perm_dir    \tDirectory in which to save random pointer permutations as index files, and from which to reload them. Later runs with the same --seed, chunk size, and working set size load them instead of rebuilding them." },
+		{ JSON_FILE, 0, "", "json", MyArg::Required, "    --json    \tStream results to this file as newline-delimited JSON. The first record describes the run and the host, and each following record holds one benchmark's configuration, every iteration's metric, warnings, per-worker counters and throughput, load thread fairness, and power traces." },
+		{ COMPARE_FILE, 0, "", "compare", MyArg::Required, "    --compare    \tCompare results against a baseline JSON results file written by --json in an earlier run. Benchmarks are matched by their parameters, including the CPUs they ran on, bytes per pass, and the latency kernel unroll length, and each difference is tested against the run-to-run variance with Welch's t-test on the per-iteration metrics. Significant regressions are listed, and X-Mem exits with status 2 if there are any. Use at least 2 iterations (-n) in both runs." },
+		{ COMPARE_THRESHOLD, 0, "", "compare_threshold", MyArg::Required, "    --compare_threshold    \tWith --compare, the smallest change in percent of the baseline mean that is reported as a regression or improvement, even if it is statistically significant. Default: 2." },
+		{ DAEMON, 0, "", "daemon", Arg::None, "    --daemon    \tMonitoring daemon mode. Run until interrupted, repeating a small set of probes on every memory NUMA node: a single-threaded latency chase and a single-threaded throughput test, using the working set size, chunk size, and read/write mode given by the other options. Results are exported as Prometheus metrics through --prom_file and/or --prom_port. Probes are paced so that they run for at most --daemon_budget of the time. Use a working set larger than the last-level cache to monitor DRAM. This cannot be combined with a plan file, NUMA matrix mode, aggregate mode, or --compare." },
+		{ DAEMON_INTERVAL, 0, "", "daemon_interval", MyArg::PositiveInteger, "    --daemon_interval    \tIn daemon mode, the minimum time in seconds between the starts of two rounds of probes. Default: 60." },
+		{ DAEMON_BUDGET, 0, "", "daemon_budget", MyArg::Required, "    --daemon_budget    \tIn daemon mode, the largest share of time in percent that probes may run. After each probe, X-Mem sleeps long enough to stay within this budget. Since each probe runs one thread, X-Mem uses at most this share of one CPU and of the bandwidth one thread can draw. Default: 2." },
+		{ PROM_FILE, 0, "", "prom_file", MyArg::Required, "    --prom_file    \tIn daemon mode, rewrite this file with the Prometheus text exposition of all probe metrics after every probe, e.g. for the node exporter's textfile collector. The file is replaced atomically." },
+		{ PROM_PORT, 0, "", "prom_port", MyArg::PositiveInteger, "    --prom_port    \tIn daemon mode, serve the Prometheus text exposition of all probe metrics over HTTP on this TCP port of the loopback interface. GNU/Linux only." },
+		{ ANTAGONIST, 0, "", "antagonist", Arg::None, "    --antagonist    \tAntagonist mode. Generate a steady background load with the worker threads, working set size, access pattern, chunk size, stride, and read/write mode given by the other options, while another workload is measured. The achieved bandwidth is printed every second, and a summary is printed when the load stops. The load stops after --antagonist_duration seconds, or on SIGINT or SIGTERM. This cannot be combined with a plan file, NUMA matrix mode, aggregate mode, daemon mode, or --compare." },
+		{ ANTAGONIST_RATE, 0, "", "antagonist_rate", MyArg::Required, "    --antagonist_rate    \tIn antagonist mode, the target bandwidth of the load, split evenly across the worker threads. Either a number of MB/s, or a percentage of the peak such as 50%. A percentage first runs the load unthrottled for a few seconds to measure the peak. Default: 0, which means unthrottled." },
+		{ ANTAGONIST_DURATION, 0, "", "antagonist_duration", MyArg::NonnegativeInteger, "    --antagonist_duration    \tIn antagonist mode, the number of seconds to generate load. Default: 0, which means until interrupted." },
+		{ ANTAGONIST_CPU_NODE, 0, "", "antagonist_cpu_node", MyArg::NonnegativeInteger, "    --antagonist_cpu_node    \tIn antagonist mode, the NUMA node whose CPUs run the worker threads, placed by the placement policy unless a CPU list is given. Default: 0." },
+		{ ANTAGONIST_MEM_NODE, 0, "", "antagonist_mem_node", MyArg::NonnegativeInteger, "    --antagonist_mem_node    \tIn antagonist mode, the NUMA node that the working set is allocated on. Default: 0." },
+		{ CHECK_KERNELS, 0, "", "check_kernels", Arg::None, "    --check_kernels    \tCheck the sequential and strided throughput kernels and the latency kernels instead of running benchmarks, then exit. Each kernel is disassembled with objdump, and its loads and stores are counted. Each throughput kernel must have exactly one access of its chunk size per word it touches in a 4096-byte block of addresses, and each latency kernel one 64-bit load per pointer in its unrolled block plus the store of the last pointer. Neither may have other memory instructions. The random throughput kernels are not implemented yet and are not checked. The exit status is 0 if every kernel passes. Use --verbose to list every kernel. GNU/Linux only, and needs objdump." },
 		{ UNKNOWN, 0, "", "", Arg::None, "\nIf a given option is not specified, X-Mem defaults will be used where appropriate.\n\nExamples:\n"
 		"    xmem --help\n"
 		"    xmem -h\n"
 		"    xmem -l --verbose -n5 --chunk_size=32 -s\n"
 		"    xmem -t --latency -w524288 -f results.csv -c32 -c256 -i 101 -u -j2\n"
+		"    xmem -t -l -M -w262144 -j4 -R -f matrix.csv\n"
+		"    xmem -t -l --daemon -w262144 --duration 1 --prom_port 9477\n"
+		"    xmem -t --antagonist -j4 -w262144 -s -R --antagonist_rate 50%\n"
+		"    xmem -t -j4 -w65536 -s -R --trace_period 1000 --json trace.json\n"
 		},
 		{ 0, 0, 0, 0, 0, 0 }
 	};
@@ -139,6 +219,37 @@ namespace xmem {
 		 * @param use_stride_n8 If true, include stride of -8 for relevant benchmarks.
 		 * @param use_stride_p16 If true, include stride of +16 for relevant benchmarks.
 		 * @param use_stride_n16 If true, include stride of -16 for relevant benchmarks.
+		 * @param numa_matrix If true, run in NUMA matrix mode instead of producing one result per benchmark configuration.
+		 * @param aggregate If true, run in aggregate mode with a worker group on every NUMA node at once.
+		 * @param remote_offset In aggregate mode, the group on CPU node c uses memory node (c + remote_offset) mod N.
+		 * @param placement Policy for placing worker threads on the logical CPUs of a NUMA node.
+		 * @param cpu_list Explicit logical CPUs for worker threads. If empty, the placement policy is used.
+		 * @param latency_cpu Logical CPU for the latency measurement thread, or -1 to choose it with the placement policy.
+		 * @param load_cpu_node NUMA node whose CPUs run the load threads of latency benchmarks, or -1 for the latency thread's node.
+		 * @param load_mem_node NUMA node whose memory the load threads of latency benchmarks use, or -1 for the latency thread's node.
+		 * @param sharing_mode How the worker threads of sequential benchmarks share the working set.
+		 * @param target_ci Target half-width of the 95% confidence interval relative to the mean, as a fraction. 0 disables adaptive iterations.
+		 * @param max_iterations Maximum iterations per benchmark in adaptive iteration mode.
+		 * @param time_budget Time budget per benchmark in seconds in adaptive iteration mode, or 0 for none.
+		 * @param reject_noisy If true, exclude iterations with interference on the measurement CPUs from the statistics.
+		 * @param plan_filename Name of the benchmark plan file, or empty to build benchmarks from the other options.
+		 * @param prep_overlap Policy for preparing the next plan benchmark while the current one is measuring.
+		 * @param perm_dir Directory for pointer permutation index files, or empty to not use them.
+		 * @param json_filename Name of the newline-delimited JSON results file, or empty to not write one.
+		 * @param compare_filename Name of the baseline JSON results file to compare against, or empty to not compare.
+		 * @param compare_threshold Smallest relative change that is reported as a regression or improvement, as a fraction.
+		 * @param daemon If true, run as a monitoring daemon.
+		 * @param daemon_interval Minimum time in seconds between the starts of two rounds of probes in daemon mode.
+		 * @param daemon_budget Largest share of time that probes may run in daemon mode, as a fraction.
+		 * @param prom_filename Name of the Prometheus textfile to write in daemon mode, or empty for none.
+		 * @param prom_port TCP port for the Prometheus HTTP endpoint in daemon mode, or 0 for none.
+		 * @param antagonist If true, generate background load instead of running benchmarks.
+		 * @param antagonist_rate Target bandwidth of the antagonist load in MB/s, or 0 for no limit.
+		 * @param antagonist_peak_fraction Target bandwidth of the antagonist load as a fraction of its measured peak, or 0 if not relative.
+		 * @param antagonist_duration Number of seconds to generate antagonist load, or 0 until interrupted.
+		 * @param antagonist_cpu_node NUMA node whose CPUs run the antagonist workers.
+		 * @param antagonist_mem_node NUMA node that holds the antagonist working set.
+		 * @param check_kernels If true, check the throughput and latency kernels instead of running benchmarks.
 		 */
 		Configurator(
 			bool runLatency,
@@ -169,7 +280,38 @@ namespace xmem {
 			bool use_stride_p8,
 			bool use_stride_n8,
 			bool use_stride_p16,
-			bool use_stride_n16
+			bool use_stride_n16,
+			bool numa_matrix,
+			bool aggregate,
+			uint32_t remote_offset,
+			placement_policy_t placement,
+			std::vector<uint32_t> cpu_list,
+			int32_t latency_cpu,
+			int32_t load_cpu_node,
+			int32_t load_mem_node,
+			sharing_mode_t sharing_mode,
+			double target_ci,
+			uint32_t max_iterations,
+			uint32_t time_budget,
+			bool reject_noisy,
+			std::string plan_filename,
+			prep_overlap_t prep_overlap,
+			std::string perm_dir,
+			std::string json_filename,
+			std::string compare_filename,
+			double compare_threshold,
+			bool daemon,
+			uint32_t daemon_interval,
+			double daemon_budget,
+			std::string prom_filename,
+			uint32_t prom_port,
+			bool antagonist,
+			double antagonist_rate,
+			double antagonist_peak_fraction,
+			uint32_t antagonist_duration,
+			uint32_t antagonist_cpu_node,
+			uint32_t antagonist_mem_node,
+			bool check_kernels
 		);
 
 		/**
@@ -360,6 +502,222 @@ namespace xmem {
 		 */
 		bool useStrideN16() const { return __use_stride_n16; }
 
+		/**
+		 * @brief Determines if X-Mem should run in NUMA matrix mode.
+		 * @returns True if a CPU node by memory node matrix of latency and throughput should be reported.
+		 */
+		bool numaMatrixMode() const { return __numa_matrix; }
+
+		/**
+		 * @brief Determines if X-Mem should run in aggregate mode.
+		 * @returns True if worker groups on all NUMA nodes should run concurrently.
+		 */
+		bool aggregateMode() const { return __aggregate; }
+
+		/**
+		 * @brief Gets the memory node offset used by worker groups in aggregate mode.
+		 * @returns The offset. 0 means each group loads its local node.
+		 */
+		uint32_t getRemoteOffset() const { return __remote_offset; }
+
+		/**
+		 * @brief Gets the policy for placing worker threads on logical CPUs.
+		 * @returns The placement policy.
+		 */
+		placement_policy_t getPlacementPolicy() const { return __placement; }
+
+		/**
+		 * @brief Gets the explicit list of logical CPUs for worker threads.
+		 * @returns The logical CPUs in worker order, or an empty list if the placement policy should be used.
+		 */
+		std::vector<uint32_t> getCPUList() const { return __cpu_list; }
+
+		/**
+		 * @brief Gets the logical CPU requested for the latency measurement thread.
+		 * @returns The logical CPU, or -1 if it should be chosen by the placement policy.
+		 */
+		int32_t getLatencyCPU() const { return __latency_cpu; }
+
+		/**
+		 * @brief Gets the NUMA node whose CPUs run the load threads of latency benchmarks.
+		 * @returns The NUMA node, or -1 if the load threads run on the latency thread's node.
+		 */
+		int32_t getLoadCPUNode() const { return __load_cpu_node; }
+
+		/**
+		 * @brief Gets the NUMA node whose memory the load threads of latency benchmarks use.
+		 * @returns The NUMA node, or -1 if the load threads use the latency thread's node.
+		 */
+		int32_t getLoadMemNode() const { return __load_mem_node; }
+
+		/**
+		 * @brief Gets how the worker threads of sequential benchmarks share the working set.
+		 * @returns The sharing mode.
+		 */
+		sharing_mode_t getSharingMode() const { return __sharing_mode; }
+
+		/**
+		 * @brief Gets the target relative half-width of the confidence interval in adaptive iteration mode.
+		 * @returns The target as a fraction of the mean, or 0 if adaptive iterations are disabled.
+		 */
+		double getTargetRelativeCI() const { return __target_ci; }
+
+		/**
+		 * @brief Gets the maximum number of iterations per benchmark in adaptive iteration mode.
+		 * @returns The maximum number of iterations.
+		 */
+		uint32_t getMaxIterations() const { return __max_iterations; }
+
+		/**
+		 * @brief Gets the time budget per benchmark in adaptive iteration mode.
+		 * @returns The time budget in seconds, or 0 if there is none.
+		 */
+		uint32_t getTimeBudget() const { return __time_budget; }
+
+		/**
+		 * @brief Determines whether iterations with interference on the measurement CPUs are excluded from the statistics.
+		 * @returns True if noisy iterations are rejected.
+		 */
+		bool rejectNoisyIterations() const { return __reject_noisy; }
+
+		/**
+		 * @brief Gets the name of the benchmark plan file.
+		 * @returns The plan filename, or an empty string if no plan file is used.
+		 */
+		std::string getPlanFilename() const { return __plan_filename; }
+
+		/**
+		 * @brief Determines whether benchmarks come from a plan file.
+		 * @returns True if a plan file was loaded.
+		 */
+		bool usePlanFile() const { return !__plan_filename.empty(); }
+
+		/**
+		 * @brief Gets the benchmarks loaded from the plan file.
+		 * @returns The plan. It is empty if usePlanFile() returns false.
+		 */
+		const BenchmarkPlan& getPlan() const { return __plan; }
+
+		/**
+		 * @brief Gets the policy for preparing the next plan benchmark while the current one is measuring.
+		 * @returns The preparation overlap policy.
+		 */
+		prep_overlap_t getPrepOverlap() const { return __prep_overlap; }
+
+		/**
+		 * @brief Gets the directory for pointer permutation index files.
+		 * @returns The directory, or an empty string if index files are not used.
+		 */
+		std::string getPermutationIndexDir() const { return __perm_dir; }
+
+		/**
+		 * @brief Gets the command line X-Mem was configured from.
+		 * @returns The program name and arguments separated by spaces, or an empty string if not configured from user input.
+		 */
+		std::string getCommandLine() const { return __command_line; }
+
+		/**
+		 * @brief Gets the name of the newline-delimited JSON results file.
+		 * @returns The filename, or an empty string if no JSON results file is written.
+		 */
+		std::string getJSONFilename() const { return __json_filename; }
+
+		/**
+		 * @brief Determines whether to stream results as newline-delimited JSON.
+		 * @returns True if a JSON results file should be written.
+		 */
+		bool useJSONFile() const { return !__json_filename.empty(); }
+
+		/**
+		 * @brief Gets the name of the baseline JSON results file to compare against.
+		 * @returns The filename, or an empty string if results are not compared.
+		 */
+		std::string getCompareFilename() const { return __compare_filename; }
+
+		/**
+		 * @brief Determines whether to compare results against a baseline.
+		 * @returns True if a baseline file was given.
+		 */
+		bool useCompareFile() const { return !__compare_filename.empty(); }
+
+		/**
+		 * @brief Gets the smallest relative change that is reported as a regression or improvement.
+		 * @returns The threshold as a fraction of the baseline mean.
+		 */
+		double getCompareThreshold() const { return __compare_threshold; }
+
+		/**
+		 * @brief Determines whether X-Mem runs as a monitoring daemon.
+		 * @returns True if daemon mode is enabled.
+		 */
+		bool daemonMode() const { return __daemon; }
+
+		/**
+		 * @brief Gets the minimum time between the starts of two rounds of probes in daemon mode.
+		 * @returns The interval in seconds.
+		 */
+		uint32_t getDaemonInterval() const { return __daemon_interval; }
+
+		/**
+		 * @brief Gets the largest share of time that probes may run in daemon mode.
+		 * @returns The budget as a fraction of wall clock time.
+		 */
+		double getDaemonBudget() const { return __daemon_budget; }
+
+		/**
+		 * @brief Gets the name of the Prometheus textfile written in daemon mode.
+		 * @returns The filename, or an empty string if no textfile is written.
+		 */
+		std::string getPrometheusFilename() const { return __prom_filename; }
+
+		/**
+		 * @brief Gets the TCP port of the Prometheus HTTP endpoint in daemon mode.
+		 * @returns The port, or 0 if there is no HTTP endpoint.
+		 */
+		uint32_t getPrometheusPort() const { return __prom_port; }
+
+		/**
+		 * @brief Determines whether X-Mem generates background load instead of running benchmarks.
+		 * @returns True if antagonist mode is enabled.
+		 */
+		bool antagonistMode() const { return __antagonist; }
+
+		/**
+		 * @brief Gets the target bandwidth of the antagonist load.
+		 * @returns The bandwidth in MB/s, or 0 if the load is unthrottled or given relative to the peak.
+		 */
+		double getAntagonistRate() const { return __antagonist_rate; }
+
+		/**
+		 * @brief Gets the target bandwidth of the antagonist load relative to its peak.
+		 * @returns The fraction of the measured peak, or 0 if the target is not relative.
+		 */
+		double getAntagonistPeakFraction() const { return __antagonist_peak_fraction; }
+
+		/**
+		 * @brief Gets how long to generate antagonist load.
+		 * @returns The duration in seconds, or 0 to run until interrupted.
+		 */
+		uint32_t getAntagonistDuration() const { return __antagonist_duration; }
+
+		/**
+		 * @brief Gets the NUMA node whose CPUs run the antagonist workers.
+		 * @returns The CPU NUMA node.
+		 */
+		uint32_t getAntagonistCPUNode() const { return __antagonist_cpu_node; }
+
+		/**
+		 * @brief Gets the NUMA node that holds the antagonist working set.
+		 * @returns The memory NUMA node.
+		 */
+		uint32_t getAntagonistMemNode() const { return __antagonist_mem_node; }
+
+		/**
+		 * @brief Determines whether X-Mem checks its throughput kernels instead of running benchmarks.
+		 * @returns True if the kernel self-check was requested.
+		 */
+		bool checkKernelsMode() const { return __check_kernels; }
+
 	private:
 		/**
 		 * @brief Inspects a command line option (switch) to see if it occurred more than once, and warns the user if this is the case. The program only uses the first occurrence of any switch.
@@ -399,6 +757,39 @@ namespace xmem {
 		bool __use_stride_n8; /**< If true, use a stride of -8 in relevant benchmarks. */
 		bool __use_stride_p16; /**< If true, use a stride of +16 in relevant benchmarks. */
 		bool __use_stride_n16; /**< If true, use a stride of -16 in relevant benchmarks. */
+		bool __numa_matrix; /**< If true, report CPU node by memory node matrices of latency and throughput for a single kernel. */
+		bool __aggregate; /**< If true, run worker groups on all NUMA nodes at once and report per-node and total throughput. */
+		uint32_t __remote_offset; /**< In aggregate mode, the worker group on CPU node c uses memory node (c + offset) mod N. */
+		placement_policy_t __placement; /**< Policy for placing worker threads on the logical CPUs of a NUMA node. */
+		std::vector<uint32_t> __cpu_list; /**< Explicit logical CPUs for worker threads. Empty if the placement policy should be used. */
+		int32_t __latency_cpu; /**< Logical CPU for the latency measurement thread, or -1 to choose it with the placement policy. */
+		int32_t __load_cpu_node; /**< NUMA node whose CPUs run the load threads of latency benchmarks, or -1 for the latency thread's node. */
+		int32_t __load_mem_node; /**< NUMA node whose memory the load threads of latency benchmarks use, or -1 for the latency thread's node. */
+		sharing_mode_t __sharing_mode; /**< How the worker threads of sequential benchmarks share the working set. */
+		double __target_ci; /**< Target half-width of the 95% confidence interval relative to the mean, as a fraction. 0 if adaptive iterations are disabled. */
+		uint32_t __max_iterations; /**< Maximum iterations per benchmark in adaptive iteration mode. */
+		uint32_t __time_budget; /**< Time budget per benchmark in seconds in adaptive iteration mode, or 0 for none. */
+		bool __reject_noisy; /**< If true, exclude iterations with interference on the measurement CPUs from the statistics. */
+		std::string __plan_filename; /**< Name of the benchmark plan file. If empty, no plan file is used. */
+		BenchmarkPlan __plan; /**< Benchmarks loaded from the plan file. */
+		std::string __command_line; /**< The command line X-Mem was configured from, or empty if it was not configured from user input. */
+		prep_overlap_t __prep_overlap; /**< Policy for preparing the next plan benchmark while the current one is measuring. */
+		std::string __perm_dir; /**< Directory for pointer permutation index files, or empty to not use them. */
+		std::string __json_filename; /**< Name of the newline-delimited JSON results file, or empty to not write one. */
+		std::string __compare_filename; /**< Name of the baseline JSON results file to compare against, or empty to not compare. */
+		double __compare_threshold; /**< Smallest relative change that is reported as a regression or improvement, as a fraction. */
+		bool __daemon; /**< If true, run as a monitoring daemon that exports Prometheus metrics. */
+		uint32_t __daemon_interval; /**< Minimum time in seconds between the starts of two rounds of probes in daemon mode. */
+		double __daemon_budget; /**< Largest share of time that probes may run in daemon mode, as a fraction. */
+		std::string __prom_filename; /**< Name of the Prometheus textfile to write in daemon mode, or empty for none. */
+		uint32_t __prom_port; /**< TCP port for the Prometheus HTTP endpoint in daemon mode, or 0 for none. */
+		bool __antagonist; /**< If true, generate background load instead of running benchmarks. */
+		double __antagonist_rate; /**< Target bandwidth of the antagonist load in MB/s, or 0 for no limit. */
+		double __antagonist_peak_fraction; /**< Target bandwidth of the antagonist load as a fraction of its measured peak, or 0 if not relative. */
+		uint32_t __antagonist_duration; /**< Number of seconds to generate antagonist load, or 0 until interrupted. */
+		uint32_t __antagonist_cpu_node; /**< NUMA node whose CPUs run the antagonist workers. */
+		uint32_t __antagonist_mem_node; /**< NUMA node that holds the antagonist working set. */
+		bool __check_kernels; /**< If true, check the throughput and latency kernels instead of running benchmarks. */
 	};
 };
 
@@ -0,0 +1,99 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the FrequencyCounter class, which reads the APERF and MPERF counters of a core.
+ */
+
+#ifndef __FREQUENCY_COUNTER_H
+#define __FREQUENCY_COUNTER_H
+
+//Libraries
+#include <cstdint>
+
+namespace xmem {
+	/**
+	 * @brief Reads the APERF and MPERF counters of the logical CPU a worker runs on. MPERF counts at the constant TSC rate and APERF at the actual core clock, both only while the core is active, so the ratio of their changes over an interval is the average core frequency relative to the TSC frequency.
+	 *
+	 * On GNU/Linux the counters are read through /dev/cpu/N/msr if it can be opened, which usually needs root and the msr module, and otherwise through the perf msr PMU, which counts for the calling thread only. Other platforms are not supported.
+	 */
+	class FrequencyCounter {
+		public:
+			/**
+			 * @brief Constructor. The counter starts closed.
+			 */
+			FrequencyCounter();
+
+			/**
+			 * @brief Destructor. Closes the counter.
+			 */
+			~FrequencyCounter();
+
+			/**
+			 * @brief Opens the counters of a logical CPU. Call this from the thread to be measured, after it is locked to that CPU.
+			 * @param cpu The logical CPU.
+			 * @returns True if the counters can be read.
+			 */
+			bool open(int32_t cpu);
+
+			/**
+			 * @brief Closes the counters. Safe to call more than once.
+			 */
+			void close();
+
+			/**
+			 * @brief Reads both counters.
+			 * @param aperf Receives the APERF count.
+			 * @param mperf Receives the MPERF count.
+			 * @returns True on success.
+			 */
+			bool read(uint64_t& aperf, uint64_t& mperf);
+
+		private:
+			int32_t __msr_fd; /**< File descriptor of the CPU's msr device, or -1. */
+			int32_t __aperf_fd; /**< File descriptor of the perf APERF event, or -1. */
+			int32_t __mperf_fd; /**< File descriptor of the perf MPERF event, or -1. */
+	};
+
+	/**
+	 * @brief Computes the ratio of core clock to TSC rate from two readings of a FrequencyCounter.
+	 * @param aperf_start APERF at the start of the interval.
+	 * @param mperf_start MPERF at the start of the interval.
+	 * @param aperf_stop APERF at the end of the interval.
+	 * @param mperf_stop MPERF at the end of the interval.
+	 * @returns The ratio, or 0 if MPERF did not advance.
+	 */
+	double frequency_ratio(uint64_t aperf_start, uint64_t mperf_start, uint64_t aperf_stop, uint64_t mperf_stop);
+
+	/**
+	 * @brief Converts a ratio of core clock to TSC rate into a frequency.
+	 * @param ratio The ratio, as from frequency_ratio().
+	 * @param ns_per_tick Nanoseconds per timer tick. When the TSC timer is in use, its inverse is the TSC frequency in GHz.
+	 * @returns The effective core frequency in GHz, or 0 if the ratio is unknown or the timer is not the TSC.
+	 */
+	double effective_frequency_ghz(double ratio, double ns_per_tick);
+};
+
+#endif
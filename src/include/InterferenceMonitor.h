@@ -0,0 +1,77 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for snapshots of interrupt, scheduler, and hypervisor activity on the CPUs that run measurements.
+ */
+
+#ifndef __INTERFERENCE_MONITOR_H
+#define __INTERFERENCE_MONITOR_H
+
+//Headers
+#include <BenchmarkResult.h>
+
+//Libraries
+#include <cstdint>
+#include <vector>
+#include <chrono>
+
+namespace xmem {
+	/**
+	 * @brief Cumulative activity counters of a set of logical CPUs at one point in time, summed over the CPUs.
+	 */
+	struct InterferenceSnapshot {
+		bool valid; /**< True if the snapshot was taken. */
+		std::chrono::steady_clock::time_point time; /**< When the snapshot was taken. */
+		uint32_t num_cpus; /**< Number of CPUs in the snapshot. */
+		uint64_t interrupts; /**< Interrupts handled, from /proc/interrupts. */
+		uint64_t irq_ticks; /**< Time spent servicing hardware interrupts in USER_HZ ticks, from /proc/stat. */
+		uint64_t softirq_ticks; /**< Time spent servicing softirqs in USER_HZ ticks, from /proc/stat. */
+		uint64_t steal_ticks; /**< Time stolen by the hypervisor in USER_HZ ticks, from /proc/stat. */
+		bool has_run_delay; /**< True if /proc/schedstat was available. */
+		uint64_t run_delay_ns; /**< Time that tasks spent waiting on the CPUs' run queues in ns, from /proc/schedstat. */
+	};
+
+	/**
+	 * @brief Takes a snapshot of the activity of a set of CPUs. GNU/Linux only.
+	 * @param cpus The logical CPUs. Negative entries are ignored.
+	 * @param snapshot Receives the snapshot.
+	 * @returns True on success, or false if the counters are unavailable on this platform.
+	 */
+	bool capture_interference(const std::vector<int32_t>& cpus, InterferenceSnapshot& snapshot);
+
+	/**
+	 * @brief Computes the activity between two snapshots of the same CPUs and judges whether it was significant. Each CPU is judged on its average: the iteration is noisy if the time spent on interrupts, softirqs, steal, or waiting tasks exceeds INTERFERENCE_THRESHOLD of the elapsed time, or if the workers were preempted more than INTERFERENCE_MAX_PREEMPTIONS_PER_SEC times per second on average.
+	 * @param before Snapshot taken before the workers started.
+	 * @param after Snapshot taken after the workers joined.
+	 * @param involuntary_switches Involuntary context switches of the workers during their timed sections.
+	 * @param num_workers Number of workers.
+	 * @param result Receives the activity.
+	 * @returns True if both snapshots were valid.
+	 */
+	bool interference_between(const InterferenceSnapshot& before, const InterferenceSnapshot& after, uint64_t involuntary_switches, uint32_t num_workers, InterferenceResult& result);
+};
+
+#endif
@@ -0,0 +1,147 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the JsonValue class.
+ */
+
+#ifndef __JSON_VALUE_H
+#define __JSON_VALUE_H
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace xmem {
+	/**
+	 * @brief A parsed JSON value. This is a small reader for X-Mem's own result files, not a general-purpose JSON library.
+	 */
+	class JsonValue {
+		public:
+			/**
+			 * @brief Kinds of JSON values.
+			 */
+			typedef enum {
+				JSON_NULL,
+				JSON_BOOL,
+				JSON_NUMBER,
+				JSON_STRING,
+				JSON_ARRAY,
+				JSON_OBJECT
+			} json_type_t;
+
+			/**
+			 * @brief Constructor. The value is null.
+			 */
+			JsonValue();
+
+			/**
+			 * @brief Parses a JSON document.
+			 * @param text The document.
+			 * @param value Filled with the parsed value on success.
+			 * @param error Set to a description of the problem on failure.
+			 * @returns True on success.
+			 */
+			static bool parse(const std::string& text, JsonValue& value, std::string& error);
+
+			/**
+			 * @brief Gets the kind of this value.
+			 * @returns The kind.
+			 */
+			json_type_t getType() const { return __type; }
+
+			/**
+			 * @brief Gets a member of an object.
+			 * @param key Name of the member.
+			 * @returns The member, or NULL if this is not an object or has no such member.
+			 */
+			const JsonValue* get(const std::string& key) const;
+
+			/**
+			 * @brief Gets the number of elements of an array.
+			 * @returns The number of elements, or 0 if this is not an array.
+			 */
+			size_t size() const;
+
+			/**
+			 * @brief Gets an element of an array.
+			 * @param i Index of the element. Must be less than size().
+			 * @returns The element.
+			 */
+			const JsonValue& at(size_t i) const;
+
+			/**
+			 * @brief Gets this value as a number.
+			 * @param fallback Returned if this is not a number.
+			 * @returns The number.
+			 */
+			double asNumber(double fallback = 0) const;
+
+			/**
+			 * @brief Gets this value as a boolean.
+			 * @param fallback Returned if this is not a boolean.
+			 * @returns The boolean.
+			 */
+			bool asBool(bool fallback = false) const;
+
+			/**
+			 * @brief Gets this value as a string.
+			 * @param fallback Returned if this is not a string.
+			 * @returns The string.
+			 */
+			std::string asString(const std::string& fallback = "") const;
+
+		private:
+			/**
+			 * @brief Parses a value starting at pos, and advances pos past it.
+			 * @param text The document.
+			 * @param pos Current position in the document.
+			 * @param value Filled with the parsed value.
+			 * @param depth Nesting depth, to bound recursion on malformed input.
+			 * @returns True on success.
+			 */
+			static bool __parseValue(const std::string& text, size_t& pos, JsonValue& value, uint32_t depth);
+
+			/**
+			 * @brief Parses a string literal starting at pos, and advances pos past it.
+			 * @param text The document.
+			 * @param pos Position of the opening quote.
+			 * @param s Filled with the unescaped string.
+			 * @returns True on success.
+			 */
+			static bool __parseString(const std::string& text, size_t& pos, std::string& s);
+
+			json_type_t __type; /**< Kind of this value. */
+			bool __bool; /**< Value if this is a boolean. */
+			double __number; /**< Value if this is a number. */
+			std::string __string; /**< Value if this is a string. */
+			std::vector<JsonValue> __array; /**< Elements if this is an array. */
+			std::vector< std::pair<std::string, JsonValue> > __object; /**< Members if this is an object, in document order. */
+	};
+};
+
+#endif
@@ -53,12 +53,11 @@ namespace xmem {
 			void* mem_array,
 			size_t len,
 			uint32_t iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			uint64_t passes_per_iteration,
-#endif
 			uint32_t num_worker_threads,
 			uint32_t mem_node,
 			uint32_t cpu_node,
+			std::vector<int32_t> cpu_ids,
 			pattern_mode_t pattern_mode,
 			rw_mode_t rw_mode,
 			chunk_size_t chunk_size,
@@ -84,6 +83,34 @@ namespace xmem {
 		 * @returns The average throughput in MB/sec.
 		 */
 		double getAvgLoadMetric() const;		
+
+		/**
+		 * @brief Get the overall average latency in core cycles per access, using the effective frequency of the latency measurement thread's core in each iteration.
+		 * @returns The average latency in cycles per access, or 0 if the core frequency could not be measured.
+		 */
+		double getAvgCyclesMetric() const;
+
+		/**
+		 * @brief Places the load threads on different NUMA nodes than the latency measurement thread. By default they share its nodes and working set. Must be called before the benchmark is prepared.
+		 * @param load_cpu_node The NUMA node whose CPUs the load threads were given.
+		 * @param load_mem_node The NUMA node of the load threads' working set.
+		 * @param load_mem_array The load threads' working set, of the same length as the benchmark's. Load thread t uses slice t of it. This may be the benchmark's own working set.
+		 */
+		void setLoadNodes(uint32_t load_cpu_node, uint32_t load_mem_node, void* load_mem_array);
+
+		/**
+		 * @brief Gets the NUMA node whose CPUs the load threads run on.
+		 * @returns The load CPU NUMA node.
+		 */
+		uint32_t getLoadCPUNode() const;
+
+		/**
+		 * @brief Gets the NUMA node of the load threads' working set.
+		 * @returns The load memory NUMA node.
+		 */
+		uint32_t getLoadMemNode() const;
+
+		virtual void getResult(BenchmarkResult& result) const;
 		
 		/**
 		 * @brief Reports benchmark configuration details to the console.
@@ -98,9 +125,20 @@ namespace xmem {
 	protected:
 		virtual bool _run_core();
 
+		/**
+		 * @brief Builds the pointer permutations for random-access worker threads.
+		 * @returns True on success.
+		 */
+		virtual bool _prepare_core();
+
 	private:
 		std::vector<double> __loadMetricOnIter; /**< Load metrics for each iteration of the benchmark. This is in MB/s. */
 		double __averageLoadMetric; /**< The average load throughput in MB/sec that was imposed on the latency measurement. */	
+		std::vector<double> __cyclesOnIter; /**< Latency of each iteration in core cycles per access, or 0 if the core frequency is unknown. */
+		double __averageCycles; /**< Mean latency in core cycles per access over the non-outlier iterations where it is known, or 0. */
+		uint32_t __load_cpu_node; /**< NUMA node whose CPUs the load threads run on. */
+		uint32_t __load_mem_node; /**< NUMA node of the load threads' working set. */
+		void* __load_mem_array; /**< The load threads' working set. This is the benchmark's own working set unless the load threads use another memory node. */
 	};
 };
 
@@ -33,6 +33,11 @@
 //Headers
 #include <MemoryWorker.h>
 #include <benchmark_kernels.h>
+#include <BandwidthTrace.h>
+
+//Libraries
+#include <cstdint>
+#include <atomic>
 
 namespace xmem {
 	/** 
@@ -52,9 +57,7 @@ namespace xmem {
 			LoadWorker(
 				void* mem_array,
 				size_t len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 				uint64_t passes_per_iteration,
-#endif
 				SequentialFunction kernel_fptr,
 				SequentialFunction kernel_dummy_fptr,
 				int32_t cpu_affinity
@@ -71,9 +74,7 @@ namespace xmem {
 			LoadWorker(
 				void* mem_array,
 				size_t len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 				uint64_t passes_per_iteration,
-#endif
 				RandomFunction kernel_fptr,
 				RandomFunction kernel_dummy_fptr,
 				int32_t cpu_affinity
@@ -88,6 +89,36 @@ namespace xmem {
 			 * @brief Thread-safe worker method.
 			 */
 			virtual void run();
+
+			/**
+			 * @brief Makes the worker generate load until its group is asked to stop, instead of measuring over a fixed window. The dummy kernel is then not run, so adjusted ticks equal elapsed ticks. Requires setGroupSync(). Must be called before the worker runs.
+			 */
+			void setFreeRunning();
+
+			/**
+			 * @brief Limits the rate at which this worker accesses memory. The worker sleeps between blocks of passes, outside its timed sections, to stay at the target rate. May be called while the worker runs, and takes effect within one block of passes. While throttled, a fixed measurement window is counted in wall clock time rather than in time spent in the kernel, and so are the elapsed ticks, so that the worker's throughput is the rate it achieved.
+			 * @param bytes_per_sec Target rate in bytes per second, or 0 for no limit.
+			 */
+			void setThrottle(uint64_t bytes_per_sec);
+
+			/**
+			 * @brief Gets the number of passes completed so far. Unlike getPasses(), this may be called while the worker runs.
+			 * @returns The number of passes, updated after every block of passes.
+			 */
+			uint64_t getLivePasses() const;
+
+			/**
+			 * @brief Makes the worker sample its progress into a bandwidth trace during time-based measurement. The trace is allocated here, so the worker does not allocate while it measures. Must be called before the worker runs.
+			 * @param period_ticks Minimum number of timer ticks between samples. Samples are taken between blocks of passes, so they are never closer together than one block.
+			 * @param capacity Number of samples to keep.
+			 */
+			void enableTrace(uint64_t period_ticks, size_t capacity);
+
+			/**
+			 * @brief Gets the bandwidth trace. Only call this after the worker has run.
+			 * @returns The trace, or NULL if tracing was not enabled.
+			 */
+			const BandwidthTrace* getTrace() const;
 		
 		private:
 			// ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
@@ -96,6 +127,12 @@ namespace xmem {
 			SequentialFunction __kernel_dummy_fptr_seq; /**< Points to a dummy version of the memory test core routine to use of the "sequential" type. */
 			RandomFunction __kernel_fptr_ran; /**< Points to the memory test core routine to use of the "random" type. */
 			RandomFunction __kernel_dummy_fptr_ran; /**< Points to a dummy version of the memory test core routine to use of the "random" type. */
+			bool __free_running; /**< If true, generate load until the group is asked to stop. */
+			BandwidthTrace* __trace; /**< Trace of this worker's progress over time, or NULL if it is not traced. Written only by the worker thread. */
+
+			//These are accessed without the lock while the worker runs
+			std::atomic<uint64_t> __throttle_bytes_per_sec; /**< Target rate in bytes per second, or 0 for no limit. */
+			std::atomic<uint64_t> __live_passes; /**< Passes completed so far. */
 	};
 };
 
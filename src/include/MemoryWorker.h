@@ -35,8 +35,45 @@
 
 //Libraries
 #include <cstdint>
+#include <atomic>
+#include <string>
+#include <vector>
 
 namespace xmem {
+	/**
+	 * @brief Start/stop gate shared by a group of workers that must all measure over the same window of time.
+	 */
+	class WorkerGroupSync {
+		public:
+			/**
+			 * @brief Constructor.
+			 * @param num_workers Number of workers that must arrive before any of them may begin its timed section.
+			 */
+			WorkerGroupSync(uint32_t num_workers);
+
+			/**
+			 * @brief Blocks the calling worker until every worker in the group has arrived. This spins rather than sleeps so that all workers are released as close together as possible.
+			 */
+			void arriveAndWait();
+
+			/**
+			 * @brief Asks every worker in the group to end its timed section. This also opens the start gate, so that if some workers never start, the ones waiting there are released and exit without a timed section.
+			 */
+			void requestStop();
+
+			/**
+			 * @brief Indicates whether a worker in the group has asked the others to stop.
+			 * @returns True if timed sections should end.
+			 */
+			bool stopRequested() const;
+
+		private:
+			uint32_t __num_workers; /**< Number of workers in the group. */
+			std::atomic<uint32_t> __num_arrived; /**< Number of workers that have reached the start gate. */
+			std::atomic<bool> __go; /**< Set once all workers have reached the start gate. */
+			std::atomic<bool> __stop; /**< Set by the first worker to finish its timed section. */
+	};
+
 	/** 
 	 * @brief Multithreading-friendly class to run memory access kernels.
 	 */
@@ -53,9 +90,7 @@ namespace xmem {
 			MemoryWorker(
 				void* mem_array,
 				size_t len,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 				uint64_t passes_per_iteration,
-#endif
 				int32_t cpu_affinity
 			);
 			
@@ -105,12 +140,42 @@ namespace xmem {
 			 */
 			uint64_t getAdjustedTicks();
 
+			/**
+			 * @brief Gets the logical CPU this worker's thread is locked to.
+			 * @returns The logical CPU, or a negative value if the worker is not pinned.
+			 */
+			int32_t getCPUAffinity();
+
 			/**
 			 * @brief Indicates whether worker's results may be questionable/inaccurate/invalid.
 			 * @returns True if the worker's results had a warning.
 			 */
 			bool hadWarning();
 
+			/**
+			 * @brief Gets the problems this worker ran into, such as failing to lock its thread to its CPU. Workers do not print these themselves, so that the benchmark can report them wherever its caller wants.
+			 * @returns The warning messages, without a "WARNING:" prefix.
+			 */
+			std::vector<std::string> getWarningMessages();
+
+			/**
+			 * @brief Gets the average core clock of this worker's CPU during its timed section, relative to the TSC rate, as measured by APERF and MPERF.
+			 * @returns The ratio, or 0 if the counters could not be read.
+			 */
+			double getFrequencyRatio();
+
+			/**
+			 * @brief Gets how often this worker's thread was preempted during its timed section.
+			 * @returns The number of involuntary context switches.
+			 */
+			uint64_t getInvoluntarySwitches();
+
+			/**
+			 * @brief Makes this worker start and stop its timed section together with other workers. Must be called before the worker runs.
+			 * @param group_sync Gate shared by all workers in the group, or NULL to run independently. It must outlive the worker's run.
+			 */
+			void setGroupSync(WorkerGroupSync* group_sync);
+
 		protected:
 			// ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
 			void* _mem_array; /**< The memory region for this worker. */
@@ -122,10 +187,12 @@ namespace xmem {
 			uint64_t _elapsed_dummy_ticks; /**< Total elapsed ticks on the dummy kernel routine. */
 			uint64_t _adjusted_ticks; /**< Elapsed ticks minus dummy elapsed ticks. */
 			bool _warning; /**< If true, results may be suspect. */
+			std::vector<std::string> _warning_messages; /**< Problems the worker ran into, for the benchmark to report. */
+			double _frequency_ratio; /**< APERF/MPERF ratio over the timed section, or 0 if unknown. */
+			uint64_t _involuntary_switches; /**< Involuntary context switches during the timed section. */
 			bool _completed; /**< If true, worker completed. */
-#ifdef USE_SIZE_BASED_BENCHMARKS
+			WorkerGroupSync* _group_sync; /**< If not NULL, gate used to align this worker's timed section with other workers. */
 			uint64_t _passes_per_iteration; /**< Number of passes per iteration. */
-#endif
 	};
 };
 
@@ -0,0 +1,94 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the MetricsServer class.
+ */
+
+#ifndef __METRICS_SERVER_H
+#define __METRICS_SERVER_H
+
+//Headers
+#include <Runnable.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+
+namespace xmem {
+	/**
+	 * @brief Minimal HTTP server that serves a Prometheus text exposition on the loopback interface. It runs in its own Thread until stop() is called, answering one request at a time.
+	 */
+	class MetricsServer : public Runnable {
+		public:
+			/**
+			 * @brief Constructor. Nothing is served until listen() and run() are called.
+			 * @param port TCP port to serve on.
+			 */
+			MetricsServer(uint16_t port);
+
+			/**
+			 * @brief Destructor. Closes the listening socket.
+			 */
+			virtual ~MetricsServer();
+
+			/**
+			 * @brief Opens the listening socket. Call this before starting the server thread, so that problems such as a port in use are reported right away.
+			 * @returns True on success. On failure, an error is printed.
+			 */
+			bool listen();
+
+			/**
+			 * @brief Thread-safe worker method. Serves requests until stop() is called.
+			 */
+			virtual void run();
+
+			/**
+			 * @brief Replaces the text served to later requests.
+			 * @param text Prometheus text exposition.
+			 */
+			void setMetrics(const std::string& text);
+
+			/**
+			 * @brief Asks the server to stop. run() returns within about half a second.
+			 */
+			void stop();
+
+		private:
+			/**
+			 * @brief Reads one request from a client and answers it.
+			 * @param client Connected client socket.
+			 */
+			void __serveClient(int client);
+
+			// ONLY ACCESS OBJECT VARIABLES UNDER THE RUNNABLE OBJECT LOCK!!!!
+			uint16_t __port; /**< TCP port to serve on. */
+			int __socket; /**< Listening socket, or -1 if it is not open. */
+			std::string __metrics; /**< Text served at /metrics. */
+			bool __stop; /**< If true, run() should return. */
+	};
+};
+
+#endif
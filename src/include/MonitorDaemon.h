@@ -0,0 +1,130 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the MonitorDaemon class.
+ */
+
+#ifndef __MONITOR_DAEMON_H
+#define __MONITOR_DAEMON_H
+
+//Headers
+#include <common.h>
+#include <Configurator.h>
+#include <BenchmarkPlan.h>
+#include <MetricsServer.h>
+#include <Thread.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <time.h>
+
+namespace xmem {
+	/**
+	 * @brief One probe run repeatedly by the monitoring daemon, and what it last measured.
+	 */
+	struct MonitorProbe {
+		BenchmarkSpec spec; /**< The benchmark to run. */
+		double value; /**< Last successfully measured metric, in Prometheus base units (seconds or bytes per second). */
+		bool has_value; /**< True once the probe has succeeded at least once. */
+		bool up; /**< True if the last run succeeded. */
+		bool warning; /**< True if the last successful run's results are questionable. */
+		double duration_sec; /**< Wall clock duration of the last run in seconds. */
+		time_t last_run; /**< Wall clock time when the last run finished. */
+		uint64_t runs; /**< Number of runs so far. */
+		uint64_t failures; /**< Number of failed runs so far. */
+	};
+
+	/**
+	 * @brief Long-running monitoring mode. Repeats a small set of single-threaded latency and throughput probes on every memory NUMA node, paced so that they stay within a share of wall clock time, and exports the results as Prometheus metrics.
+	 */
+	class MonitorDaemon {
+		public:
+			/**
+			 * @brief Constructor.
+			 * @param config The configuration object containing run-time options for this X-Mem execution instance.
+			 */
+			MonitorDaemon(Configurator& config);
+
+			/**
+			 * @brief Destructor.
+			 */
+			~MonitorDaemon();
+
+			/**
+			 * @brief Runs probes until the process receives SIGINT or SIGTERM.
+			 * @returns True if the daemon stopped because it was asked to, false if it could not start.
+			 */
+			bool run();
+
+		private:
+			/**
+			 * @brief Builds the list of probes from the configuration.
+			 * @returns True on success. On failure, an error is printed.
+			 */
+			bool __setupProbes();
+
+			/**
+			 * @brief Runs one probe and records what it measured.
+			 * @param probe The probe.
+			 */
+			void __runProbe(MonitorProbe& probe);
+
+			/**
+			 * @brief Formats all probe results in the Prometheus text exposition format.
+			 * @returns The text.
+			 */
+			std::string __formatMetrics() const;
+
+			/**
+			 * @brief Publishes the current metrics to the textfile and the HTTP endpoint, whichever are enabled.
+			 */
+			void __publish();
+
+			/**
+			 * @brief Sleeps until a given time, or until the daemon is asked to stop.
+			 * @param seconds Time to wait, in seconds since the daemon started.
+			 * @returns False if the daemon was asked to stop.
+			 */
+			bool __waitUntil(double seconds) const;
+
+			/**
+			 * @brief Gets the time since the daemon started.
+			 * @returns Elapsed wall clock time in seconds.
+			 */
+			double __elapsed() const;
+
+			Configurator __config; /**< The configuration object containing run-time options for this X-Mem execution instance. */
+			std::vector<MonitorProbe> __probes; /**< The probes, in the order they are run in each round. */
+			MetricsServer* __server; /**< HTTP endpoint, or NULL if there is none. */
+			Thread* __server_thread; /**< Thread running the HTTP endpoint, or NULL. */
+			double __busy_sec; /**< Total wall clock time spent running probes, in seconds. */
+			uint64_t __start_ns; /**< Monotonic clock reading when run() was called, in nanoseconds. */
+	};
+};
+
+#endif
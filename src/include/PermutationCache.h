@@ -0,0 +1,167 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the PermutationCache class.
+ */
+
+#ifndef __PERMUTATION_CACHE_H
+#define __PERMUTATION_CACHE_H
+
+//Headers
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <mutex>
+
+namespace xmem {
+	/**
+	 * @brief Remembers which pointer permutation currently sits in each slice of the working sets, so benchmarks that need the same layout in the same place do not rebuild it.
+	 * Optionally, permutations are also saved as index files, so later runs with the same seed can reload them instead of shuffling again.
+	 * All methods are thread-safe, as a benchmark may be prepared in the background while another one runs.
+	 */
+	class PermutationCache {
+		public:
+			/**
+			 * @brief Constructor. The cache starts empty, without an index file directory.
+			 */
+			PermutationCache();
+
+			/**
+			 * @brief Sets the directory for permutation index files.
+			 * @param dir The directory. If empty, index files are not used.
+			 */
+			void setIndexDirectory(const std::string& dir);
+
+			/**
+			 * @brief Writes to a memory region so its pages are resident in physical memory and are not shared, unless that was already done since it was allocated.
+			 * @param start_address Start of the region.
+			 * @param end_address End of the region, exclusive.
+			 */
+			void touch(void* start_address, void* end_address);
+
+			/**
+			 * @brief Makes sure a memory region holds the random pointer permutation for the given chunk size and seed. It is reused if already there, loaded from an index file if one exists, or built otherwise.
+			 * @param start_address Start of the region.
+			 * @param end_address End of the region, exclusive.
+			 * @param chunk_size Size of each pointer chunk.
+			 * @param seed Seed of the random number generator used to shuffle.
+			 * @param info_log Stream for progress details, or NULL to not report them.
+			 * @param warning_log Stream for warnings and errors, or NULL to discard them.
+			 * @returns True on success.
+			 */
+			bool preparePermutation(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed, std::ostream* info_log, std::ostream* warning_log);
+
+			/**
+			 * @brief Forgets any permutation overlapping a memory region, as its contents are about to be overwritten.
+			 * @param start_address Start of the region.
+			 * @param end_address End of the region, exclusive.
+			 */
+			void invalidate(void* start_address, void* end_address);
+
+			/**
+			 * @brief Forgets everything about a memory region, as it is about to be freed.
+			 * @param start_address Start of the region.
+			 * @param end_address End of the region, exclusive.
+			 */
+			void release(void* start_address, void* end_address);
+
+			/**
+			 * @brief Gets the number of permutations that were reused from memory.
+			 * @returns The number of reuses.
+			 */
+			uint64_t getNumReused() const { return __num_reused; }
+
+			/**
+			 * @brief Gets the number of permutations that were loaded from index files.
+			 * @returns The number of loads.
+			 */
+			uint64_t getNumLoaded() const { return __num_loaded; }
+
+			/**
+			 * @brief Gets the number of permutations that had to be built.
+			 * @returns The number of builds.
+			 */
+			uint64_t getNumBuilt() const { return __num_built; }
+
+		private:
+			/**
+			 * @brief A permutation that currently sits in memory.
+			 */
+			struct Layout {
+				uintptr_t start; /**< Start address of the region. */
+				uintptr_t end; /**< End address of the region, exclusive. */
+				chunk_size_t chunk_size; /**< Size of each pointer chunk. */
+				uint64_t seed; /**< Seed used to shuffle. */
+			};
+
+			/**
+			 * @brief Gets the index file name for a permutation.
+			 * @param chunk_size Size of each pointer chunk.
+			 * @param num_pointers Number of pointers in the permutation.
+			 * @param seed Seed used to shuffle.
+			 * @returns The full path of the index file.
+			 */
+			std::string __indexFileName(chunk_size_t chunk_size, size_t num_pointers, uint64_t seed) const;
+
+			/**
+			 * @brief Fills a memory region with a permutation from an index file.
+			 * @param start_address Start of the region.
+			 * @param end_address End of the region, exclusive.
+			 * @param chunk_size Size of each pointer chunk.
+			 * @param seed Seed used to shuffle.
+			 * @param info_log Stream for progress details, or NULL to not report them.
+			 * @param warning_log Stream for warnings, or NULL to discard them.
+			 * @returns True if a matching index file was found and loaded, and its permutation is a single cycle through every chunk.
+			 */
+			bool __loadIndexFile(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed, std::ostream* info_log, std::ostream* warning_log) const;
+
+			/**
+			 * @brief Saves the permutation held by a memory region to an index file.
+			 * @param start_address Start of the region.
+			 * @param end_address End of the region, exclusive.
+			 * @param chunk_size Size of each pointer chunk.
+			 * @param seed Seed used to shuffle.
+			 * @returns True on success.
+			 */
+			bool __saveIndexFile(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed) const;
+
+			std::vector<Layout> __layouts; /**< Permutations currently in memory. */
+			std::vector< std::pair<uintptr_t, uintptr_t> > __resident; /**< Regions that were touched since they were allocated. */
+			std::string __index_dir; /**< Directory for index files, or empty if they are not used. */
+			uint64_t __num_reused; /**< Number of permutations reused from memory. */
+			uint64_t __num_loaded; /**< Number of permutations loaded from index files. */
+			uint64_t __num_built; /**< Number of permutations built from scratch. */
+			std::mutex __lock; /**< Guards all of the above. */
+	};
+
+	extern PermutationCache g_permutation_cache; /**< Shared by all benchmarks, as they may reuse the same working set regions. */
+};
+
+#endif
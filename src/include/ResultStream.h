@@ -0,0 +1,89 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the ResultStream class.
+ */
+
+#ifndef __RESULT_STREAM_H
+#define __RESULT_STREAM_H
+
+//Headers
+#include <common.h>
+#include <BenchmarkResult.h>
+#include <Configurator.h>
+
+//Libraries
+#include <string>
+#include <fstream>
+
+namespace xmem {
+	/**
+	 * @brief Writes results as newline-delimited JSON. Each line is one self-describing record, written and flushed as soon as it is available, so a consumer can follow the file while X-Mem runs.
+	 * The first record has "record":"run" and describes the host and the configuration. Each benchmark then gets a "record":"benchmark" line.
+	 */
+	class ResultStream {
+		public:
+			/**
+			 * @brief Constructor. The stream starts closed.
+			 */
+			ResultStream();
+
+			/**
+			 * @brief Destructor. Closes the file.
+			 */
+			~ResultStream();
+
+			/**
+			 * @brief Opens the output file, replacing any existing contents.
+			 * @param filename Name of the file.
+			 * @returns True on success.
+			 */
+			bool open(const std::string& filename);
+
+			/**
+			 * @brief Indicates whether the output file is open.
+			 * @returns True if records can be written.
+			 */
+			bool isOpen() const;
+
+			/**
+			 * @brief Writes the run record, with the host's topology, kernel, transparent huge page settings, CPU model and microcode, and the X-Mem configuration.
+			 * @param config The X-Mem configuration.
+			 */
+			void writeRunHeader(const Configurator& config);
+
+			/**
+			 * @brief Writes one benchmark's record.
+			 * @param result The benchmark's results.
+			 */
+			void writeResult(const BenchmarkResult& result);
+
+		private:
+			std::ofstream __file; /**< The output file. */
+	};
+};
+
+#endif
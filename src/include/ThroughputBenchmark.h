@@ -52,12 +52,11 @@ namespace xmem {
 			void* mem_array,
 			size_t len,
 			uint32_t iterations,
-#ifdef USE_SIZE_BASED_BENCHMARKS
 			uint64_t passes_per_iteration,
-#endif
 			uint32_t num_worker_threads,
 			uint32_t mem_node,
 			uint32_t cpu_node,
+			std::vector<int32_t> cpu_ids,
 			pattern_mode_t pattern_mode,
 			rw_mode_t rw_mode,
 			chunk_size_t chunk_size,
@@ -71,8 +70,16 @@ namespace xmem {
 		 */
 		virtual ~ThroughputBenchmark() {}
 
+		virtual void getResult(BenchmarkResult& result) const;
+
 	protected:
 		virtual bool _run_core();
+
+		/**
+		 * @brief Builds the pointer permutations for random-access worker threads.
+		 * @returns True on success.
+		 */
+		virtual bool _prepare_core();
 	};
 };
 
@@ -0,0 +1,287 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Header file for the Topology class.
+ */
+
+#ifndef __TOPOLOGY_H
+#define __TOPOLOGY_H
+
+//Headers
+#include <common.h>
+
+//Libraries
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace xmem {
+	/**
+	 * @brief A group of logical CPUs that share one cache.
+	 */
+	struct CacheDomain {
+		uint32_t level; /**< Cache level, e.g. 1 for L1. */
+		std::string type; /**< "Data", "Instruction", or "Unified". */
+		size_t size; /**< Capacity in bytes, or 0 if unknown. */
+		std::vector<uint32_t> cpus; /**< Logical CPUs sharing this cache, in ascending order. */
+	};
+
+	/**
+	 * @brief Model of the processor and memory topology of the machine. It is built once at startup, and then answers placement queries without asking the OS again.
+	 */
+	class Topology {
+		public:
+			/**
+			 * @brief Constructor. The object is empty until build() is called.
+			 */
+			Topology();
+
+			/**
+			 * @brief Queries the OS for the machine topology. On GNU/Linux this reads /sys/devices/system/cpu and /sys/devices/system/node.
+			 * @returns True on success.
+			 */
+			bool build();
+
+			/**
+			 * @brief Prints a summary of the topology to the console.
+			 */
+			void report() const;
+
+			/**
+			 * @brief Gets the number of NUMA nodes. Node IDs may be sparse, so this is one more than the highest node ID.
+			 * @returns The number of NUMA nodes.
+			 */
+			uint32_t getNumNodes() const;
+
+			/**
+			 * @brief Gets the number of online logical CPUs that the process may use.
+			 * @returns The number of logical CPUs.
+			 */
+			uint32_t getNumLogicalCPUs() const;
+
+			/**
+			 * @brief Gets the number of physical cores, counting each core once regardless of SMT.
+			 * @returns The number of physical cores.
+			 */
+			uint32_t getNumPhysicalCores() const;
+
+			/**
+			 * @brief Gets the number of physical processor packages.
+			 * @returns The number of packages.
+			 */
+			uint32_t getNumPackages() const;
+
+			/**
+			 * @brief Gets the number of distinct caches at a given level, counting data, instruction and unified caches separately.
+			 * @param level The cache level, e.g. 1 for L1.
+			 * @returns The number of caches at that level.
+			 */
+			uint32_t getNumCaches(uint32_t level) const;
+
+			/**
+			 * @brief Indicates whether cache information was obtained from the OS.
+			 * @returns True if the cache counts are known rather than guessed.
+			 */
+			bool hasCacheInfo() const;
+
+			/**
+			 * @brief Gets the logical CPUs in a NUMA node that the process may use.
+			 * @param numa_node The NUMA node of interest.
+			 * @returns The logical CPUs in ascending order. Empty for memory-only nodes and nodes that do not exist.
+			 */
+			const std::vector<uint32_t>& getCPUsInNode(uint32_t numa_node) const;
+
+			/**
+			 * @brief Gets the NUMA node of a logical CPU.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns The NUMA node, or -1 if unknown.
+			 */
+			int32_t getNodeOfCPU(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Gets the physical package of a logical CPU.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns The package ID, or -1 if unknown.
+			 */
+			int32_t getPackageOfCPU(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Gets the die of a logical CPU within its package.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns The die ID, or -1 if unknown.
+			 */
+			int32_t getDieOfCPU(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Gets an identifier of the physical core of a logical CPU. SMT siblings share the same identifier.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns A core identifier that is unique across the machine, or -1 if unknown.
+			 */
+			int64_t getCoreOfCPU(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Gets the SMT siblings of a logical CPU.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns All logical CPUs on the same physical core, including cpu_id, in ascending order.
+			 */
+			const std::vector<uint32_t>& getSMTSiblings(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Gets the relative distance between two NUMA nodes as reported by the OS. By convention a node's distance to itself is 10.
+			 * @param from_node The NUMA node where the accesses originate.
+			 * @param to_node The NUMA node being accessed.
+			 * @returns The relative distance, or -1 if unknown.
+			 */
+			int32_t getDistance(uint32_t from_node, uint32_t to_node) const;
+
+			/**
+			 * @brief Indicates whether a NUMA node has any logical CPUs.
+			 * @param numa_node The NUMA node of interest.
+			 * @returns True if threads can run on the node.
+			 */
+			bool nodeHasCPUs(uint32_t numa_node) const;
+
+			/**
+			 * @brief Indicates whether a NUMA node has any memory.
+			 * @param numa_node The NUMA node of interest.
+			 * @returns True if memory can be allocated on the node.
+			 */
+			bool nodeHasMemory(uint32_t numa_node) const;
+
+			/**
+			 * @brief Indicates whether a NUMA node has memory but no CPUs, as with CXL-attached or HBM memory tiers.
+			 * @param numa_node The NUMA node of interest.
+			 * @returns True if the node is memory-only.
+			 */
+			bool isMemoryOnlyNode(uint32_t numa_node) const;
+
+			/**
+			 * @brief Gets all cache sharing domains.
+			 * @returns One entry per distinct cache in the machine.
+			 */
+			const std::vector<CacheDomain>& getCaches() const;
+
+			/**
+			 * @brief Orders all logical CPUs for placing worker threads near a NUMA node. See cpu_placement_order() for semantics.
+			 * @param numa_node The NUMA node the workers should run on.
+			 * @param policy How to arrange the CPUs within each node.
+			 * @returns Logical CPU IDs in placement order.
+			 */
+			std::vector<uint32_t> getPlacementOrder(uint32_t numa_node, placement_policy_t policy) const;
+
+			/**
+			 * @brief Indicates whether this process may run on a logical CPU, according to its affinity mask and cpuset cgroup.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns True if the CPU is online and allowed.
+			 */
+			bool isCPUAllowed(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Indicates whether the process is restricted to a subset of the online logical CPUs.
+			 * @returns True if some online CPUs are not allowed.
+			 */
+			bool isCPUConstrained() const;
+
+			/**
+			 * @brief Indicates whether the process is restricted to a subset of the NUMA nodes with memory.
+			 * @returns True if the cpuset cgroup excludes some memory nodes.
+			 */
+			bool isMemoryNodeConstrained() const;
+
+			/**
+			 * @brief Gets the number of online logical CPUs, including any that the process is not allowed to use.
+			 * @returns The number of online logical CPUs.
+			 */
+			uint32_t getNumOnlineCPUs() const;
+
+			/**
+			 * @brief Gets the memory limit of the process's cgroup on GNU/Linux, or of its job object on Windows.
+			 * @returns The limit in bytes, or 0 if there is none.
+			 */
+			size_t getMemoryLimit() const;
+
+			/**
+			 * @brief Indicates whether a logical CPU is isolated from general scheduling and housekeeping by the isolcpus or nohz_full kernel parameters.
+			 * @param cpu_id The logical CPU of interest.
+			 * @returns True if the CPU is isolated and allowed.
+			 */
+			bool isCPUIsolated(uint32_t cpu_id) const;
+
+			/**
+			 * @brief Indicates whether any allowed logical CPU is isolated.
+			 * @returns True if some CPUs are isolated.
+			 */
+			bool hasIsolatedCPUs() const;
+
+			/**
+			 * @brief Gets the allowed logical CPUs that are not isolated. These handle interrupts and kernel housekeeping.
+			 * @returns Housekeeping CPU IDs in ascending order.
+			 */
+			std::vector<uint32_t> getHousekeepingCPUs() const;
+
+		private:
+			/**
+			 * @brief Fills in a single node holding all CPUs, for systems that do not expose NUMA information.
+			 * @param cpus All logical CPUs in the system.
+			 */
+			void __buildSingleNode(const std::vector<uint32_t>& cpus);
+
+			/**
+			 * @brief Derives the CPU, core and package counts from the per-CPU tables.
+			 */
+			void __computeCounts();
+
+			/**
+			 * @brief Restricts the CPUs and memory nodes to those the process may use, and reads the cgroup memory limit. On Linux this honors the affinity mask and cgroup v1 or v2 cpuset and memory controllers, and finds the isolated CPUs.
+			 */
+			void __applyConstraints();
+
+			bool __built; /**< True once build() has succeeded. */
+			uint32_t __num_logical_cpus; /**< Number of online logical CPUs that the process may use. */
+			uint32_t __num_online_cpus; /**< Number of online logical CPUs. */
+			uint32_t __num_physical_cores; /**< Number of physical cores. */
+			uint32_t __num_packages; /**< Number of physical packages. */
+			bool __has_cache_info; /**< True if cache domains were read from the OS. */
+			std::vector<int32_t> __cpu_node; /**< NUMA node of each logical CPU, indexed by CPU ID. -1 if unknown or offline. */
+			std::vector<int32_t> __cpu_package; /**< Package of each logical CPU, indexed by CPU ID. */
+			std::vector<int32_t> __cpu_die; /**< Die of each logical CPU, indexed by CPU ID. */
+			std::vector<int64_t> __cpu_core; /**< Machine-wide core identifier of each logical CPU, indexed by CPU ID. */
+			std::vector< std::vector<uint32_t> > __cpu_siblings; /**< SMT siblings of each logical CPU, indexed by CPU ID. */
+			std::vector< std::vector<uint32_t> > __node_cpus; /**< Allowed logical CPUs of each NUMA node, indexed by node ID. */
+			std::vector<bool> __node_has_memory; /**< Whether each NUMA node has memory that the process may allocate, indexed by node ID. */
+			std::vector< std::vector<int32_t> > __distances; /**< NUMA distance matrix, indexed as [from][to]. */
+			std::vector<CacheDomain> __caches; /**< All distinct caches. */
+			std::vector<bool> __cpu_allowed; /**< Whether the process may run on each logical CPU, indexed by CPU ID. */
+			std::vector<bool> __cpu_isolated; /**< Whether each allowed logical CPU is isolated by isolcpus or nohz_full, indexed by CPU ID. */
+			bool __mems_constrained; /**< True if some memory nodes were excluded by the cpuset cgroup. */
+			size_t __memory_limit; /**< cgroup or job object memory limit in bytes, or 0 if none. */
+			std::vector<uint32_t> __empty; /**< Returned for lookups of nonexistent nodes or CPUs. */
+	};
+
+	extern Topology g_topology; /**< The machine topology, built once by query_sys_info(). */
+};
+
+#endif
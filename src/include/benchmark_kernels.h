@@ -36,6 +36,7 @@
 //Libraries
 #include <cstdint>
 #include <cstddef>
+#include <ostream>
 
 namespace xmem {
 	
@@ -64,13 +65,31 @@ namespace xmem {
 	bool determineRandomKernel(rw_mode_t rw_mode, chunk_size_t chunk_size, RandomFunction* kernel_function, RandomFunction* dummy_kernel_function);
 
 	/**
-	 * @brief Builds a random chain of pointers within the specified memory region.
+	 * @brief Determines which pointer-chasing latency kernel to use based on the unroll length. Only a fixed set of unroll lengths is compiled.
+	 * @param unroll_length Number of dependent loads per kernel call. Must be 128, 256, 512, or 1024.
+	 * @param kernel_function Function pointer that will be set to the matching kernel function.
+	 * @param dummy_kernel_function Function pointer that will be set to the matching dummy kernel function.
+	 * @returns True on success.
+	 */
+	bool determineLatencyKernel(uint32_t unroll_length, RandomFunction* kernel_function, RandomFunction* dummy_kernel_function);
+
+	/**
+	 * @brief Builds a random chain of pointers within the specified memory region. The chain is a single cycle through every chunk.
 	 * @param start_address Beginning address of the memory region.
 	 * @param end_address End address of the memory region.
 	 * @param chunk_size Granularity of words to read, dereference, and jump by. This cannot be 32 bits due to a need for 64-bit pointers. If the chunk size is more than 64 bits, when chasing pointers, only the first 64 bits of the referenced word are used to make the next hop.
+	 * @param seed Seed of the random number generator used to shuffle.
+	 * @param info_log Stream for progress details, or NULL to not report them.
+	 * @param warning_log Stream for errors, or NULL to discard them.
 	 * @returns True on success.
 	 */
-	bool buildRandomPointerPermutation(void* start_address, void* end_address, chunk_size_t chunk_size);
+	bool buildRandomPointerPermutation(void* start_address, void* end_address, chunk_size_t chunk_size, uint64_t seed, std::ostream* info_log, std::ostream* warning_log);
+
+	/**
+	 * @brief Checks that the sequential and strided throughput kernels and the latency kernels in this executable access memory exactly as intended. Each kernel is disassembled with objdump, and its memory instructions are counted. Each throughput kernel must have exactly one load or store of its word width per word it accesses in a 4096-byte block, and each latency kernel one 64-bit load per pointer in its unrolled block plus the store of the last pointer. Neither may have other memory instructions, and dummy kernels must have none. The random throughput kernels are not implemented yet and are not checked. GNU/Linux only.
+	 * @returns True if every kernel was found and passed.
+	 */
+	bool checkKernelInstructions();
 
 	/***********************************************************************
 	 ***********************************************************************
@@ -81,23 +100,70 @@ namespace xmem {
 	/* --------------------- DUMMY BENCHMARK ROUTINES --------------------------- */
 
 	/**
-	 * @brief Mimics the __chasePointers() method but doesn't do the memory accesses.
+	 * @brief Mimics chasePointers_Unroll128() but doesn't do the memory accesses.
 	 * @returns Undefined.
 	 */
-	int32_t dummy_chasePointers(uintptr_t*, uintptr_t**, size_t len);
+	int32_t dummy_chasePointers_Unroll128(uintptr_t*, uintptr_t**, size_t len);
+
+	/**
+	 * @brief Mimics chasePointers_Unroll256() but doesn't do the memory accesses.
+	 * @returns Undefined.
+	 */
+	int32_t dummy_chasePointers_Unroll256(uintptr_t*, uintptr_t**, size_t len);
+
+	/**
+	 * @brief Mimics chasePointers_Unroll512() but doesn't do the memory accesses.
+	 * @returns Undefined.
+	 */
+	int32_t dummy_chasePointers_Unroll512(uintptr_t*, uintptr_t**, size_t len);
+
+	/**
+	 * @brief Mimics chasePointers_Unroll1024() but doesn't do the memory accesses.
+	 * @returns Undefined.
+	 */
+	int32_t dummy_chasePointers_Unroll1024(uintptr_t*, uintptr_t**, size_t len);
 
 	/* ------------------------------------------------------------------------- */
 	/* --------------------- CORE BENCHMARK ROUTINES --------------------------- */
 	/* ------------------------------------------------------------------------- */
 
 	/**
-	 * @brief Walks over the allocated memory in random order by chasing pointers.
-	 * TODO update Doxygen comments
+	 * @brief Walks over the allocated memory in random order by chasing pointers, 128 dereferences at a time.
+	 * @param first_address Pointer to the first element of the chain.
+	 * @param last_touched_address Set to the last pointer reached, so the next call can continue the chain.
+	 * @param len If 0, performs exactly 128 dereferences. Otherwise, performs enough dereferences to cover len bytes, rounded up to a multiple of 128.
+	 * @returns Undefined.
 	 */
-	int32_t chasePointers(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
-	
-	
-	
+	int32_t chasePointers_Unroll128(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+
+	/**
+	 * @brief Walks over the allocated memory in random order by chasing pointers, 256 dereferences at a time.
+	 * @param first_address Pointer to the first element of the chain.
+	 * @param last_touched_address Set to the last pointer reached, so the next call can continue the chain.
+	 * @param len If 0, performs exactly 256 dereferences. Otherwise, performs enough dereferences to cover len bytes, rounded up to a multiple of 256.
+	 * @returns Undefined.
+	 */
+	int32_t chasePointers_Unroll256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+
+	/**
+	 * @brief Walks over the allocated memory in random order by chasing pointers, 512 dereferences at a time.
+	 * @param first_address Pointer to the first element of the chain.
+	 * @param last_touched_address Set to the last pointer reached, so the next call can continue the chain.
+	 * @param len If 0, performs exactly 512 dereferences. Otherwise, performs enough dereferences to cover len bytes, rounded up to a multiple of 512.
+	 * @returns Undefined.
+	 */
+	int32_t chasePointers_Unroll512(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+
+	/**
+	 * @brief Walks over the allocated memory in random order by chasing pointers, 1024 dereferences at a time.
+	 * @param first_address Pointer to the first element of the chain.
+	 * @param last_touched_address Set to the last pointer reached, so the next call can continue the chain.
+	 * @param len If 0, performs exactly 1024 dereferences. Otherwise, performs enough dereferences to cover len bytes, rounded up to a multiple of 1024.
+	 * @returns Undefined.
+	 */
+	int32_t chasePointers_Unroll1024(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
+
+
 	/***********************************************************************
 	 ***********************************************************************
 	 ******************* THROUGHPUT-RELATED BENCHMARK KERNELS **************
@@ -1183,4 +1249,50 @@ namespace xmem {
 	int32_t randomWrite_Word256(uintptr_t* first_address, uintptr_t** last_touched_address, size_t len);
 };
 
+/**
+ * @brief Lists every sequential and strided kernel, including the dummies, as X(kernel). This lets code be generated for each kernel at compile time.
+ */
+#define XMEM_SEQUENTIAL_KERNELS(X) \
+	X(forwSequentialRead_Word32) X(revSequentialRead_Word32) X(forwSequentialWrite_Word32) X(revSequentialWrite_Word32) \
+	X(dummy_forwSequentialLoop_Word32) X(dummy_revSequentialLoop_Word32) X(forwStride2Read_Word32) X(revStride2Read_Word32) \
+	X(forwStride2Write_Word32) X(revStride2Write_Word32) X(dummy_forwStride2Loop_Word32) X(dummy_revStride2Loop_Word32) \
+	X(forwStride4Read_Word32) X(revStride4Read_Word32) X(forwStride4Write_Word32) X(revStride4Write_Word32) \
+	X(dummy_forwStride4Loop_Word32) X(dummy_revStride4Loop_Word32) X(forwStride8Read_Word32) X(revStride8Read_Word32) \
+	X(forwStride8Write_Word32) X(revStride8Write_Word32) X(dummy_forwStride8Loop_Word32) X(dummy_revStride8Loop_Word32) \
+	X(forwStride16Read_Word32) X(revStride16Read_Word32) X(forwStride16Write_Word32) X(revStride16Write_Word32) \
+	X(dummy_forwStride16Loop_Word32) X(dummy_revStride16Loop_Word32) \
+	X(forwSequentialRead_Word64) X(revSequentialRead_Word64) X(forwSequentialWrite_Word64) X(revSequentialWrite_Word64) \
+	X(dummy_forwSequentialLoop_Word64) X(dummy_revSequentialLoop_Word64) X(forwStride2Read_Word64) X(revStride2Read_Word64) \
+	X(forwStride2Write_Word64) X(revStride2Write_Word64) X(dummy_forwStride2Loop_Word64) X(dummy_revStride2Loop_Word64) \
+	X(forwStride4Read_Word64) X(revStride4Read_Word64) X(forwStride4Write_Word64) X(revStride4Write_Word64) \
+	X(dummy_forwStride4Loop_Word64) X(dummy_revStride4Loop_Word64) X(forwStride8Read_Word64) X(revStride8Read_Word64) \
+	X(forwStride8Write_Word64) X(revStride8Write_Word64) X(dummy_forwStride8Loop_Word64) X(dummy_revStride8Loop_Word64) \
+	X(forwStride16Read_Word64) X(revStride16Read_Word64) X(forwStride16Write_Word64) X(revStride16Write_Word64) \
+	X(dummy_forwStride16Loop_Word64) X(dummy_revStride16Loop_Word64) \
+	X(forwSequentialRead_Word128) X(revSequentialRead_Word128) X(forwSequentialWrite_Word128) X(revSequentialWrite_Word128) \
+	X(dummy_forwSequentialLoop_Word128) X(dummy_revSequentialLoop_Word128) X(forwStride2Read_Word128) X(revStride2Read_Word128) \
+	X(forwStride2Write_Word128) X(revStride2Write_Word128) X(dummy_forwStride2Loop_Word128) X(dummy_revStride2Loop_Word128) \
+	X(forwStride4Read_Word128) X(revStride4Read_Word128) X(forwStride4Write_Word128) X(revStride4Write_Word128) \
+	X(dummy_forwStride4Loop_Word128) X(dummy_revStride4Loop_Word128) X(forwStride8Read_Word128) X(revStride8Read_Word128) \
+	X(forwStride8Write_Word128) X(revStride8Write_Word128) X(dummy_forwStride8Loop_Word128) X(dummy_revStride8Loop_Word128) \
+	X(forwStride16Read_Word128) X(revStride16Read_Word128) X(forwStride16Write_Word128) X(revStride16Write_Word128) \
+	X(dummy_forwStride16Loop_Word128) X(dummy_revStride16Loop_Word128) \
+	X(forwSequentialRead_Word256) X(revSequentialRead_Word256) X(forwSequentialWrite_Word256) X(revSequentialWrite_Word256) \
+	X(dummy_forwSequentialLoop_Word256) X(dummy_revSequentialLoop_Word256) X(forwStride2Read_Word256) X(revStride2Read_Word256) \
+	X(forwStride2Write_Word256) X(revStride2Write_Word256) X(dummy_forwStride2Loop_Word256) X(dummy_revStride2Loop_Word256) \
+	X(forwStride4Read_Word256) X(revStride4Read_Word256) X(forwStride4Write_Word256) X(revStride4Write_Word256) \
+	X(dummy_forwStride4Loop_Word256) X(dummy_revStride4Loop_Word256) X(forwStride8Read_Word256) X(revStride8Read_Word256) \
+	X(forwStride8Write_Word256) X(revStride8Write_Word256) X(dummy_forwStride8Loop_Word256) X(dummy_revStride8Loop_Word256) \
+	X(forwStride16Read_Word256) X(revStride16Read_Word256) X(forwStride16Write_Word256) X(revStride16Write_Word256) \
+	X(dummy_forwStride16Loop_Word256) X(dummy_revStride16Loop_Word256)
+
+/**
+ * @brief Lists every random throughput kernel, including the dummies, as X(kernel). This lets code be generated for each kernel at compile time.
+ */
+#define XMEM_RANDOM_KERNELS(X) \
+	X(randomRead_Word32) X(randomWrite_Word32) X(dummy_randomLoop_Word32) \
+	X(randomRead_Word64) X(randomWrite_Word64) X(dummy_randomLoop_Word64) \
+	X(randomRead_Word128) X(randomWrite_Word128) X(dummy_randomLoop_Word128) \
+	X(randomRead_Word256) X(randomWrite_Word256) X(dummy_randomLoop_Word256)
+
 #endif
@@ -33,6 +33,8 @@
 //Libraries
 #include <cstdint>
 #include <cstddef>
+#include <vector>
+#include <string>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -133,6 +135,7 @@ namespace xmem {
 #define DEFAULT_LARGE_PAGE_SIZE 2*MB /**< Default platform large page size in bytes. This generally should not be relied on, but is a failsafe. */
 #define DEFAULT_WORKING_SET_SIZE_PER_THREAD DEFAULT_PAGE_SIZE /**< Default working set size in bytes. */
 #define DEFAULT_NUM_WORKER_THREADS 1 /**< Default number of worker threads to use. */
+#define DEFAULT_MAX_ITERATIONS 50 /**< Default maximum number of iterations of a benchmark in adaptive iteration mode. */
 #define DEFAULT_NUM_NODES 0 /**< Default number of NUMA nodes. */
 #define DEFAULT_NUM_PHYSICAL_PACKAGES 0 /**< Default number of physical packages. */
 #define DEFAULT_NUM_PHYSICAL_CPUS 0 /**< Default number of physical CPU cores. */
@@ -163,7 +166,7 @@ namespace xmem {
 #define UNROLL32768(x) UNROLL16384(x) UNROLL16384(x)
 #define UNROLL65536(x) UNROLL32768(x) UNROLL32768(x)
 
-#define LATENCY_BENCHMARK_UNROLL_LENGTH 512 /**< Number of unrolls in the latency benchmark pointer chasing core function. */
+#define DEFAULT_LATENCY_BENCHMARK_UNROLL_LENGTH 512 /**< Default number of unrolls in the latency benchmark pointer chasing core function. Must be one of the lengths for which a kernel is compiled: 128, 256, 512, or 1024. */
 
 /***********************************************************************************************************/
 /***********************************************************************************************************/
@@ -180,21 +183,26 @@ namespace xmem {
 //#define USE_QPC_TIMER /**< RECOMMENDED DISABLED. WINDOWS ONLY. Use the Windows QueryPerformanceCounter timer API. This is a safe bet as it is more hardware-agnostic and has fewer quirks, but it has lower resolution than the TSC timer. */
 #define USE_TSC_TIMER /**< RECOMMENDED ENABLED. Use the Intel Time Stamp Counter native hardware timer. Only use this if you know what you are doing. */
 
-//Benchmarking methodology. Only one may be selected!
-#define USE_TIME_BASED_BENCHMARKS /**< RECOMMENDED ENABLED. All benchmarks run for an estimated amount of time, and the figures of merit are computed based on the amount of memory accesses completed in the time limit. This mode has more consistent runtime across different machines, memory performance, and working set sizes, but may have more conservative measurements for differing levels of cache hierarchy (overestimating latency and underestimating throughput). */
-//#define USE_SIZE_BASED_BENCHMARKS /**< RECOMMENDED DISABLED. All benchmarks run for an estimated amount of memory accesses, and the figures of merit are computed based on the length of time required to run the benchmark. This mode may have highly varying runtime across different machines, memory performance, and working set sizes, but may have more optimistic measurements across differing levels of cache hierarchy (underestimating latency and overestimating throughput). */
-
-#ifdef USE_TIME_BASED_BENCHMARKS //DO NOT COMMENT THIS OUT!
-#define BENCHMARK_DURATION_SEC 4 /**< RECOMMENDED VALUE: At least 2. Number of seconds to run in each benchmark. */
-#define THROUGHPUT_BENCHMARK_BYTES_PER_PASS 4096 /**< RECOMMENDED VALUE: 4096. Number of bytes read or written per pass of any ThroughputBenchmark. This must be less than or equal to the minimum working set size, which is currently 4 KB. */
-#endif //DO NOT COMMENT THIS OUT
-
-#ifdef USE_SIZE_BASED_BENCHMARKS //DO NOT COMMENT THIS OUT
-//#define USE_PASSES_CURVE_1 /**< RECOMMENDED DISABLED. The passes per iteration of a benchmark will be given by y = 65536 / working_set_size_KB */
-#define USE_PASSES_CURVE_2 /**< RECOMMENDED ENABLED. The passes per iteration of a benchmark will be given by y = 4*2097152 / working_set_size_KB^2 */
-#endif //DO NOT COMMENT THIS OUT
-
-#define POWER_SAMPLING_PERIOD_SEC 1 /**< RECOMMENDED VALUE: 1. Sampling period in seconds for all power measurement mechanisms. */
+//Default benchmarking methodology and its parameters. Time-based and size-based engines are both compiled in; these values may be overridden at runtime with the --mode, --duration, --bytes_per_pass, --latency_unroll, --power_period, and --trace_period options.
+#define DEFAULT_BENCHMARK_MODE TIME_BASED /**< RECOMMENDED VALUE: TIME_BASED. See benchmark_mode_t. */
+#define DEFAULT_BENCHMARK_DURATION_SEC 4 /**< RECOMMENDED VALUE: At least 2. Number of seconds to run in each time-based benchmark. */
+#define DEFAULT_THROUGHPUT_BENCHMARK_BYTES_PER_PASS 4096 /**< RECOMMENDED VALUE: 4096. Number of bytes read or written per pass of any time-based ThroughputBenchmark. This must be less than or equal to the working set size per thread. */
+#define THROUGHPUT_BENCHMARK_BYTES_PER_PASS_GRANULARITY 4096 /**< Bytes per pass must be a nonzero multiple of this. Every throughput kernel accesses whole blocks of this size, so a shorter pass would run past the end of its region. */
+
+//#define USE_PASSES_CURVE_1 /**< RECOMMENDED DISABLED. The passes per iteration of a size-based benchmark will be given by y = 65536 / working_set_size_KB */
+#define USE_PASSES_CURVE_2 /**< RECOMMENDED ENABLED. The passes per iteration of a size-based benchmark will be given by y = 4*2097152 / working_set_size_KB^2 */
+
+#define DEFAULT_POWER_SAMPLING_PERIOD_SEC 1 /**< RECOMMENDED VALUE: 1. Sampling period in seconds for all power measurement mechanisms. */
+#define DEFAULT_BANDWIDTH_TRACE_PERIOD_US 0 /**< Sampling period in microseconds of the per-worker bandwidth traces of throughput benchmarks, or 0 to not trace. */
+#define BANDWIDTH_TRACE_MAX_SAMPLES 1048576 /**< Most samples kept by each worker's bandwidth trace. Older samples are overwritten beyond this. */
+#define DEFAULT_COMPARE_THRESHOLD 0.02 /**< RECOMMENDED VALUE: 0.02. Smallest relative change from a baseline that is reported as a regression or improvement, even if it is statistically significant. */
+#define DEFAULT_DAEMON_INTERVAL_SEC 60 /**< Minimum time in seconds between the starts of two rounds of probes in daemon mode. */
+#define DEFAULT_DAEMON_BUDGET 0.02 /**< RECOMMENDED VALUE: At most 0.05. Largest share of time that probes may run in daemon mode, so that monitoring does not disturb the workloads it watches. */
+#define INTERFERENCE_THRESHOLD 0.01 /**< RECOMMENDED VALUE: 0.01. Largest share of a measurement CPU's time that may go to interrupts, softirqs, hypervisor steal, or other runnable tasks before an iteration counts as noisy. */
+#define INTERFERENCE_MAX_PREEMPTIONS_PER_SEC 10 /**< RECOMMENDED VALUE: 10. Most involuntary context switches per second per worker before an iteration counts as noisy. */
+#define FREQUENCY_VARIATION_THRESHOLD 0.05 /**< RECOMMENDED VALUE: 0.05. Largest spread of the effective core frequency across a benchmark's iterations, relative to the highest, before its results are flagged with a warning. */
+#define FALSE_SHARING_LINE_SIZE 64 /**< RECOMMENDED VALUE: 64. Cache line size in bytes across which false-sharing writers interleave their chunks. */
+#define ANTAGONIST_CALIBRATION_SEC 2 /**< Seconds of unthrottled load used to measure the peak bandwidth when the antagonist rate is relative to it. */
 /***********************************************************************************************************/
 /***********************************************************************************************************/
 /***********************************************************************************************************/
@@ -218,34 +226,8 @@ namespace xmem {
 #error Only one type of timer may be specified!
 #endif
 
-#if (defined(USE_TIME_BASED_BENCHMARKS) && defined(USE_SIZE_BASED_BENCHMARKS)) || (!defined(USE_TIME_BASED_BENCHMARKS) && !defined(USE_SIZE_BASED_BENCHMARKS))
-#error Exactly one of USE_TIME_BASED_BENCHMARKS and USE_SIZE_BASED_BENCHMARKS must be defined!
-#endif
-
-#ifdef USE_TIME_BASED_BENCHMARKS
-#ifndef BENCHMARK_DURATION_SEC
-#error BENCHMARK_DURATION_SEC must be defined!
-#endif
-#if BENCHMARK_DURATION_SEC <= 0
-#error BENCHMARK_DURATION_SEC must be a positive integer!
-#endif
-#ifndef THROUGHPUT_BENCHMARK_BYTES_PER_PASS
-#error THROUGHPUT_BENCHMARK_BYTES_PER_PASS must be defined!
-#else
-#if THROUGHPUT_BENCHMARK_BYTES_PER_PASS > DEFAULT_PAGE_SIZE || THROUGHPUT_BENCHMARK_BYTES_PER_PASS <= 0
-#error THROUGHPUT_BENCHMARK_BYTES_PER_PASS must be less than or equal to the minimum possible working set size. It also must be a positive integer.
-#endif
-#endif
-#endif
-
-#ifdef USE_SIZE_BASED_BENCHMARKS
 #if (defined(USE_PASSES_CURVE_1) && defined(USE_PASSES_CURVE_2)) || (!defined(USE_PASSES_CURVE_1) && !defined(USE_PASSES_CURVE_2))
 #error Exactly one passes curve must be defined.
-#endif
-#endif
-
-#if !defined(POWER_SAMPLING_PERIOD_SEC) || POWER_SAMPLING_PERIOD_SEC <= 0
-#error POWER_SAMPLING_PERIOD_SEC must be defined and greater than 0!
 #endif
 
 	extern bool g_verbose;
@@ -256,6 +238,7 @@ namespace xmem {
 	extern uint32_t g_num_physical_packages;
 	extern uint32_t g_starting_test_index;
 	extern uint32_t g_test_index;
+	extern bool g_sys_info_ready;
 
 	//Typedef the platform specific stuff to word sizes to match 4 different chunk options
 	typedef uint32_t Word32_t;
@@ -295,6 +278,67 @@ namespace xmem {
 		NUM_CHUNK_SIZES
 	} chunk_size_t;
 
+	/**
+	 * @brief Policies for choosing the logical CPUs that worker threads run on.
+	 */
+	typedef enum {
+		PLACEMENT_COMPACT, /**< Logical CPUs in ascending ID order. */
+		PLACEMENT_SCATTER, /**< One logical CPU on every physical core first, then the remaining SMT siblings. */
+		PLACEMENT_SMT_PAIRS, /**< All SMT siblings of a physical core before moving on to the next core. */
+		NUM_PLACEMENT_POLICIES
+	} placement_policy_t;
+
+	/**
+	 * @brief How the worker threads of a benchmark share its working set.
+	 */
+	typedef enum {
+		SHARING_PRIVATE, /**< Each worker has its own disjoint slice of the working set. */
+		SHARING_READ_SHARED, /**< All workers read the same slice. */
+		SHARING_ONE_WRITER, /**< One worker writes a slice while all the others read it. */
+		SHARING_FALSE_SHARING, /**< All workers write the same cache lines of one slice, each to its own chunk within every line. */
+		NUM_SHARING_MODES
+	} sharing_mode_t;
+
+	/**
+	 * @brief Benchmarking methodologies.
+	 */
+	typedef enum {
+		TIME_BASED, /**< All benchmarks run for an estimated amount of time, and the figures of merit are computed based on the amount of memory accesses completed in the time limit. This mode has more consistent runtime across different machines, memory performance, and working set sizes, but may have more conservative measurements for differing levels of cache hierarchy (overestimating latency and underestimating throughput). */
+		SIZE_BASED, /**< All benchmarks run for an estimated amount of memory accesses, and the figures of merit are computed based on the length of time required to run the benchmark. This mode may have highly varying runtime across different machines, memory performance, and working set sizes, but may have more optimistic measurements across differing levels of cache hierarchy (underestimating latency and overestimating throughput). */
+		NUM_BENCHMARK_MODES
+	} benchmark_mode_t;
+
+	/**
+	 * @brief Policies for preparing the next benchmark's working set while the current benchmark is measuring.
+	 */
+	typedef enum {
+		PREP_OVERLAP_OFF, /**< Never overlap. Each benchmark is prepared right before it runs. */
+		PREP_OVERLAP_ISOLATED, /**< Overlap only on a CPU outside the measured CPU and memory nodes, and only if the next working set is not on the measured memory node. */
+		PREP_OVERLAP_ANY, /**< Overlap on any CPU not running a measured worker thread, preferring CPUs that do not share a core with one. */
+		NUM_PREP_OVERLAP_MODES
+	} prep_overlap_t;
+
+	/**
+	 * @brief The workload of one load worker thread that does not run its benchmark's kernel.
+	 */
+	struct WorkerSpec {
+		pattern_mode_t pattern_mode; /**< Access pattern of the worker's kernel. */
+		rw_mode_t rw_mode; /**< Read/write mode of the worker's kernel. */
+		chunk_size_t chunk_size; /**< Chunk size of the worker's kernel. */
+		int64_t stride_size; /**< Stride size in chunks for the sequential pattern. Ignored for the random pattern. */
+		uint32_t mem_node; /**< NUMA node of the worker's memory region. */
+		uint64_t throttle_bytes_per_sec; /**< Rate the worker is limited to in bytes per second, or 0 for no limit. Only time-based benchmarks are throttled. */
+		void* mem_array; /**< Start of the worker's memory region, which holds one per-thread working set. NULL means the worker's own slice of the benchmark's working set, which is then on the benchmark's memory node. */
+	};
+
+	extern benchmark_mode_t g_benchmark_mode;
+	extern uint32_t g_benchmark_duration_sec;
+	extern size_t g_throughput_bytes_per_pass;
+	extern uint32_t g_latency_unroll_length;
+	extern uint32_t g_power_sampling_period_sec;
+	extern uint32_t g_bandwidth_trace_period_us;
+	extern uint64_t g_permutation_seed;
+
 	/**
 	* @brief Prints a basic welcome message to the console with useful information.
 	*/
@@ -346,6 +390,24 @@ namespace xmem {
 	 * @returns True on success.
 	 */
 	bool unlock_thread_to_cpu();
+
+	/**
+	 * @brief Restricts the calling thread to the housekeeping logical CPUs, so that it stays off CPUs isolated for measurement. Threads it creates inherit this affinity until they lock themselves elsewhere.
+	 * @returns True on success, or if no CPUs are isolated.
+	 */
+	bool lock_thread_to_housekeeping_cpus();
+
+	/**
+	 * @brief Starts or stops catching SIGINT and SIGTERM for long-running modes, so that they can finish cleanly instead of being killed. While caught, these signals only set a flag that stop_signal_received() reports.
+	 * @param enable If true, install the handlers and clear the flag. If false, restore the previous handlers.
+	 */
+	void catch_stop_signals(bool enable);
+
+	/**
+	 * @brief Indicates whether SIGINT or SIGTERM arrived since catch_stop_signals(true) was called. Safe to call from any thread.
+	 * @returns True if the process was asked to stop.
+	 */
+	bool stop_signal_received();
 	
 	/**
 	 * @brief Gets the CPU ID for a logical CPU of interest in a particular NUMA node.
@@ -356,6 +418,88 @@ namespace xmem {
 	 */
 	int32_t cpu_id_in_numa_node(uint32_t numa_node, uint32_t cpu_in_node);
 
+	/**
+	 * @brief Gets a logical CPU in a NUMA node for auxiliary threads such as power sampling. This is the highest-numbered housekeeping CPU of the node, or the highest-numbered CPU if the whole node is isolated.
+	 * @param numa_node The NUMA node of interest.
+	 * @returns The logical CPU ID, or -1 if the node has no CPUs.
+	 */
+	int32_t housekeeping_cpu_in_numa_node(uint32_t numa_node);
+
+	/**
+	 * @brief Gets the NUMA node that a logical CPU belongs to.
+	 * @param cpu_id The logical CPU of interest.
+	 * @returns The NUMA node, or -1 if it could not be determined.
+	 */
+	int32_t numa_node_of_cpu_id(uint32_t cpu_id);
+
+	/**
+	 * @brief Gets an identifier of the physical core that a logical CPU belongs to. Logical CPUs that are SMT siblings share the same identifier.
+	 * @param cpu_id The logical CPU of interest.
+	 * @returns The physical core identifier, unique across packages, or -1 if it could not be determined.
+	 */
+	int64_t physical_core_of_cpu_id(uint32_t cpu_id);
+
+	/**
+	 * @brief Orders all logical CPUs in the system for placing worker threads near a NUMA node. CPUs of the given node come first, arranged according to the placement policy, with any CPUs isolated by isolcpus or nohz_full ahead of housekeeping CPUs. The other nodes follow in order of increasing NUMA distance, so that thread counts larger than one node spill over to the nearest nodes.
+	 * @param numa_node The NUMA node the workers should run on.
+	 * @param policy How to arrange the CPUs within each node.
+	 * @returns Logical CPU IDs in placement order.
+	 */
+	std::vector<uint32_t> cpu_placement_order(uint32_t numa_node, placement_policy_t policy);
+
+	/**
+	 * @brief Chooses the logical CPUs for the worker threads of a benchmark.
+	 * @param cpu_node The NUMA node the workers should run on. Ignored if cpu_list is not empty.
+	 * @param num_threads The number of worker threads.
+	 * @param cpu_list Explicit logical CPUs to use in order, or empty to use the placement policy.
+	 * @param policy How to arrange the CPUs within each node.
+	 * @param latency_cpu Logical CPU for the latency measurement thread, or -1 to use the first placed CPU.
+	 * @param tp_cpus Set to the CPU of each throughput worker. A negative entry means no suitable CPU was found.
+	 * @param lat_cpus Set to the CPU of each latency benchmark worker, starting with the latency measurement thread.
+	 */
+	void choose_worker_cpus(uint32_t cpu_node, uint32_t num_threads, const std::vector<uint32_t>& cpu_list, placement_policy_t policy, int32_t latency_cpu, std::vector<int32_t>& tp_cpus, std::vector<int32_t>& lat_cpus);
+
+	/**
+	 * @brief Chooses the logical CPUs for a latency benchmark whose load threads run on a different NUMA node than its latency measurement thread.
+	 * @param cpu_node The NUMA node of the latency measurement thread.
+	 * @param load_cpu_node The NUMA node of the load threads.
+	 * @param num_threads The number of worker threads, including the latency measurement thread.
+	 * @param policy How to arrange the CPUs within each node.
+	 * @param latency_cpu Logical CPU for the latency measurement thread, or -1 to use the first placed CPU of cpu_node.
+	 * @param lat_cpus Set to the CPU of each worker, starting with the latency measurement thread. A negative entry means no suitable CPU was found.
+	 */
+	void choose_split_latency_cpus(uint32_t cpu_node, uint32_t load_cpu_node, uint32_t num_threads, placement_policy_t policy, int32_t latency_cpu, std::vector<int32_t>& lat_cpus);
+
+	/**
+	 * @brief Gets the relative distance between two NUMA nodes as reported by the OS, e.g. the ACPI SLIT table. By convention a node's distance to itself is 10.
+	 * @param from_node The NUMA node where the accesses originate.
+	 * @param to_node The NUMA node being accessed.
+	 * @returns The relative NUMA distance. If it is not known on this platform, returns -1.
+	 */
+	int32_t numa_node_distance(uint32_t from_node, uint32_t to_node);
+
+	/**
+	 * @brief Parses a Linux-style list of IDs, e.g. "0,2,4-7", as used by sysfs and the --cpus option. IDs are appended in the order given.
+	 * @param list The list to parse.
+	 * @param ids The vector to append the parsed IDs to.
+	 * @returns True on success.
+	 */
+	bool parse_cpu_list(const std::string& list, std::vector<uint32_t>& ids);
+
+	/**
+	 * @brief Gets the two-sided 95% critical value of Student's t distribution.
+	 * @param degrees_of_freedom Degrees of freedom, at least 1.
+	 * @returns The critical value. Beyond the tabulated range this conservatively rounds the degrees of freedom down.
+	 */
+	double student_t_critical_95(uint32_t degrees_of_freedom);
+
+	/**
+	 * @brief Gets the median of sorted values.
+	 * @param sorted Values in ascending order.
+	 * @returns The median, or 0 if there are no values.
+	 */
+	double median_of_sorted(const std::vector<double>& sorted);
+
 	/**
 	 * @brief Computes the number of passes to use for a given working set size in KB, when size-based benchmarking mode is enabled at compile-time.
 	 * You may want to change this implementation to suit your needs. See the compile-time options in common.h.
@@ -428,6 +572,12 @@ namespace xmem {
 	 */
 	bool revertSchedulingPriority();
 #endif
+
+	/**
+	 * @brief Counts how often the calling thread has been preempted, i.e. its involuntary context switches so far.
+	 * @returns The count, or 0 if the platform does not report it.
+	 */
+	uint64_t thread_involuntary_switches();
 };
 
 #endif
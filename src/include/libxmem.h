@@ -0,0 +1,153 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Public interface of libxmem, which lets other programs run X-Mem benchmarks without the xmem front end.
+ *
+ * A program fills in a benchmark specification, runs it, and gets the results back in a struct. The library does not write to stdout or stderr unless a C++ caller hands run_benchmark() streams to report to, does not parse command lines, and does not number tests, so it does not depend on the xmem program's console settings. Problems are reported through the return value and an error message. Benchmarks run one at a time: concurrent calls from several threads are serialized, because overlapping memory benchmarks would disturb each other's measurements.
+ *
+ * C programs use the xmem_* functions. C++ programs may also use run_benchmark() with the BenchmarkSpec and BenchmarkResult types that xmem itself uses.
+ */
+
+#ifndef __LIBXMEM_H
+#define __LIBXMEM_H
+
+//Libraries
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/**
+	 * @brief Kinds of benchmark that the library can run.
+	 */
+	typedef enum {
+		XMEM_THROUGHPUT, /**< Throughput of all worker threads in MB/s. */
+		XMEM_LATENCY /**< Latency of a pointer-chasing thread in ns/access. Any further worker threads generate load. */
+	} xmem_benchmark_kind_t;
+
+	/**
+	 * @brief Describes one benchmark to run. Start from xmem_default_spec() and change what is needed.
+	 */
+	typedef struct {
+		xmem_benchmark_kind_t kind; /**< Which benchmark to run. */
+		uint32_t num_worker_threads; /**< Number of worker threads. For latency benchmarks this includes the latency measurement thread. */
+		size_t working_set_size_per_thread; /**< Working set size per thread in bytes. Must be a multiple of 4 KB. */
+		int random; /**< Nonzero for a random access pattern, zero for sequential. Applies to throughput and load threads. */
+		int write; /**< Nonzero for writes, zero for reads. Applies to throughput and load threads. */
+		uint32_t chunk_size_bits; /**< Width of each memory access: 32, 64, 128, or 256. */
+		int64_t stride_size; /**< Stride in chunks for sequential patterns: 1, -1, 2, -2, 4, -4, 8, -8, 16, or -16. */
+		uint32_t cpu_node; /**< NUMA node whose CPUs run the worker threads. */
+		uint32_t mem_node; /**< NUMA node the working set is allocated on. */
+		const uint32_t* cpus; /**< Explicit logical CPUs for the worker threads in order, or NULL to place them on cpu_node. */
+		uint32_t num_cpus; /**< Number of entries in cpus. */
+		int32_t latency_cpu; /**< Logical CPU for the latency measurement thread, or -1 to use the first placed CPU. */
+		uint32_t iterations; /**< Number of iterations. */
+	} xmem_spec_t;
+
+	/**
+	 * @brief Summary of one benchmark run.
+	 */
+	typedef struct {
+		int warning; /**< Nonzero if any iteration's results are questionable. */
+		uint32_t iterations; /**< Number of iterations that ran. */
+		uint32_t num_outliers; /**< Number of iterations excluded from the statistics as outliers. */
+		double average; /**< Mean of the metric, excluding outliers. */
+		double median; /**< Median of the metric, excluding outliers. */
+		double min; /**< Minimum of the metric, excluding outliers. */
+		double max; /**< Maximum of the metric, excluding outliers. */
+		double stddev; /**< Sample standard deviation of the metric, excluding outliers. */
+		double confidence_interval; /**< Half-width of the 95% confidence interval of the mean. */
+		char units[16]; /**< Units of the metric, e.g. "MB/s" or "ns/access". */
+		double load_throughput; /**< For latency benchmarks with load threads, their mean throughput in MB/s. Otherwise 0. */
+	} xmem_result_t;
+
+	/**
+	 * @brief Queries the system topology. The other functions call this themselves if needed, but a program may call it early to find problems at startup.
+	 * @returns 0 on success, -1 on failure.
+	 */
+	int xmem_init(void);
+
+	/**
+	 * @brief Fills in a specification with defaults: one thread reading sequentially with 64-bit chunks from a 4 KB working set on NUMA node 0, for one iteration.
+	 * @param spec The specification to fill in.
+	 */
+	void xmem_default_spec(xmem_spec_t* spec);
+
+	/**
+	 * @brief Runs one benchmark. This blocks until it has finished.
+	 * @param spec What to run.
+	 * @param result Filled with the results on success.
+	 * @returns 0 on success, -1 on failure. xmem_last_error() then describes the problem.
+	 */
+	int xmem_run(const xmem_spec_t* spec, xmem_result_t* result);
+
+	/**
+	 * @brief Describes why the last failed call on this thread failed.
+	 * @returns The error message, or an empty string. It remains valid until the next library call on this thread.
+	 */
+	const char* xmem_last_error(void);
+
+#ifdef __cplusplus
+}
+
+//Headers
+#include <BenchmarkPlan.h>
+#include <BenchmarkResult.h>
+
+//Libraries
+#include <ostream>
+#include <string>
+
+namespace xmem {
+	/**
+	 * @brief Queries the system topology once per process. Called by run_benchmark() if needed. If the program has already done so through query_sys_info(), its global settings are kept.
+	 * @param error Set to a description of the problem on failure.
+	 * @returns True on success.
+	 */
+	bool library_init(std::string& error);
+
+	/**
+	 * @brief Gets a benchmark specification with the same defaults as xmem_default_spec().
+	 * @returns The specification.
+	 */
+	BenchmarkSpec default_benchmark_spec();
+
+	/**
+	 * @brief Runs one benchmark. This blocks until it has finished. The benchmark is named after spec.label, or "Throughput" or "Latency" if it is empty.
+	 * @param spec What to run. The line field is ignored.
+	 * @param result Filled with the results on success.
+	 * @param error Set to a description of the problem on failure, such as why the working set could not be prepared.
+	 * @param info_log Stream for progress details, like those of xmem --verbose, or NULL to not report them.
+	 * @param warning_log Stream for warnings and errors as they happen, or NULL to discard them. Either way, the reason for a failure is returned through error.
+	 * @returns True on success.
+	 */
+	bool run_benchmark(const BenchmarkSpec& spec, BenchmarkResult& result, std::string& error, std::ostream* info_log = NULL, std::ostream* warning_log = NULL);
+};
+#endif
+
+#endif
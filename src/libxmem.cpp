@@ -0,0 +1,343 @@
+/* The MIT License (MIT)
+ *
+ * Copyright (c) 2014 Microsoft
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file
+ * 
+ * @brief Implementation file for the libxmem programmatic interface.
+ */
+
+//Headers
+#include <libxmem.h>
+#include <common.h>
+#include <Benchmark.h>
+#include <ThroughputBenchmark.h>
+#include <LatencyBenchmark.h>
+#include <PermutationCache.h>
+#include <PowerReader.h>
+
+//Libraries
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#ifdef __gnu_linux__
+#include <numa.h>
+#endif
+
+using namespace xmem;
+
+static std::mutex s_run_mutex; /**< Serializes benchmarks so that they do not disturb each other. */
+static std::once_flag s_init_flag; /**< Ensures that the system is queried only once per process. */
+static bool s_init_ok = false; /**< Whether querying the system succeeded. */
+static thread_local std::string s_last_error; /**< Error message of the last failed call on each thread. */
+
+/**
+ * @brief Allocates a working set on a NUMA node, aligned to a page boundary.
+ * @param numa_node The NUMA node to allocate on.
+ * @param len Length of the working set in bytes.
+ * @param allocation Set to the start of the underlying allocation, which is needed to free it.
+ * @param allocation_size Set to the size of the underlying allocation in bytes.
+ * @returns The aligned working set, or nullptr on failure.
+ */
+static void* allocate_working_set(uint32_t numa_node, size_t len, void*& allocation, size_t& allocation_size) {
+	allocation_size = len + g_page_size; //One page extra so that the working set can be aligned
+#ifdef _WIN32
+	allocation = VirtualAllocExNuma(GetCurrentProcess(), NULL, allocation_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE, numa_node);
+#endif
+#ifdef __gnu_linux__
+	numa_set_strict(1); //Enforce NUMA memory allocation to land on specified node or fail otherwise.
+	allocation = numa_alloc_onnode(allocation_size, numa_node);
+#endif
+	if (allocation == nullptr)
+		return nullptr;
+
+	uintptr_t mask = static_cast<uintptr_t>(g_page_size)-1;
+	return reinterpret_cast<void*>((reinterpret_cast<uintptr_t>(allocation) + mask) & ~mask);
+}
+
+/**
+ * @brief Frees a working set allocated by allocate_working_set().
+ * @param allocation Start of the underlying allocation.
+ * @param allocation_size Size of the underlying allocation in bytes.
+ */
+static void free_working_set(void* allocation, size_t allocation_size) {
+#ifdef _WIN32
+	VirtualFreeEx(GetCurrentProcess(), allocation, 0, MEM_RELEASE);
+#endif
+#ifdef __gnu_linux__
+	numa_free(allocation, allocation_size);
+#endif
+}
+
+bool xmem::library_init(std::string& error) {
+	std::call_once(s_init_flag, []() {
+		if (g_sys_info_ready) { //The host program, e.g. xmem itself, already set things up. Keep its settings.
+			s_init_ok = true;
+			return;
+		}
+		init_globals();
+		s_init_ok = (query_sys_info() == 0);
+	});
+	if (!s_init_ok)
+		error = "Failed to query system information.";
+	return s_init_ok;
+}
+
+BenchmarkSpec xmem::default_benchmark_spec() {
+	BenchmarkSpec spec;
+	spec.latency = false;
+	spec.label = "";
+	spec.num_worker_threads = DEFAULT_NUM_WORKER_THREADS;
+	spec.working_set_size_per_thread = DEFAULT_WORKING_SET_SIZE_PER_THREAD;
+	spec.pattern_mode = SEQUENTIAL;
+	spec.rw_mode = READ;
+	spec.chunk_size = CHUNK_64b;
+	spec.stride_size = 1;
+	spec.cpu_node = 0;
+	spec.mem_node = 0;
+	spec.placement = PLACEMENT_COMPACT;
+	spec.cpus.clear();
+	spec.latency_cpu = -1;
+	spec.load_cpu_node = -1;
+	spec.load_mem_node = -1;
+	spec.sharing_mode = SHARING_PRIVATE;
+	spec.workers.clear();
+	spec.iterations = 1;
+	spec.line = 0;
+	return spec;
+}
+
+bool xmem::run_benchmark(const BenchmarkSpec& spec, BenchmarkResult& result, std::string& error, std::ostream* info_log, std::ostream* warning_log) {
+	std::lock_guard<std::mutex> lock(s_run_mutex);
+
+	if (!library_init(error))
+		return false;
+	if (!validate_benchmark_spec(spec, error))
+		return false;
+
+	size_t len = spec.num_worker_threads * spec.working_set_size_per_thread;
+	void* allocation = nullptr;
+	size_t allocation_size = 0;
+	void* mem_array = allocate_working_set(spec.mem_node, len, allocation, allocation_size);
+	if (mem_array == nullptr) {
+		error = "Failed to allocate the working set on the memory NUMA node.";
+		return false;
+	}
+
+	//Load threads of a latency benchmark on another memory node get a working set of their own there
+	uint32_t load_mem_node = spec_load_mem_node(spec);
+	std::vector<void*> worker_allocations;
+	std::vector<size_t> worker_allocation_sizes;
+	void* load_mem_array = mem_array;
+	bool allocated = true;
+	if (load_mem_node != spec.mem_node) {
+		void* load_allocation = nullptr;
+		size_t load_allocation_size = 0;
+		load_mem_array = allocate_working_set(load_mem_node, len, load_allocation, load_allocation_size);
+		if (load_mem_array == nullptr) {
+			error = "Failed to allocate the working set of the load threads on their memory NUMA node.";
+			allocated = false;
+		} else {
+			worker_allocations.push_back(load_allocation);
+			worker_allocation_sizes.push_back(load_allocation_size);
+		}
+	}
+
+	//Load threads on other memory nodes get one region each from a working set allocated on their node
+	std::vector<WorkerSpec> workers = spec.workers;
+	for (uint32_t node = 0; node < g_num_nodes && allocated; node++) {
+		if (node == load_mem_node)
+			continue;
+		uint32_t num_on_node = 0;
+		for (uint32_t w = 0; w < workers.size(); w++)
+			if (workers[w].mem_node == node)
+				num_on_node++;
+		if (num_on_node == 0)
+			continue;
+
+		void* node_allocation = nullptr;
+		size_t node_allocation_size = 0;
+		void* node_array = allocate_working_set(node, num_on_node * spec.working_set_size_per_thread, node_allocation, node_allocation_size);
+		if (node_array == nullptr) {
+			error = "Failed to allocate the working set of a load thread on its memory NUMA node.";
+			allocated = false;
+			break;
+		}
+		worker_allocations.push_back(node_allocation);
+		worker_allocation_sizes.push_back(node_allocation_size);
+
+		uint32_t region = 0;
+		for (uint32_t w = 0; w < workers.size(); w++)
+			if (workers[w].mem_node == node)
+				workers[w].mem_array = reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(node_array) + (region++) * spec.working_set_size_per_thread);
+	}
+	if (!allocated) {
+		for (uint32_t i = 0; i < worker_allocations.size(); i++)
+			free_working_set(worker_allocations[i], worker_allocation_sizes[i]);
+		free_working_set(allocation, allocation_size);
+		return false;
+	}
+
+	std::vector<int32_t> tp_cpus;
+	std::vector<int32_t> lat_cpus;
+	choose_worker_cpus(spec.cpu_node, spec.num_worker_threads, spec.cpus, spec.placement, spec.latency_cpu, tp_cpus, lat_cpus);
+	if (spec_load_cpu_node(spec) != spec.cpu_node)
+		choose_split_latency_cpus(spec.cpu_node, spec_load_cpu_node(spec), spec.num_worker_threads, spec.placement, spec.latency_cpu, lat_cpus);
+
+	//DRAM power readers belong to the xmem front end, which knows whether the platform supports them
+	std::vector<PowerReader*> no_power_readers;
+	int64_t stride = (spec.pattern_mode == SEQUENTIAL) ? spec.stride_size : 0;
+	Benchmark* benchmark = NULL;
+	if (!spec.latency) {
+		size_t passes_per_iteration = compute_number_of_passes(spec.working_set_size_per_thread / KB);
+		benchmark = new ThroughputBenchmark(mem_array, len, spec.iterations, passes_per_iteration, spec.num_worker_threads, spec.mem_node, spec.cpu_node, tp_cpus, spec.pattern_mode, spec.rw_mode, spec.chunk_size, stride, no_power_readers, spec.label.empty() ? "Throughput" : spec.label);
+	} else {
+		size_t passes_per_iteration = compute_number_of_passes(spec.working_set_size_per_thread / KB) / 4;
+		LatencyBenchmark* latency_benchmark = new LatencyBenchmark(mem_array, len, spec.iterations, passes_per_iteration, spec.num_worker_threads, spec.mem_node, spec.cpu_node, lat_cpus, spec.pattern_mode, spec.rw_mode, spec.chunk_size, stride, no_power_readers, spec.label.empty() ? "Latency" : spec.label);
+		latency_benchmark->setLoadNodes(spec_load_cpu_node(spec), load_mem_node, load_mem_array);
+		benchmark = latency_benchmark;
+	}
+
+	benchmark->setSharingMode(spec.sharing_mode);
+	benchmark->setWorkerSpecs(workers);
+	benchmark->setReporting(info_log, warning_log);
+	bool success = benchmark->run(false);
+	if (success)
+		benchmark->getResult(result);
+	else if (!benchmark->getError().empty())
+		error = benchmark->getError();
+	else
+		error = "The benchmark failed to run.";
+
+	delete benchmark;
+	g_permutation_cache.release(mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(mem_array) + len));
+	free_working_set(allocation, allocation_size);
+	if (load_mem_array != mem_array)
+		g_permutation_cache.release(load_mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(load_mem_array) + len));
+	for (uint32_t w = 0; w < workers.size(); w++)
+		if (workers[w].mem_array != NULL)
+			g_permutation_cache.release(workers[w].mem_array, reinterpret_cast<void*>(reinterpret_cast<uint8_t*>(workers[w].mem_array) + spec.working_set_size_per_thread));
+	for (uint32_t i = 0; i < worker_allocations.size(); i++)
+		free_working_set(worker_allocations[i], worker_allocation_sizes[i]);
+	return success;
+}
+
+int xmem_init(void) {
+	s_last_error.clear();
+	return library_init(s_last_error) ? 0 : -1;
+}
+
+void xmem_default_spec(xmem_spec_t* spec) {
+	if (spec == NULL)
+		return;
+	BenchmarkSpec defaults = default_benchmark_spec();
+	std::memset(spec, 0, sizeof(xmem_spec_t));
+	spec->kind = XMEM_THROUGHPUT;
+	spec->num_worker_threads = defaults.num_worker_threads;
+	spec->working_set_size_per_thread = defaults.working_set_size_per_thread;
+	spec->random = 0;
+	spec->write = 0;
+	spec->chunk_size_bits = chunk_size_bits(defaults.chunk_size);
+	spec->stride_size = defaults.stride_size;
+	spec->cpu_node = defaults.cpu_node;
+	spec->mem_node = defaults.mem_node;
+	spec->cpus = NULL;
+	spec->num_cpus = 0;
+	spec->latency_cpu = defaults.latency_cpu;
+	spec->iterations = defaults.iterations;
+}
+
+int xmem_run(const xmem_spec_t* spec, xmem_result_t* result) {
+	s_last_error.clear();
+	if (spec == NULL || result == NULL) {
+		s_last_error = "The specification and result must not be NULL.";
+		return -1;
+	}
+
+	BenchmarkSpec cpp_spec = default_benchmark_spec();
+	cpp_spec.latency = (spec->kind == XMEM_LATENCY);
+	cpp_spec.num_worker_threads = spec->num_worker_threads;
+	cpp_spec.working_set_size_per_thread = spec->working_set_size_per_thread;
+	cpp_spec.pattern_mode = spec->random ? RANDOM : SEQUENTIAL;
+	cpp_spec.rw_mode = spec->write ? WRITE : READ;
+	switch (spec->chunk_size_bits) {
+		case 32:
+			cpp_spec.chunk_size = CHUNK_32b;
+			break;
+		case 64:
+			cpp_spec.chunk_size = CHUNK_64b;
+			break;
+		case 128:
+			cpp_spec.chunk_size = CHUNK_128b;
+			break;
+		case 256:
+			cpp_spec.chunk_size = CHUNK_256b;
+			break;
+		default:
+			s_last_error = "Chunk size must be 32, 64, 128, or 256 bits.";
+			return -1;
+	}
+	switch (spec->stride_size) {
+		case 1: case -1: case 2: case -2: case 4: case -4: case 8: case -8: case 16: case -16:
+			cpp_spec.stride_size = spec->stride_size;
+			break;
+		default:
+			s_last_error = "Stride size must be one of 1, -1, 2, -2, 4, -4, 8, -8, 16, -16.";
+			return -1;
+	}
+	cpp_spec.cpu_node = spec->cpu_node;
+	cpp_spec.mem_node = spec->mem_node;
+	if (spec->cpus != NULL)
+		cpp_spec.cpus.assign(spec->cpus, spec->cpus + spec->num_cpus);
+	cpp_spec.latency_cpu = spec->latency_cpu;
+	cpp_spec.iterations = spec->iterations;
+
+	BenchmarkResult cpp_result;
+	if (!run_benchmark(cpp_spec, cpp_result, s_last_error))
+		return -1;
+
+	std::memset(result, 0, sizeof(xmem_result_t));
+	result->warning = cpp_result.warning ? 1 : 0;
+	result->iterations = static_cast<uint32_t>(cpp_result.metric_on_iter.size());
+	result->num_outliers = cpp_result.num_outliers;
+	result->average = cpp_result.average_metric;
+	result->median = cpp_result.median_metric;
+	result->min = cpp_result.min_metric;
+	result->max = cpp_result.max_metric;
+	result->stddev = cpp_result.stddev_metric;
+	result->confidence_interval = cpp_result.ci_metric;
+	std::strncpy(result->units, cpp_result.metric_units.c_str(), sizeof(result->units)-1);
+	result->load_throughput = cpp_result.load_metric_units.empty() ? 0 : cpp_result.average_load_metric;
+	return 0;
+}
+
+const char* xmem_last_error(void) {
+	return s_last_error.c_str();
+}
@@ -38,6 +38,8 @@
 #include <build_datetime.h>
 #include <Configurator.h>
 #include <BenchmarkManager.h>
+#include <MonitorDaemon.h>
+#include <benchmark_kernels.h>
 
 //Libraries
 #include <iostream>
@@ -75,9 +77,14 @@ int main(int argc, char* argv[]) {
 		std::cerr << "ERROR occurred while querying CPU information." << std::endl;
 		return -1;
 	}
+
+	//Keep the control thread, and the power, preparation and monitoring threads it spawns, on housekeeping CPUs
+	if (!lock_thread_to_housekeeping_cpus())
+		std::cerr << "WARNING: Failed to move the control thread to the housekeeping CPUs." << std::endl;
 		
 	Configurator config;
 	bool configSuccess = !config.configureFromInput(argc, argv);
+	uint32_t regressions = 0;
 
 	if (configSuccess) {
 		if (g_verbose) {
@@ -86,15 +93,41 @@ int main(int argc, char* argv[]) {
 			test_timers();
 		}
 
-		BenchmarkManager benchmgr(config);
-		if (config.throughputTestSelected()) {
-			benchmgr.runThroughputBenchmarks();
-		}
+		if (config.checkKernelsMode()) {
+			if (!checkKernelInstructions())
+				return 1;
+		} else if (config.daemonMode()) {
+			MonitorDaemon daemon(config);
+			if (!daemon.run())
+				return -1;
+		} else {
+			BenchmarkManager benchmgr(config);
+			if (config.usePlanFile()) {
+				benchmgr.runPlanBenchmarks();
+			} else if (config.numaMatrixMode()) {
+				benchmgr.runMatrixBenchmarks();
+			} else if (config.aggregateMode()) {
+				benchmgr.runAggregateBenchmarks();
+			} else if (config.antagonistMode()) {
+				if (!benchmgr.runAntagonist())
+					return -1;
+			} else {
+				if (config.throughputTestSelected()) {
+					benchmgr.runThroughputBenchmarks();
+				}
+
+				if (config.latencyTestSelected()) {
+					benchmgr.runLatencyBenchmarks();
+				}
+			}
 
-		if (config.latencyTestSelected()) {
-			benchmgr.runLatencyBenchmarks();
+			regressions = benchmgr.reportComparison();
 		}
 	}
 
-	return !configSuccess;
+	if (!configSuccess)
+		return 1;
+	if (regressions > 0) //Distinct status so nightly regression checks can tell regressions from usage errors
+		return 2;
+	return 0;
 }